@@ -0,0 +1,34 @@
+#ifndef BARCODE_ENCODER_H
+#define BARCODE_ENCODER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Software CODE128 (code set B: printable ASCII) for printers without GS k.
+// Produces the module sequence - start, data, check, stop - as packed bits
+// (1 = bar) for printRaster(); every row of the symbol is the same.
+class BarcodeEncoder {
+public:
+    static const uint16_t MAX_MODULES = 11 * (BARCODE_MAX_LENGTH + 3) + 2;
+
+private:
+    uint8_t bars[(MAX_MODULES + 7) / 8];
+    uint16_t moduleCount;
+
+    void appendPattern(uint16_t pattern, uint8_t width);
+
+public:
+    BarcodeEncoder();
+
+    // False for an empty or too long string or characters outside 32-126
+    bool encode(const char* data, size_t length);
+
+    uint16_t getModuleCount() const { return moduleCount; }
+    bool getModule(uint16_t x) const;
+
+    static bool isEncodable(const char* data, size_t length);
+    // Modules for length characters, without quiet zones
+    static uint16_t modulesFor(size_t length) { return 11 * (length + 3) + 2; }
+};
+
+#endif // BARCODE_ENCODER_H
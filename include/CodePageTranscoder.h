@@ -0,0 +1,59 @@
+#ifndef CODE_PAGE_TRANSCODER_H
+#define CODE_PAGE_TRANSCODER_H
+
+#include <Arduino.h>
+#include "EscPosEncoder.h"
+#include "IconAtlas.h"
+
+// ESC t n values for the code pages the transcoder can select
+#define CODE_PAGE_CP437 0
+#define CODE_PAGE_CP850 2
+#define CODE_PAGE_CP1252 16
+
+// One row per Unicode codepoint that exists in at least one supported code
+// page. Each column holds the byte for that page, 0 if the page lacks it.
+struct CodePageEntry {
+    uint16_t codepoint;
+    uint8_t cp437;
+    uint8_t cp850;
+    uint8_t cp1252;
+};
+
+// UTF-8 -> printer code page transcoder. Each supported character costs a
+// single byte on the wire; ESC t is only emitted when a character isn't in
+// the page currently selected on the printer. Emoji without a code page
+// equivalent fall back to the TextSanitizer replacement table.
+class CodePageTranscoder {
+private:
+    uint8_t currentPage;  // ESC t value currently selected on the printer
+    bool userGlyphs;      // ESC % 1 active with the UserGlyphs set downloaded
+    IconAtlas* icons;     // Inline 24-dot icons for other emoji (nullptr = off)
+    
+    static const CodePageEntry* findEntry(uint32_t codepoint);
+    static uint8_t byteForPage(const CodePageEntry* entry, uint8_t page);
+    uint8_t choosePage(const CodePageEntry* entry, const uint8_t* text, size_t length) const;
+    
+public:
+    CodePageTranscoder();
+    
+    // Call after ESC @ / ESC t so the tracked page matches the printer
+    void reset(uint8_t page = CODE_PAGE_CP437) { currentPage = page; }
+    uint8_t getCurrentPage() const { return currentPage; }
+    
+    // Call after ESC % so emoji map to the downloaded glyphs
+    void setUserGlyphs(bool enabled) { userGlyphs = enabled; }
+    void setIconAtlas(IconAtlas* atlas) { icons = atlas; }
+    
+    // Append text to the job, switching code page only when needed.
+    // Returns the number of code page switches emitted.
+    int transcode(const char* text, size_t length, EscPosEncoder& out);
+    int transcode(const String& text, EscPosEncoder& out) { return transcode(text.c_str(), text.length(), out); }
+    
+    // Printer columns the next UTF-8 character will occupy once transcoded
+    // (0 if dropped, >1 for emoji replacements). Sets consumed to its byte length.
+    // Assumes user glyphs (and inline icons, if PRINTER_INLINE_ICONS) are
+    // active, as they are for every template print.
+    static uint8_t printedWidth(const char* text, size_t length, size_t* consumed);
+};
+
+#endif // CODE_PAGE_TRANSCODER_H
@@ -0,0 +1,79 @@
+#ifndef ESC_POS_ENCODER_H
+#define ESC_POS_ENCODER_H
+
+#include <Arduino.h>
+
+// ESC/POS control bytes
+#define ESCPOS_ESC 27
+#define ESCPOS_GS 29
+#define ESCPOS_DLE 16
+#define ESCPOS_EOT 4
+#define ESCPOS_DC2 18
+
+// Builds a complete printer job (init, formatting, text, cut) in one
+// contiguous byte buffer so it can be handed to the UART with a single write.
+// The buffer is kept between jobs to avoid re-allocating for every receipt.
+class EscPosEncoder {
+private:
+    uint8_t* buffer;
+    size_t length;
+    size_t capacity;
+    bool overflow;  // Set when the buffer could not grow; job must be dropped
+
+    bool ensureCapacity(size_t extra);
+
+public:
+    EscPosEncoder(size_t initialCapacity = 512);
+    ~EscPosEncoder();
+
+    // Buffer management
+    void reset();
+    const uint8_t* data() const { return buffer; }
+    size_t size() const { return length; }
+    bool hasOverflowed() const { return overflow; }
+
+    // Raw output
+    EscPosEncoder& write(uint8_t b);
+    EscPosEncoder& write(const uint8_t* bytes, size_t count);
+    EscPosEncoder& print(const char* text);
+    EscPosEncoder& print(const String& text);
+    EscPosEncoder& println(const String& text);  // Appends CR LF like Print::println
+
+    // In-place output: reserve space at the end of the job, fill it, then
+    // commit the bytes actually written. Returns nullptr if out of memory.
+    uint8_t* reserve(size_t count);
+    void commit(size_t count);
+
+    // Printer commands
+    EscPosEncoder& initialize();                 // ESC @
+    EscPosEncoder& codePage(uint8_t page);       // ESC t n
+    EscPosEncoder& defaultLineSpace();           // ESC 2
+    EscPosEncoder& lineSpacing(uint8_t dots);    // ESC 3 n
+    EscPosEncoder& align(uint8_t mode);          // ESC a n (0 = left, 1 = center, 2 = right)
+    EscPosEncoder& printMode(uint8_t mode);      // ESC ! n
+    EscPosEncoder& bold(bool enable);            // ESC E n
+    EscPosEncoder& underline(uint8_t mode);      // ESC - n
+    EscPosEncoder& inverse(bool enable);         // GS B n
+    EscPosEncoder& cut(uint8_t mode = 0);        // GS V n
+    EscPosEncoder& userCharacters(bool enable);  // ESC % n
+    EscPosEncoder& heatingParameters(uint8_t dots, uint8_t time, uint8_t interval);  // ESC 7 n1 n2 n3
+    EscPosEncoder& printDensity(uint8_t density, uint8_t breakTime);  // DC2 # n
+    EscPosEncoder& transmitPaperStatus();        // GS r 1 - answered once everything before it is processed
+    // GS ( E user setup: set the serial speed, then leave setup mode, which
+    // restarts the printer at the new rate
+    EscPosEncoder& serialBaudRate(uint32_t baud);
+    // GS ( k - QR Code model 2: select the model, module size (1-16 dots)
+    // and error correction (0-3 = L, M, Q, H), then store the data
+    EscPosEncoder& qrCodeStore(const uint8_t* data, size_t length, uint8_t moduleDots, uint8_t errorCorrection);
+    EscPosEncoder& qrCodePrint();                // GS ( k fn 181 - print the stored symbol
+    EscPosEncoder& qrCodeTransmitSize();         // GS ( k fn 182 - reply 0x37 ... NUL, only if QR is supported
+    // GS h / GS w / GS H / GS k 73 - CODE128 (code set B) with the text
+    // printed below; moduleDots is the narrowest bar (2-6)
+    EscPosEncoder& barcode128(const char* data, size_t length, uint8_t heightDots, uint8_t moduleDots);
+    // ESC * 33 nL nH d1...d(3n) - 24-dot bit image printed inline with text
+    EscPosEncoder& bitImage24(uint16_t width, const uint8_t* columns);
+    // ESC & 3 c c x d1...d(3x) - one 24-dot-high user-defined character
+    EscPosEncoder& defineCharacter(uint8_t code, uint8_t width, const uint8_t* columns);
+};
+
+#endif // ESC_POS_ENCODER_H
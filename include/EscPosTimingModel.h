@@ -0,0 +1,71 @@
+#ifndef ESC_POS_TIMING_MODEL_H
+#define ESC_POS_TIMING_MODEL_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Follows an ESC/POS byte stream the way the printer would - line feeds,
+// line spacing, raster rows, QR codes, barcodes and cuts - and estimates
+// how long it takes to print without a printer attached. The stream may
+// arrive in any number of pieces.
+//
+// Time model: the UART and the head overlap (the printer prints from its
+// buffer while more arrives), so a job takes the longer of the wire time
+// and the paper feed (RASTER_ROW_TIME_US per dot row), plus PRINTER_CUT_MS
+// per cut.
+class EscPosTimingModel {
+private:
+    enum ParseState {
+        PARSE_TEXT,
+        PARSE_COMMAND,      // Collecting a command header
+        PARSE_SKIP,         // Skipping command data
+        PARSE_SKIP_TO_NUL,  // GS k with m < 65: data ends at NUL
+        PARSE_CHAR_WIDTH    // ESC &: width byte of the next character
+    };
+
+    ParseState state;
+    uint8_t header[8];
+    uint8_t headerLength;
+    uint8_t headerNeeded;
+    uint32_t skipRemaining;
+    uint8_t charsRemaining;   // ESC &: characters still to define
+    uint8_t charHeight;       // ESC &: bytes per column
+
+    // Printer modes that affect paper use
+    uint8_t lineSpacing;
+    bool doubleHeight;
+    uint8_t lineHeight;       // Tallest thing on the current line, 0 = empty
+    uint8_t barcodeHeight;
+    bool barcodeText;
+    uint8_t qrModuleDots;
+    uint16_t qrLength;
+
+    uint32_t bytes;
+    uint32_t lines;
+    uint32_t paperDots;
+    uint32_t rasterRows;
+    uint16_t cuts;
+
+    void command();
+    void lineFeed();
+    uint8_t headerLengthFor(uint8_t prefix, uint8_t code) const;
+
+public:
+    EscPosTimingModel();
+
+    void reset();
+    void feed(const uint8_t* data, size_t length);
+
+    uint32_t getBytes() const { return bytes; }
+    uint32_t getLines() const { return lines; }            // Line feeds
+    uint32_t getPaperDots() const { return paperDots; }    // Paper advanced, 8 dots/mm
+    uint32_t getRasterRows() const { return rasterRows; }
+    uint16_t getCuts() const { return cuts; }
+
+    uint32_t getUartMs(uint32_t baud) const;
+    uint32_t getHeadMs() const;
+    uint32_t getCutMs() const;
+    uint32_t getEstimatedMs(uint32_t baud) const;
+};
+
+#endif // ESC_POS_TIMING_MODEL_H
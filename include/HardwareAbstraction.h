@@ -4,6 +4,9 @@
 #include <Arduino.h>
 #include <HardwareSerial.h>
 #include <SPI.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 // Configure TFT_eSPI before including it
 #define USER_SETUP_LOADED
@@ -14,11 +17,12 @@
 #define TFT_CS   22   // LCD_CS (Chip Select - moved from GPIO 15 to avoid strapping pin)
 #define TFT_DC   18   // LCD_RS (Data/Command)
 #define TFT_RST  19   // LCD_RST (Reset)
-// Touch screen disabled to avoid TFT_eSPI parallel mode conflict and save memory
+// TFT_eSPI touch support stays off; TouchController drives the XPT2046 (config.h pins)
 // #define TOUCH_CS 25   // Touch Controller Chip Select
 // #define TOUCH_IRQ 4   // Touch Interrupt - moved from GPIO 26 to GPIO 4
 #define SPI_FREQUENCY  20000000
-// Memory optimization: Disable DMA and frame buffers to save RAM
+// Memory optimization: no frame buffers. TFT_eSPI has no DMA for the ILI9486 over
+// SPI (18-bit colour); the dashboard has its own small DMA path (DISPLAY_DMA_ENABLED)
 #define ESP32_DMA_CHAN 0  // Disable DMA (0 = no DMA)
 #define ESP32_PARALLEL 0  // Not using parallel interface
 // Reduced font set to save flash memory
@@ -30,31 +34,75 @@
 #include <TFT_eSPI.h>
 #include "config.h"
 #include "Logger.h"
+#include "SanitizerModel.h"
+#include "SensorSampler.h"
+#include "LedDimmer.h"
+#include "TouchController.h"
+#include "PrinterPort.h"
+
+// Timed pump doses, measured from pump on to pump off
+struct DoseStats {
+    uint32_t doses;            // Ended by the dose timer
+    uint32_t stoppedEarly;     // Stopped by a command before the dose ended
+    uint32_t lastDoseMs;       // Requested
+    uint32_t lastOnUs;         // Measured
+    int32_t jitterMinUs;       // Measured minus requested
+    int32_t jitterMaxUs;
+    uint64_t jitterAbsTotalUs;
+};
 
 // Hardware Abstraction Layer for Print_n_Prick
-class HardwareAbstraction {
+class HardwareAbstraction : public PrinterPort {
 private:
     static const char* TAG;
     HardwareSerial* printerSerial;
+    uint32_t printerBaud;
     TFT_eSPI* tft;
+    SemaphoreHandle_t displayLock;  // Shared SPI bus: display drawing and touch readings
+    TouchController touch;
     
     // Pin states
     bool ledState;
     bool pumpState;
     
-    // Sensor readings
+    // Sensor readings (analog ones from the background sampler)
+    SensorSampler sensorSampler;
     float moisturePercent;
     bool irDetected;
     float lightPercent;
-    uint8_t ledBrightness;
+    LedDimmer ledDimmer;
     bool autoBrightnessEnabled;  // Flag to enable/disable automatic brightness control
     
     // Sanitizer tracking
-    float sanitizerLevel;
+    SanitizerModel sanitizer;
     int totalDispenses;
     unsigned long lastDispenseTime;
     unsigned long dispenseStartTime;
+    unsigned long pumpStartMicros;  // When the pump GPIO went high, for latency measurement
     bool dispensing;
+    SemaphoreHandle_t pumpLock;     // startPump/stopPump run from loop(), the dispenser task and the timers
+    enum PumpStartResult {
+        PUMP_STARTED,
+        PUMP_ALREADY_RUNNING,
+        PUMP_COOLING_DOWN
+    };
+    // No logging under pumpLock (the timers give up on a busy lock), so
+    // these report back and the caller logs after releasing it. detailMs
+    // is the dose started, or the cooldown left.
+    PumpStartResult startPumpLocked(uint32_t requestedMs, uint32_t& detailMs);
+    bool stopPumpLocked(bool doseEnded);
+    void logPumpStopped(const DoseStats& stats) const;
+    
+    // Dose timing: pump-off is a one-shot esp_timer armed at pump start,
+    // so the dose length doesn't depend on loop() getting around to it
+    uint32_t doseMs;                // Default dose
+    uint32_t activeDoseMs;          // Dose running now
+    esp_timer_handle_t pumpOffTimer;
+    esp_timer_handle_t pumpRampTimer;
+    DoseStats doseStats;
+    volatile bool doseEndUnlogged;  // Set by the dose timer, logged from loop()
+    static void handlePumpOff(void* param);
+    static void handlePumpRamp(void* param);
     
 public:
     HardwareAbstraction();
@@ -71,46 +119,60 @@ public:
     bool getLEDState() const { return ledState; }
     
     // Pump Control
-    bool startPump();
+    bool startPump(uint32_t requestedMs = 0);  // Under DISPENSE_MIN_DOSE_MS = default dose; capped at MAX_DISPENSE_DURATION_MS
     bool stopPump();
     bool isPumpRunning() const { return pumpState; }
     bool isDispensing() const { return dispensing; }
+    unsigned long getPumpStartMicros() const { return pumpStartMicros; }
     unsigned long getDispenseDuration() const;
-    bool checkDispenseTimeout();
+    bool checkDispenseTimeout();  // Call from loop(): backstop stop, and logs timer-ended doses
     bool checkCooldown() const;
+    bool setDoseMs(uint32_t ms);          // Default dose, saved in NVS
+    uint32_t getDoseMs() const { return doseMs; }
+    uint32_t getActiveDoseMs() const { return activeDoseMs; }
+    DoseStats getDoseStats() const;
     
-    // Sensor Reading
+    // Sensor Reading (moisture and light are memory reads of the sampler's filtered values)
     float readMoistureSensor();
     bool readIRSensor();
     float readLightSensor();
-    float getMoisturePercent() const { return moisturePercent; }
+    SensorSampler& getSensorSampler() { return sensorSampler; }
+    float getMoisturePercent() const override { return moisturePercent; }
     bool isIRDetected() const { return irDetected; }
     float getLightPercent() const { return lightPercent; }
     
     // LED Brightness Control (inverse of light level)
     void updateLEDBrightness();
-    void setLEDBrightness(uint8_t brightness);  // 0-255
+    void setLEDBrightness(uint8_t brightness, uint16_t fadeMs = LED_FADE_MANUAL_MS);  // 0-255, gamma-corrected, hardware fade
     void setAutoBrightness(bool enabled);  // Enable/disable automatic brightness control
     bool isAutoBrightnessEnabled() const { return autoBrightnessEnabled; }
-    uint8_t getLEDBrightness() const { return ledBrightness; }
+    uint8_t getLEDBrightness() const { return ledDimmer.getLevel(); }
+    LedDimmer& getLedDimmer() { return ledDimmer; }
     
     // Sanitizer Management
-    float getSanitizerLevel() const { return sanitizerLevel; }
+    float getSanitizerLevel() const override { return sanitizer.getPercent(); }
     void setSanitizerLevel(float level);
-    void updateSanitizerLevel(float amount);
+    SanitizerModel& getSanitizer() { return sanitizer; }
     int getTotalDispenses() const { return totalDispenses; }
     void resetSanitizer();
     
     // Printer Operations
-    bool printerWrite(const uint8_t* data, size_t length);
+    bool printerWrite(const uint8_t* data, size_t length) override;
     bool printerWrite(uint8_t data);
     bool printerWriteString(const String& str);
     bool printerPrintln(const String& str);
-    bool printerAvailable() const;
+    bool printerWaitTxDone(uint32_t timeoutMs) override;  // Wait until UART2 has shifted out every queued byte
+    int printerRead(uint32_t timeoutMs) override;          // One byte from the printer, -1 on timeout
+    void printerFlushInput() override;                     // Drop stale bytes from the RX buffer
+    bool printerAvailable() const override;
+    bool setPrinterBaud(uint32_t baud) override;           // Reconfigure UART2 once queued bytes are out
+    uint32_t getPrinterBaud() const override { return printerBaud; }
     
     // Display Operations
     TFT_eSPI* getDisplay() { return tft; }
     bool displayAvailable() const { return tft != nullptr; }
+    bool lockDisplay(TickType_t wait = portMAX_DELAY);  // Hold while drawing from outside the dashboard task
+    void unlockDisplay();
     void displayDebugText(const String& text, uint16_t color = 0xFFFF, uint8_t size = 2);
     void displayClear(uint16_t color = 0x0000);
     void displayTestPattern();
@@ -122,6 +184,7 @@ public:
     bool isTouchPressed();
     bool readTouch(int16_t* x, int16_t* y);
     int getTouchIRQState() const;
+    TouchController& getTouch() { return touch; }
     
     // Diagnostic
     void printDiagnostics() const;
@@ -4,10 +4,14 @@
 #include <Arduino.h>
 #include "Logger.h"
 
+class PrinterService;
+
 struct SystemHealth {
     bool wifiConnected;
     bool firebaseHealthy;
     bool printerReady;
+    String printerState;
+    bool printerPaperNearEnd;
     unsigned long uptime;
     uint32_t freeHeap;
     uint32_t minFreeHeap;
@@ -24,6 +28,7 @@ private:
     SystemHealth health;
     unsigned long lastHealthCheck;
     unsigned long healthCheckInterval;
+    const PrinterService* printer;
     
 public:
     HealthMonitor();
@@ -31,6 +36,7 @@ public:
     
     // Configuration
     void setCheckInterval(unsigned long intervalMs);
+    void setPrinter(const PrinterService* printerService) { printer = printerService; }
     
     // Health checks
     void update();
@@ -41,6 +47,7 @@ public:
     void checkWiFi();
     void checkMemory();
     void checkSystem();
+    void checkPrinter();
     
     // Reporting
     String getHealthReport() const;
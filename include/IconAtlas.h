@@ -0,0 +1,59 @@
+#ifndef ICON_ATLAS_H
+#define ICON_ATLAS_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Icons are 24x24 dots, stored column-major with 3 bytes per column (top
+// byte first, MSB = top dot) - the ESC * 33 bit image layout
+#define ICON_WIDTH 24
+#define ICON_BYTES (ICON_WIDTH * 3)
+
+struct IconAtlasEntry {
+    uint32_t codepoint;
+    const uint8_t* packed;   // PackBits-compressed columns in flash
+    uint8_t packedLength;
+};
+
+// Flash-resident emoji icons printed inline with text (ESC * 33) for emoji
+// the user-defined glyph set doesn't cover. Decoded icons are kept in a
+// small LRU cache so repeated emoji don't pay for decompression again.
+// Only used from the print spooler task.
+class IconAtlas {
+private:
+    struct CacheSlot {
+        uint32_t codepoint;      // 0 = empty
+        uint32_t lastUse;
+        uint8_t columns[ICON_BYTES];
+    };
+
+    CacheSlot cache[ICON_CACHE_SLOTS];
+    uint32_t useCounter;
+
+    // Benchmark counters
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t iconsPrinted;
+    uint32_t iconBytes;          // Bytes sent for inline icons
+    uint32_t replacementBytes;   // Bytes the [WORD] replacements would have cost
+
+    static const IconAtlasEntry* findEntry(uint32_t codepoint);
+    static bool unpack(const uint8_t* packed, size_t length, uint8_t* out, size_t outLength);
+
+public:
+    IconAtlas();
+
+    static bool contains(uint32_t codepoint);
+
+    // Decoded columns for a codepoint (ICON_BYTES), or nullptr if it has
+    // no icon. Counts the use for the byte statistics.
+    const uint8_t* get(uint32_t codepoint);
+
+    uint32_t getCacheHits() const { return hits; }
+    uint32_t getCacheMisses() const { return misses; }
+    uint32_t getIconsPrinted() const { return iconsPrinted; }
+    uint32_t getIconBytes() const { return iconBytes; }
+    uint32_t getReplacementBytes() const { return replacementBytes; }
+};
+
+#endif // ICON_ATLAS_H
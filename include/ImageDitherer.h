@@ -0,0 +1,55 @@
+#ifndef IMAGE_DITHERER_H
+#define IMAGE_DITHERER_H
+
+#include <Arduino.h>
+#include <functional>
+
+enum DitherMode {
+    DITHER_FLOYD_STEINBERG,
+    DITHER_ATKINSON
+};
+
+// Reads the next source row of 8-bit grayscale pixels (0 = black).
+// Return false on end of data or error.
+typedef std::function<bool(uint8_t* gray, uint16_t width)> GrayRowSource;
+
+// Streaming grayscale -> 1bpp converter. Source rows are pulled one at a
+// time, scaled to the target width (box filter horizontally, nearest row
+// vertically), error-diffusion dithered and packed MSB-first. Memory is one
+// source row plus the error rows, independent of image height.
+class ImageDitherer {
+private:
+    uint16_t srcWidth;
+    uint16_t srcHeight;
+    uint16_t outWidth;
+    uint16_t outHeight;
+    DitherMode mode;
+
+    uint8_t* srcRow;
+    int16_t* errorRows[3];   // Current row, next row, row after next (Atkinson only)
+    int32_t srcRowIndex;     // Index of the source row currently in srcRow
+    uint16_t outRowIndex;
+    size_t allocatedBytes;
+
+    void scaleInto(int16_t* row);
+    void rotateErrorRows();
+
+public:
+    ImageDitherer();
+    ~ImageDitherer();
+
+    // Allocates row buffers; targetWidth is rounded down to a multiple of 8
+    bool begin(uint16_t sourceWidth, uint16_t sourceHeight, uint16_t targetWidth, DitherMode ditherMode);
+    void end();
+
+    // Produce the next packed output row (getOutputWidth() / 8 bytes)
+    bool nextRow(const GrayRowSource& source, uint8_t* out);
+
+    uint16_t getOutputWidth() const { return outWidth; }
+    uint16_t getOutputHeight() const { return outHeight; }
+    size_t getMemoryUsage() const { return allocatedBytes; }
+
+    static DitherMode parseMode(const String& name);
+};
+
+#endif // IMAGE_DITHERER_H
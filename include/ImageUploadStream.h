@@ -0,0 +1,72 @@
+#ifndef IMAGE_UPLOAD_STREAM_H
+#define IMAGE_UPLOAD_STREAM_H
+
+#include <Arduino.h>
+#include <functional>
+#include <freertos/FreeRTOS.h>
+#include <freertos/stream_buffer.h>
+#include "ImageDitherer.h"
+#include "Logger.h"
+#include "config.h"
+
+enum ImageFormat {
+    IMAGE_FORMAT_PGM,       // Binary PGM (P5), size read from the header
+    IMAGE_FORMAT_RAW_GRAY   // Headerless 8-bit grayscale, size given by the request
+};
+
+// Bounded pipe between the HTTP upload handler (producer, loop task) and the
+// print spooler (consumer). The image is never held in RAM: the producer
+// blocks while the buffer is full, so the upload runs at printer speed.
+// Both sides hold a reference; the stream deletes itself when both release.
+class ImageUploadStream {
+private:
+    static const char* TAG;
+
+    StreamBufferHandle_t buffer;
+    ImageFormat format;
+    uint16_t width;
+    uint16_t height;
+    uint8_t maxValue;        // PGM maxval; samples are rescaled to 0-255
+    DitherMode ditherMode;
+    size_t bytesWritten;
+    size_t bytesRead;
+
+    volatile bool producerDone;
+    volatile bool consumerDone;
+    volatile bool aborted;
+    int refCount;
+    portMUX_TYPE mux;
+
+    std::function<void()> waitCallback;
+
+    bool read(uint8_t* out, size_t length);
+    bool readByte(uint8_t& b);
+    bool readHeaderNumber(uint32_t& value);
+    void release();
+
+public:
+    ImageUploadStream(ImageFormat imageFormat, uint16_t imageWidth, uint16_t imageHeight, DitherMode mode);
+    ~ImageUploadStream();
+
+    bool isValid() const { return buffer != nullptr; }
+
+    // Producer side. write() blocks while the consumer catches up and
+    // calls the wait callback between polls so loop() work isn't starved.
+    void setWaitCallback(std::function<void()> callback) { waitCallback = callback; }
+    bool write(const uint8_t* data, size_t length);
+    void finish(bool abort);  // End of upload; drops the producer reference
+
+    // Consumer side
+    bool readHeader();
+    bool readRow(uint8_t* gray, uint16_t rowWidth);
+    void close();             // Drops the consumer reference
+
+    ImageFormat getFormat() const { return format; }
+    uint16_t getWidth() const { return width; }
+    uint16_t getHeight() const { return height; }
+    DitherMode getDitherMode() const { return ditherMode; }
+    size_t getBytesWritten() const { return bytesWritten; }
+    bool isConsumerDone() const { return consumerDone; }
+};
+
+#endif // IMAGE_UPLOAD_STREAM_H
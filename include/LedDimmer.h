@@ -0,0 +1,65 @@
+#ifndef LED_DIMMER_H
+#define LED_DIMMER_H
+
+#include <Arduino.h>
+#include <driver/ledc.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include "Logger.h"
+#include "config.h"
+
+// 12V LED brightness through the LEDC hardware fade engine.
+//
+// Levels are 0-255 and perceptual: a gamma LUT built at begin() maps them
+// to LED_PWM_RESOLUTION-bit duty, so equal steps look equal. Changes are
+// handed to the fade engine and ramp without CPU involvement. The driver
+// blocks when a fade is started while another is running, so a change
+// that arrives mid-fade is kept and started by a one-shot timer once the
+// running fade has finished.
+class LedDimmer {
+private:
+    static const char* TAG;
+
+    uint16_t gammaLut[256];
+    uint32_t maxDuty;
+    bool fadeReady;                // ledc fade service installed
+
+    mutable portMUX_TYPE fadeMux;  // Guards the fade bookkeeping below
+    uint8_t level;                 // Newest requested level
+    uint8_t pendingLevel;
+    uint16_t pendingFadeMs;
+    bool pending;
+    int64_t fadeEndsUs;            // esp_timer time the running fade finishes
+    esp_timer_handle_t pendingTimer;
+
+    float lightRef;                // Light level the current auto level came from (-1 = none)
+    uint32_t fades;
+    uint32_t deferred;
+
+    static void handlePending(void* param);
+    void startFade(uint8_t target, uint16_t fadeMs);
+
+public:
+    LedDimmer();
+    ~LedDimmer();
+
+    // Build the LUT and install the fade service; the LEDC channel must
+    // already be set up
+    bool begin();
+
+    // Fade to a 0-255 level over fadeMs
+    void setLevel(uint8_t target, uint16_t fadeMs);
+
+    // Auto brightness: dark -> bright LED. Ignores light changes smaller
+    // than LED_LIGHT_HYSTERESIS so the LED doesn't hunt. True if it faded.
+    bool setFromLight(float lightPercent);
+    void resetLightReference() { lightRef = -1; }
+
+    uint8_t getLevel() const { return level; }
+    uint32_t getDuty() const;      // Current hardware duty, mid-fade included
+    uint32_t getMaxDuty() const { return maxDuty; }
+
+    String getStatusJSON() const;
+};
+
+#endif // LED_DIMMER_H
@@ -0,0 +1,27 @@
+#ifndef PRINT_COALESCER_H
+#define PRINT_COALESCER_H
+
+#include <Arduino.h>
+#include "PrintJob.h"
+#include "config.h"
+
+// Rules for printing a burst of receipts as one job (one ESC @, one cut).
+// Works on the queued jobs in FIFO order so the spooler can ask it while
+// holding its lock, and the rules can be tested without a spooler task.
+class PrintCoalescer {
+public:
+    // Whether next can print in the same batch as first: receipts only,
+    // and only with the same heating profile
+    static bool canJoin(const PrintJob& first, const PrintJob& next);
+
+    // Jobs from the front of the queue that print together (at most
+    // PRINT_COALESCE_MAX_JOBS; 1 for anything but a receipt)
+    static int batchSize(const PrintJob* const* queue, int count);
+
+    // How long to hold the front job for more receipts to join; 0 prints
+    // it now. Nothing is held once the batch is full, can't grow (a job
+    // that can't join is queued behind it) or the window has passed.
+    static unsigned long holdMs(const PrintJob* const* queue, int count, unsigned long now);
+};
+
+#endif // PRINT_COALESCER_H
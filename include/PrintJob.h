@@ -0,0 +1,56 @@
+#ifndef PRINT_JOB_H
+#define PRINT_JOB_H
+
+#include <Arduino.h>
+#include "PrintProfiles.h"
+
+class ImageUploadStream;
+
+enum PrintJobType {
+    PRINT_JOB_RECEIPT,
+    PRINT_JOB_GROCERY_LIST,
+    PRINT_JOB_TEST,
+    PRINT_JOB_IMAGE,
+    PRINT_JOB_BAUD_TEST,
+    PRINT_JOB_QR_CODE,
+    PRINT_JOB_BARCODE,
+    PRINT_JOB_BENCHMARK,
+    PRINT_JOB_CALIBRATION
+};
+
+enum PrintJobStatus {
+    PRINT_JOB_EMPTY,
+    PRINT_JOB_QUEUED,
+    PRINT_JOB_PRINTING,
+    PRINT_JOB_DONE,
+    PRINT_JOB_FAILED,
+    PRINT_JOB_CANCELLED
+};
+
+struct PrintJob {
+    uint32_t id;
+    PrintJobType type;
+    PrintJobStatus status;
+    String text;         // Message, or grocery items separated by '\n'
+    String weather;      // Weather snapshot taken when the job was submitted
+    String label;        // Short preview kept after the payload is released
+    String caption;      // QR code jobs: text printed under the symbol
+    ImageUploadStream* image;  // Image jobs only; the spooler closes it when done
+    uint16_t estimatedLines;   // Printed lines from the layout engine (0 = unknown)
+    uint32_t journalId;        // PrintJournal entry, completed when the job finishes
+    uint32_t baudRate;         // Baud test jobs: rate to switch to first
+    bool saveBaud;             // Baud test jobs: persist even if the printer can't confirm it
+    PrintProfileId profile;    // Heating profile (PRINT_PROFILE_DEFAULT = printer default)
+    bool includeWeatherAndSanitizer;
+    time_t createdTime;
+    unsigned long queuedAt;
+    unsigned long startedAt;
+    unsigned long finishedAt;
+
+    PrintJob() : id(0), type(PRINT_JOB_RECEIPT), status(PRINT_JOB_EMPTY),
+                 image(nullptr), estimatedLines(0), journalId(0), baudRate(0), saveBaud(false),
+                 profile(PRINT_PROFILE_DEFAULT), includeWeatherAndSanitizer(false), createdTime(0),
+                 queuedAt(0), startedAt(0), finishedAt(0) {}
+};
+
+#endif // PRINT_JOB_H
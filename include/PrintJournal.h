@@ -0,0 +1,119 @@
+#ifndef PRINT_JOURNAL_H
+#define PRINT_JOURNAL_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <functional>
+#include "Logger.h"
+#include "config.h"
+
+enum PrintJournalType {
+    PRINT_JOURNAL_RECEIPT = 1,
+    PRINT_JOURNAL_GROCERY_LIST = 2
+};
+
+enum PrintJournalRecordKind {
+    PRINT_JOURNAL_ADD = 1,    // Header + payload of a job
+    PRINT_JOURNAL_DONE = 2    // Job finished; header only
+};
+
+// On-flash record header, little-endian. The CRC covers the header (with
+// crc = 0) and the payload, so a record torn by a reset is detected.
+struct PrintJournalRecord {
+    uint8_t magic;
+    uint8_t kind;
+    uint8_t jobType;
+    uint8_t flags;            // Bit 0: include weather and sanitizer
+    uint32_t id;
+    uint32_t createdTime;
+    uint16_t length;          // Payload bytes
+    uint16_t reserved;
+    uint32_t crc;
+};
+
+// A journaled job handed back for replay
+struct PrintJournalEntry {
+    uint32_t id;
+    PrintJournalType type;
+    String text;              // Message, or grocery items separated by '\n'
+    bool includeWeatherAndSanitizer;
+    time_t createdTime;
+};
+
+// Return true if the job was accepted (it is then in flight until completed)
+typedef std::function<bool(const PrintJournalEntry& entry)> PrintJournalReplay;
+
+// Append-only print journal on LittleFS. A job is appended (one sequential
+// write + flush) before its source is acknowledged and a small DONE record
+// is appended once it has printed, so after a brownout or OTA reboot every
+// job without a DONE record is replayed. When the file outgrows
+// PRINT_JOURNAL_COMPACT_BYTES it is rewritten with only the unfinished jobs
+// (or simply truncated when there are none).
+class PrintJournal {
+private:
+    static const char* TAG;
+    static const int MAX_PENDING = PRINT_JOURNAL_MAX_PENDING;
+
+    struct PendingJob {
+        uint32_t id;
+        uint32_t offset;      // Record position in the file
+        bool inFlight;        // Handed to the queue/spooler since boot
+    };
+
+    bool available;
+    File file;                // Kept open for appending
+    SemaphoreHandle_t lock;
+    PendingJob pending[MAX_PENDING];
+    int pendingCount;
+    uint32_t nextId;
+    uint32_t fileBytes;
+
+    // Flash wear, since boot
+    uint32_t appends;
+    uint32_t bytesWritten;
+    uint32_t payloadBytes;    // Job text journaled, for write amplification
+    uint32_t compactions;
+    uint32_t bytesCompacted;
+    uint32_t replayed;
+
+    // Callers hold the lock (or are in begin())
+    bool scan(uint32_t& validBytes);
+    bool writeRecord(File& out, PrintJournalRecord& record, const uint8_t* payload);
+    bool appendRecord(PrintJournalRecord& record, const uint8_t* payload);
+    bool readRecord(uint32_t offset, PrintJournalRecord& record, String* text);
+    void completeLocked(uint32_t id);
+    bool compact();
+    int findPending(uint32_t id) const;
+    void removePending(int index);
+    static uint32_t recordCrc(PrintJournalRecord record, const uint8_t* payload);
+
+public:
+    PrintJournal();
+    ~PrintJournal();
+
+    // Mount LittleFS and load unfinished jobs from the journal
+    bool begin();
+    bool isAvailable() const { return available; }
+
+    // Persist a job; returns its journal ID, or 0 if it could not be written.
+    // New jobs count as in flight - the caller is about to queue them.
+    uint32_t append(PrintJournalType type, const String& text, bool includeWeatherAndSanitizer,
+                    time_t createdTime = 0);
+
+    // The job printed (or was given up on) - it won't be replayed
+    void complete(uint32_t id);
+
+    // The job left the queue without printing; replay picks it up again
+    void release(uint32_t id);
+
+    // Offer unfinished jobs that aren't in flight, oldest first, until one
+    // is refused. Returns the number accepted.
+    int replay(const PrintJournalReplay& submit);
+
+    int getPendingCount() const;
+    String getStatsJSON() const;
+};
+
+#endif // PRINT_JOURNAL_H
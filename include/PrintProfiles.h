@@ -0,0 +1,40 @@
+#ifndef PRINT_PROFILES_H
+#define PRINT_PROFILES_H
+
+#include <Arduino.h>
+#include "EscPosEncoder.h"
+
+enum PrintProfileId {
+    PRINT_PROFILE_DEFAULT = -1,   // The job takes the printer's default profile
+    PRINT_PROFILE_FAST,
+    PRINT_PROFILE_BALANCED,
+    PRINT_PROFILE_DARK,
+    PRINT_PROFILE_CALIBRATED,     // Balanced with the heating time picked from the calibration strip
+    PRINT_PROFILE_COUNT
+};
+
+// Thermal head settings. Heating time is the main speed/darkness trade-off;
+// heating more dots at once is faster but draws more current from the supply.
+struct PrintProfile {
+    uint8_t heatingDots;      // ESC 7 n1: dots heated at once = (n + 1) x 8
+    uint8_t heatingTime;      // ESC 7 n2: x10us per burn
+    uint8_t heatingInterval;  // ESC 7 n3: x10us between burns
+    uint8_t density;          // DC2 # bits 0-4: 50% + 5% x n
+    uint8_t breakTime;        // DC2 # bits 5-7: x250us
+};
+
+// Named heating profiles (ESC 7 / DC2 #), selectable per print job
+class PrintProfiles {
+public:
+    // Built-in settings; the calibrated profile starts from balanced
+    static const PrintProfile& preset(PrintProfileId id);
+
+    static const char* name(PrintProfileId id);
+    // PRINT_PROFILE_DEFAULT for an empty or unknown name
+    static PrintProfileId parse(const String& name);
+
+    // Append ESC 7 and DC2 # for the profile
+    static void encode(const PrintProfile& profile, EscPosEncoder& out);
+};
+
+#endif // PRINT_PROFILES_H
@@ -0,0 +1,84 @@
+#ifndef PRINT_SPOOLER_H
+#define PRINT_SPOOLER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include "PrinterService.h"
+#include "ImageUploadStream.h"
+#include "PrintJournal.h"
+#include "PrintJob.h"
+#include "PrintCoalescer.h"
+#include "Logger.h"
+#include "config.h"
+
+// Print spooler running on its own FreeRTOS task so producers (web handlers,
+// Firebase commands, reminders) return immediately instead of blocking loop()
+// for the duration of a print.
+class PrintSpooler {
+private:
+    static const char* TAG;
+    static const int MAX_JOBS = PRINT_SPOOLER_QUEUE_SIZE;
+
+    PrinterService* printer;
+    PrintJournal* journal;
+    PrintJob jobs[MAX_JOBS];
+    uint32_t nextJobId;
+    SemaphoreHandle_t lock;
+    TaskHandle_t taskHandle;
+    volatile bool paused;  // Holding queued jobs until the printer is ready
+
+    // Receipt throughput (guarded by lock)
+    uint32_t messagesPrinted;
+    uint32_t batchesPrinted;
+    uint32_t receiptBusyMs;
+
+    static void taskEntry(void* param);
+    void run();
+    bool printJob(const PrintJob& job);
+    bool printReceiptBatch(const PrintJob* batch, int count);
+    bool printImage(ImageUploadStream* image);
+
+    // Slot helpers (caller must hold lock)
+    int findFreeSlot() const;
+    int findNextQueued(uint32_t afterId = 0) const;
+    int findQueued(int* slots, const PrintJob** queue) const;  // All queued, FIFO; returns count
+    int findJob(uint32_t id) const;
+
+    uint32_t submit(PrintJob& job);
+
+public:
+    PrintSpooler(PrinterService* printerService);
+    ~PrintSpooler();
+
+    // Start the spooler task
+    bool begin();
+
+    // Journal text jobs to flash so they survive a reboot (optional)
+    void setJournal(PrintJournal* printJournal) { journal = printJournal; }
+
+    // Producers - return job ID, or 0 if the queue is full. Jobs already
+    // journaled by the caller pass their journal ID; others are journaled here.
+    uint32_t submitReceipt(const String& message, bool includeWeatherAndSanitizer,
+                           const String& weather, time_t createdTime = 0, uint32_t journalId = 0);
+    uint32_t submitGroceryList(const String* items, int itemCount, uint32_t journalId = 0);
+    uint32_t submitTest(PrintProfileId profile = PRINT_PROFILE_DEFAULT);
+    uint32_t submitImage(ImageUploadStream* image, PrintProfileId profile = PRINT_PROFILE_DEFAULT);  // Takes the consumer reference
+    uint32_t submitBaudTest(uint32_t baud, bool save);  // Switch rate, then print the reference receipt
+    uint32_t submitQrCode(const String& data, const String& caption);
+    uint32_t submitBarcode(const String& data);
+    uint32_t submitBenchmark();  // Dry run through the timing model, nothing printed
+    uint32_t submitCalibration();  // Heating test strip, one step per PRINT_CALIBRATION_TIMES
+
+    // Job control
+    bool cancel(uint32_t id);
+    PrintJobStatus getStatus(uint32_t id) const;
+    int getPendingCount() const;
+
+    // Reporting
+    String getJobsJSON() const;
+    static const char* statusToString(PrintJobStatus status);
+};
+
+#endif // PRINT_SPOOLER_H
@@ -0,0 +1,26 @@
+#ifndef PRINTER_PORT_H
+#define PRINTER_PORT_H
+
+#include <Arduino.h>
+
+// What PrinterService and PrinterStatus need from the board: the printer's
+// serial link plus the sensor readings printed on message receipts.
+// HardwareAbstraction implements it over UART2; the native tests (test/)
+// substitute a mock that records the bytes and answers status queries.
+class PrinterPort {
+public:
+    virtual ~PrinterPort() {}
+
+    virtual bool printerWrite(const uint8_t* data, size_t length) = 0;
+    virtual bool printerWaitTxDone(uint32_t timeoutMs) = 0;  // Every queued byte shifted out
+    virtual int printerRead(uint32_t timeoutMs) = 0;          // One byte, -1 on timeout
+    virtual void printerFlushInput() = 0;
+    virtual bool printerAvailable() const = 0;
+    virtual bool setPrinterBaud(uint32_t baud) = 0;
+    virtual uint32_t getPrinterBaud() const = 0;
+
+    virtual float getMoisturePercent() const = 0;
+    virtual float getSanitizerLevel() const = 0;
+};
+
+#endif // PRINTER_PORT_H
@@ -2,16 +2,129 @@
 #define PRINTER_SERVICE_H
 
 #include <Arduino.h>
-#include "HardwareAbstraction.h"
+#include <freertos/FreeRTOS.h>
+#include "PrinterPort.h"
+#include "EscPosEncoder.h"
+#include "CodePageTranscoder.h"
+#include "ReceiptTemplates.h"
+#include "TextLayout.h"
+#include "UserGlyphs.h"
+#include "PrinterStatus.h"
+#include "QrEncoder.h"
+#include "BarcodeEncoder.h"
+#include "EscPosTimingModel.h"
+#include "PrintProfiles.h"
 #include "Logger.h"
+#include <functional>
+
+// Fills one raster row (bytesPerRow bytes, MSB = leftmost dot, 1 = black).
+// Return false to abort the print.
+typedef std::function<bool(uint16_t row, uint8_t* out, uint16_t bytesPerRow)> RasterRowSource;
+
+// One receipt in a coalesced batch
+struct ReceiptContent {
+    const String* message;
+    const String* weather;
+    bool includeWeatherAndSanitizer;
+    time_t createdTime;
+};
 
 class PrinterService {
 private:
     static const char* TAG;
-    HardwareAbstraction* hardware;
+    PrinterPort* hardware;
     String currentWeather;
     
-    // Printer commands
+    // Current job is encoded here and sent with a single UART write
+    EscPosEncoder job;
+    size_t lastJobBytes;
+    unsigned long lastJobDurationMs;
+    uint16_t lastRasterRows;  // Non-zero when the last job was a raster image
+    
+    bool sendJob();
+    
+    // Real-time status and readiness pacing over the RX line
+    PrinterStatus status;
+    volatile bool paused;  // Waiting mid-job for paper / cover
+    bool awaitPrinter(uint8_t maxPending);
+    
+    // Baud rate negotiation; a reference receipt is timed at each rate
+    static const uint8_t MAX_BAUD_RATES = 8;
+    struct BaudMeasurement {
+        uint32_t bytes;
+        uint32_t ms;       // Send + print time, 0 = not measured yet
+    };
+    BaudMeasurement baudResults[MAX_BAUD_RATES];
+    const char* baudSource;      // "default", "nvs", "probe" or "api"
+    uint32_t lastBaudRequest;
+    bool lastBaudVerified;       // Printer answered a status query at the new rate
+    bool lastBaudSaved;
+    uint32_t wireTimeMs(size_t bytes) const;
+    
+    // QR codes and barcodes: GS ( k / GS k when the boot probe found them
+    // (~100 bytes per symbol), otherwise encoded here and sent as raster
+    bool nativeSymbols;
+    const char* symbolSource;    // "probe" or "config"
+    uint32_t qrCodesPrinted;
+    uint32_t barcodesPrinted;
+    size_t lastSymbolBytes;      // Whole job, raster bands included
+    unsigned long lastSymbolMs;
+    bool lastSymbolNative;
+    bool printQrRaster(const String& data);
+    bool printBarcodeRaster(const String& data);
+    bool finishSymbol(const String& caption, unsigned long startTime, size_t rasterBytes, bool native);
+    static uint8_t fitModuleDots(uint16_t modules, uint8_t preferred);
+    
+    // Time spent blocked while printing, since boot
+    uint32_t uartWaitMs;         // UART draining a job or band
+    uint32_t printerWaitMs;      // Waiting for the printer's GS r replies (incl. paper-out pauses)
+    uint32_t delayMs;            // Fixed delay() calls: raster head pacing, baud change settle
+    
+    // Heating profile: picked per job, sent only when it differs from what
+    // the printer last got. ESC @ may restore the factory heating settings,
+    // so sendInitialize() forgets the applied profile.
+    //
+    // The saved default and calibrated time are set from web handlers, so
+    // they live in profileState under profileMux with the spooler's applied
+    // profile republished next to them; everything else is spooler-only.
+    struct ProfileState {
+        PrintProfileId defaultProfile;
+        uint8_t calibratedHeatingTime;   // 0 = not calibrated yet
+        PrintProfileId appliedProfile;   // As last published by the spooler
+        uint32_t profileChanges;
+    };
+    ProfileState profileState;
+    mutable portMUX_TYPE profileMux;
+    PrintProfileId jobProfile;
+    PrintProfileId appliedProfile;   // PRINT_PROFILE_DEFAULT = none sent since the last reset
+    uint8_t appliedHeatingTime;      // Calibrated time sent with appliedProfile (0 = preset)
+    uint32_t profileChanges;
+    void applyPrintProfile();
+    void publishAppliedProfile();
+    ProfileState getProfileState() const;
+    static PrintProfile profileSettings(PrintProfileId id, uint8_t calibratedHeatingTime);
+    
+    // Benchmark: while dryRun is set, jobs go to the timing model instead
+    // of the UART and nothing waits for the printer
+    EscPosTimingModel* dryRun;
+    static const uint8_t BENCHMARK_CASES = 9;
+    struct BenchmarkResult {
+        const char* name;
+        uint32_t encodeUs;       // Layout and encoding on this CPU
+        uint32_t bytes;
+        uint32_t lines;
+        uint32_t paperDots;
+        uint32_t rasterRows;
+        uint32_t headMs;
+        uint32_t cutMs;
+        bool success;
+    };
+    BenchmarkResult benchmarkResults[BENCHMARK_CASES];
+    uint32_t benchmarkRuns;
+    unsigned long benchmarkAt;
+    void runBenchmarkCase(uint8_t index, const char* name, const std::function<bool()>& print);
+    
+    // Printer commands (append to the current job)
     void sendInitialize();
     void sendCenterAlign();
     void sendLeftAlign();
@@ -26,25 +139,126 @@ private:
     void setUnderline(uint8_t mode);
     void setInverse(bool enable);
     
-    // Text sanitization for printer compatibility
-    String sanitizeForPrinter(const String& text);
+    // UTF-8 text output in the printer's code pages
+    CodePageTranscoder transcoder;
+    uint8_t columns;  // Characters per line in the current print mode
+    bool glyphsResident;  // UserGlyphs downloaded since the last ESC @ / failure
+    IconAtlas icons;      // Inline images for emoji without a glyph
+    void sendJobStart();
+    void printTimestamp(const char* label, const struct tm* timeinfo);
+    
+    // Layout helpers write to the job only when emit is set and always
+    // return the number of printed lines, so the same code estimates length.
+    // Estimates (emit off) lay out at PRINTER_COLUMNS and never read columns,
+    // which belongs to the spooler task.
+    // lineColumns: line width to lay out for (columns while printing).
+    // indent: columns already used on the first line and kept on the rest.
+    uint16_t layoutText(const String& text, uint8_t lineColumns, uint8_t indent, bool justify, bool emit);
+    uint16_t layoutItems(const String* items, int itemCount, uint8_t lineColumns, bool emit);
+    
+    // Runtime values for template slots
+    struct ReceiptFields {
+        const String* message;
+        const String* weather;
+        time_t createdTime;
+        const String* items;
+        int itemCount;
+        bool batchStart;   // Emit the printer reset (first receipt of a batch)
+        bool batchEnd;     // Emit the cut (last receipt of a batch)
+        
+        ReceiptFields() : message(nullptr), weather(nullptr), createdTime(0), items(nullptr), itemCount(0),
+                          batchStart(true), batchEnd(true) {}
+    };
+    uint16_t renderTemplate(const ReceiptTemplate& tpl, const ReceiptFields& fields, bool emit = true);
+    uint16_t layoutSlot(TemplateSlot slot, const ReceiptFields& fields, bool emit);
     
 public:
-    PrinterService(HardwareAbstraction* hw);
+    PrinterService(PrinterPort* hw);
     ~PrinterService();
     
     // Main printing functions
     bool printReceipt(const String& message, bool includeWeatherAndSanitizer, time_t createdTime = 0);
+    // Several receipts as one job: one reset, separators between them, one cut
+    bool printReceipts(const ReceiptContent* receipts, int count);
     bool printGroceryList(const String* items, int itemCount);
     bool printBitmap(const uint8_t* bitmap, uint16_t width, uint16_t height);
+    // Commands already in the job (reset, alignment) go out with the first band
+    bool printRaster(uint16_t width, uint16_t height, RasterRowSource source);
+    
+    // Printed line counts without printing (for queue/paper estimates).
+    // Safe from producer tasks: laid out at PRINTER_COLUMNS, never the
+    // print mode the spooler has set for the job in progress.
+    uint16_t estimateReceiptLines(const String& message, bool includeWeatherAndSanitizer,
+                                  const String& weather, time_t createdTime = 0);
+    uint16_t estimateGroceryListLines(const String* items, int itemCount);
     
     // Weather management
     void setWeather(const String& weather) { currentWeather = weather; }
     String getWeather() const { return currentWeather; }
     
+    // Forces the user glyphs to be downloaded again with the next receipt
+    // (call when the printer may have been reset or power cycled)
+    void invalidateUserGlyphs() { glyphsResident = false; }
+    bool areUserGlyphsResident() const { return glyphsResident; }
+    
     // Test functions
     bool printTest();
     bool isReady() const;
+    
+    // Printer status (spooler task only). refreshStatus polls the printer
+    // and returns false while it reports paper out, cover open or an error.
+    bool refreshStatus();
+    const PrinterStatus& getPrinterStatus() const { return status; }
+    bool isPaused() const { return paused; }
+    
+    // Baud rate. detectBaudRate probes PRINTER_BAUD_RATES with status
+    // queries at boot; changeBaudRate tells the printer, switches UART2 and
+    // reverts if the printer stops answering (probing again if the old rate
+    // is silent too). Verified rates go to NVS.
+    bool detectBaudRate();
+    bool changeBaudRate(uint32_t baud, bool saveUnverified);
+    bool printBaudTest();
+    uint32_t getBaudRate() const;
+    static bool isSupportedBaud(uint32_t baud);
+    String getBaudJSON() const;
+    
+    // QR codes (data up to maxQrLength() bytes, optional caption below)
+    // and CODE128 barcodes (printable ASCII up to BARCODE_MAX_LENGTH).
+    // detectSymbolSupport asks the printer once at boot, before the spooler
+    // starts; the result holds until reboot.
+    bool detectSymbolSupport();
+    bool printQrCode(const String& data, const String& caption = "");
+    bool printBarcode(const String& data);
+    bool hasNativeSymbols() const { return nativeSymbols; }
+    static size_t maxQrLength() { return QrEncoder::maxLength(QR_ERROR_CORRECTION); }
+    
+    // Heating profiles. setJobProfile picks the profile for the following
+    // jobs (PRINT_PROFILE_DEFAULT = the saved default). The calibration strip
+    // prints one sample per PRINT_CALIBRATION_TIMES step; selecting a step
+    // saves it as the calibrated profile and makes that the default.
+    // setDefaultProfile, selectCalibrationStep, getDefaultProfile and
+    // getProfileJSON are safe from any task; the spooler picks the change
+    // up with its next job.
+    void setJobProfile(PrintProfileId id) { jobProfile = id; }
+    bool setDefaultProfile(PrintProfileId id);
+    PrintProfileId getDefaultProfile() const { return getProfileState().defaultProfile; }
+    bool printCalibrationStrip();
+    bool selectCalibrationStep(uint8_t step);
+    static uint8_t getCalibrationStepCount();
+    String getProfileJSON() const;
+    
+    // Print receipts, grocery lists and raster images of small, medium and
+    // worst-case size into the ESC/POS timing model (no paper used) and
+    // keep the bytes, paper and modeled time per case. Spooler task only.
+    bool runBenchmark();
+    String getBenchmarkJSON() const;
+    
+    // Last job metrics
+    size_t getLastJobBytes() const { return lastJobBytes; }
+    unsigned long getLastJobDurationMs() const { return lastJobDurationMs; }
+    uint32_t getRasterBytesPerSecond() const;
+    uint32_t getRasterMsPer100Rows() const;
+    String getStatsJSON() const;
 };
 
 #endif // PRINTER_SERVICE_H
@@ -0,0 +1,107 @@
+#ifndef PRINTER_STATUS_H
+#define PRINTER_STATUS_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "PrinterPort.h"
+#include "EscPosEncoder.h"
+#include "Logger.h"
+#include "config.h"
+
+enum PrinterState {
+    PRINTER_STATE_UNKNOWN,      // Never answered a status query (RX not wired or unsupported)
+    PRINTER_STATE_READY,
+    PRINTER_STATE_PAPER_OUT,
+    PRINTER_STATE_COVER_OPEN,
+    PRINTER_STATE_ERROR,        // Cutter or mechanical error reported
+    PRINTER_STATE_OFFLINE       // Answered before, silent now
+};
+
+// Status as of the last poll, for tasks other than the spooler
+struct PrinterStatusSnapshot {
+    PrinterState state;
+    bool canPrint;
+    bool responding;
+    bool syncEnabled;
+    bool paperNearEnd;
+    unsigned long lastPollAt;
+    uint32_t polls;
+    uint32_t timeouts;
+};
+
+// Printer status over the UART2 RX line.
+//
+// DLE EOT n is a real-time command: the printer answers immediately, even
+// while its buffer is full or it is stopped for paper, so it is used for
+// paper-out / cover-open / error. GS r 1 is queued like print data and only
+// answered once everything sent before it has been processed, so a reply
+// means the printer has actually caught up - that is what jobs pace on.
+// The two replies are told apart by bit 4 (always 1 for DLE EOT, 0 for GS r).
+//
+// Printers that never answer stay UNKNOWN and are treated as ready, so
+// pacing falls back to UART drain times.
+//
+// Queries and the accessors below belong to the spooler task, which owns
+// the UART. Other tasks (health monitor, web handlers) read getSnapshot(),
+// republished under a spinlock whenever the spooler's view changes.
+class PrinterStatus {
+private:
+    static const char* TAG;
+    PrinterPort* hardware;
+
+    bool responding;       // Last DLE EOT query was answered
+    bool everResponded;
+    bool syncSupported;    // GS r replies arrive; cleared if they never do
+    bool paperOut;
+    bool paperNearEnd;
+    bool coverOpen;
+    bool error;
+    uint8_t pendingSyncs;  // GS r requests sent and not answered yet
+    unsigned long lastPollAt;
+    uint32_t polls;
+    uint32_t timeouts;
+
+    PrinterStatusSnapshot published;
+    mutable portMUX_TYPE snapshotMux;
+
+    int query(uint8_t n);              // DLE EOT n; the reply, or -1
+    void handleSyncReply(uint8_t reply);
+    static bool isRealtimeReply(uint8_t reply) { return (reply & 0x93) == 0x12; }
+    void publish();
+
+public:
+    PrinterStatus(PrinterPort* hw);
+
+    // Query printer, offline cause, error and paper sensor status.
+    // Returns true if the printer answered.
+    bool poll();
+
+    // Readiness pacing: appendSync adds GS r 1 to a job about to be written;
+    // awaitSyncs blocks until at most maxPending of them are unanswered and
+    // returns false on timeout (still printing, stopped, or unsupported)
+    void appendSync(EscPosEncoder& job);
+    bool awaitSyncs(uint8_t maxPending, uint32_t timeoutMs);
+    void abandonSyncs();               // Forget outstanding requests
+    void disableSync();                // Printer answers DLE EOT but not GS r
+
+    bool isResponding() const { return responding; }
+    bool isSyncEnabled() const { return responding && syncSupported; }
+    bool isPaperOut() const { return paperOut; }
+    bool isPaperNearEnd() const { return paperNearEnd; }
+    bool isCoverOpen() const { return coverOpen; }
+    bool hasError() const { return error; }
+
+    // False only when the printer reported a condition that stops printing
+    bool canPrint() const;
+    PrinterState getState() const;
+    static const char* stateToString(PrinterState state);
+
+    unsigned long getLastPollAt() const { return lastPollAt; }
+    uint32_t getPollCount() const { return polls; }
+    uint32_t getTimeoutCount() const { return timeouts; }
+
+    // Safe from any task
+    PrinterStatusSnapshot getSnapshot() const;
+};
+
+#endif // PRINTER_STATUS_H
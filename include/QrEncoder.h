@@ -0,0 +1,72 @@
+#ifndef QR_ENCODER_H
+#define QR_ENCODER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+enum QrErrorCorrection {
+    QR_ECC_LOW,        // ~7% of codewords recoverable
+    QR_ECC_MEDIUM,     // ~15%
+    QR_ECC_QUARTILE,   // ~25%
+    QR_ECC_HIGH        // ~30%
+};
+
+// Software QR Code (model 2) encoder for printers without GS ( k.
+//
+// Byte mode only, versions 1 to QR_MAX_VERSION. The symbol is kept as a
+// packed module bitmap (1 bit per module, 407 bytes at version 10) so it
+// can be streamed to printRaster() row by row at any module size instead
+// of being rendered into a full-page bitmap. About 1.5KB in all at version
+// 10 - allocate it for the print and free it afterwards.
+class QrEncoder {
+public:
+    static const uint8_t MAX_SIZE = QR_MAX_VERSION * 4 + 17;
+
+private:
+    static const uint16_t MAX_MODULE_BYTES = ((uint16_t)MAX_SIZE * MAX_SIZE + 7) / 8;
+    static const uint16_t MAX_CODEWORDS = ((16 * QR_MAX_VERSION + 128) * QR_MAX_VERSION + 64) / 8;
+
+    uint8_t version;           // 0 = nothing encoded
+    uint8_t size;              // Modules per side
+    uint8_t modules[MAX_MODULE_BYTES];   // 1 = dark
+    uint8_t function[MAX_MODULE_BYTES];  // 1 = finder/timing/format module, not data
+    uint8_t codewords[MAX_CODEWORDS];    // Data codewords
+    uint8_t interleaved[MAX_CODEWORDS];  // Data + ECC in placement order
+
+    void setModule(uint8_t x, uint8_t y, bool dark);
+    void setFunction(uint8_t x, uint8_t y, bool dark);
+    bool isFunction(uint8_t x, uint8_t y) const;
+
+    void drawFunctionPatterns(QrErrorCorrection ecc);
+    void drawFinder(int x, int y);
+    void drawAlignment(int x, int y);
+    void drawFormatBits(QrErrorCorrection ecc, uint8_t mask);
+    void drawVersion();
+    void drawCodewords(const uint8_t* data, uint16_t count);
+    void applyMask(uint8_t mask);
+    long penaltyScore() const;
+
+    // Split the data codewords into blocks, add Reed-Solomon ECC to each and
+    // interleave them in the order they are placed in the symbol
+    static void addEccAndInterleave(const uint8_t* data, uint8_t ver, QrErrorCorrection ecc, uint8_t* out);
+    static uint16_t rawDataModules(uint8_t ver);
+    static uint8_t alignmentPositions(uint8_t ver, uint8_t* positions);
+
+public:
+    QrEncoder();
+
+    // Encode data at the smallest version that fits. Returns false (and
+    // keeps nothing) if it needs more than QR_MAX_VERSION.
+    bool encode(const uint8_t* data, size_t length, QrErrorCorrection ecc);
+
+    uint8_t getVersion() const { return version; }
+    uint8_t getSize() const { return size; }
+    bool getModule(uint8_t x, uint8_t y) const;
+
+    // Smallest version holding length bytes, or 0 if none up to QR_MAX_VERSION
+    static uint8_t versionFor(size_t length, QrErrorCorrection ecc);
+    static uint16_t dataCodewords(uint8_t ver, QrErrorCorrection ecc);
+    static size_t maxLength(QrErrorCorrection ecc);
+};
+
+#endif // QR_ENCODER_H
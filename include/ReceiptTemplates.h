@@ -0,0 +1,54 @@
+#ifndef RECEIPT_TEMPLATES_H
+#define RECEIPT_TEMPLATES_H
+
+#include <Arduino.h>
+
+// Receipt layouts as static ESC/POS byte programs. Each template is a list
+// of segments: literal bytes (built by string-literal concatenation at
+// compile time and stored in flash) or a slot the printer service fills
+// with runtime text. Rendering is a memcpy per literal segment.
+
+// Runtime fields a template can reference
+enum TemplateSlot {
+    SLOT_NONE,
+    SLOT_INIT,          // Printer reset; downloads user glyphs when needed
+    SLOT_DATE,          // "Date: <now>" and a blank line
+    SLOT_CREATED,       // "Set on: <created>" and a blank line, if known
+    SLOT_MESSAGE,       // Message body, transcoded
+    SLOT_WEATHER,       // Weather snapshot, transcoded
+    SLOT_SENSORS,       // Moisture / sanitizer line
+    SLOT_ITEMS,         // Numbered grocery items, transcoded
+    SLOT_CUT            // Paper cut, or a separator inside a coalesced batch
+};
+
+struct TemplateSegment {
+    const char* bytes;  // Literal bytes, or nullptr for a slot
+    uint16_t length;
+    TemplateSlot slot;
+};
+
+struct ReceiptTemplate {
+    const TemplateSegment* segments;
+    uint8_t count;
+    uint16_t literalBytes;  // Sum of literal lengths, used to pre-size the job
+    uint8_t literalLines;   // Line feeds in the literals, for print length estimates
+};
+
+// ESC/POS commands as string literals. Command letters are separate
+// literals so a following hex digit can't extend the \x escape.
+#define TPL_ALIGN_LEFT      "\x1b" "a" "\x00"
+#define TPL_ALIGN_CENTER    "\x1b" "a" "\x01"
+#define TPL_BOLD_ON         "\x1b" "E" "\x01"
+#define TPL_BOLD_OFF        "\x1b" "E" "\x00"
+#define TPL_NL              "\r\n"
+#define TPL_RULE            "================================" TPL_NL
+#define TPL_DIVIDER         "--------------------------------" TPL_NL
+
+#define TPL_LITERAL(s)      { s, (uint16_t)(sizeof(s) - 1), SLOT_NONE }
+#define TPL_SLOT(id)        { nullptr, 0, id }
+
+extern const ReceiptTemplate MESSAGE_RECEIPT_TEMPLATE;
+extern const ReceiptTemplate REMINDER_RECEIPT_TEMPLATE;
+extern const ReceiptTemplate GROCERY_LIST_TEMPLATE;
+
+#endif // RECEIPT_TEMPLATES_H
@@ -22,8 +22,9 @@ struct QueuedRequest {
     unsigned long timestamp;
     int retryCount;
     bool processed;
+    uint32_t journalId;  // PrintJournal entry for REQUEST_PRINT, 0 if not journaled
     
-    QueuedRequest() : type(REQUEST_FIREBASE_GET), timestamp(0), retryCount(0), processed(false) {}
+    QueuedRequest() : type(REQUEST_FIREBASE_GET), timestamp(0), retryCount(0), processed(false), journalId(0) {}
 };
 
 class RequestQueue {
@@ -44,8 +45,9 @@ public:
     ~RequestQueue();
     
     // Queue management
-    bool enqueue(RequestType type, const String& path = "", const String& data = "");
+    bool enqueue(RequestType type, const String& path = "", const String& data = "", uint32_t journalId = 0);
     bool dequeue(QueuedRequest& request);
+    bool peek(QueuedRequest& request) const;  // Copy of the head without removing it
     bool isEmpty() const { return queueSize == 0; }
     bool isFull() const { return queueSize >= MAX_QUEUE_SIZE; }
     int getSize() const { return queueSize; }
@@ -0,0 +1,77 @@
+#ifndef SANITIZER_MODEL_H
+#define SANITIZER_MODEL_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "Logger.h"
+#include "config.h"
+
+// Sanitizer left in the reservoir, from pump on-time x calibrated flow rate.
+//
+// Every dispense adds to the volume used since the last refill. The total
+// is saved to NVS as a small record in a ring of SANITIZER_RING_SLOTS keys
+// written round-robin, and only once SANITIZER_PERSIST_ML more has been
+// used - not once per dispense. At boot the newest record with a valid
+// checksum wins, so a power cut mid-write falls back to the one before.
+class SanitizerModel {
+private:
+    static const char* TAG;
+
+    struct LevelRecord {
+        uint32_t sequence;     // Highest = newest
+        float usedMl;          // Since the last refill
+        uint32_t dispenses;    // Since the last refill
+        uint32_t crc;
+    };
+
+    // Guards usedMl and dispenses. recordDispense() runs on the esp_timer
+    // task, so nothing may hold this longer than a few loads and stores.
+    mutable portMUX_TYPE levelMux;
+    float reservoirMl;
+    float flowMlPerS;
+    bool flowCalibrated;
+
+    float usedMl;
+    uint32_t dispenses;
+    float persistedUsedMl;     // usedMl in the newest record
+    uint32_t sequence;         // Of the newest record
+    uint8_t nextSlot;
+    uint32_t recordWrites;     // Since boot
+
+    void readLevel(float& used, uint32_t& count) const;
+    float remainingMl(float used) const;
+    float mlPerDispense(float used, uint32_t count, uint32_t doseMs) const;
+    bool writeRecord(float used, uint32_t count);
+    static uint32_t recordCrc(const LevelRecord& record);
+
+public:
+    SanitizerModel();
+
+    // Load the settings and the newest level record
+    bool begin();
+
+    // Pump ran for onUs; RAM only under a spinlock, safe from any task
+    // including the esp_timer task
+    void recordDispense(uint32_t onUs);
+
+    // Save the running total if SANITIZER_PERSIST_ML more has been used
+    // (or always with force). Call from loop() - it writes flash.
+    bool persist(bool force = false);
+
+    void refill();                               // Reservoir full again
+    void setPercent(float percent);              // Manual correction
+    bool setReservoirMl(float ml);
+    bool setFlowMlPerS(float mlPerS);
+    bool calibrateFlow(float measuredMl, uint32_t onUs);  // Measured output of one timed dose
+
+    float getReservoirMl() const { return reservoirMl; }
+    float getFlowMlPerS() const { return flowMlPerS; }
+    float getRemainingMl() const;
+    float getPercent() const;
+    float getMlPerDispense(uint32_t doseMs) const;   // Average so far, else the dose at the flow rate
+    uint32_t getDispensesLeft(uint32_t doseMs) const;
+
+    String getStatusJSON(uint32_t doseMs) const;
+};
+
+#endif // SANITIZER_MODEL_H
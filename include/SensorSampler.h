@@ -0,0 +1,76 @@
+#ifndef SENSOR_SAMPLER_H
+#define SENSOR_SAMPLER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "Logger.h"
+#include "config.h"
+
+enum SensorChannel {
+    SENSOR_MOISTURE,
+    SENSOR_LIGHT,
+    SENSOR_CHANNEL_COUNT
+};
+
+// Background sampling of the analog sensors.
+//
+// A task wakes at the sample rate and takes SENSOR_OVERSAMPLE readings of
+// each pin back to back. Their mean goes into a median over the last
+// SENSOR_MEDIAN_WINDOW updates (drops single spikes), and the median into
+// an EMA (smooths the rest). Readers get the latest published value from
+// memory - no ADC conversion on the caller's time. The time the task
+// spends converting is measured and reported as CPU load.
+class SensorSampler {
+private:
+    static const char* TAG;
+
+    struct Channel {
+        uint8_t pin;
+        uint16_t window[SENSOR_MEDIAN_WINDOW];  // Oversampled means, ring
+        float ema;
+        uint16_t lastMean;     // Newest oversampled mean, unfiltered
+        uint16_t lastMin;      // Spread of the newest oversample burst
+        uint16_t lastMax;
+    };
+
+    Channel channels[SENSOR_CHANNEL_COUNT];
+    uint8_t windowPos;
+    bool primed;
+
+    TaskHandle_t taskHandle;
+    mutable portMUX_TYPE dataMux;  // Guards the published values and the CPU figures
+    volatile uint16_t rateHz;
+
+    // CPU cost, over the last completed one-second window
+    uint32_t updates;
+    uint32_t lastUpdateUs;
+    uint32_t maxUpdateUs;
+    uint32_t windowBusyUs;
+    unsigned long windowStartUs;
+    float cpuPercent;
+
+    static void taskEntry(void* param);
+    void run();
+    void sample();
+    static uint16_t median(const uint16_t* values);
+
+public:
+    SensorSampler();
+    ~SensorSampler();
+
+    // Prime the filters with one synchronous update, then start the task
+    bool begin();
+
+    bool setRateHz(uint16_t hz);       // Saved in NVS
+    uint16_t getRateHz() const { return rateHz; }
+
+    float getFiltered(SensorChannel channel) const;   // 0-4095, filtered
+    uint16_t getRaw(SensorChannel channel) const;     // Newest oversampled mean
+    float getCpuPercent() const;
+
+    String getStatusJSON() const;
+    static const char* channelToString(SensorChannel channel);
+};
+
+#endif // SENSOR_SAMPLER_H
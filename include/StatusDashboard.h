@@ -0,0 +1,146 @@
+#ifndef STATUS_DASHBOARD_H
+#define STATUS_DASHBOARD_H
+
+#include <Arduino.h>
+#include <time.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include "HardwareAbstraction.h"
+#include "TftDmaWriter.h"
+#include "Logger.h"
+#include "config.h"
+
+// Values shown on the dashboard, gathered by main each update
+struct DashboardData {
+    float sanitizerPercent;
+    uint32_t sanitizerMl;
+    uint32_t dispensesLeft;
+    float moisturePercent;
+    float lightPercent;
+    String weather;            // "72.5°F, clear sky"
+    time_t nextReminderTime;   // 0 = none
+    String nextReminder;
+    int printQueueDepth;
+    bool wifiConnected;
+    int wifiRssi;
+    String ip;
+};
+
+enum DashboardWidget {
+    WIDGET_SANITIZER,
+    WIDGET_MOISTURE,
+    WIDGET_WEATHER,
+    WIDGET_REMINDER,
+    WIDGET_PRINT_QUEUE,
+    WIDGET_WIFI,
+    WIDGET_COUNT
+};
+
+// Live status screen on the TFT.
+//
+// Six fixed widgets in a 2x3 grid. The frame (background, labels, grid
+// lines) is drawn once; after that each update formats every widget's
+// text and redraws only the widgets whose text or colour changed. A
+// redraw writes the widget's text lines straight to their screen region,
+// background included, so there is no frame buffer and no
+// clear-then-draw flicker.
+//
+// update() only formats text and wakes a display task, which does the
+// SPI work; the loop and web server never wait for the panel. Widget
+// lines go out either by CPU writes (TFT_eSPI) or, with
+// DISPLAY_DMA_ENABLED, rendered into a 1-bit sprite and streamed by
+// TftDmaWriter. Push time is tracked per path so the two can be compared
+// at runtime.
+class StatusDashboard {
+private:
+    static const char* TAG;
+
+    struct Widget {
+        const char* label;
+        int16_t x;
+        int16_t y;
+        String value;
+        String detail;
+        uint16_t color;
+        bool dirty;
+    };
+
+    struct PathStats {
+        uint32_t updates;
+        uint32_t lastUs;
+        uint32_t maxUs;
+        uint64_t totalUs;
+        uint64_t totalBytes;
+    };
+
+    HardwareAbstraction* hardware;
+    TFT_eSPI* tft;
+    TftDmaWriter* dma;             // nullptr = CPU path only
+    TFT_eSprite* lineSprite;       // 1-bit text line for the DMA path
+    bool useDma;
+    TaskHandle_t taskHandle;
+    SemaphoreHandle_t stateLock;   // Widgets, flags and counters (loop vs display task)
+    uint32_t heapCost;             // Task, sprite and DMA, measured at begin()
+
+    Widget widgets[WIDGET_COUNT];
+    bool frameDrawn;
+    unsigned long pausedAt;
+    uint32_t pauseMs;
+
+    // Counters
+    uint32_t updates;              // Redraws done by the task
+    uint32_t skipped;              // update() calls with nothing changed
+    uint32_t widgetRedraws;
+    uint32_t fullRedraws;
+    uint32_t lastFrameUs;
+    uint32_t maxFrameUs;
+    uint32_t lastBytes;
+    uint64_t totalBytes;
+    uint8_t lastWidgets;
+    bool lastDma;
+    uint32_t loopUs;               // Time update() took on the caller
+    uint32_t maxLoopUs;
+    PathStats cpuStats;            // Widget pushes only; the frame is always CPU
+    PathStats dmaStats;
+
+    static void taskEntry(void* param);
+    void render();
+    void setWidget(DashboardWidget id, const String& value, const String& detail, uint16_t color);
+    bool pausedLocked() const;
+    uint32_t drawFrame();
+    uint32_t drawWidget(const Widget& widget, bool viaDma);
+    uint32_t drawText(const String& text, int16_t x, int16_t y, uint8_t font, uint16_t color, bool viaDma);
+    String fitText(const String& text, uint8_t font) const;
+    static void addPathStats(JsonObject out, const PathStats& stats);
+
+public:
+    StatusDashboard(HardwareAbstraction* hw);
+    ~StatusDashboard();
+
+    // Set up the DMA path (if enabled) and start the display task, which
+    // draws the frame; widgets fill in on the first update()
+    bool begin();
+
+    // Format the widgets and hand any changes to the display task
+    void update(const DashboardData& data);
+
+    // Redraw everything on the next update (something else drew on the screen)
+    void invalidate();
+
+    // Leave the screen alone for ms (display tests), then redraw everything
+    void pause(uint32_t ms);
+    bool isPaused() const;
+
+    // Switch widget pushes between DMA and CPU writes; redraws all widgets.
+    // False if DMA was asked for and isn't available.
+    bool setDmaEnabled(bool enabled);
+    bool isDmaEnabled() const { return useDma; }
+    bool dmaAvailable() const { return dma != nullptr; }
+
+    String getStatusJSON() const;
+    static const char* widgetToString(DashboardWidget widget);
+};
+
+#endif // STATUS_DASHBOARD_H
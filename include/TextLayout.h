@@ -0,0 +1,41 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <Arduino.h>
+#include <functional>
+
+// Receives one laid-out line: a slice of the source UTF-8 text, its width in
+// printer columns, and whether it ends a paragraph (explicit newline or end
+// of text). Justification is only applied to lines that don't.
+typedef std::function<void(const char* text, size_t length, uint8_t width, bool paragraphEnd)> LayoutLineSink;
+
+// Column-aware word wrapping for the printer's fixed-pitch fonts. Widths are
+// measured in printed columns after transcoding (accents are one column,
+// emoji replacements several), so lines never hit the printer's hard wrap.
+class TextLayout {
+public:
+    // Columns available for an ESC ! print mode (double width halves them)
+    static uint8_t columnsForMode(uint8_t printMode);
+
+    // Printed width of a UTF-8 string
+    static uint16_t measure(const char* text, size_t length);
+    static uint16_t measure(const String& text) { return measure(text.c_str(), text.length()); }
+
+    // Word-wrap in a single pass; words longer than a line are broken.
+    // sink may be empty to only count. Returns the number of lines.
+    static uint16_t wrap(const char* text, size_t length, uint8_t columns, const LayoutLineSink& sink);
+    static uint16_t wrap(const String& text, uint8_t columns, const LayoutLineSink& sink) {
+        return wrap(text.c_str(), text.length(), columns, sink);
+    }
+    static uint16_t countLines(const String& text, uint8_t columns) {
+        return wrap(text, columns, LayoutLineSink());
+    }
+
+    // Widen the gaps between words so the line fills `columns`. Writes a
+    // NUL-terminated copy into out; returns false if it doesn't fit, the
+    // line has no gaps, or it is too short to stretch.
+    static bool justify(const char* text, size_t length, uint8_t width, uint8_t columns,
+                        char* out, size_t outSize);
+};
+
+#endif // TEXT_LAYOUT_H
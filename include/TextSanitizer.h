@@ -0,0 +1,34 @@
+#ifndef TEXT_SANITIZER_H
+#define TEXT_SANITIZER_H
+
+#include <Arduino.h>
+
+#define UTF8_INVALID 0xFFFFFFFF
+
+struct EmojiReplacement {
+    uint32_t codepoint;
+    const char* text;
+};
+
+// Single-pass UTF-8 -> printable ASCII sanitizer for the thermal printer.
+// Known emoji are replaced from a flash-resident table sorted by codepoint
+// (binary search); every other non-ASCII character is dropped.
+class TextSanitizer {
+public:
+    // Decode one UTF-8 sequence. Returns UTF8_INVALID for malformed input.
+    // consumed is always set to at least 1 so callers make progress.
+    static uint32_t decodeUtf8(const uint8_t* text, size_t length, size_t* consumed);
+    
+    // Replacement text for a codepoint, or nullptr if it has none
+    static const char* lookupReplacement(uint32_t codepoint);
+    
+    // Sanitize into a caller-supplied buffer (snprintf style, no terminator).
+    // Returns the number of bytes the full result needs; at most outSize
+    // bytes are written. Pass out = nullptr to only measure.
+    static size_t sanitize(const char* text, size_t length, char* out, size_t outSize);
+    
+    // Convenience wrapper - measures once, then fills a pre-sized String
+    static String sanitize(const String& text);
+};
+
+#endif // TEXT_SANITIZER_H
@@ -0,0 +1,50 @@
+#ifndef TFT_DMA_WRITER_H
+#define TFT_DMA_WRITER_H
+
+#include <Arduino.h>
+#include <driver/spi_master.h>
+#include "HardwareAbstraction.h"
+#include "Logger.h"
+#include "config.h"
+
+// DMA pixel pushes for the ILI9486.
+//
+// TFT_eSPI has no DMA for this panel: over SPI it takes 18-bit colour,
+// which TFT_eSPI sends a byte at a time from the CPU. This adds an ESP-IDF
+// SPI device on the bus TFT_eSPI already drives and streams pixel data
+// through two small DMA-capable buffers: the CPU expands the next chunk
+// into one buffer while the other is being transferred. TFT_eSPI still
+// selects the panel and sends the address window; only the pixel data
+// goes by DMA.
+class TftDmaWriter {
+private:
+    static const char* TAG;
+    static const uint8_t BYTES_PER_PIXEL = 3;   // RGB666, one byte per channel
+
+    TFT_eSPI* tft;
+    spi_device_handle_t device;
+    bool busInitialized;
+    uint8_t* buffers[2];
+    spi_transaction_t transactions[2];
+    size_t bufferBytes;
+    uint32_t heapCost;          // Measured at begin()
+
+public:
+    TftDmaWriter(TFT_eSPI* display);
+    ~TftDmaWriter();
+
+    // Allocate the buffers and attach to the SPI bus
+    bool begin();
+    bool isReady() const { return device != nullptr; }
+
+    // Push a 1-bit bitmap (MSB first, strideBytes per row) into the
+    // window at x,y as fg/bg pixels. Call between tft->startWrite() and
+    // endWrite(), like TFT_eSPI's pushPixelsDMA. Returns the bytes sent.
+    uint32_t pushMono(int16_t x, int16_t y, int16_t w, int16_t h,
+                      const uint8_t* bits, uint16_t strideBytes, uint16_t fg, uint16_t bg);
+
+    uint32_t getHeapCost() const { return heapCost; }
+    size_t getBufferBytes() const { return bufferBytes; }
+};
+
+#endif // TFT_DMA_WRITER_H
@@ -0,0 +1,155 @@
+#ifndef TOUCH_CONTROLLER_H
+#define TOUCH_CONTROLLER_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include "Logger.h"
+#include "config.h"
+
+class TFT_eSPI;  // Configured and included by HardwareAbstraction.h
+
+enum TouchEventType {
+    TOUCH_DOWN,
+    TOUCH_MOVE,
+    TOUCH_UP,
+    TOUCH_CALIBRATION_DONE    // Calibration finished, failed or timed out; no position
+};
+
+struct TouchEvent {
+    TouchEventType type;
+    int16_t x;                // Screen pixels
+    int16_t y;
+    uint16_t z;               // Pressure
+    uint32_t sequence;        // Increases by one per event
+    unsigned long timeMs;
+};
+
+// XPT2046 resistive touch controller on the display's SPI bus.
+//
+// The controller's PENIRQ output interrupts on a press and wakes a touch
+// task; nothing polls the pin. While the panel is pressed the task reads
+// it every TOUCH_SAMPLE_MS: a burst of TOUCH_BURST_SAMPLES conversions per
+// axis, median-filtered, mapped to screen pixels by a 3-point affine
+// calibration kept in NVS. Down / move / up events go to a queue.
+//
+// Each burst holds the bus lock shared with display drawing, so a reading
+// never lands in the middle of a display transfer. If the display holds
+// the bus longer than TOUCH_BUS_WAIT_MS the reading is skipped and retried
+// on the next sample.
+class TouchController {
+public:
+    enum CalibrationState {
+        CALIBRATION_NONE,         // Default mapping, never calibrated
+        CALIBRATION_RUNNING,
+        CALIBRATION_SAVED,
+        CALIBRATION_FAILED,       // Points too close together; old matrix kept
+        CALIBRATION_TIMED_OUT
+    };
+
+private:
+    static const char* TAG;
+    static const uint8_t CALIBRATION_POINTS = 3;
+
+    // screenX = a*rawX + b*rawY + c, screenY = d*rawX + e*rawY + f
+    struct CalibrationRecord {
+        float a, b, c, d, e, f;
+        uint32_t crc;
+    };
+
+    struct Reading {
+        uint16_t rawX;
+        uint16_t rawY;
+        uint16_t z;
+    };
+
+    enum ReadResult {
+        READ_OK,
+        READ_RELEASED,
+        READ_BUS_BUSY
+    };
+
+    SPIClass* spi;
+    TFT_eSPI* tft;                 // Calibration targets; nullptr = no display
+    SemaphoreHandle_t busLock;     // The HAL's display lock
+    TaskHandle_t taskHandle;
+    QueueHandle_t events;
+    SemaphoreHandle_t lock;        // Matrix, history and counters
+    int16_t screenW;
+    int16_t screenH;
+    volatile bool armed;           // PENIRQ edges count only between presses
+
+    CalibrationRecord matrix;
+    CalibrationState calibration;
+    uint8_t calibrationStep;
+    unsigned long calibrationStartedAt;
+    volatile bool targetPending;   // First target still to be drawn by the task
+    int16_t targetX[CALIBRATION_POINTS];
+    int16_t targetY[CALIBRATION_POINTS];
+    uint16_t sampledX[CALIBRATION_POINTS];
+    uint16_t sampledY[CALIBRATION_POINTS];
+
+    // Latest reading
+    bool pressed;
+    int16_t lastX;
+    int16_t lastY;
+    Reading lastRaw;
+
+    TouchEvent history[TOUCH_HISTORY_LENGTH];
+    uint8_t historyCount;
+    uint8_t historyNext;
+    uint32_t sequence;
+
+    // Counters
+    uint32_t presses;
+    uint32_t readings;
+    uint32_t busSkips;             // Display held the bus past TOUCH_BUS_WAIT_MS
+    uint32_t dropped;              // Queue full
+    uint32_t lastBurstUs;
+    uint32_t maxBurstUs;
+
+    static void IRAM_ATTR handleIrq(void* param);
+    static void taskEntry(void* param);
+    void run();
+    void trackPress();
+    ReadResult sample(Reading& reading);
+    uint16_t readChannel(uint8_t command);
+    void toScreen(const Reading& reading, int16_t& x, int16_t& y) const;
+    void publish(TouchEventType type, int16_t x, int16_t y, uint16_t z);
+    void calibrationPoint(const Reading& reading);
+    void finishCalibration(CalibrationState result);
+    void drawTarget(uint8_t step);
+    void loadCalibration();
+    bool saveCalibration();
+    static uint32_t recordCrc(const CalibrationRecord& record);
+
+public:
+    TouchController();
+    ~TouchController();
+
+    // Attach PENIRQ and start the touch task. busLock is held around every
+    // reading; display is used for the bus and calibration targets.
+    bool begin(TFT_eSPI* display, SemaphoreHandle_t displayBusLock);
+    bool isRunning() const { return taskHandle != nullptr; }
+
+    // Next event, waiting up to wait ticks
+    bool receiveEvent(TouchEvent& event, TickType_t wait = 0);
+
+    bool isPressed() const { return pressed; }
+    bool getLastPoint(int16_t* x, int16_t* y) const;
+
+    // Draw three targets in turn; each press records one point. The
+    // caller keeps other drawing off the screen until TOUCH_CALIBRATION_DONE.
+    bool startCalibration();
+    bool isCalibrating() const { return calibration == CALIBRATION_RUNNING; }
+
+    // Status plus the recent events with a sequence number above since
+    String getStatusJSON(uint32_t since = 0) const;
+    static const char* eventTypeToString(TouchEventType type);
+    static const char* calibrationToString(CalibrationState state);
+};
+
+#endif // TOUCH_CONTROLLER_H
@@ -0,0 +1,90 @@
+#ifndef TOUCHLESS_DISPENSER_H
+#define TOUCHLESS_DISPENSER_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include "HardwareAbstraction.h"
+#include "Logger.h"
+#include "config.h"
+
+enum DispenserState {
+    DISPENSER_IDLE,        // Waiting for a hand
+    DISPENSER_DISPENSING,  // One dose running (the HAL's dose timer ends it)
+    DISPENSER_WAIT_CLEAR   // Dispensed (or refused); re-arms once the hand is gone
+};
+
+// Dispenses sanitizer when a hand is held under the IR sensor.
+//
+// The sensor pin interrupts on every edge and (re)starts a one-shot
+// esp_timer, so the input is sampled only once it has been stable for
+// IR_DEBOUNCE_MS. Debounced changes go through a queue to a dispenser task
+// that runs above loop() - a Firebase request or web page in progress
+// can't delay the pump. Latency from the first edge to the pump GPIO is
+// recorded per dispense.
+class TouchlessDispenser {
+public:
+    static const uint8_t LATENCY_BUCKETS = 8;
+
+private:
+    static const char* TAG;
+    static const uint16_t LATENCY_BUCKET_MS[LATENCY_BUCKETS - 1];  // Upper bounds; the last bucket is open
+
+    struct SensorEvent {
+        bool present;
+        unsigned long edgeMicros;  // First edge of the change, before debouncing
+    };
+
+    HardwareAbstraction* hardware;
+    TaskHandle_t taskHandle;
+    QueueHandle_t events;
+    SemaphoreHandle_t lock;        // Guards the counters for getStatusJSON()
+    esp_timer_handle_t debounceTimer;
+
+    // Shared between the pin ISR and the debounce timer
+    portMUX_TYPE edgeMux;
+    volatile bool debouncing;
+    volatile unsigned long firstEdgeMicros;
+    bool stablePresent;            // Debounce timer only
+
+    volatile bool enabled;
+    DispenserState state;
+    bool handPresent;
+    unsigned long dispenseStartedAt;
+
+    // Counters (guarded by lock)
+    uint32_t detections;
+    uint32_t dispenses;
+    uint32_t refused;              // Hand seen during cooldown or a remote dispense
+    uint32_t latencyCounts[LATENCY_BUCKETS];
+    uint32_t latencyMinUs;
+    uint32_t latencyMaxUs;
+    uint64_t latencyTotalUs;
+    uint32_t overTarget;
+
+    static void IRAM_ATTR handleEdge(void* param);
+    static void handleDebounce(void* param);
+    static void taskEntry(void* param);
+    void run();
+    void handleEvent(const SensorEvent& event);
+    void recordLatency(uint32_t latencyUs);
+
+public:
+    TouchlessDispenser(HardwareAbstraction* hal);
+    ~TouchlessDispenser();
+
+    // Attach the sensor interrupt and start the dispenser task
+    bool begin();
+
+    void setEnabled(bool enable);
+    bool isEnabled() const { return enabled; }
+    bool isHandPresent() const { return handPresent; }
+
+    String getStatusJSON() const;
+    static const char* stateToString(DispenserState state);
+};
+
+#endif // TOUCHLESS_DISPENSER_H
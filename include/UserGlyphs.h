@@ -0,0 +1,40 @@
+#ifndef USER_GLYPHS_H
+#define USER_GLYPHS_H
+
+#include <Arduino.h>
+#include "EscPosEncoder.h"
+
+// Font A cell size
+#define USER_GLYPH_WIDTH 12
+#define USER_GLYPH_HEIGHT 24
+
+struct UserGlyph {
+    uint8_t code;                       // ASCII code the glyph is downloaded over
+    uint16_t rows[USER_GLYPH_HEIGHT];   // Bit 11 = leftmost dot
+};
+
+struct UserGlyphMapping {
+    uint32_t codepoint;
+    uint8_t glyph;                      // Index into the glyph table
+};
+
+// Emoji printed as printer-resident user-defined characters (ESC & / ESC %).
+// The set is downloaded once after a printer reset; from then on each emoji
+// costs one byte instead of an ASCII replacement like "[CACTUS]".
+// To add one: draw the bitmap, pick an unused rare ASCII code, map codepoints.
+class UserGlyphs {
+public:
+    // Character code for a codepoint, 0 if there's no glyph for it
+    static uint8_t lookup(uint32_t codepoint);
+
+    // True for ASCII codes overlaid by a glyph; literal uses of them must
+    // be printed with ESC % 0 around them
+    static bool isReservedCode(uint8_t code);
+
+    // Append ESC & definitions for the whole set
+    static void encodeDownload(EscPosEncoder& out);
+
+    static size_t count();
+};
+
+#endif // USER_GLYPHS_H
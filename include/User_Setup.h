@@ -15,7 +15,7 @@
 #define TFT_DC   18   // LCD_RS (Data/Command)
 #define TFT_RST  19   // LCD_RST (Reset)
 
-// Touch screen disabled to avoid TFT_eSPI parallel mode conflict and save memory
+// TFT_eSPI touch support stays off; TouchController drives the XPT2046 (config.h pins)
 // Optional touch screen pins (if available) - commented out to fix build error
 // #define TOUCH_CS 25   // Touch Controller Chip Select
 // #define TOUCH_IRQ 4   // Touch Interrupt - moved from GPIO 26 to GPIO 4
@@ -29,6 +29,7 @@
 #define SPI_READ_FREQUENCY  20000000
 #define SPI_TOUCH_FREQUENCY  2500000
 // Memory optimization: Disable DMA to save RAM
+// (TFT_eSPI has no DMA for the ILI9486 over SPI anyway; see TftDmaWriter for the dashboard's)
 #define ESP32_DMA_CHAN 0  // Disable DMA (0 = no DMA, saves ~50KB RAM)
 
 // Optional features - Reduced font set to save flash memory (~15KB saved)
@@ -35,12 +35,93 @@
 // Touch Screen Configuration
 #define TOUCH_CS_PIN 25         // Touch Controller Chip Select
 #define TOUCH_IRQ_PIN 4         // Touch Interrupt (optional but recommended) - moved from GPIO 26 to GPIO 4
+#define TOUCH_ENABLED true
+#define TOUCH_SPI_FREQUENCY 2000000     // XPT2046 is rated to 2.5MHz; shares the display's SPI bus
+#define TOUCH_BURST_SAMPLES 7           // Conversions per axis per reading (odd); the median is used
+#define TOUCH_SAMPLE_MS 20              // Re-read this often while pressed
+#define TOUCH_PRESSURE_MIN 400          // Pressure (Z) below this is a lift or noise
+#define TOUCH_MOVE_THRESHOLD 4          // Pixels; smaller changes don't raise a move event
+#define TOUCH_BUS_WAIT_MS 20            // Skip a reading rather than wait longer for a display update
+#define TOUCH_EVENT_QUEUE_LENGTH 16
+#define TOUCH_HISTORY_LENGTH 16         // Recent events kept for /api/touch
+#define TOUCH_CALIBRATION_TIMEOUT_MS 30000
+#define TOUCH_TASK_STACK_SIZE 3072
+#define TOUCH_TASK_PRIORITY 2           // Above loop() and the display task; a reading is ~0.3ms of bus time
+#define TOUCH_TASK_CORE 0
+#define TOUCH_NVS_NAMESPACE "touch"
+
+// Status dashboard (replaces the boot test pattern once the system is up)
+#define DASHBOARD_ENABLED true
+#define DASHBOARD_UPDATE_MS 1000        // Widgets are re-checked this often; only changed ones are drawn
+#define DASHBOARD_TEST_HOLD_MS 15000    // A display test keeps the screen this long before the dashboard returns
+#define DASHBOARD_SANITIZER_LOW 20      // Level (%) shown red; yellow below twice this
+#define DISPLAY_DMA_ENABLED true        // Widget text by SPI DMA (~6KB heap); false = CPU writes only
+#define DISPLAY_DMA_BUFFER_BYTES 2688   // Per buffer, two of them: 4 rows of a 224px widget line at 3 bytes/px
+#define DISPLAY_TASK_STACK_SIZE 4096
+#define DISPLAY_TASK_PRIORITY 1         // Same as loop(); waits on DMA instead of spinning
+#define DISPLAY_TASK_CORE 0
 
 // ============================================================================
 // THERMAL PRINTER CONFIGURATION
 // ============================================================================
 
-#define THERMAL_PRINTER_BAUD 9600  // Confirmed working for this printer
+#define THERMAL_PRINTER_BAUD 9600  // Confirmed working for this printer; default until one is saved in NVS
+#define PRINTER_BAUD_RATES {115200, 38400, 19200, 9600}  // Rates the boot probe and /api/printer/baudrate accept
+#define PRINTER_BAUD_SETTLE_MS 1000     // Printer restart after a baud change
+#define PRINTER_NVS_NAMESPACE "printer"
+#define PRINTER_TX_BUFFER_SIZE 1024     // UART2 software TX ring so job writes don't block on the 128-byte FIFO
+#define PRINTER_JOB_BUFFER_SIZE 512     // Initial ESC/POS job buffer (grows for long messages)
+#define PRINTER_DRAIN_MARGIN_MS 500     // Extra time allowed for the UART to drain a job
+#define PRINTER_HEAD_DOTS 384           // 58mm head, 8 dots/mm
+#define PRINTER_COLUMNS 32              // Font A characters per line (16 in double width)
+#define GROCERY_LIST_TWO_COLUMNS true   // Pack pairs of short grocery items onto one line
+#define PRINTER_INLINE_ICONS true       // Print atlas emoji as inline 24-dot images instead of [WORDS]
+#define ICON_CACHE_SLOTS 4              // Decoded icons kept in RAM (72 bytes each)
+#define RASTER_BAND_HEIGHT 24           // Rows per GS v 0 band (48 x 24 = 1152 bytes at full width)
+#define RASTER_ROW_TIME_US 2000         // Time the head needs to burn one dot row
+#define PRINTER_LINE_SPACING_DOTS 30    // ESC 2 default line feed (timing model)
+#define PRINTER_CUT_MS 400              // Full cut (timing model)
+#define PRINTER_DEFAULT_PROFILE PRINT_PROFILE_BALANCED  // Heating profile until one is saved in NVS
+#define PRINT_CALIBRATION_TIMES {40, 60, 80, 100, 120, 140, 160}  // Heating time steps on the strip (x10us)
+#define IMAGE_STREAM_BUFFER_SIZE 2048   // Upload -> spooler pipe for image prints
+#define IMAGE_STREAM_POLL_MS 20         // Wait slice while the pipe is full/empty
+#define IMAGE_STREAM_TIMEOUT_MS 30000   // Abort an image print if the pipe stalls this long
+#define IMAGE_MAX_SOURCE_WIDTH 2048     // Bounds the single source-row buffer
+#define IMAGE_MAX_SOURCE_HEIGHT 8192
+
+// Printer status over the RX line (DLE EOT real-time status, GS r sync)
+#define PRINTER_STATUS_TIMEOUT_MS 100   // Reply wait per DLE EOT query
+#define PRINTER_STATUS_POLL_MS 5000     // Idle status poll on the spooler task
+#define PRINTER_SYNC_TIMEOUT_MS 10000   // Wait for the printer to finish a job before asking why
+#define PRINTER_PAUSE_POLL_MS 2000      // Status re-check while paused for paper / cover
+#define PRINTER_PAUSE_TIMEOUT_MS 1800000UL  // Fail a job paused mid-print after 30 minutes
+
+// QR codes and barcodes: native GS ( k / GS k when the printer has them,
+// otherwise rendered here and printed as raster
+#define QR_MAX_VERSION 10               // Software encoder limit: 57x57 modules, 213 bytes at ECC M
+#define QR_ERROR_CORRECTION QR_ECC_MEDIUM
+#define QR_MODULE_DOTS 6                // Module size (shrunk if the symbol wouldn't fit the head)
+#define BARCODE_HEIGHT_DOTS 80          // CODE128 bar height
+#define BARCODE_MODULE_DOTS 2           // Narrowest bar width
+#define BARCODE_MAX_LENGTH 24           // Characters; keeps the symbol within the head at 1 dot
+#define PRINTER_SYMBOL_PROBE_MS 500     // Wait for the GS ( k size reply at boot
+#define PRINTER_SYMBOLS_ASSUME_NATIVE false  // Use GS ( k / GS k when the probe can't run (no RX)
+
+// Print spooler task (printing runs off the main loop)
+#define PRINT_SPOOLER_QUEUE_SIZE 8      // Job slots (queued + recently finished)
+#define PRINT_SPOOLER_STACK_SIZE 6144   // Task stack in bytes
+#define PRINT_SPOOLER_PRIORITY 1        // Same as loop() so WiFi/OTA keep precedence
+#define PRINT_SPOOLER_CORE 0            // loop() runs on core 1
+#define PRINT_SPOOLER_MAX_LIST_ITEMS 50 // Matches MAX_GROCERY_ITEMS
+#define PRINT_COALESCE_WINDOW_MS 1000UL // Hold a receipt this long to batch a burst (0 = print immediately)
+#define PRINT_COALESCE_MAX_JOBS 4       // Receipts sharing one init and cut
+
+// Print journal on LittleFS ("spiffs" partition) so queued jobs survive a reboot
+#define PRINT_JOURNAL_PATH "/printjournal.log"
+#define PRINT_JOURNAL_MAX_PENDING 24        // Unfinished jobs tracked (more are refused)
+#define PRINT_JOURNAL_MAX_PAYLOAD 2048      // Largest job text journaled
+#define PRINT_JOURNAL_COMPACT_BYTES 16384   // Rewrite the file once it grows past this
+#define PRINT_JOURNAL_REPLAY_MS 5000        // How often unfinished jobs are offered to the spooler
 
 // ============================================================================
 // TIMING CONFIGURATION
@@ -48,13 +129,36 @@
 
 #define SENSOR_CHECK_INTERVAL 10000     // Check sensors every 10 seconds
 
+// Background sampling of the analog sensors (moisture, light)
+#define SENSOR_SAMPLE_RATE_HZ 20        // Filtered updates per second until one is saved in NVS
+#define SENSOR_SAMPLE_RATE_MAX_HZ 200   // Upper limit for /api/sensors
+#define SENSOR_OVERSAMPLE 8             // Conversions averaged per pin per update
+#define SENSOR_MEDIAN_WINDOW 5          // Updates in the spike filter (odd)
+#define SENSOR_EMA_ALPHA 0.2f           // Weight of each new median (1 = no smoothing)
+#define SENSOR_SAMPLER_STACK_SIZE 2048
+#define SENSOR_SAMPLER_PRIORITY 1       // Same as loop(); a conversion burst is well under a tick
+#define SENSOR_SAMPLER_CORE 0
+#define SENSOR_NVS_NAMESPACE "sensors"
+
 // ============================================================================
 // LED PWM CONFIGURATION
 // ============================================================================
 
 #define LED_PWM_CHANNEL 0               // LEDC channel for LED PWM (0-15)
 #define LED_PWM_FREQUENCY 5000          // PWM frequency in Hz (5kHz)
-#define LED_PWM_RESOLUTION 8            // PWM resolution in bits (8-bit = 0-255)
+#define LED_PWM_RESOLUTION 12           // Duty resolution in bits; levels stay 0-255, gamma-mapped onto it
+#define LED_GAMMA 2.2f                  // Perceptual correction for the level -> duty LUT
+#define LED_FADE_MS 1000                // Hardware fade time for auto-brightness changes
+#define LED_FADE_MANUAL_MS 250          // Hardware fade time for set brightness commands
+#define LED_LIGHT_HYSTERESIS 5.0f       // Light change (%) needed before auto-brightness moves
+#define LED_AUTO_UPDATE_MS 1000         // Auto-brightness check interval (a memory read, fades run in hardware)
+
+#define PUMP_PWM_CHANNEL 2              // LEDC channel for the pump MOSFET (timer 1, separate from the LED)
+#define PUMP_PWM_FREQUENCY 1000         // Slow enough for the IRF520 module's gate driver
+#define PUMP_PWM_RESOLUTION 8
+#define PUMP_SOFT_START_MS 120          // Ramp to full power over this long (0 = switch straight on)
+#define PUMP_SOFT_START_DUTY 96         // First ramp step (0-255); the pump stalls much below this
+#define PUMP_RAMP_STEP_MS 10            // Duty update interval during the ramp
 
 // ============================================================================
 // CONFIGURATION
@@ -81,6 +185,24 @@
 // Sanitizer Dispensing Settings
 #define DISPENSE_COOLDOWN_MS 3000        // Cooldown period: 3 seconds between dispenses (3000ms)
 #define MAX_DISPENSE_DURATION_MS 2000   // Maximum dispense duration: 2 seconds (prevents continuous dumping)
+#define DISPENSE_DOSE_MS 700            // Default dose; pump-off runs on a one-shot esp_timer
+#define DISPENSE_MIN_DOSE_MS 50
+#define DISPENSER_NVS_NAMESPACE "dispenser"
+
+// Sanitizer level: pump on-time x calibrated flow rate, taken from the reservoir
+#define SANITIZER_RESERVOIR_ML 500.0f   // Until set at /api/sanitizer/calibrate
+#define SANITIZER_FLOW_ML_PER_S 2.0f    // Until calibrated
+#define SANITIZER_PERSIST_ML 5.0f       // Save after this much use (most that a power cut can lose)
+#define SANITIZER_RING_SLOTS 8          // NVS records written round-robin
+#define SANITIZER_NVS_NAMESPACE "sanitizer"
+
+// Touchless dispensing: IR sensor interrupt -> debounce timer -> dispenser task
+#define TOUCHLESS_DISPENSE_ENABLED true  // Dispense when a hand is detected (toggle at /api/dispenser)
+#define IR_DEBOUNCE_MS 15                // Sensor must be stable this long; part of the latency budget
+#define DISPENSE_LATENCY_TARGET_MS 50    // Hand detected -> pump on
+#define DISPENSER_TASK_STACK_SIZE 3072
+#define DISPENSER_TASK_PRIORITY 3        // Above loop() and the spooler so a hand is never queued behind them
+#define DISPENSER_TASK_CORE 1
 
 // Web Server Authentication
 #define WEB_PASSWORD "0820"              // Password to access web interface (change in secrets.h if needed)
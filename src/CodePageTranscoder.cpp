@@ -0,0 +1,385 @@
+#include "CodePageTranscoder.h"
+#include "TextSanitizer.h"
+#include "UserGlyphs.h"
+
+// How many codepoints ahead to look when picking a page to switch to
+#define CODE_PAGE_LOOKAHEAD 32
+
+// Generated from the CP437, CP850 and CP1252 mappings; sorted by codepoint.
+// Kept as a single merged table (~1 KB of flash) instead of three reverse maps.
+static constexpr CodePageEntry CODE_PAGE_TABLE[] = {
+    {0x00A0, 0xFF, 0xFF, 0xA0},  // (no-break space)
+    {0x00A1, 0xAD, 0xAD, 0xA1},  // ¡
+    {0x00A2, 0x9B, 0xBD, 0xA2},  // ¢
+    {0x00A3, 0x9C, 0x9C, 0xA3},  // £
+    {0x00A4, 0x00, 0xCF, 0xA4},  // ¤
+    {0x00A5, 0x9D, 0xBE, 0xA5},  // ¥
+    {0x00A6, 0x00, 0xDD, 0xA6},  // ¦
+    {0x00A7, 0x00, 0xF5, 0xA7},  // §
+    {0x00A8, 0x00, 0xF9, 0xA8},  // ¨
+    {0x00A9, 0x00, 0xB8, 0xA9},  // ©
+    {0x00AA, 0xA6, 0xA6, 0xAA},  // ª
+    {0x00AB, 0xAE, 0xAE, 0xAB},  // «
+    {0x00AC, 0xAA, 0xAA, 0xAC},  // ¬
+    {0x00AD, 0x00, 0xF0, 0xAD},  // ­
+    {0x00AE, 0x00, 0xA9, 0xAE},  // ®
+    {0x00AF, 0x00, 0xEE, 0xAF},  // ¯
+    {0x00B0, 0xF8, 0xF8, 0xB0},  // °
+    {0x00B1, 0xF1, 0xF1, 0xB1},  // ±
+    {0x00B2, 0xFD, 0xFD, 0xB2},  // ²
+    {0x00B3, 0x00, 0xFC, 0xB3},  // ³
+    {0x00B4, 0x00, 0xEF, 0xB4},  // ´
+    {0x00B5, 0xE6, 0xE6, 0xB5},  // µ
+    {0x00B6, 0x00, 0xF4, 0xB6},  // ¶
+    {0x00B7, 0xFA, 0xFA, 0xB7},  // ·
+    {0x00B8, 0x00, 0xF7, 0xB8},  // ¸
+    {0x00B9, 0x00, 0xFB, 0xB9},  // ¹
+    {0x00BA, 0xA7, 0xA7, 0xBA},  // º
+    {0x00BB, 0xAF, 0xAF, 0xBB},  // »
+    {0x00BC, 0xAC, 0xAC, 0xBC},  // ¼
+    {0x00BD, 0xAB, 0xAB, 0xBD},  // ½
+    {0x00BE, 0x00, 0xF3, 0xBE},  // ¾
+    {0x00BF, 0xA8, 0xA8, 0xBF},  // ¿
+    {0x00C0, 0x00, 0xB7, 0xC0},  // À
+    {0x00C1, 0x00, 0xB5, 0xC1},  // Á
+    {0x00C2, 0x00, 0xB6, 0xC2},  // Â
+    {0x00C3, 0x00, 0xC7, 0xC3},  // Ã
+    {0x00C4, 0x8E, 0x8E, 0xC4},  // Ä
+    {0x00C5, 0x8F, 0x8F, 0xC5},  // Å
+    {0x00C6, 0x92, 0x92, 0xC6},  // Æ
+    {0x00C7, 0x80, 0x80, 0xC7},  // Ç
+    {0x00C8, 0x00, 0xD4, 0xC8},  // È
+    {0x00C9, 0x90, 0x90, 0xC9},  // É
+    {0x00CA, 0x00, 0xD2, 0xCA},  // Ê
+    {0x00CB, 0x00, 0xD3, 0xCB},  // Ë
+    {0x00CC, 0x00, 0xDE, 0xCC},  // Ì
+    {0x00CD, 0x00, 0xD6, 0xCD},  // Í
+    {0x00CE, 0x00, 0xD7, 0xCE},  // Î
+    {0x00CF, 0x00, 0xD8, 0xCF},  // Ï
+    {0x00D0, 0x00, 0xD1, 0xD0},  // Ð
+    {0x00D1, 0xA5, 0xA5, 0xD1},  // Ñ
+    {0x00D2, 0x00, 0xE3, 0xD2},  // Ò
+    {0x00D3, 0x00, 0xE0, 0xD3},  // Ó
+    {0x00D4, 0x00, 0xE2, 0xD4},  // Ô
+    {0x00D5, 0x00, 0xE5, 0xD5},  // Õ
+    {0x00D6, 0x99, 0x99, 0xD6},  // Ö
+    {0x00D7, 0x00, 0x9E, 0xD7},  // ×
+    {0x00D8, 0x00, 0x9D, 0xD8},  // Ø
+    {0x00D9, 0x00, 0xEB, 0xD9},  // Ù
+    {0x00DA, 0x00, 0xE9, 0xDA},  // Ú
+    {0x00DB, 0x00, 0xEA, 0xDB},  // Û
+    {0x00DC, 0x9A, 0x9A, 0xDC},  // Ü
+    {0x00DD, 0x00, 0xED, 0xDD},  // Ý
+    {0x00DE, 0x00, 0xE8, 0xDE},  // Þ
+    {0x00DF, 0xE1, 0xE1, 0xDF},  // ß
+    {0x00E0, 0x85, 0x85, 0xE0},  // à
+    {0x00E1, 0xA0, 0xA0, 0xE1},  // á
+    {0x00E2, 0x83, 0x83, 0xE2},  // â
+    {0x00E3, 0x00, 0xC6, 0xE3},  // ã
+    {0x00E4, 0x84, 0x84, 0xE4},  // ä
+    {0x00E5, 0x86, 0x86, 0xE5},  // å
+    {0x00E6, 0x91, 0x91, 0xE6},  // æ
+    {0x00E7, 0x87, 0x87, 0xE7},  // ç
+    {0x00E8, 0x8A, 0x8A, 0xE8},  // è
+    {0x00E9, 0x82, 0x82, 0xE9},  // é
+    {0x00EA, 0x88, 0x88, 0xEA},  // ê
+    {0x00EB, 0x89, 0x89, 0xEB},  // ë
+    {0x00EC, 0x8D, 0x8D, 0xEC},  // ì
+    {0x00ED, 0xA1, 0xA1, 0xED},  // í
+    {0x00EE, 0x8C, 0x8C, 0xEE},  // î
+    {0x00EF, 0x8B, 0x8B, 0xEF},  // ï
+    {0x00F0, 0x00, 0xD0, 0xF0},  // ð
+    {0x00F1, 0xA4, 0xA4, 0xF1},  // ñ
+    {0x00F2, 0x95, 0x95, 0xF2},  // ò
+    {0x00F3, 0xA2, 0xA2, 0xF3},  // ó
+    {0x00F4, 0x93, 0x93, 0xF4},  // ô
+    {0x00F5, 0x00, 0xE4, 0xF5},  // õ
+    {0x00F6, 0x94, 0x94, 0xF6},  // ö
+    {0x00F7, 0xF6, 0xF6, 0xF7},  // ÷
+    {0x00F8, 0x00, 0x9B, 0xF8},  // ø
+    {0x00F9, 0x97, 0x97, 0xF9},  // ù
+    {0x00FA, 0xA3, 0xA3, 0xFA},  // ú
+    {0x00FB, 0x96, 0x96, 0xFB},  // û
+    {0x00FC, 0x81, 0x81, 0xFC},  // ü
+    {0x00FD, 0x00, 0xEC, 0xFD},  // ý
+    {0x00FE, 0x00, 0xE7, 0xFE},  // þ
+    {0x00FF, 0x98, 0x98, 0xFF},  // ÿ
+    {0x0131, 0x00, 0xD5, 0x00},  // ı
+    {0x0152, 0x00, 0x00, 0x8C},  // Œ
+    {0x0153, 0x00, 0x00, 0x9C},  // œ
+    {0x0160, 0x00, 0x00, 0x8A},  // Š
+    {0x0161, 0x00, 0x00, 0x9A},  // š
+    {0x0178, 0x00, 0x00, 0x9F},  // Ÿ
+    {0x017D, 0x00, 0x00, 0x8E},  // Ž
+    {0x017E, 0x00, 0x00, 0x9E},  // ž
+    {0x0192, 0x9F, 0x9F, 0x83},  // ƒ
+    {0x02C6, 0x00, 0x00, 0x88},  // ˆ
+    {0x02DC, 0x00, 0x00, 0x98},  // ˜
+    {0x0393, 0xE2, 0x00, 0x00},  // Γ
+    {0x0398, 0xE9, 0x00, 0x00},  // Θ
+    {0x03A3, 0xE4, 0x00, 0x00},  // Σ
+    {0x03A6, 0xE8, 0x00, 0x00},  // Φ
+    {0x03A9, 0xEA, 0x00, 0x00},  // Ω
+    {0x03B1, 0xE0, 0x00, 0x00},  // α
+    {0x03B4, 0xEB, 0x00, 0x00},  // δ
+    {0x03B5, 0xEE, 0x00, 0x00},  // ε
+    {0x03C0, 0xE3, 0x00, 0x00},  // π
+    {0x03C3, 0xE5, 0x00, 0x00},  // σ
+    {0x03C4, 0xE7, 0x00, 0x00},  // τ
+    {0x03C6, 0xED, 0x00, 0x00},  // φ
+    {0x2013, 0x00, 0x00, 0x96},  // –
+    {0x2014, 0x00, 0x00, 0x97},  // —
+    {0x2017, 0x00, 0xF2, 0x00},  // ‗
+    {0x2018, 0x00, 0x00, 0x91},  // ‘
+    {0x2019, 0x00, 0x00, 0x92},  // ’
+    {0x201A, 0x00, 0x00, 0x82},  // ‚
+    {0x201C, 0x00, 0x00, 0x93},  // “
+    {0x201D, 0x00, 0x00, 0x94},  // ”
+    {0x201E, 0x00, 0x00, 0x84},  // „
+    {0x2020, 0x00, 0x00, 0x86},  // †
+    {0x2021, 0x00, 0x00, 0x87},  // ‡
+    {0x2022, 0x00, 0x00, 0x95},  // •
+    {0x2026, 0x00, 0x00, 0x85},  // …
+    {0x2030, 0x00, 0x00, 0x89},  // ‰
+    {0x2039, 0x00, 0x00, 0x8B},  // ‹
+    {0x203A, 0x00, 0x00, 0x9B},  // ›
+    {0x207F, 0xFC, 0x00, 0x00},  // ⁿ
+    {0x20A7, 0x9E, 0x00, 0x00},  // ₧
+    {0x20AC, 0x00, 0x00, 0x80},  // €
+    {0x2122, 0x00, 0x00, 0x99},  // ™
+    {0x2219, 0xF9, 0x00, 0x00},  // ∙
+    {0x221A, 0xFB, 0x00, 0x00},  // √
+    {0x221E, 0xEC, 0x00, 0x00},  // ∞
+    {0x2229, 0xEF, 0x00, 0x00},  // ∩
+    {0x2248, 0xF7, 0x00, 0x00},  // ≈
+    {0x2261, 0xF0, 0x00, 0x00},  // ≡
+    {0x2264, 0xF3, 0x00, 0x00},  // ≤
+    {0x2265, 0xF2, 0x00, 0x00},  // ≥
+    {0x2310, 0xA9, 0x00, 0x00},  // ⌐
+    {0x2320, 0xF4, 0x00, 0x00},  // ⌠
+    {0x2321, 0xF5, 0x00, 0x00},  // ⌡
+    {0x2500, 0xC4, 0xC4, 0x00},  // ─
+    {0x2502, 0xB3, 0xB3, 0x00},  // │
+    {0x250C, 0xDA, 0xDA, 0x00},  // ┌
+    {0x2510, 0xBF, 0xBF, 0x00},  // ┐
+    {0x2514, 0xC0, 0xC0, 0x00},  // └
+    {0x2518, 0xD9, 0xD9, 0x00},  // ┘
+    {0x251C, 0xC3, 0xC3, 0x00},  // ├
+    {0x2524, 0xB4, 0xB4, 0x00},  // ┤
+    {0x252C, 0xC2, 0xC2, 0x00},  // ┬
+    {0x2534, 0xC1, 0xC1, 0x00},  // ┴
+    {0x253C, 0xC5, 0xC5, 0x00},  // ┼
+    {0x2550, 0xCD, 0xCD, 0x00},  // ═
+    {0x2551, 0xBA, 0xBA, 0x00},  // ║
+    {0x2552, 0xD5, 0x00, 0x00},  // ╒
+    {0x2553, 0xD6, 0x00, 0x00},  // ╓
+    {0x2554, 0xC9, 0xC9, 0x00},  // ╔
+    {0x2555, 0xB8, 0x00, 0x00},  // ╕
+    {0x2556, 0xB7, 0x00, 0x00},  // ╖
+    {0x2557, 0xBB, 0xBB, 0x00},  // ╗
+    {0x2558, 0xD4, 0x00, 0x00},  // ╘
+    {0x2559, 0xD3, 0x00, 0x00},  // ╙
+    {0x255A, 0xC8, 0xC8, 0x00},  // ╚
+    {0x255B, 0xBE, 0x00, 0x00},  // ╛
+    {0x255C, 0xBD, 0x00, 0x00},  // ╜
+    {0x255D, 0xBC, 0xBC, 0x00},  // ╝
+    {0x255E, 0xC6, 0x00, 0x00},  // ╞
+    {0x255F, 0xC7, 0x00, 0x00},  // ╟
+    {0x2560, 0xCC, 0xCC, 0x00},  // ╠
+    {0x2561, 0xB5, 0x00, 0x00},  // ╡
+    {0x2562, 0xB6, 0x00, 0x00},  // ╢
+    {0x2563, 0xB9, 0xB9, 0x00},  // ╣
+    {0x2564, 0xD1, 0x00, 0x00},  // ╤
+    {0x2565, 0xD2, 0x00, 0x00},  // ╥
+    {0x2566, 0xCB, 0xCB, 0x00},  // ╦
+    {0x2567, 0xCF, 0x00, 0x00},  // ╧
+    {0x2568, 0xD0, 0x00, 0x00},  // ╨
+    {0x2569, 0xCA, 0xCA, 0x00},  // ╩
+    {0x256A, 0xD8, 0x00, 0x00},  // ╪
+    {0x256B, 0xD7, 0x00, 0x00},  // ╫
+    {0x256C, 0xCE, 0xCE, 0x00},  // ╬
+    {0x2580, 0xDF, 0xDF, 0x00},  // ▀
+    {0x2584, 0xDC, 0xDC, 0x00},  // ▄
+    {0x2588, 0xDB, 0xDB, 0x00},  // █
+    {0x258C, 0xDD, 0x00, 0x00},  // ▌
+    {0x2590, 0xDE, 0x00, 0x00},  // ▐
+    {0x2591, 0xB0, 0xB0, 0x00},  // ░
+    {0x2592, 0xB1, 0xB1, 0x00},  // ▒
+    {0x2593, 0xB2, 0xB2, 0x00},  // ▓
+    {0x25A0, 0xFE, 0xFE, 0x00},  // ■
+};
+
+static constexpr size_t CODE_PAGE_TABLE_SIZE = sizeof(CODE_PAGE_TABLE) / sizeof(CODE_PAGE_TABLE[0]);
+
+static constexpr bool isCodePageTableSorted(size_t i) {
+    return i + 1 >= CODE_PAGE_TABLE_SIZE ||
+           (CODE_PAGE_TABLE[i].codepoint < CODE_PAGE_TABLE[i + 1].codepoint && isCodePageTableSorted(i + 1));
+}
+static_assert(isCodePageTableSorted(0), "CODE_PAGE_TABLE must be sorted by codepoint for binary search");
+
+// Page preference when several pages can print a character
+static const uint8_t PAGE_ORDER[] = {CODE_PAGE_CP437, CODE_PAGE_CP850, CODE_PAGE_CP1252};
+
+CodePageTranscoder::CodePageTranscoder() : currentPage(CODE_PAGE_CP437), userGlyphs(false), icons(nullptr) {
+}
+
+const CodePageEntry* CodePageTranscoder::findEntry(uint32_t codepoint) {
+    if (codepoint < CODE_PAGE_TABLE[0].codepoint || codepoint > 0xFFFF) {
+        return nullptr;
+    }
+    
+    size_t low = 0;
+    size_t high = CODE_PAGE_TABLE_SIZE;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (CODE_PAGE_TABLE[mid].codepoint < codepoint) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low < CODE_PAGE_TABLE_SIZE && CODE_PAGE_TABLE[low].codepoint == codepoint) {
+        return &CODE_PAGE_TABLE[low];
+    }
+    return nullptr;
+}
+
+uint8_t CodePageTranscoder::byteForPage(const CodePageEntry* entry, uint8_t page) {
+    switch (page) {
+        case CODE_PAGE_CP437: return entry->cp437;
+        case CODE_PAGE_CP850: return entry->cp850;
+        case CODE_PAGE_CP1252: return entry->cp1252;
+        default: return 0;
+    }
+}
+
+uint8_t CodePageTranscoder::choosePage(const CodePageEntry* entry, const uint8_t* text, size_t length) const {
+    // Pick the page that can print the longest run of upcoming characters,
+    // so a run of accented text costs one switch instead of several
+    uint8_t bestPage = currentPage;
+    int bestRun = -1;
+    
+    for (size_t p = 0; p < sizeof(PAGE_ORDER); p++) {
+        uint8_t page = PAGE_ORDER[p];
+        if (byteForPage(entry, page) == 0) continue;
+        
+        int run = 0;
+        size_t i = 0;
+        while (i < length && run < CODE_PAGE_LOOKAHEAD) {
+            if (text[i] < 0x80) {
+                i++;
+                continue;
+            }
+            size_t consumed;
+            uint32_t codepoint = TextSanitizer::decodeUtf8(text + i, length - i, &consumed);
+            i += consumed;
+            const CodePageEntry* next = codepoint != UTF8_INVALID ? findEntry(codepoint) : nullptr;
+            if (!next) continue;                       // Not printable on any page - doesn't matter
+            if (byteForPage(next, page) == 0) break;   // Run ends here
+            run++;
+        }
+        
+        if (run > bestRun) {
+            bestRun = run;
+            bestPage = page;
+        }
+    }
+    
+    return bestPage;
+}
+
+int CodePageTranscoder::transcode(const char* text, size_t length, EscPosEncoder& out) {
+    const uint8_t* input = (const uint8_t*)text;
+    int switches = 0;
+    size_t i = 0;
+    
+    while (i < length) {
+        uint8_t c = input[i];
+        
+        // Printable ASCII plus newline/tab is identical on every page
+        if (c < 0x80) {
+            if ((c >= 32 && c <= 126) || c == '\n' || c == '\r' || c == '\t') {
+                if (userGlyphs && UserGlyphs::isReservedCode(c)) {
+                    // A glyph is downloaded over this code - print the real one
+                    out.userCharacters(false);
+                    out.write(c);
+                    out.userCharacters(true);
+                } else {
+                    out.write(c);
+                }
+            }
+            i++;
+            continue;
+        }
+        
+        size_t consumed;
+        uint32_t codepoint = TextSanitizer::decodeUtf8(input + i, length - i, &consumed);
+        const uint8_t* rest = input + i;
+        size_t restLength = length - i;
+        i += consumed;
+        
+        if (codepoint == UTF8_INVALID) {
+            continue;
+        }
+        
+        // Printer-resident glyph: one byte
+        uint8_t glyph = userGlyphs ? UserGlyphs::lookup(codepoint) : 0;
+        if (glyph) {
+            out.write(glyph);
+            continue;
+        }
+        
+        // Atlas icon: printed in the same 24-dot line as the text around it
+        const uint8_t* icon = icons ? icons->get(codepoint) : nullptr;
+        if (icon) {
+            out.bitImage24(ICON_WIDTH, icon);
+            continue;
+        }
+        
+        const CodePageEntry* entry = findEntry(codepoint);
+        if (entry) {
+            uint8_t b = byteForPage(entry, currentPage);
+            if (b == 0) {
+                currentPage = choosePage(entry, rest, restLength);
+                out.codePage(currentPage);
+                switches++;
+                b = byteForPage(entry, currentPage);
+            }
+            out.write(b);
+            continue;
+        }
+        
+        // No code page has it - use the ASCII replacement if there is one
+        const char* replacement = TextSanitizer::lookupReplacement(codepoint);
+        if (replacement) {
+            out.print(replacement);
+        }
+    }
+    
+    return switches;
+}
+
+uint8_t CodePageTranscoder::printedWidth(const char* text, size_t length, size_t* consumed) {
+    const uint8_t* input = (const uint8_t*)text;
+    uint8_t c = input[0];
+    
+    // Same rules as transcode(): printable ASCII and tab take a column,
+    // other control bytes are dropped or don't advance the column
+    if (c < 0x80) {
+        *consumed = 1;
+        return (c >= 32 && c <= 126) || c == '\t' ? 1 : 0;
+    }
+    
+    uint32_t codepoint = TextSanitizer::decodeUtf8(input, length, consumed);
+    if (codepoint == UTF8_INVALID) {
+        return 0;
+    }
+    if (UserGlyphs::lookup(codepoint) || findEntry(codepoint)) {
+        return 1;
+    }
+    if (PRINTER_INLINE_ICONS && IconAtlas::contains(codepoint)) {
+        return ICON_WIDTH / 12;  // Font A characters are 12 dots wide
+    }
+    const char* replacement = TextSanitizer::lookupReplacement(codepoint);
+    return replacement ? strlen(replacement) : 0;
+}
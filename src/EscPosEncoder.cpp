@@ -0,0 +1,230 @@
+#include "EscPosEncoder.h"
+
+EscPosEncoder::EscPosEncoder(size_t initialCapacity)
+    : buffer(nullptr), length(0), capacity(0), overflow(false) {
+    ensureCapacity(initialCapacity);
+}
+
+EscPosEncoder::~EscPosEncoder() {
+    if (buffer) {
+        free(buffer);
+    }
+}
+
+bool EscPosEncoder::ensureCapacity(size_t extra) {
+    if (overflow) return false;
+    if (length + extra <= capacity) return true;
+
+    // Grow geometrically so a long message only costs a few reallocations
+    size_t newCapacity = capacity > 0 ? capacity : 64;
+    while (newCapacity < length + extra) {
+        newCapacity *= 2;
+    }
+
+    uint8_t* grown = (uint8_t*)realloc(buffer, newCapacity);
+    if (!grown) {
+        overflow = true;
+        return false;
+    }
+    buffer = grown;
+    capacity = newCapacity;
+    return true;
+}
+
+void EscPosEncoder::reset() {
+    length = 0;
+    overflow = false;
+}
+
+EscPosEncoder& EscPosEncoder::write(uint8_t b) {
+    if (ensureCapacity(1)) {
+        buffer[length++] = b;
+    }
+    return *this;
+}
+
+EscPosEncoder& EscPosEncoder::write(const uint8_t* bytes, size_t count) {
+    if (count > 0 && ensureCapacity(count)) {
+        memcpy(buffer + length, bytes, count);
+        length += count;
+    }
+    return *this;
+}
+
+EscPosEncoder& EscPosEncoder::print(const char* text) {
+    return write((const uint8_t*)text, strlen(text));
+}
+
+EscPosEncoder& EscPosEncoder::print(const String& text) {
+    return write((const uint8_t*)text.c_str(), text.length());
+}
+
+EscPosEncoder& EscPosEncoder::println(const String& text) {
+    print(text);
+    write('\r');
+    return write('\n');
+}
+
+uint8_t* EscPosEncoder::reserve(size_t count) {
+    if (!ensureCapacity(count)) {
+        return nullptr;
+    }
+    return buffer + length;
+}
+
+void EscPosEncoder::commit(size_t count) {
+    if (length + count <= capacity) {
+        length += count;
+    }
+}
+
+EscPosEncoder& EscPosEncoder::initialize() {
+    write(ESCPOS_ESC);
+    return write('@');
+}
+
+EscPosEncoder& EscPosEncoder::codePage(uint8_t page) {
+    const uint8_t cmd[] = {ESCPOS_ESC, 't', page};
+    return write(cmd, sizeof(cmd));
+}
+
+EscPosEncoder& EscPosEncoder::defaultLineSpace() {
+    write(ESCPOS_ESC);
+    return write('2');
+}
+
+EscPosEncoder& EscPosEncoder::lineSpacing(uint8_t dots) {
+    const uint8_t cmd[] = {ESCPOS_ESC, '3', dots};
+    return write(cmd, sizeof(cmd));
+}
+
+EscPosEncoder& EscPosEncoder::align(uint8_t mode) {
+    const uint8_t cmd[] = {ESCPOS_ESC, 'a', mode};
+    return write(cmd, sizeof(cmd));
+}
+
+EscPosEncoder& EscPosEncoder::printMode(uint8_t mode) {
+    const uint8_t cmd[] = {ESCPOS_ESC, '!', mode};
+    return write(cmd, sizeof(cmd));
+}
+
+EscPosEncoder& EscPosEncoder::bold(bool enable) {
+    const uint8_t cmd[] = {ESCPOS_ESC, 'E', (uint8_t)(enable ? 1 : 0)};
+    return write(cmd, sizeof(cmd));
+}
+
+EscPosEncoder& EscPosEncoder::underline(uint8_t mode) {
+    const uint8_t cmd[] = {ESCPOS_ESC, '-', mode};
+    return write(cmd, sizeof(cmd));
+}
+
+EscPosEncoder& EscPosEncoder::inverse(bool enable) {
+    const uint8_t cmd[] = {ESCPOS_GS, 'B', (uint8_t)(enable ? 1 : 0)};
+    return write(cmd, sizeof(cmd));
+}
+
+EscPosEncoder& EscPosEncoder::cut(uint8_t mode) {
+    const uint8_t cmd[] = {ESCPOS_GS, 'V', mode};
+    return write(cmd, sizeof(cmd));
+}
+
+EscPosEncoder& EscPosEncoder::userCharacters(bool enable) {
+    const uint8_t cmd[] = {ESCPOS_ESC, '%', (uint8_t)(enable ? 1 : 0)};
+    return write(cmd, sizeof(cmd));
+}
+
+EscPosEncoder& EscPosEncoder::heatingParameters(uint8_t dots, uint8_t time, uint8_t interval) {
+    const uint8_t cmd[] = {ESCPOS_ESC, '7', dots, time, interval};
+    return write(cmd, sizeof(cmd));
+}
+
+EscPosEncoder& EscPosEncoder::printDensity(uint8_t density, uint8_t breakTime) {
+    const uint8_t cmd[] = {ESCPOS_DC2, '#', (uint8_t)((breakTime << 5) | (density & 0x1F))};
+    return write(cmd, sizeof(cmd));
+}
+
+EscPosEncoder& EscPosEncoder::transmitPaperStatus() {
+    const uint8_t cmd[] = {ESCPOS_GS, 'r', 1};
+    return write(cmd, sizeof(cmd));
+}
+
+EscPosEncoder& EscPosEncoder::serialBaudRate(uint32_t baud) {
+    // Function 1: enter user setting mode ("IN")
+    const uint8_t enter[] = {ESCPOS_GS, '(', 'E', 3, 0, 1, 'I', 'N'};
+    write(enter, sizeof(enter));
+
+    // Function 11, a = 1: transmission speed as ASCII digits
+    char digits[11];
+    uint8_t count = snprintf(digits, sizeof(digits), "%lu", (unsigned long)baud);
+    const uint8_t speed[] = {ESCPOS_GS, '(', 'E', (uint8_t)(count + 2), 0, 11, 1};
+    write(speed, sizeof(speed));
+    write((const uint8_t*)digits, count);
+
+    // Function 2: end the session ("OUT") - the printer resets to apply it
+    const uint8_t leave[] = {ESCPOS_GS, '(', 'E', 4, 0, 2, 'O', 'U', 'T'};
+    return write(leave, sizeof(leave));
+}
+
+EscPosEncoder& EscPosEncoder::qrCodeStore(const uint8_t* data, size_t length, uint8_t moduleDots,
+                                          uint8_t errorCorrection) {
+    // Function 165: model 2
+    const uint8_t model[] = {ESCPOS_GS, '(', 'k', 4, 0, 49, 65, 50, 0};
+    write(model, sizeof(model));
+
+    // Function 167: module size; function 169: error correction level
+    const uint8_t size[] = {ESCPOS_GS, '(', 'k', 3, 0, 49, 67, moduleDots};
+    write(size, sizeof(size));
+    const uint8_t level[] = {ESCPOS_GS, '(', 'k', 3, 0, 49, 69, (uint8_t)(48 + errorCorrection)};
+    write(level, sizeof(level));
+
+    // Function 180: store data in the symbol storage area
+    size_t count = length + 3;
+    const uint8_t store[] = {ESCPOS_GS, '(', 'k', (uint8_t)(count & 0xFF), (uint8_t)(count >> 8), 49, 80, 48};
+    write(store, sizeof(store));
+    return write(data, length);
+}
+
+EscPosEncoder& EscPosEncoder::qrCodePrint() {
+    const uint8_t cmd[] = {ESCPOS_GS, '(', 'k', 3, 0, 49, 81, 48};
+    return write(cmd, sizeof(cmd));
+}
+
+EscPosEncoder& EscPosEncoder::qrCodeTransmitSize() {
+    const uint8_t cmd[] = {ESCPOS_GS, '(', 'k', 3, 0, 49, 82, 48};
+    return write(cmd, sizeof(cmd));
+}
+
+EscPosEncoder& EscPosEncoder::barcode128(const char* data, size_t length, uint8_t heightDots, uint8_t moduleDots) {
+    const uint8_t setup[] = {
+        ESCPOS_GS, 'h', heightDots,
+        ESCPOS_GS, 'w', moduleDots,
+        ESCPOS_GS, 'H', 2,          // Human readable text below
+        ESCPOS_GS, 'f', 0           // in font A
+    };
+    write(setup, sizeof(setup));
+
+    // GS k 73 n: data starts with the code set ("{B"); a literal '{' is "{{"
+    uint8_t count = 2;
+    for (size_t i = 0; i < length; i++) {
+        count += data[i] == '{' ? 2 : 1;
+    }
+    const uint8_t cmd[] = {ESCPOS_GS, 'k', 73, count, '{', 'B'};
+    write(cmd, sizeof(cmd));
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] == '{') write('{');
+        write((uint8_t)data[i]);
+    }
+    return *this;
+}
+
+EscPosEncoder& EscPosEncoder::defineCharacter(uint8_t code, uint8_t width, const uint8_t* columns) {
+    const uint8_t cmd[] = {ESCPOS_ESC, '&', 3, code, code, width};
+    write(cmd, sizeof(cmd));
+    return write(columns, (size_t)width * 3);
+}
+
+EscPosEncoder& EscPosEncoder::bitImage24(uint16_t width, const uint8_t* columns) {
+    const uint8_t cmd[] = {ESCPOS_ESC, '*', 33, (uint8_t)(width & 0xFF), (uint8_t)(width >> 8)};
+    write(cmd, sizeof(cmd));
+    return write(columns, (size_t)width * 3);
+}
@@ -0,0 +1,256 @@
+#include "EscPosTimingModel.h"
+#include "EscPosEncoder.h"
+#include "QrEncoder.h"
+
+static const uint8_t TEXT_HEIGHT_DOTS = 24;     // Font A
+static const uint8_t BARCODE_TEXT_DOTS = 24;    // Human readable line under a barcode
+static const uint8_t DEFAULT_BARCODE_HEIGHT = 162;
+
+EscPosTimingModel::EscPosTimingModel() {
+    reset();
+}
+
+void EscPosTimingModel::reset() {
+    state = PARSE_TEXT;
+    headerLength = 0;
+    headerNeeded = 0;
+    skipRemaining = 0;
+    charsRemaining = 0;
+    charHeight = 0;
+    lineSpacing = PRINTER_LINE_SPACING_DOTS;
+    doubleHeight = false;
+    lineHeight = 0;
+    barcodeHeight = DEFAULT_BARCODE_HEIGHT;
+    barcodeText = false;
+    qrModuleDots = 3;
+    qrLength = 0;
+    bytes = 0;
+    lines = 0;
+    paperDots = 0;
+    rasterRows = 0;
+    cuts = 0;
+}
+
+uint8_t EscPosTimingModel::headerLengthFor(uint8_t prefix, uint8_t code) const {
+    if (prefix == ESCPOS_ESC) {
+        switch (code) {
+            case '@':
+            case '2':
+                return 2;
+            case '&':                 // ESC & y c1 c2
+            case '*':                 // ESC * m nL nH
+            case '7':                 // ESC 7 n1 n2 n3
+                return 5;
+            default:
+                return 3;
+        }
+    }
+    if (prefix == ESCPOS_GS) {
+        switch (code) {
+            case 'v': return 8;       // GS v 0 m xL xH yL yH
+            case '(': return 5;       // GS ( fn pL pH
+            default: return 3;
+        }
+    }
+    return 3;                         // DLE EOT n, DC2 # n
+}
+
+void EscPosTimingModel::lineFeed() {
+    paperDots += lineHeight > lineSpacing ? lineHeight : lineSpacing;
+    lineHeight = 0;
+    lines++;
+}
+
+void EscPosTimingModel::feed(const uint8_t* data, size_t length) {
+    bytes += length;
+
+    for (size_t i = 0; i < length; i++) {
+        uint8_t b = data[i];
+
+        switch (state) {
+            case PARSE_TEXT:
+                if (b == ESCPOS_ESC || b == ESCPOS_GS || b == ESCPOS_DLE || b == ESCPOS_DC2) {
+                    header[0] = b;
+                    headerLength = 1;
+                    headerNeeded = 2;
+                    state = PARSE_COMMAND;
+                } else if (b == '\n') {
+                    lineFeed();
+                } else if (b >= 0x20) {
+                    uint8_t height = doubleHeight ? TEXT_HEIGHT_DOTS * 2 : TEXT_HEIGHT_DOTS;
+                    if (height > lineHeight) lineHeight = height;
+                }
+                break;
+
+            case PARSE_COMMAND:
+                header[headerLength++] = b;
+                if (headerLength == 2) {
+                    headerNeeded = headerLengthFor(header[0], b);
+                }
+                if (headerLength >= headerNeeded) {
+                    command();
+                }
+                break;
+
+            case PARSE_SKIP:
+                if (--skipRemaining == 0) {
+                    state = charsRemaining > 0 ? PARSE_CHAR_WIDTH : PARSE_TEXT;
+                }
+                break;
+
+            case PARSE_SKIP_TO_NUL:
+                if (b == 0) {
+                    state = PARSE_TEXT;
+                }
+                break;
+
+            case PARSE_CHAR_WIDTH:
+                // x, then x columns of charHeight bytes
+                charsRemaining--;
+                skipRemaining = (uint32_t)b * charHeight;
+                state = skipRemaining > 0 ? PARSE_SKIP : (charsRemaining > 0 ? PARSE_CHAR_WIDTH : PARSE_TEXT);
+                break;
+        }
+    }
+}
+
+void EscPosTimingModel::command() {
+    uint8_t prefix = header[0];
+    uint8_t code = header[1];
+    uint32_t skip = 0;
+    state = PARSE_TEXT;
+
+    if (prefix == ESCPOS_ESC) {
+        switch (code) {
+            case '@':
+                lineSpacing = PRINTER_LINE_SPACING_DOTS;
+                doubleHeight = false;
+                barcodeHeight = DEFAULT_BARCODE_HEIGHT;
+                barcodeText = false;
+                break;
+            case '2':
+                lineSpacing = PRINTER_LINE_SPACING_DOTS;
+                break;
+            case '3':
+                lineSpacing = header[2];
+                break;
+            case '!':
+                doubleHeight = (header[2] & 0x10) != 0;
+                break;
+            case 'J':
+                paperDots += header[2];
+                lineHeight = 0;
+                break;
+            case 'd':
+                for (uint8_t n = 0; n < header[2]; n++) lineFeed();
+                break;
+            case '*': {
+                // Inline bit image: 24 dots tall in the 24-dot modes
+                bool tall = header[2] >= 32;
+                uint16_t width = header[3] | (header[4] << 8);
+                skip = (uint32_t)width * (tall ? 3 : 1);
+                uint8_t height = tall ? 24 : 8;
+                if (height > lineHeight) lineHeight = height;
+                break;
+            }
+            case '&':
+                charHeight = header[2];
+                charsRemaining = header[4] >= header[3] ? header[4] - header[3] + 1 : 0;
+                if (charsRemaining > 0) state = PARSE_CHAR_WIDTH;
+                return;
+            default:
+                break;
+        }
+    } else if (prefix == ESCPOS_GS) {
+        switch (code) {
+            case 'V':
+                // Function B (m >= 65) carries a feed amount
+                if (header[2] >= 65 && headerLength == 3) {
+                    headerNeeded = 4;
+                    state = PARSE_COMMAND;
+                    return;
+                }
+                cuts++;
+                break;
+            case 'h':
+                barcodeHeight = header[2];
+                break;
+            case 'H':
+                barcodeText = header[2] != 0;
+                break;
+            case 'k':
+                if (header[2] >= 65 && headerLength == 3) {
+                    headerNeeded = 4;
+                    state = PARSE_COMMAND;
+                    return;
+                }
+                paperDots += barcodeHeight + (barcodeText ? BARCODE_TEXT_DOTS : 0);
+                if (header[2] < 65) {
+                    state = PARSE_SKIP_TO_NUL;
+                    return;
+                }
+                skip = header[3];
+                break;
+            case 'v': {
+                uint16_t widthBytes = header[4] | (header[5] << 8);
+                uint16_t rows = header[6] | (header[7] << 8);
+                paperDots += rows;
+                rasterRows += rows;
+                skip = (uint32_t)widthBytes * rows;
+                break;
+            }
+            case '(': {
+                uint16_t length = header[3] | (header[4] << 8);
+                if (header[2] == 'k' && length >= 3) {
+                    // Read cn fn m to follow the QR code settings
+                    if (headerLength == 5) {
+                        headerNeeded = 8;
+                        state = PARSE_COMMAND;
+                        return;
+                    }
+                    if (header[5] == 49) {
+                        if (header[6] == 67) {
+                            qrModuleDots = header[7];
+                        } else if (header[6] == 80) {
+                            qrLength = length - 3;
+                        } else if (header[6] == 81) {
+                            uint8_t version = QrEncoder::versionFor(qrLength, QR_ERROR_CORRECTION);
+                            if (version == 0) version = QR_MAX_VERSION;
+                            paperDots += (uint32_t)(version * 4 + 17) * qrModuleDots;
+                        }
+                    }
+                    skip = length - 3;
+                } else {
+                    skip = length;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    if (skip > 0) {
+        skipRemaining = skip;
+        state = PARSE_SKIP;
+    }
+}
+
+uint32_t EscPosTimingModel::getUartMs(uint32_t baud) const {
+    // 8N1: 10 bits per byte
+    return baud > 0 ? (uint32_t)(((uint64_t)bytes * 10UL * 1000UL) / baud) : 0;
+}
+
+uint32_t EscPosTimingModel::getHeadMs() const {
+    return (uint32_t)(((uint64_t)paperDots * RASTER_ROW_TIME_US) / 1000UL);
+}
+
+uint32_t EscPosTimingModel::getCutMs() const {
+    return (uint32_t)cuts * PRINTER_CUT_MS;
+}
+
+uint32_t EscPosTimingModel::getEstimatedMs(uint32_t baud) const {
+    uint32_t uartMs = getUartMs(baud);
+    uint32_t headMs = getHeadMs();
+    return (uartMs > headMs ? uartMs : headMs) + getCutMs();
+}
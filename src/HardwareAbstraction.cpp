@@ -1,17 +1,44 @@
 #include "HardwareAbstraction.h"
 #include <ArduinoJson.h>
+#include <driver/uart.h>
+#include <Preferences.h>
 
 const char* HardwareAbstraction::TAG = "HAL";
 
+static const uint32_t DOSE_TIMER_SLACK_US = 1000;      // esp_timer fires at or just after the deadline
+static const uint32_t DOSE_BACKSTOP_MARGIN_MS = 100;   // loop() stops the pump if the timer didn't
+static const uint32_t DOSE_TIMER_RETRY_US = 200;       // Pump lock busy at pump-off: fire again this soon
+
 HardwareAbstraction::HardwareAbstraction() 
-    : printerSerial(nullptr), tft(nullptr), ledState(false), pumpState(false),
+    : printerSerial(nullptr), printerBaud(THERMAL_PRINTER_BAUD), tft(nullptr), ledState(false), pumpState(false),
       moisturePercent(0.0), irDetected(false), lightPercent(0.0),
-      ledBrightness(0), sanitizerLevel(0.0),
-      totalDispenses(0), lastDispenseTime(0), dispenseStartTime(0),
-      dispensing(false), autoBrightnessEnabled(true) {
+      totalDispenses(0), lastDispenseTime(0), dispenseStartTime(0), pumpStartMicros(0),
+      dispensing(false), autoBrightnessEnabled(true),
+      doseMs(DISPENSE_DOSE_MS), activeDoseMs(0), pumpOffTimer(nullptr), pumpRampTimer(nullptr),
+      doseEndUnlogged(false) {
+    pumpLock = xSemaphoreCreateMutex();
+    displayLock = xSemaphoreCreateMutex();
+    memset(&doseStats, 0, sizeof(doseStats));
+    
+    Preferences prefs;
+    if (prefs.begin(DISPENSER_NVS_NAMESPACE, true)) {
+        uint32_t saved = prefs.getUInt("doseMs", 0);
+        if (saved >= DISPENSE_MIN_DOSE_MS && saved <= MAX_DISPENSE_DURATION_MS) {
+            doseMs = saved;
+        }
+        prefs.end();
+    }
 }
 
 HardwareAbstraction::~HardwareAbstraction() {
+    if (pumpOffTimer) {
+        esp_timer_stop(pumpOffTimer);
+        esp_timer_delete(pumpOffTimer);
+    }
+    if (pumpRampTimer) {
+        esp_timer_stop(pumpRampTimer);
+        esp_timer_delete(pumpRampTimer);
+    }
     if (printerSerial) {
         printerSerial->end();
         delete printerSerial;
@@ -46,9 +73,11 @@ bool HardwareAbstraction::initialize() {
     // Initialize touch screen
     initializeTouch();
     
-    // Initialize sanitizer level (will be calibrated later)
-    sanitizerLevel = random(30, 95);
-    Logger::info(TAG, "Sanitizer level initialized: " + String(sanitizerLevel, 1) + "%");
+    // Sanitizer level from NVS (volume used since the last refill)
+    sanitizer.begin();
+    
+    // Analog sensors sample in the background from here on
+    sensorSampler.begin();
     
     // Read initial sensor values
     readMoistureSensor();
@@ -80,10 +109,31 @@ bool HardwareAbstraction::initializePins() {
     ledcSetup(LED_PWM_CHANNEL, LED_PWM_FREQUENCY, LED_PWM_RESOLUTION);
     ledcAttachPin(LED_PWM_PIN, LED_PWM_CHANNEL);
     ledcWrite(LED_PWM_CHANNEL, 0);  // Start with LED off (PWM will override digital state)
+    ledDimmer.begin();              // Gamma LUT and hardware fade on the LED channel
+    
+    // Pump MOSFET on its own LEDC channel for soft start
+    ledcSetup(PUMP_PWM_CHANNEL, PUMP_PWM_FREQUENCY, PUMP_PWM_RESOLUTION);
+    ledcAttachPin(SANITIZER_PUMP_PIN, PUMP_PWM_CHANNEL);
+    ledcWrite(PUMP_PWM_CHANNEL, 0);
+    
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.callback = handlePumpOff;
+    timerArgs.name = "pumpOff";
+    if (esp_timer_create(&timerArgs, &pumpOffTimer) != ESP_OK) {
+        pumpOffTimer = nullptr;
+        Logger::error(TAG, "Failed to create pump timer - doses end from loop()");
+    }
+    timerArgs.callback = handlePumpRamp;
+    timerArgs.name = "pumpRamp";
+    if (esp_timer_create(&timerArgs, &pumpRampTimer) != ESP_OK) {
+        pumpRampTimer = nullptr;
+    }
     
     // Set initial states (all outputs LOW = OFF)
     digitalWrite(LED_PIN, LOW);
-    digitalWrite(SANITIZER_PUMP_PIN, LOW);  // Pump OFF initially
+    ledcWrite(PUMP_PWM_CHANNEL, 0);  // Pump OFF initially
     
     // Test LED briefly to verify it works with external power
     // This helps diagnose if the LED pin is functioning
@@ -97,11 +147,10 @@ bool HardwareAbstraction::initializePins() {
     
     ledState = false;
     pumpState = false;
-    ledBrightness = 0;
     
     Logger::debug(TAG, "GPIO pins configured successfully");
     Logger::debug(TAG, "LED (GPIO " + String(LED_PIN) + ") tested with 2 blinks");
-    Logger::debug(TAG, "Pump control pin (GPIO " + String(SANITIZER_PUMP_PIN) + ") set to OUTPUT mode");
+    Logger::debug(TAG, "Pump control pin (GPIO " + String(SANITIZER_PUMP_PIN) + ") on LEDC channel " + String(PUMP_PWM_CHANNEL));
     Logger::debug(TAG, "LED PWM initialized on pin " + String(LED_PWM_PIN) + " (channel " + String(LED_PWM_CHANNEL) + ")");
     return true;
 }
@@ -119,6 +168,8 @@ bool HardwareAbstraction::initializePrinter() {
     delay(200);  // Allow pins to stabilize
     
     printerSerial = new HardwareSerial(2);
+    // Buffer TX in software so a whole print job can be queued with one write
+    printerSerial->setTxBufferSize(PRINTER_TX_BUFFER_SIZE);
     // Try inverted serial logic - common issue with thermal printers
     printerSerial->begin(THERMAL_PRINTER_BAUD, SERIAL_8N1, THERMAL_RX_PIN, THERMAL_TX_PIN, true);
     // Extended delay for external power stabilization
@@ -239,67 +290,88 @@ void HardwareAbstraction::setLED(bool state) {
     }
 }
 
-bool HardwareAbstraction::startPump() {
-    Logger::debug(TAG, "startPump() called - Current state: dispensing=" + String(dispensing) + ", pumpState=" + String(pumpState));
-    
+bool HardwareAbstraction::startPump(uint32_t requestedMs) {
+    uint32_t detailMs = 0;
+    xSemaphoreTake(pumpLock, portMAX_DELAY);
+    PumpStartResult result = startPumpLocked(requestedMs, detailMs);
+    xSemaphoreGive(pumpLock);
+    
+    switch (result) {
+        case PUMP_STARTED:
+            Logger::info(TAG, "✅ Pump started for " + String(detailMs) + "ms - GPIO " + String(SANITIZER_PUMP_PIN));
+            return true;
+        case PUMP_ALREADY_RUNNING:
+            Logger::warn(TAG, "Pump already running");
+            return false;
+        case PUMP_COOLING_DOWN:
+        default:
+            Logger::warn(TAG, "Cooldown active: " + String(detailMs) + "ms remaining");
+            return false;
+    }
+}
+
+HardwareAbstraction::PumpStartResult HardwareAbstraction::startPumpLocked(uint32_t requestedMs, uint32_t& detailMs) {
     if (dispensing) {
-        Logger::warn(TAG, "Pump already running");
-        return false;
+        return PUMP_ALREADY_RUNNING;
     }
     
     if (!checkCooldown()) {
-        unsigned long remainingCooldown = DISPENSE_COOLDOWN_MS - (millis() - lastDispenseTime);
-        Logger::warn(TAG, "Cooldown active: " + String(remainingCooldown) + "ms remaining");
-        return false;
+        detailMs = DISPENSE_COOLDOWN_MS - (millis() - lastDispenseTime);
+        return PUMP_COOLING_DOWN;
     }
     
-    Logger::debug(TAG, "Setting GPIO " + String(SANITIZER_PUMP_PIN) + " to HIGH");
-    digitalWrite(SANITIZER_PUMP_PIN, HIGH);
-    delay(10);  // Small delay to ensure pin state settles
-    
-    // Verify the pin state multiple times to ensure it's actually HIGH
-    int pinState1 = digitalRead(SANITIZER_PUMP_PIN);
-    delay(5);
-    int pinState2 = digitalRead(SANITIZER_PUMP_PIN);
+    // Anything shorter than a real dose (0, or a command's "1") means the default
+    uint32_t dose = requestedMs >= DISPENSE_MIN_DOSE_MS ? requestedMs : doseMs;
+    if (dose > MAX_DISPENSE_DURATION_MS) dose = MAX_DISPENSE_DURATION_MS;
     
-    if (pinState1 == HIGH && pinState2 == HIGH) {
-        Logger::info(TAG, "✅ GPIO " + String(SANITIZER_PUMP_PIN) + " confirmed HIGH (MOSFET should be switching)");
-    } else {
-        Logger::error(TAG, "❌ GPIO " + String(SANITIZER_PUMP_PIN) + " state inconsistent! Read: " + String(pinState1) + ", " + String(pinState2));
+    // Soft start ramps the duty up from the ramp timer; otherwise full on
+    ledcWrite(PUMP_PWM_CHANNEL, PUMP_SOFT_START_MS > 0 && pumpRampTimer ? PUMP_SOFT_START_DUTY : 255);
+    pumpStartMicros = micros();
+    if (PUMP_SOFT_START_MS > 0 && pumpRampTimer) {
+        esp_timer_start_periodic(pumpRampTimer, (uint64_t)PUMP_RAMP_STEP_MS * 1000ULL);
+    }
+    if (pumpOffTimer) {
+        esp_timer_stop(pumpOffTimer);  // A pump-off retry may still be armed
+        esp_timer_start_once(pumpOffTimer, (uint64_t)dose * 1000ULL);
     }
     
     pumpState = true;
     dispensing = true;
+    activeDoseMs = dose;
     dispenseStartTime = millis();
-    
-    Logger::info(TAG, "✅ Pump started - GPIO " + String(SANITIZER_PUMP_PIN) + " = HIGH");
-    return true;
+    detailMs = dose;
+    return PUMP_STARTED;
 }
 
 bool HardwareAbstraction::stopPump() {
-    Logger::debug(TAG, "stopPump() called - Current state: dispensing=" + String(dispensing) + ", pumpState=" + String(pumpState));
+    xSemaphoreTake(pumpLock, portMAX_DELAY);
+    bool stopped = stopPumpLocked(false);
+    DoseStats stats = doseStats;
+    xSemaphoreGive(pumpLock);
     
-    if (!dispensing) {
+    if (stopped) {
+        logPumpStopped(stats);
+    } else {
         Logger::debug(TAG, "Pump already stopped");
-        // Still ensure pin is LOW even if we think it's stopped
-        digitalWrite(SANITIZER_PUMP_PIN, LOW);
-        pumpState = false;
-        return false;
     }
+    return stopped;
+}
+
+void HardwareAbstraction::logPumpStopped(const DoseStats& stats) const {
+    Logger::info(TAG, "✅ Pump stopped after " + String(stats.lastOnUs / 1000.0, 1) + "ms of " +
+                      String(stats.lastDoseMs) + "ms (total dispenses: " + String(totalDispenses) + ")");
+}
+
+bool HardwareAbstraction::stopPumpLocked(bool doseEnded) {
+    if (pumpRampTimer) esp_timer_stop(pumpRampTimer);
+    if (pumpOffTimer && !doseEnded) esp_timer_stop(pumpOffTimer);
+    // Off even if we think it's stopped
+    ledcWrite(PUMP_PWM_CHANNEL, 0);
+    uint32_t onUs = micros() - pumpStartMicros;
     
-    Logger::debug(TAG, "Setting GPIO " + String(SANITIZER_PUMP_PIN) + " to LOW");
-    digitalWrite(SANITIZER_PUMP_PIN, LOW);
-    delay(10);  // Small delay to ensure pin state settles
-    
-    // Verify the pin state multiple times to ensure it's actually LOW
-    int pinState1 = digitalRead(SANITIZER_PUMP_PIN);
-    delay(5);
-    int pinState2 = digitalRead(SANITIZER_PUMP_PIN);
-    
-    if (pinState1 == LOW && pinState2 == LOW) {
-        Logger::info(TAG, "✅ GPIO " + String(SANITIZER_PUMP_PIN) + " confirmed LOW (MOSFET should be off)");
-    } else {
-        Logger::error(TAG, "❌ GPIO " + String(SANITIZER_PUMP_PIN) + " state inconsistent! Read: " + String(pinState1) + ", " + String(pinState2));
+    if (!dispensing) {
+        pumpState = false;
+        return false;
     }
     
     pumpState = false;
@@ -307,21 +379,74 @@ bool HardwareAbstraction::stopPump() {
     lastDispenseTime = millis();
     totalDispenses++;
     
-    unsigned long duration = lastDispenseTime - dispenseStartTime;
-    Logger::info(TAG, "✅ Pump stopped (duration: " + String(duration) + "ms, total dispenses: " + String(totalDispenses) + ")");
-    
+    sanitizer.recordDispense(onUs);
+    doseStats.lastDoseMs = activeDoseMs;
+    doseStats.lastOnUs = onUs;
+    if (doseEnded) {
+        int32_t jitterUs = (int32_t)onUs - (int32_t)(activeDoseMs * 1000UL);
+        if (doseStats.doses == 0 || jitterUs < doseStats.jitterMinUs) doseStats.jitterMinUs = jitterUs;
+        if (doseStats.doses == 0 || jitterUs > doseStats.jitterMaxUs) doseStats.jitterMaxUs = jitterUs;
+        doseStats.jitterAbsTotalUs += jitterUs < 0 ? -jitterUs : jitterUs;
+        doseStats.doses++;
+    } else {
+        doseStats.stoppedEarly++;
+    }
     return true;
 }
 
+void HardwareAbstraction::handlePumpOff(void* param) {
+    HardwareAbstraction* self = static_cast<HardwareAbstraction*>(param);
+    // Never block the esp_timer task: if a start or stop holds the lock,
+    // come back in DOSE_TIMER_RETRY_US (that holder may end the dose itself)
+    if (xSemaphoreTake(self->pumpLock, 0) != pdTRUE) {
+        esp_timer_start_once(self->pumpOffTimer, DOSE_TIMER_RETRY_US);
+        return;
+    }
+    // A stop + restart may have happened since the timer was armed; only
+    // end a dose that is actually due
+    uint32_t elapsedUs = micros() - self->pumpStartMicros;
+    if (self->dispensing && elapsedUs + DOSE_TIMER_SLACK_US >= self->activeDoseMs * 1000UL) {
+        self->stopPumpLocked(true);
+        self->doseEndUnlogged = true;  // No String building here; loop() logs it
+    }
+    xSemaphoreGive(self->pumpLock);
+}
+
+void HardwareAbstraction::handlePumpRamp(void* param) {
+    HardwareAbstraction* self = static_cast<HardwareAbstraction*>(param);
+    // Skip a step rather than hold up other timers while the pump is
+    // being started or stopped
+    if (xSemaphoreTake(self->pumpLock, 0) != pdTRUE) {
+        return;
+    }
+    if (self->pumpState) {
+        uint32_t elapsedUs = micros() - self->pumpStartMicros;
+        if (elapsedUs >= (uint32_t)PUMP_SOFT_START_MS * 1000UL) {
+            ledcWrite(PUMP_PWM_CHANNEL, 255);
+            esp_timer_stop(self->pumpRampTimer);
+        } else {
+            ledcWrite(PUMP_PWM_CHANNEL, PUMP_SOFT_START_DUTY +
+                      (uint32_t)(255 - PUMP_SOFT_START_DUTY) * elapsedUs / (PUMP_SOFT_START_MS * 1000UL));
+        }
+    }
+    xSemaphoreGive(self->pumpLock);
+}
+
 unsigned long HardwareAbstraction::getDispenseDuration() const {
     if (!dispensing) return 0;
     return millis() - dispenseStartTime;
 }
 
 bool HardwareAbstraction::checkDispenseTimeout() {
+    if (doseEndUnlogged) {
+        doseEndUnlogged = false;
+        logPumpStopped(getDoseStats());
+    }
+    
     if (!dispensing) return false;
     
-    if (getDispenseDuration() >= MAX_DISPENSE_DURATION_MS) {
+    // Backstop only - the dose timer normally stops the pump on time
+    if (getDispenseDuration() >= activeDoseMs + DOSE_BACKSTOP_MARGIN_MS) {
         Logger::warn(TAG, "Dispense timeout reached, stopping pump");
         stopPump();
         return true;
@@ -329,19 +454,40 @@ bool HardwareAbstraction::checkDispenseTimeout() {
     return false;
 }
 
+bool HardwareAbstraction::setDoseMs(uint32_t ms) {
+    if (ms < DISPENSE_MIN_DOSE_MS || ms > MAX_DISPENSE_DURATION_MS) {
+        return false;
+    }
+    doseMs = ms;
+    Preferences prefs;
+    if (prefs.begin(DISPENSER_NVS_NAMESPACE, false)) {
+        prefs.putUInt("doseMs", doseMs);
+        prefs.end();
+    }
+    Logger::info(TAG, "Dose set to " + String(doseMs) + "ms");
+    return true;
+}
+
+DoseStats HardwareAbstraction::getDoseStats() const {
+    xSemaphoreTake(pumpLock, portMAX_DELAY);
+    DoseStats stats = doseStats;
+    xSemaphoreGive(pumpLock);
+    return stats;
+}
+
 bool HardwareAbstraction::checkCooldown() const {
     if (lastDispenseTime == 0) return true;
     return (millis() - lastDispenseTime) >= DISPENSE_COOLDOWN_MS;
 }
 
 float HardwareAbstraction::readMoistureSensor() {
-    int rawValue = analogRead(MOISTURE_SENSOR_PIN);
-    moisturePercent = 100.0 - ((float)rawValue * 100.0 / 4095.0);
+    float rawValue = sensorSampler.getFiltered(SENSOR_MOISTURE);
+    moisturePercent = 100.0 - (rawValue * 100.0 / 4095.0);
     
     if (moisturePercent < 0) moisturePercent = 0;
     if (moisturePercent > 100) moisturePercent = 100;
     
-    Logger::verbose(TAG, "Moisture sensor: " + String(moisturePercent, 1) + "% (raw: " + String(rawValue) + ")");
+    Logger::verbose(TAG, "Moisture sensor: " + String(moisturePercent, 1) + "% (raw: " + String(rawValue, 0) + ")");
     return moisturePercent;
 }
 
@@ -354,15 +500,15 @@ bool HardwareAbstraction::readIRSensor() {
 }
 
 float HardwareAbstraction::readLightSensor() {
-    int rawValue = analogRead(LIGHT_SENSOR_PIN);
+    float rawValue = sensorSampler.getFiltered(SENSOR_LIGHT);
     // LM393 typically outputs higher values in darkness, lower in bright light
     // Convert to percentage: 0% = dark, 100% = bright
-    lightPercent = ((float)rawValue * 100.0 / 4095.0);
+    lightPercent = (rawValue * 100.0 / 4095.0);
     
     if (lightPercent < 0) lightPercent = 0;
     if (lightPercent > 100) lightPercent = 100;
     
-    Logger::verbose(TAG, "Light sensor: " + String(lightPercent, 1) + "% (raw: " + String(rawValue) + ")");
+    Logger::verbose(TAG, "Light sensor: " + String(lightPercent, 1) + "% (raw: " + String(rawValue, 0) + ")");
     return lightPercent;
 }
 
@@ -376,26 +522,21 @@ void HardwareAbstraction::updateLEDBrightness() {
     // Read light sensor first
     readLightSensor();
     
-    // Inverse relationship: dark = bright LED, bright = dim LED
-    // lightPercent: 0% = dark, 100% = bright
-    // LED brightness: 0 = off, 255 = full brightness
-    float inverseLight = 100.0 - lightPercent;
-    uint8_t brightness = (uint8_t)((inverseLight / 100.0) * 255.0);
-    
-    setLEDBrightness(brightness);
+    // Inverse relationship: dark = bright LED, bright = dim LED. Small
+    // light changes are ignored; a change fades in hardware
+    if (ledDimmer.setFromLight(lightPercent)) {
+        Logger::verbose(TAG, "Auto-brightness: light " + String(lightPercent, 1) + "% -> LED " + String(ledDimmer.getLevel()) + "/255");
+    }
 }
 
 void HardwareAbstraction::setAutoBrightness(bool enabled) {
     autoBrightnessEnabled = enabled;
+    ledDimmer.resetLightReference();  // Re-enabling applies the current light level straight away
     Logger::info(TAG, "Auto-brightness " + String(enabled ? "enabled" : "disabled"));
 }
 
-void HardwareAbstraction::setLEDBrightness(uint8_t brightness) {
-    // Clamp brightness to 0-255
-    if (brightness > 255) brightness = 255;
-    
-    ledBrightness = brightness;
-    ledcWrite(LED_PWM_CHANNEL, brightness);
+void HardwareAbstraction::setLEDBrightness(uint8_t brightness, uint16_t fadeMs) {
+    ledDimmer.setLevel(brightness, fadeMs);
     
     Logger::verbose(TAG, "LED brightness set to: " + String(brightness) + "/255 (" + String((brightness * 100) / 255) + "%)");
     
@@ -407,20 +548,12 @@ void HardwareAbstraction::setLEDBrightness(uint8_t brightness) {
 }
 
 void HardwareAbstraction::setSanitizerLevel(float level) {
-    if (level < 0) level = 0;
-    if (level > 100) level = 100;
-    sanitizerLevel = level;
-    Logger::debug(TAG, "Sanitizer level set to: " + String(level, 1) + "%");
-}
-
-void HardwareAbstraction::updateSanitizerLevel(float amount) {
-    sanitizerLevel -= amount;
-    if (sanitizerLevel < 0) sanitizerLevel = 0;
-    Logger::debug(TAG, "Sanitizer level updated: " + String(sanitizerLevel, 1) + "%");
+    sanitizer.setPercent(level);
+    Logger::debug(TAG, "Sanitizer level set to: " + String(sanitizer.getPercent(), 1) + "%");
 }
 
 void HardwareAbstraction::resetSanitizer() {
-    sanitizerLevel = 100.0;
+    sanitizer.refill();
     totalDispenses = 0;
     Logger::info(TAG, "Sanitizer reset to 100%");
 }
@@ -446,6 +579,42 @@ bool HardwareAbstraction::printerPrintln(const String& str) {
     return printerSerial->println(str) > 0;
 }
 
+bool HardwareAbstraction::printerWaitTxDone(uint32_t timeoutMs) {
+    if (!printerSerial) return false;
+    return uart_wait_tx_done(UART_NUM_2, pdMS_TO_TICKS(timeoutMs)) == ESP_OK;
+}
+
+int HardwareAbstraction::printerRead(uint32_t timeoutMs) {
+    if (!printerSerial) return -1;
+    unsigned long start = millis();
+    while (!printerSerial->available()) {
+        if (millis() - start >= timeoutMs) {
+            return -1;
+        }
+        delay(1);  // Yield to other tasks while the reply is on the wire
+    }
+    return printerSerial->read();
+}
+
+void HardwareAbstraction::printerFlushInput() {
+    if (!printerSerial) return;
+    while (printerSerial->available()) {
+        printerSerial->read();
+    }
+}
+
+bool HardwareAbstraction::setPrinterBaud(uint32_t baud) {
+    if (!printerSerial) return false;
+    // Changing the divisor mid-byte would garble what is still queued
+    uint32_t wireTimeMs = (uint32_t)((PRINTER_TX_BUFFER_SIZE * 10UL * 1000UL) / printerBaud);
+    printerWaitTxDone(wireTimeMs + PRINTER_DRAIN_MARGIN_MS);
+    printerSerial->updateBaudRate(baud);
+    printerBaud = baud;
+    printerFlushInput();  // Anything received at the old rate is noise now
+    Logger::debug(TAG, "Printer UART at " + String(baud) + " baud");
+    return true;
+}
+
 bool HardwareAbstraction::printerAvailable() const {
     return printerSerial != nullptr;
 }
@@ -455,7 +624,7 @@ void HardwareAbstraction::printDiagnostics() const {
     Logger::info(TAG, "HARDWARE DIAGNOSTICS");
     Logger::info(TAG, "========================================");
     Logger::info(TAG, "LED State: " + String(ledState ? "ON" : "OFF"));
-    Logger::info(TAG, "LED Brightness: " + String(ledBrightness) + "/255 (" + String((ledBrightness * 100) / 255) + "%)");
+    Logger::info(TAG, "LED Brightness: " + String(getLEDBrightness()) + "/255 (" + String((getLEDBrightness() * 100) / 255) + "%)");
     
     // Detailed pump diagnostics
     int pumpPinState = digitalRead(SANITIZER_PUMP_PIN);
@@ -475,7 +644,8 @@ void HardwareAbstraction::printDiagnostics() const {
     Logger::info(TAG, "IR Sensor: " + String(irDetected ? "DETECTED" : "CLEAR"));
     Logger::info(TAG, "Moisture: " + String(moisturePercent, 1) + "%");
     Logger::info(TAG, "Light Level: " + String(lightPercent, 1) + "%");
-    Logger::info(TAG, "Sanitizer Level: " + String(sanitizerLevel, 1) + "%");
+    Logger::info(TAG, "Sanitizer Level: " + String(sanitizer.getPercent(), 1) + "% (" +
+                      String(sanitizer.getRemainingMl(), 0) + "ml)");
     Logger::info(TAG, "Total Dispenses: " + String(totalDispenses));
     Logger::info(TAG, "Printer: " + String(printerAvailable() ? "READY" : "NOT AVAILABLE"));
     Logger::info(TAG, "========================================");
@@ -484,13 +654,13 @@ void HardwareAbstraction::printDiagnostics() const {
 String HardwareAbstraction::getStatusJSON() const {
     DynamicJsonDocument doc(512);
     doc["led"] = ledState;
-    doc["ledBrightness"] = ledBrightness;
+    doc["ledBrightness"] = getLEDBrightness();
     doc["pump"] = pumpState;
     doc["dispensing"] = dispensing;
     doc["irSensor"] = irDetected;
     doc["moisture"] = String(moisturePercent, 1);
     doc["light"] = String(lightPercent, 1);
-    doc["sanitizer"] = String(sanitizerLevel, 1);
+    doc["sanitizer"] = String(sanitizer.getPercent(), 1);
     doc["dispenses"] = totalDispenses;
     doc["printer"] = printerAvailable();
     
@@ -509,6 +679,14 @@ void HardwareAbstraction::displayDebugText(const String& text, uint16_t color, u
     Logger::debug(TAG, "Display debug: " + text);
 }
 
+bool HardwareAbstraction::lockDisplay(TickType_t wait) {
+    return xSemaphoreTake(displayLock, wait) == pdTRUE;
+}
+
+void HardwareAbstraction::unlockDisplay() {
+    xSemaphoreGive(displayLock);
+}
+
 void HardwareAbstraction::displayClear(uint16_t color) {
     if (!tft || !displayAvailable()) return;
     tft->fillScreen(color);
@@ -575,46 +753,34 @@ void HardwareAbstraction::displayTestText() {
 }
 
 bool HardwareAbstraction::initializeTouch() {
-    // Touch screen initialization - using config.h pins (not TFT_eSPI defines)
-    // TFT_eSPI touch support is disabled to avoid parallel mode conflict
-    Logger::debug(TAG, "Initializing touch screen (hardware pins only)...");
+    // XPT2046 on the display's SPI bus - using config.h pins (not TFT_eSPI defines)
+    Logger::debug(TAG, "Initializing touch screen...");
     Logger::debug(TAG, "  CS Pin: " + String(TOUCH_CS_PIN));
     Logger::debug(TAG, "  IRQ Pin: " + String(TOUCH_IRQ_PIN));
     
-    // Configure touch pins
-    pinMode(TOUCH_CS_PIN, OUTPUT);
-    digitalWrite(TOUCH_CS_PIN, HIGH);  // CS high = not selected
-    
-    pinMode(TOUCH_IRQ_PIN, INPUT_PULLUP);
+    if (!TOUCH_ENABLED) {
+        // Keep the controller off the bus
+        pinMode(TOUCH_CS_PIN, OUTPUT);
+        digitalWrite(TOUCH_CS_PIN, HIGH);  // CS high = not selected
+        pinMode(TOUCH_IRQ_PIN, INPUT_PULLUP);
+        return false;
+    }
     
-    Logger::info(TAG, "Touch screen pins configured (TFT_eSPI touch disabled)");
-    return true;
+    // Readings share displayLock with everything that draws
+    return touch.begin(tft, displayLock);
 }
 
 bool HardwareAbstraction::isTouchPressed() {
+    if (touch.isRunning()) {
+        return touch.isPressed();
+    }
     // IRQ pin goes LOW when touch is detected (active low)
     return digitalRead(TOUCH_IRQ_PIN) == LOW;
 }
 
 bool HardwareAbstraction::readTouch(int16_t* x, int16_t* y) {
-    if (!isTouchPressed()) {
-        return false;
-    }
-    
-    // Basic touch reading - for XPT2046 or similar controllers
-    // This is a simplified version - full implementation would require SPI communication
-    // For now, we'll return a basic reading
-    
-    // Note: Full touch controller implementation would require:
-    // 1. SPI communication with touch controller
-    // 2. Reading X and Y coordinates from touch controller registers
-    // 3. Calibration and coordinate transformation
-    
-    // Placeholder - return center of screen if touch detected
-    if (x) *x = tft ? tft->width() / 2 : 240;
-    if (y) *y = tft ? tft->height() / 2 : 160;
-    
-    return true;
+    // Latest filtered, calibrated position from the touch task
+    return touch.getLastPoint(x, y);
 }
 
 int HardwareAbstraction::getTouchIRQState() const {
@@ -1,15 +1,18 @@
 #include "HealthMonitor.h"
 #include <WiFi.h>
 #include <ArduinoJson.h>
+#include "PrinterService.h"
 #include "version.h"
 
 const char* HealthMonitor::TAG = "Health";
 
 HealthMonitor::HealthMonitor() 
-    : lastHealthCheck(0), healthCheckInterval(60000) {
+    : lastHealthCheck(0), healthCheckInterval(60000), printer(nullptr) {
     health.wifiConnected = false;
     health.firebaseHealthy = false;
     health.printerReady = false;
+    health.printerState = "unknown";
+    health.printerPaperNearEnd = false;
     health.uptime = 0;
     health.freeHeap = 0;
     health.minFreeHeap = 0;
@@ -35,6 +38,7 @@ void HealthMonitor::update() {
     checkWiFi();
     checkMemory();
     checkSystem();
+    checkPrinter();
     
     health.lastCheck = time(nullptr);
     lastHealthCheck = now;
@@ -70,6 +74,20 @@ void HealthMonitor::checkSystem() {
     health.uptime = millis();
 }
 
+void HealthMonitor::checkPrinter() {
+    if (!printer) {
+        health.printerReady = false;
+        health.printerState = "unknown";
+        return;
+    }
+    
+    // Status is polled by the print spooler; this just reads its latest snapshot
+    PrinterStatusSnapshot status = printer->getPrinterStatus().getSnapshot();
+    health.printerReady = printer->isReady() && status.canPrint;
+    health.printerState = PrinterStatus::stateToString(status.state);
+    health.printerPaperNearEnd = status.paperNearEnd;
+}
+
 String HealthMonitor::getHealthReport() const {
     String report;
     report += "========================================\n";
@@ -81,7 +99,10 @@ String HealthMonitor::getHealthReport() const {
     report += "  IP: " + health.ipAddress + "\n";
     report += "  RSSI: " + String(health.wifiRSSI) + " dBm\n";
     report += "Firebase: " + String(health.firebaseHealthy ? "HEALTHY" : "UNHEALTHY") + "\n";
-    report += "Printer: " + String(health.printerReady ? "READY" : "NOT READY") + "\n";
+    report += "Printer: " + String(health.printerReady ? "READY" : "NOT READY") + " (" + health.printerState + ")\n";
+    if (health.printerPaperNearEnd) {
+        report += "  Paper: NEAR END\n";
+    }
     report += "Memory:\n";
     report += "  Free Heap: " + String(health.freeHeap) + " bytes\n";
     report += "  Min Free: " + String(health.minFreeHeap) + " bytes\n";
@@ -103,6 +124,8 @@ String HealthMonitor::getHealthJSON() const {
     doc["wifi"]["rssi"] = health.wifiRSSI;
     doc["firebase"]["healthy"] = health.firebaseHealthy;
     doc["printer"]["ready"] = health.printerReady;
+    doc["printer"]["state"] = health.printerState;
+    doc["printer"]["paperNearEnd"] = health.printerPaperNearEnd;
     doc["memory"]["freeHeap"] = health.freeHeap;
     doc["memory"]["minFreeHeap"] = health.minFreeHeap;
     doc["memory"]["usagePercent"] = getMemoryUsagePercent();
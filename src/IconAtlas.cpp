@@ -0,0 +1,173 @@
+#include "IconAtlas.h"
+#include "TextSanitizer.h"
+
+// ESC * 33 nL nH header in front of each inline icon
+#define ICON_COMMAND_BYTES 5
+
+// Generated from 24x24 drawings; columns packed with PackBits
+// (n < 128: n + 1 literal bytes follow, n > 128: next byte repeats 257 - n times)
+
+// alarm
+static const uint8_t ICON_ALARM[] = {
+    0xFE, 0x00, 0x00, 0x18, 0xFF, 0x00, 0x00, 0x38, 0xFF, 0x00, 0x00, 0x78,
+    0xFF, 0x00, 0x1D, 0x70, 0xFC, 0x10, 0x63, 0x03, 0x30, 0x04, 0x00, 0xA0,
+    0x08, 0x00, 0x40, 0x18, 0x00, 0x40, 0x10, 0x00, 0x20, 0x30, 0x00, 0x20,
+    0x37, 0xF0, 0x20, 0x37, 0xF0, 0x20, 0x30, 0x10, 0x20, 0xFF, 0x10, 0x10,
+    0x20, 0x18, 0x10, 0x40, 0x08, 0x00, 0x40, 0x04, 0x00, 0xA0, 0x63, 0x03,
+    0x30, 0x70, 0xFC, 0x10, 0x78, 0xFF, 0x00, 0x00, 0x38, 0xFF, 0x00, 0x00,
+    0x18, 0xFC, 0x00
+};
+
+// check
+static const uint8_t ICON_CHECK[] = {
+    0xFE, 0x00, 0x41, 0x7F, 0xFF, 0xE0, 0x40, 0x00, 0x20, 0x40, 0x00, 0x20,
+    0x40, 0x00, 0x20, 0x40, 0x60, 0x20, 0x40, 0x70, 0x20, 0x40, 0x38, 0x20,
+    0x40, 0x1C, 0x20, 0x40, 0x0E, 0x20, 0x40, 0x07, 0x20, 0x40, 0x0E, 0x20,
+    0x40, 0x1C, 0x20, 0x40, 0x38, 0x20, 0x40, 0x70, 0x20, 0x40, 0xE0, 0x20,
+    0x41, 0xC0, 0x20, 0x43, 0x80, 0x20, 0x47, 0x00, 0x20, 0x4E, 0x00, 0x20,
+    0x5C, 0x00, 0x20, 0x40, 0x00, 0x20, 0x7F, 0xFF, 0xE0, 0xFE, 0x00
+};
+
+// gift
+static const uint8_t ICON_GIFT[] = {
+    0xF8, 0x00, 0x34, 0x01, 0xE0, 0x00, 0x01, 0x3F, 0xF0, 0x01, 0x20, 0x10,
+    0x19, 0x20, 0x10, 0x25, 0x20, 0x10, 0x23, 0x20, 0x10, 0x23, 0x20, 0x10,
+    0x13, 0x20, 0x10, 0x0F, 0xFF, 0xF0, 0x0F, 0xFF, 0xF0, 0x13, 0x20, 0x10,
+    0x23, 0x20, 0x10, 0x23, 0x20, 0x10, 0x25, 0x20, 0x10, 0x19, 0x20, 0x10,
+    0x01, 0x20, 0x10, 0x01, 0x3F, 0xF0, 0x01, 0xE0, 0xF7, 0x00
+};
+
+// balloon
+static const uint8_t ICON_BALLOON[] = {
+    0xF2, 0x00, 0x28, 0x0F, 0x80, 0x00, 0x1F, 0xC0, 0x00, 0x3F, 0xE0, 0x00,
+    0x3F, 0xF0, 0x00, 0x7F, 0xF1, 0x80, 0x7F, 0xFB, 0x48, 0x7F, 0xFE, 0x30,
+    0x67, 0xFC, 0x00, 0x63, 0xF8, 0x00, 0x63, 0xF0, 0x00, 0x33, 0xF0, 0x00,
+    0x3F, 0xE0, 0x00, 0x1F, 0xC0, 0x00, 0x0F, 0x80, 0xF1, 0x00
+};
+
+// party
+static const uint8_t ICON_PARTY[] = {
+    0xFC, 0x00, 0x00, 0x08, 0xFF, 0x00, 0x00, 0x38, 0xFF, 0x00, 0x07, 0xD8,
+    0x00, 0x03, 0x10, 0x00, 0x0C, 0x10, 0x00, 0xFF, 0x30, 0x1E, 0x00, 0xC1,
+    0x20, 0x01, 0x08, 0xA0, 0x03, 0xE4, 0x60, 0x07, 0xF2, 0x40, 0x08, 0x79,
+    0x40, 0x00, 0x3C, 0xC0, 0x22, 0x1F, 0x80, 0x14, 0x4F, 0x00, 0x04, 0x86,
+    0x00, 0x03, 0x10, 0x00, 0x20, 0xFF, 0x00, 0x03, 0x40, 0x20, 0x00, 0x0A,
+    0xFF, 0x00, 0x01, 0x10, 0x80, 0xF7, 0x00
+};
+
+// cart
+static const uint8_t ICON_CART[] = {
+    0x00, 0x20, 0xFF, 0x00, 0x00, 0x20, 0xFF, 0x00, 0x00, 0x30, 0xFF, 0x00,
+    0x00, 0x1E, 0xFF, 0x00, 0x34, 0x07, 0xC0, 0x00, 0x04, 0xB8, 0x00, 0x04,
+    0x96, 0x60, 0x07, 0xF2, 0xF0, 0x04, 0x92, 0xF0, 0x04, 0x92, 0xF0, 0x07,
+    0xF2, 0x60, 0x04, 0x92, 0x00, 0x04, 0x92, 0x00, 0x07, 0xF2, 0x00, 0x04,
+    0x92, 0x00, 0x04, 0x92, 0x00, 0x07, 0xF2, 0x60, 0x04, 0xA2, 0xF0, 0x05,
+    0xC2, 0xF0, 0x06, 0x82, 0xF0, 0x00, 0x02, 0x60, 0x00, 0x02, 0xFF, 0x00,
+    0x00, 0x02, 0xFD, 0x00
+};
+#define ICON(cp, data) { cp, data, (uint8_t)sizeof(data) }
+
+// Sorted by codepoint - checked at compile time below
+static constexpr IconAtlasEntry ICON_ATLAS[] = {
+    ICON(0x023F0, ICON_ALARM),      // ⏰
+    ICON(0x02705, ICON_CHECK),      // ✅
+    ICON(0x1F381, ICON_GIFT),       // 🎁
+    ICON(0x1F388, ICON_BALLOON),    // 🎈
+    ICON(0x1F389, ICON_PARTY),      // 🎉
+    ICON(0x1F6D2, ICON_CART),       // 🛒
+};
+
+static constexpr size_t ICON_ATLAS_SIZE = sizeof(ICON_ATLAS) / sizeof(ICON_ATLAS[0]);
+
+static constexpr bool isAtlasSorted(size_t i) {
+    return i + 1 >= ICON_ATLAS_SIZE ||
+           (ICON_ATLAS[i].codepoint < ICON_ATLAS[i + 1].codepoint && isAtlasSorted(i + 1));
+}
+
+static_assert(isAtlasSorted(0), "ICON_ATLAS must be sorted by codepoint for binary search");
+
+IconAtlas::IconAtlas()
+    : useCounter(0), hits(0), misses(0), iconsPrinted(0), iconBytes(0), replacementBytes(0) {
+    for (int i = 0; i < ICON_CACHE_SLOTS; i++) {
+        cache[i].codepoint = 0;
+        cache[i].lastUse = 0;
+    }
+}
+
+const IconAtlasEntry* IconAtlas::findEntry(uint32_t codepoint) {
+    size_t low = 0;
+    size_t high = ICON_ATLAS_SIZE;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (ICON_ATLAS[mid].codepoint < codepoint) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low < ICON_ATLAS_SIZE && ICON_ATLAS[low].codepoint == codepoint) {
+        return &ICON_ATLAS[low];
+    }
+    return nullptr;
+}
+
+bool IconAtlas::contains(uint32_t codepoint) {
+    return findEntry(codepoint) != nullptr;
+}
+
+bool IconAtlas::unpack(const uint8_t* packed, size_t length, uint8_t* out, size_t outLength) {
+    size_t i = 0;
+    size_t o = 0;
+    while (i < length) {
+        uint8_t header = packed[i++];
+        if (header < 128) {
+            size_t count = header + 1;
+            if (i + count > length || o + count > outLength) return false;
+            memcpy(out + o, packed + i, count);
+            i += count;
+            o += count;
+        } else if (header > 128) {
+            size_t count = 257 - header;
+            if (i >= length || o + count > outLength) return false;
+            memset(out + o, packed[i++], count);
+            o += count;
+        }
+    }
+    return o == outLength;
+}
+
+const uint8_t* IconAtlas::get(uint32_t codepoint) {
+    const IconAtlasEntry* entry = findEntry(codepoint);
+    if (!entry) {
+        return nullptr;
+    }
+
+    useCounter++;
+    iconsPrinted++;
+    iconBytes += ICON_COMMAND_BYTES + ICON_BYTES;
+    const char* replacement = TextSanitizer::lookupReplacement(codepoint);
+    replacementBytes += replacement ? strlen(replacement) : 0;
+
+    // Hit: refresh; miss: decode into the least recently used slot
+    int victim = 0;
+    for (int i = 0; i < ICON_CACHE_SLOTS; i++) {
+        if (cache[i].codepoint == codepoint) {
+            cache[i].lastUse = useCounter;
+            hits++;
+            return cache[i].columns;
+        }
+        if (cache[i].lastUse < cache[victim].lastUse) {
+            victim = i;
+        }
+    }
+
+    misses++;
+    CacheSlot& slot = cache[victim];
+    if (!unpack(entry->packed, entry->packedLength, slot.columns, ICON_BYTES)) {
+        slot.codepoint = 0;
+        return nullptr;
+    }
+    slot.codepoint = codepoint;
+    slot.lastUse = useCounter;
+    return slot.columns;
+}
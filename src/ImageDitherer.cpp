@@ -0,0 +1,149 @@
+#include "ImageDitherer.h"
+
+// Error rows are padded so the kernels can write left of x = 0 and up to
+// two pixels right of the last column without bounds checks
+#define DITHER_PAD_LEFT 1
+#define DITHER_PAD_RIGHT 2
+
+ImageDitherer::ImageDitherer()
+    : srcWidth(0), srcHeight(0), outWidth(0), outHeight(0), mode(DITHER_FLOYD_STEINBERG),
+      srcRow(nullptr), srcRowIndex(-1), outRowIndex(0), allocatedBytes(0) {
+    errorRows[0] = errorRows[1] = errorRows[2] = nullptr;
+}
+
+ImageDitherer::~ImageDitherer() {
+    end();
+}
+
+bool ImageDitherer::begin(uint16_t sourceWidth, uint16_t sourceHeight, uint16_t targetWidth, DitherMode ditherMode) {
+    end();
+
+    targetWidth -= targetWidth % 8;
+    if (sourceWidth == 0 || sourceHeight == 0 || targetWidth == 0) {
+        return false;
+    }
+
+    srcWidth = sourceWidth;
+    srcHeight = sourceHeight;
+    outWidth = targetWidth;
+    outHeight = (uint16_t)(((uint32_t)sourceHeight * targetWidth + sourceWidth / 2) / sourceWidth);
+    if (outHeight == 0) outHeight = 1;
+    mode = ditherMode;
+
+    // Floyd-Steinberg only looks one row ahead; Atkinson needs two
+    int rows = mode == DITHER_ATKINSON ? 3 : 2;
+    size_t rowBytes = (outWidth + DITHER_PAD_LEFT + DITHER_PAD_RIGHT) * sizeof(int16_t);
+
+    srcRow = (uint8_t*)malloc(srcWidth);
+    allocatedBytes = srcWidth;
+    for (int i = 0; i < rows; i++) {
+        errorRows[i] = (int16_t*)calloc(1, rowBytes);
+        allocatedBytes += rowBytes;
+    }
+
+    if (!srcRow || !errorRows[0] || !errorRows[1] || (rows == 3 && !errorRows[2])) {
+        end();
+        return false;
+    }
+
+    srcRowIndex = -1;
+    outRowIndex = 0;
+    return true;
+}
+
+void ImageDitherer::end() {
+    free(srcRow);
+    srcRow = nullptr;
+    for (int i = 0; i < 3; i++) {
+        free(errorRows[i]);
+        errorRows[i] = nullptr;
+    }
+    allocatedBytes = 0;
+}
+
+void ImageDitherer::scaleInto(int16_t* row) {
+    // Box-average the source pixels that fall under each output pixel
+    // (nearest pixel when upscaling) and add to the carried error
+    for (uint16_t x = 0; x < outWidth; x++) {
+        uint32_t s0 = (uint32_t)x * srcWidth / outWidth;
+        uint32_t s1 = (uint32_t)(x + 1) * srcWidth / outWidth;
+        if (s1 <= s0) s1 = s0 + 1;
+
+        uint32_t sum = 0;
+        for (uint32_t s = s0; s < s1; s++) {
+            sum += srcRow[s];
+        }
+        row[x + DITHER_PAD_LEFT] += (int16_t)(sum / (s1 - s0));
+    }
+}
+
+void ImageDitherer::rotateErrorRows() {
+    size_t rowBytes = (outWidth + DITHER_PAD_LEFT + DITHER_PAD_RIGHT) * sizeof(int16_t);
+    int16_t* done = errorRows[0];
+    if (mode == DITHER_ATKINSON) {
+        errorRows[0] = errorRows[1];
+        errorRows[1] = errorRows[2];
+        errorRows[2] = done;
+    } else {
+        errorRows[0] = errorRows[1];
+        errorRows[1] = done;
+    }
+    memset(done, 0, rowBytes);
+}
+
+bool ImageDitherer::nextRow(const GrayRowSource& source, uint8_t* out) {
+    if (!srcRow || outRowIndex >= outHeight) {
+        return false;
+    }
+
+    // Pull source rows until we hold the one this output row maps to;
+    // rows in between are read and discarded when downscaling
+    int32_t wanted = (int32_t)((uint32_t)outRowIndex * srcHeight / outHeight);
+    while (srcRowIndex < wanted) {
+        if (!source(srcRow, srcWidth)) {
+            return false;
+        }
+        srcRowIndex++;
+    }
+
+    int16_t* cur = errorRows[0] + DITHER_PAD_LEFT;
+    int16_t* next = errorRows[1] + DITHER_PAD_LEFT;
+    int16_t* after = mode == DITHER_ATKINSON ? errorRows[2] + DITHER_PAD_LEFT : nullptr;
+
+    scaleInto(errorRows[0]);
+    memset(out, 0, outWidth / 8);
+
+    for (uint16_t x = 0; x < outWidth; x++) {
+        int16_t value = cur[x];
+        bool black = value < 128;
+        int16_t error = value - (black ? 0 : 255);
+
+        if (black) {
+            out[x >> 3] |= 0x80 >> (x & 7);
+        }
+
+        if (mode == DITHER_ATKINSON) {
+            // 1/8 to six neighbours; 2/8 of the error is deliberately dropped
+            int16_t e = error / 8;
+            cur[x + 1] += e;
+            cur[x + 2] += e;
+            next[x - 1] += e;
+            next[x] += e;
+            next[x + 1] += e;
+            after[x] += e;
+        } else {
+            cur[x + 1] += error * 7 / 16;
+            next[x - 1] += error * 3 / 16;
+            next[x] += error * 5 / 16;
+            next[x + 1] += error / 16;
+        }
+    }
+
+    rotateErrorRows();
+    outRowIndex++;
+    return true;
+}
+
+DitherMode ImageDitherer::parseMode(const String& name) {
+    return name == "atkinson" ? DITHER_ATKINSON : DITHER_FLOYD_STEINBERG;
+}
@@ -0,0 +1,196 @@
+#include "ImageUploadStream.h"
+
+const char* ImageUploadStream::TAG = "ImageStream";
+
+ImageUploadStream::ImageUploadStream(ImageFormat imageFormat, uint16_t imageWidth, uint16_t imageHeight, DitherMode mode)
+    : format(imageFormat), width(imageWidth), height(imageHeight), maxValue(255), ditherMode(mode),
+      bytesWritten(0), bytesRead(0), producerDone(false), consumerDone(false), aborted(false),
+      refCount(2), mux(portMUX_INITIALIZER_UNLOCKED) {
+    buffer = xStreamBufferCreate(IMAGE_STREAM_BUFFER_SIZE, 1);
+    if (!buffer) {
+        Logger::error(TAG, "Failed to allocate image stream buffer");
+    }
+}
+
+ImageUploadStream::~ImageUploadStream() {
+    if (buffer) {
+        vStreamBufferDelete(buffer);
+    }
+}
+
+void ImageUploadStream::release() {
+    portENTER_CRITICAL(&mux);
+    bool last = --refCount == 0;
+    portEXIT_CRITICAL(&mux);
+
+    if (last) {
+        delete this;
+    }
+}
+
+// ============================================================================
+// Producer side
+// ============================================================================
+
+bool ImageUploadStream::write(const uint8_t* data, size_t length) {
+    if (!buffer || aborted) {
+        return false;
+    }
+
+    size_t sent = 0;
+    unsigned long lastProgress = millis();
+    while (sent < length) {
+        // Consumer gave up (bad header, print failure, cancel) - drop the rest
+        if (consumerDone) {
+            return false;
+        }
+
+        size_t n = xStreamBufferSend(buffer, data + sent, length - sent, pdMS_TO_TICKS(IMAGE_STREAM_POLL_MS));
+        if (n > 0) {
+            sent += n;
+            lastProgress = millis();
+        } else {
+            if (millis() - lastProgress > IMAGE_STREAM_TIMEOUT_MS) {
+                Logger::warn(TAG, "Printer stalled, aborting upload");
+                aborted = true;
+                return false;
+            }
+            if (waitCallback) {
+                waitCallback();
+            }
+        }
+    }
+
+    bytesWritten += length;
+    return true;
+}
+
+void ImageUploadStream::finish(bool abort) {
+    if (abort) {
+        aborted = true;
+    }
+    producerDone = true;
+    release();
+}
+
+// ============================================================================
+// Consumer side
+// ============================================================================
+
+bool ImageUploadStream::readByte(uint8_t& b) {
+    return read(&b, 1);
+}
+
+bool ImageUploadStream::read(uint8_t* out, size_t length) {
+    size_t received = 0;
+    unsigned long lastProgress = millis();
+
+    while (received < length) {
+        if (aborted) {
+            return false;
+        }
+
+        // Check the flag before the buffer: once the producer is done no
+        // more data can arrive, so an empty buffer means end of stream
+        bool done = producerDone;
+        size_t n = xStreamBufferReceive(buffer, out + received, length - received, pdMS_TO_TICKS(IMAGE_STREAM_POLL_MS));
+        if (n > 0) {
+            received += n;
+            lastProgress = millis();
+        } else if (done) {
+            Logger::warn(TAG, "Image data ended early at byte " + String(bytesRead + received));
+            return false;
+        } else if (millis() - lastProgress > IMAGE_STREAM_TIMEOUT_MS) {
+            Logger::warn(TAG, "Upload stalled, aborting print");
+            return false;
+        }
+    }
+
+    bytesRead += length;
+    return true;
+}
+
+bool ImageUploadStream::readHeaderNumber(uint32_t& value) {
+    uint8_t c;
+
+    // Skip whitespace and '#' comments
+    while (true) {
+        if (!readByte(c)) return false;
+        if (c == '#') {
+            while (c != '\n') {
+                if (!readByte(c)) return false;
+            }
+        } else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+            break;
+        }
+    }
+
+    if (c < '0' || c > '9') {
+        return false;
+    }
+
+    value = 0;
+    while (c >= '0' && c <= '9') {
+        value = value * 10 + (c - '0');
+        if (value > 65535) return false;
+        if (!readByte(c)) return false;
+    }
+
+    // The single whitespace byte after the number is consumed here, which
+    // is exactly what PGM requires between maxval and the raster
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool ImageUploadStream::readHeader() {
+    if (!buffer) {
+        return false;
+    }
+
+    if (format == IMAGE_FORMAT_PGM) {
+        uint8_t magic[2];
+        uint32_t w, h, maxval;
+        if (!read(magic, 2) || magic[0] != 'P' || magic[1] != '5') {
+            Logger::warn(TAG, "Not a binary PGM (P5) image");
+            return false;
+        }
+        if (!readHeaderNumber(w) || !readHeaderNumber(h) || !readHeaderNumber(maxval)) {
+            Logger::warn(TAG, "Malformed PGM header");
+            return false;
+        }
+        if (maxval == 0 || maxval > 255) {
+            Logger::warn(TAG, "Unsupported PGM maxval: " + String(maxval));
+            return false;
+        }
+        width = w;
+        height = h;
+        maxValue = maxval;
+    }
+
+    if (width == 0 || height == 0 || width > IMAGE_MAX_SOURCE_WIDTH || height > IMAGE_MAX_SOURCE_HEIGHT) {
+        Logger::warn(TAG, "Unsupported image size: " + String(width) + "x" + String(height));
+        return false;
+    }
+
+    Logger::info(TAG, "Image " + String(width) + "x" + String(height) +
+                      (format == IMAGE_FORMAT_PGM ? " PGM" : " raw") +
+                      (ditherMode == DITHER_ATKINSON ? ", Atkinson" : ", Floyd-Steinberg"));
+    return true;
+}
+
+bool ImageUploadStream::readRow(uint8_t* gray, uint16_t rowWidth) {
+    if (!read(gray, rowWidth)) {
+        return false;
+    }
+    if (maxValue != 255) {
+        for (uint16_t i = 0; i < rowWidth; i++) {
+            uint16_t v = gray[i] > maxValue ? maxValue : gray[i];
+            gray[i] = (uint8_t)(v * 255 / maxValue);
+        }
+    }
+    return true;
+}
+
+void ImageUploadStream::close() {
+    consumerDone = true;
+    release();
+}
@@ -0,0 +1,161 @@
+#include "LedDimmer.h"
+#include <ArduinoJson.h>
+
+const char* LedDimmer::TAG = "LED";
+
+static_assert(LED_PWM_RESOLUTION >= 8 && LED_PWM_RESOLUTION <= 16, "LED_PWM_RESOLUTION must be 8-16 bits");
+static_assert((uint64_t)LED_PWM_FREQUENCY << LED_PWM_RESOLUTION <= 80000000ULL,
+              "LED_PWM_FREQUENCY too high for LED_PWM_RESOLUTION (80MHz APB clock)");
+
+// Arduino numbers LEDC channels 0-15: 0-7 high speed, 8-15 low speed
+static const ledc_mode_t LED_SPEED_MODE = LED_PWM_CHANNEL < 8 ? LEDC_HIGH_SPEED_MODE : LEDC_LOW_SPEED_MODE;
+static const ledc_channel_t LED_CHANNEL = (ledc_channel_t)(LED_PWM_CHANNEL % 8);
+
+static const uint32_t FADE_SLACK_US = 5000;  // Fade hardware finishes on its own step clock
+
+LedDimmer::LedDimmer()
+    : maxDuty((1UL << LED_PWM_RESOLUTION) - 1), fadeReady(false),
+      level(0), pendingLevel(0), pendingFadeMs(0), pending(false), fadeEndsUs(0), pendingTimer(nullptr),
+      lightRef(-1), fades(0), deferred(0) {
+    portMUX_INITIALIZE(&fadeMux);
+    memset(gammaLut, 0, sizeof(gammaLut));
+}
+
+LedDimmer::~LedDimmer() {
+    if (pendingTimer) {
+        esp_timer_stop(pendingTimer);
+        esp_timer_delete(pendingTimer);
+    }
+}
+
+bool LedDimmer::begin() {
+    // Level 1 and up get at least one duty step, so the dimmest levels
+    // don't all round to off (the reason to run above 8 bits)
+    for (uint16_t i = 0; i < 256; i++) {
+        float duty = powf(i / 255.0f, LED_GAMMA) * maxDuty + 0.5f;
+        gammaLut[i] = (i > 0 && duty < 1) ? 1 : (uint16_t)duty;
+    }
+
+    esp_err_t result = ledc_fade_func_install(0);
+    fadeReady = result == ESP_OK || result == ESP_ERR_INVALID_STATE;  // Already installed is fine
+
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = handlePending;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "ledFade";
+    if (esp_timer_create(&timerArgs, &pendingTimer) != ESP_OK) {
+        pendingTimer = nullptr;
+        fadeReady = false;  // Without it a mid-fade change would block the caller
+    }
+
+    if (!fadeReady) {
+        Logger::warn(TAG, "LED fade unavailable - brightness changes will switch directly");
+        return false;
+    }
+    Logger::debug(TAG, "LED fade ready: " + String(LED_PWM_RESOLUTION) + "-bit duty, gamma " + String(LED_GAMMA, 1));
+    return true;
+}
+
+void LedDimmer::startFade(uint8_t target, uint16_t fadeMs) {
+    uint32_t duty = gammaLut[target];
+    if (!fadeReady) {
+        ledcWrite(LED_PWM_CHANNEL, duty);
+        return;
+    }
+    ledc_set_fade_with_time(LED_SPEED_MODE, LED_CHANNEL, duty, fadeMs > 0 ? fadeMs : 1);
+    ledc_fade_start(LED_SPEED_MODE, LED_CHANNEL, LEDC_FADE_NO_WAIT);
+}
+
+void LedDimmer::setLevel(uint8_t target, uint16_t fadeMs) {
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&fadeMux);
+    level = target;
+    if (fadeReady && pendingTimer && now < fadeEndsUs) {
+        // Mid-fade: keep only the newest request and start it when the
+        // running fade is done
+        bool armed = pending;
+        pending = true;
+        pendingLevel = target;
+        pendingFadeMs = fadeMs;
+        deferred++;
+        int64_t waitUs = fadeEndsUs - now;
+        portEXIT_CRITICAL(&fadeMux);
+        if (!armed) {
+            esp_timer_start_once(pendingTimer, waitUs);
+        }
+        return;
+    }
+    pending = false;  // Superseded, if the timer hasn't run yet
+    fadeEndsUs = now + (int64_t)fadeMs * 1000 + FADE_SLACK_US;
+    fades++;
+    portEXIT_CRITICAL(&fadeMux);
+
+    startFade(target, fadeMs);
+}
+
+void LedDimmer::handlePending(void* param) {
+    LedDimmer* self = static_cast<LedDimmer*>(param);
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&self->fadeMux);
+    if (!self->pending) {
+        portEXIT_CRITICAL(&self->fadeMux);
+        return;
+    }
+    self->pending = false;
+    uint8_t target = self->pendingLevel;
+    uint16_t fadeMs = self->pendingFadeMs;
+    self->fadeEndsUs = now + (int64_t)fadeMs * 1000 + FADE_SLACK_US;
+    self->fades++;
+    portEXIT_CRITICAL(&self->fadeMux);
+
+    self->startFade(target, fadeMs);
+}
+
+bool LedDimmer::setFromLight(float lightPercent) {
+    if (lightRef >= 0 && fabsf(lightPercent - lightRef) < LED_LIGHT_HYSTERESIS) {
+        return false;
+    }
+    lightRef = lightPercent;
+
+    // lightPercent: 0% = dark, 100% = bright
+    uint8_t target = (uint8_t)((100.0f - lightPercent) * 255.0f / 100.0f + 0.5f);
+    if (target == level) {
+        return false;
+    }
+    setLevel(target, LED_FADE_MS);
+    return true;
+}
+
+uint32_t LedDimmer::getDuty() const {
+    return fadeReady ? ledc_get_duty(LED_SPEED_MODE, LED_CHANNEL) : gammaLut[level];
+}
+
+String LedDimmer::getStatusJSON() const {
+    DynamicJsonDocument doc(384);
+    doc["level"] = level;
+    doc["duty"] = getDuty();
+    doc["targetDuty"] = gammaLut[level];
+    doc["maxDuty"] = maxDuty;
+    doc["resolutionBits"] = LED_PWM_RESOLUTION;
+    doc["gamma"] = LED_GAMMA;
+    doc["hardwareFade"] = fadeReady;
+    doc["fadeMs"] = LED_FADE_MS;
+    doc["hysteresis"] = LED_LIGHT_HYSTERESIS;
+    if (lightRef >= 0) {
+        doc["lightReference"] = round(lightRef * 10) / 10.0;
+    }
+
+    portENTER_CRITICAL(&fadeMux);
+    uint32_t fadeCount = fades;
+    uint32_t deferredCount = deferred;
+    portEXIT_CRITICAL(&fadeMux);
+    doc["fades"] = fadeCount;
+    doc["deferred"] = deferredCount;  // Arrived mid-fade and started afterwards
+
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
@@ -0,0 +1,33 @@
+#include "PrintCoalescer.h"
+
+bool PrintCoalescer::canJoin(const PrintJob& first, const PrintJob& next) {
+    return first.type == PRINT_JOB_RECEIPT && next.type == PRINT_JOB_RECEIPT && next.profile == first.profile;
+}
+
+int PrintCoalescer::batchSize(const PrintJob* const* queue, int count) {
+    if (count <= 0) {
+        return 0;
+    }
+
+    int size = 1;
+    while (size < count && size < PRINT_COALESCE_MAX_JOBS && canJoin(*queue[0], *queue[size])) {
+        size++;
+    }
+    return size;
+}
+
+unsigned long PrintCoalescer::holdMs(const PrintJob* const* queue, int count, unsigned long now) {
+    // Only receipts are coalesced; anything else prints straight away
+    if (PRINT_COALESCE_WINDOW_MS == 0 || count <= 0 || queue[0]->type != PRINT_JOB_RECEIPT) {
+        return 0;
+    }
+
+    // Full, or closed off by a job that prints on its own
+    int size = batchSize(queue, count);
+    if (size >= PRINT_COALESCE_MAX_JOBS || size < count) {
+        return 0;
+    }
+
+    unsigned long age = now - queue[0]->queuedAt;
+    return age < PRINT_COALESCE_WINDOW_MS ? PRINT_COALESCE_WINDOW_MS - age : 0;
+}
@@ -0,0 +1,424 @@
+#include "PrintJournal.h"
+#include <ArduinoJson.h>
+#include <esp_rom_crc.h>
+
+const char* PrintJournal::TAG = "Journal";
+
+static const uint8_t RECORD_MAGIC = 0xA5;
+static const char* JOURNAL_TMP_PATH = PRINT_JOURNAL_PATH ".tmp";
+
+static_assert(sizeof(PrintJournalRecord) == 20, "Journal record header must stay packed");
+
+PrintJournal::PrintJournal()
+    : available(false), lock(nullptr), pendingCount(0), nextId(1), fileBytes(0),
+      appends(0), bytesWritten(0), payloadBytes(0), compactions(0), bytesCompacted(0), replayed(0) {
+}
+
+PrintJournal::~PrintJournal() {
+    if (file) {
+        file.close();
+    }
+}
+
+bool PrintJournal::begin() {
+    if (!LittleFS.begin(true)) {
+        Logger::error(TAG, "LittleFS mount failed, print jobs won't survive a reboot");
+        return false;
+    }
+
+    lock = xSemaphoreCreateMutex();
+    if (!lock) {
+        Logger::error(TAG, "Failed to create journal mutex");
+        return false;
+    }
+
+    // Left over from a compaction that was interrupted before the rename
+    if (LittleFS.exists(JOURNAL_TMP_PATH)) {
+        LittleFS.remove(JOURNAL_TMP_PATH);
+    }
+
+    uint32_t validBytes = 0;
+    bool clean = scan(validBytes);
+    fileBytes = validBytes;
+
+    file = LittleFS.open(PRINT_JOURNAL_PATH, "a");
+    if (!file) {
+        Logger::error(TAG, "Cannot open " + String(PRINT_JOURNAL_PATH));
+        return false;
+    }
+    available = true;
+
+    if (!clean) {
+        // A record was torn by the reset; rewrite so appends follow valid data
+        Logger::warn(TAG, "Journal has a torn record at " + String(validBytes) + ", compacting");
+        compact();
+    }
+
+    Logger::info(TAG, "Print journal ready: " + String(pendingCount) + " unfinished job(s), " +
+                      String(fileBytes) + " bytes");
+    return true;
+}
+
+uint32_t PrintJournal::recordCrc(PrintJournalRecord record, const uint8_t* payload) {
+    record.crc = 0;
+    uint32_t crc = esp_rom_crc32_le(0, (const uint8_t*)&record, sizeof(record));
+    if (payload && record.length > 0) {
+        crc = esp_rom_crc32_le(crc, payload, record.length);
+    }
+    return crc;
+}
+
+bool PrintJournal::scan(uint32_t& validBytes) {
+    validBytes = 0;
+    File in = LittleFS.open(PRINT_JOURNAL_PATH, "r");
+    if (!in) {
+        return true;  // No journal yet
+    }
+
+    uint32_t size = in.size();
+    uint8_t* payload = (uint8_t*)malloc(PRINT_JOURNAL_MAX_PAYLOAD);
+    if (!payload) {
+        in.close();
+        return false;
+    }
+
+    while (validBytes + sizeof(PrintJournalRecord) <= size) {
+        PrintJournalRecord record;
+        in.seek(validBytes);
+        if (in.read((uint8_t*)&record, sizeof(record)) != sizeof(record) ||
+            record.magic != RECORD_MAGIC || record.length > PRINT_JOURNAL_MAX_PAYLOAD ||
+            validBytes + sizeof(record) + record.length > size) {
+            break;
+        }
+        if (record.length > 0 && in.read(payload, record.length) != record.length) {
+            break;
+        }
+        if (record.crc != recordCrc(record, payload)) {
+            break;
+        }
+
+        if (record.kind == PRINT_JOURNAL_ADD) {
+            if (pendingCount < MAX_PENDING) {
+                pending[pendingCount].id = record.id;
+                pending[pendingCount].offset = validBytes;
+                pending[pendingCount].inFlight = false;
+                pendingCount++;
+            } else {
+                Logger::error(TAG, "Too many unfinished jobs, dropping #" + String(record.id));
+            }
+        } else if (record.kind == PRINT_JOURNAL_DONE) {
+            int index = findPending(record.id);
+            if (index >= 0) {
+                removePending(index);
+            }
+        }
+        if (record.id >= nextId) {
+            nextId = record.id + 1;
+        }
+
+        validBytes += sizeof(record) + record.length;
+    }
+
+    free(payload);
+    in.close();
+    return validBytes == size;
+}
+
+bool PrintJournal::writeRecord(File& out, PrintJournalRecord& record, const uint8_t* payload) {
+    record.magic = RECORD_MAGIC;
+    record.reserved = 0;
+    record.crc = recordCrc(record, payload);
+
+    size_t written = out.write((const uint8_t*)&record, sizeof(record));
+    if (record.length > 0) {
+        written += out.write(payload, record.length);
+    }
+    out.flush();
+    return written == sizeof(record) + record.length;
+}
+
+bool PrintJournal::readRecord(uint32_t offset, PrintJournalRecord& record, String* text) {
+    File in = LittleFS.open(PRINT_JOURNAL_PATH, "r");
+    if (!in || !in.seek(offset) || in.read((uint8_t*)&record, sizeof(record)) != sizeof(record) ||
+        record.magic != RECORD_MAGIC || record.length > PRINT_JOURNAL_MAX_PAYLOAD) {
+        return false;
+    }
+
+    bool ok = true;
+    if (text) {
+        uint8_t* payload = (uint8_t*)malloc(record.length + 1);
+        ok = payload && in.read(payload, record.length) == record.length &&
+             record.crc == recordCrc(record, payload);
+        if (ok) {
+            payload[record.length] = 0;
+            *text = String((const char*)payload);
+        }
+        free(payload);
+    }
+    in.close();
+    return ok;
+}
+
+uint32_t PrintJournal::append(PrintJournalType type, const String& text, bool includeWeatherAndSanitizer,
+                              time_t createdTime) {
+    if (!available) {
+        return 0;
+    }
+    if (text.length() > PRINT_JOURNAL_MAX_PAYLOAD) {
+        Logger::warn(TAG, "Job too large to journal (" + String(text.length()) + " bytes)");
+        return 0;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (pendingCount >= MAX_PENDING) {
+        xSemaphoreGive(lock);
+        Logger::warn(TAG, "Journal full (" + String(MAX_PENDING) + " unfinished jobs)");
+        return 0;
+    }
+
+    PrintJournalRecord record;
+    record.kind = PRINT_JOURNAL_ADD;
+    record.jobType = type;
+    record.flags = includeWeatherAndSanitizer ? 1 : 0;
+    record.id = nextId++;
+    record.createdTime = (uint32_t)createdTime;
+    record.length = text.length();
+
+    uint32_t offset = fileBytes;
+    if (!appendRecord(record, (const uint8_t*)text.c_str())) {
+        xSemaphoreGive(lock);
+        Logger::error(TAG, "Journal write failed");
+        return 0;
+    }
+    payloadBytes += record.length;
+
+    pending[pendingCount].id = record.id;
+    pending[pendingCount].offset = offset;
+    pending[pendingCount].inFlight = true;
+    pendingCount++;
+    xSemaphoreGive(lock);
+
+    Logger::debug(TAG, "Journaled job #" + String(record.id) + " (" + String(record.length) + " bytes)");
+    return record.id;
+}
+
+bool PrintJournal::appendRecord(PrintJournalRecord& record, const uint8_t* payload) {
+    if (!writeRecord(file, record, payload)) {
+        return false;
+    }
+    appends++;
+    bytesWritten += sizeof(record) + record.length;
+    fileBytes += sizeof(record) + record.length;
+    return true;
+}
+
+void PrintJournal::complete(uint32_t id) {
+    if (!available || id == 0) {
+        return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    completeLocked(id);
+    xSemaphoreGive(lock);
+}
+
+void PrintJournal::completeLocked(uint32_t id) {
+    int index = findPending(id);
+    if (index < 0) {
+        return;
+    }
+
+    PrintJournalRecord record;
+    record.kind = PRINT_JOURNAL_DONE;
+    record.jobType = 0;
+    record.flags = 0;
+    record.id = id;
+    record.createdTime = 0;
+    record.length = 0;
+    if (!appendRecord(record, nullptr)) {
+        Logger::error(TAG, "Journal write failed, job #" + String(id) + " may print again after a reboot");
+    }
+    removePending(index);
+
+    if (fileBytes >= PRINT_JOURNAL_COMPACT_BYTES) {
+        compact();
+    }
+}
+
+void PrintJournal::release(uint32_t id) {
+    if (!available || id == 0) {
+        return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    int index = findPending(id);
+    if (index >= 0) {
+        pending[index].inFlight = false;
+    }
+    xSemaphoreGive(lock);
+}
+
+int PrintJournal::replay(const PrintJournalReplay& submit) {
+    if (!available) {
+        return 0;
+    }
+
+    int accepted = 0;
+    while (true) {
+        PrintJournalEntry entry;
+        bool found = false;
+
+        xSemaphoreTake(lock, portMAX_DELAY);
+        for (int i = 0; i < pendingCount && !found; i++) {
+            if (pending[i].inFlight) continue;
+
+            PrintJournalRecord record;
+            if (!readRecord(pending[i].offset, record, &entry.text)) {
+                // Unreadable - give up on it rather than retrying forever
+                Logger::error(TAG, "Cannot read journaled job #" + String(pending[i].id) + ", dropping");
+                completeLocked(pending[i].id);
+                i--;
+                continue;
+            }
+            entry.id = record.id;
+            entry.type = (PrintJournalType)record.jobType;
+            entry.includeWeatherAndSanitizer = record.flags & 1;
+            entry.createdTime = record.createdTime;
+            found = true;
+        }
+        xSemaphoreGive(lock);
+
+        // Submit without the lock - the spooler may complete other jobs meanwhile
+        if (!found || !submit(entry)) {
+            break;
+        }
+
+        xSemaphoreTake(lock, portMAX_DELAY);
+        int index = findPending(entry.id);
+        if (index >= 0) {
+            pending[index].inFlight = true;
+        }
+        replayed++;
+        xSemaphoreGive(lock);
+
+        Logger::info(TAG, "Replayed journaled job #" + String(entry.id));
+        accepted++;
+    }
+    return accepted;
+}
+
+bool PrintJournal::compact() {
+    file.close();
+    unsigned long startTime = millis();
+    bool success = true;
+
+    if (pendingCount == 0) {
+        // Nothing unfinished - start an empty file
+        file = LittleFS.open(PRINT_JOURNAL_PATH, "w");
+        fileBytes = 0;
+    } else {
+        // Copy the unfinished records to a new file, then swap it in
+        File in = LittleFS.open(PRINT_JOURNAL_PATH, "r");
+        File out = LittleFS.open(JOURNAL_TMP_PATH, "w");
+        uint8_t* buffer = (uint8_t*)malloc(sizeof(PrintJournalRecord) + PRINT_JOURNAL_MAX_PAYLOAD);
+        uint32_t outBytes = 0;
+        success = in && out && buffer;
+
+        for (int i = 0; i < pendingCount && success; i++) {
+            PrintJournalRecord* record = (PrintJournalRecord*)buffer;
+            success = in.seek(pending[i].offset) &&
+                      in.read(buffer, sizeof(PrintJournalRecord)) == sizeof(PrintJournalRecord) &&
+                      record->length <= PRINT_JOURNAL_MAX_PAYLOAD &&
+                      in.read(buffer + sizeof(PrintJournalRecord), record->length) == record->length;
+            if (!success) break;
+
+            size_t recordBytes = sizeof(PrintJournalRecord) + record->length;
+            success = out.write(buffer, recordBytes) == recordBytes;
+            pending[i].offset = outBytes;
+            outBytes += recordBytes;
+        }
+
+        free(buffer);
+        if (in) in.close();
+        if (out) {
+            out.flush();
+            out.close();
+        }
+
+        // Rename replaces the old journal atomically
+        success = success && LittleFS.rename(JOURNAL_TMP_PATH, PRINT_JOURNAL_PATH);
+        if (success) {
+            fileBytes = outBytes;
+            bytesCompacted += outBytes;
+        } else {
+            LittleFS.remove(JOURNAL_TMP_PATH);
+            Logger::error(TAG, "Compaction failed, keeping the old journal");
+        }
+        file = LittleFS.open(PRINT_JOURNAL_PATH, "a");
+    }
+
+    if (!file) {
+        Logger::error(TAG, "Cannot reopen journal, disabling it");
+        available = false;
+        return false;
+    }
+
+    if (success) {
+        compactions++;
+        Logger::debug(TAG, "Journal compacted to " + String(fileBytes) + " bytes in " +
+                           String(millis() - startTime) + "ms");
+    }
+    return success;
+}
+
+int PrintJournal::findPending(uint32_t id) const {
+    for (int i = 0; i < pendingCount; i++) {
+        if (pending[i].id == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void PrintJournal::removePending(int index) {
+    // Shift down to keep the oldest job first
+    for (int i = index; i < pendingCount - 1; i++) {
+        pending[i] = pending[i + 1];
+    }
+    pendingCount--;
+}
+
+int PrintJournal::getPendingCount() const {
+    return pendingCount;
+}
+
+String PrintJournal::getStatsJSON() const {
+    DynamicJsonDocument doc(512);
+    doc["available"] = available;
+
+    if (available) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        int inFlight = 0;
+        for (int i = 0; i < pendingCount; i++) {
+            if (pending[i].inFlight) inFlight++;
+        }
+        doc["pending"] = pendingCount;
+        doc["inFlight"] = inFlight;
+        doc["fileBytes"] = fileBytes;
+        doc["appends"] = appends;
+        doc["bytesWritten"] = bytesWritten;
+        doc["compactions"] = compactions;
+        doc["bytesCompacted"] = bytesCompacted;
+        doc["replayed"] = replayed;
+        // Flash bytes written per byte of job payload
+        doc["writeAmplification"] = payloadBytes > 0 ? (float)(bytesWritten + bytesCompacted) / payloadBytes : 0.0f;
+        xSemaphoreGive(lock);
+
+        doc["fsUsedBytes"] = LittleFS.usedBytes();
+        doc["fsTotalBytes"] = LittleFS.totalBytes();
+    }
+
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
@@ -0,0 +1,38 @@
+#include "PrintProfiles.h"
+
+// In PrintProfileId order. Factory defaults on these heads are about
+// 64 dots / 800us / 20us at 100% density.
+static const PrintProfile PRESETS[] = {
+    {15,  60,  2, 10, 2},   // fast: 128 dots per burn, short burns - light grey on cheap paper
+    {11,  90, 20, 12, 2},   // balanced
+    { 7, 150, 40, 15, 3}    // dark: images and faded paper
+};
+static const char* const NAMES[PRINT_PROFILE_COUNT] = {"fast", "balanced", "dark", "calibrated"};
+
+const PrintProfile& PrintProfiles::preset(PrintProfileId id) {
+    if (id == PRINT_PROFILE_FAST || id == PRINT_PROFILE_DARK) {
+        return PRESETS[id];
+    }
+    return PRESETS[PRINT_PROFILE_BALANCED];
+}
+
+const char* PrintProfiles::name(PrintProfileId id) {
+    if (id < 0 || id >= PRINT_PROFILE_COUNT) {
+        return "default";
+    }
+    return NAMES[id];
+}
+
+PrintProfileId PrintProfiles::parse(const String& name) {
+    for (int i = 0; i < PRINT_PROFILE_COUNT; i++) {
+        if (name.equalsIgnoreCase(NAMES[i])) {
+            return (PrintProfileId)i;
+        }
+    }
+    return PRINT_PROFILE_DEFAULT;
+}
+
+void PrintProfiles::encode(const PrintProfile& profile, EscPosEncoder& out) {
+    out.heatingParameters(profile.heatingDots, profile.heatingTime, profile.heatingInterval);
+    out.printDensity(profile.density, profile.breakTime);
+}
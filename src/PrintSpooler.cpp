@@ -0,0 +1,532 @@
+#include "PrintSpooler.h"
+#include <ArduinoJson.h>
+
+const char* PrintSpooler::TAG = "Spooler";
+
+PrintSpooler::PrintSpooler(PrinterService* printerService)
+    : printer(printerService), journal(nullptr), nextJobId(1), lock(nullptr), taskHandle(nullptr), paused(false),
+      messagesPrinted(0), batchesPrinted(0), receiptBusyMs(0) {
+}
+
+PrintSpooler::~PrintSpooler() {
+    if (taskHandle) {
+        vTaskDelete(taskHandle);
+    }
+}
+
+bool PrintSpooler::begin() {
+    lock = xSemaphoreCreateMutex();
+    if (!lock) {
+        Logger::error(TAG, "Failed to create spooler mutex");
+        return false;
+    }
+
+    BaseType_t result = xTaskCreatePinnedToCore(taskEntry, "printSpooler",
+                                                PRINT_SPOOLER_STACK_SIZE, this,
+                                                PRINT_SPOOLER_PRIORITY, &taskHandle,
+                                                PRINT_SPOOLER_CORE);
+    if (result != pdPASS) {
+        Logger::error(TAG, "Failed to start spooler task");
+        taskHandle = nullptr;
+        return false;
+    }
+
+    Logger::info(TAG, "Print spooler started on core " + String(PRINT_SPOOLER_CORE));
+    return true;
+}
+
+void PrintSpooler::taskEntry(void* param) {
+    static_cast<PrintSpooler*>(param)->run();
+}
+
+void PrintSpooler::run() {
+    while (true) {
+        // Sleep until a producer submits a job; wake now and then to keep
+        // the printer status fresh for the health monitor
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PRINTER_STATUS_POLL_MS)) == 0) {
+            printer->refreshStatus();
+            continue;
+        }
+
+        while (true) {
+            int slots[MAX_JOBS];
+            const PrintJob* queue[MAX_JOBS];
+
+            xSemaphoreTake(lock, portMAX_DELAY);
+            int queued = findQueued(slots, queue);
+            unsigned long waitMs = PrintCoalescer::holdMs(queue, queued, millis());
+            xSemaphoreGive(lock);
+
+            if (queued == 0) {
+                break;
+            }
+            if (waitMs > 0) {
+                // Hold the receipt briefly so a burst prints as one job; a new
+                // submission wakes us early to re-check
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+                continue;
+            }
+
+            // Jobs stay queued (and cancellable) while the printer reports
+            // paper out or cover open, instead of printing into nothing
+            if (!printer->refreshStatus()) {
+                if (!paused) {
+                    paused = true;
+                    Logger::warn(TAG, String("Printer ") +
+                                      PrinterStatus::stateToString(printer->getPrinterStatus().getState()) +
+                                      ", holding jobs");
+                }
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PRINTER_PAUSE_POLL_MS));
+                continue;
+            }
+            if (paused) {
+                paused = false;
+                Logger::info(TAG, "Printer ready, resuming jobs");
+            }
+
+            PrintJob batch[PRINT_COALESCE_MAX_JOBS];
+
+            xSemaphoreTake(lock, portMAX_DELAY);
+            // Claim the job, plus any receipts queued right behind it that can
+            // share its init and cut
+            queued = findQueued(slots, queue);
+            int count = PrintCoalescer::batchSize(queue, queued);
+            unsigned long now = millis();
+            for (int i = 0; i < count; i++) {
+                jobs[slots[i]].status = PRINT_JOB_PRINTING;
+                jobs[slots[i]].startedAt = now;
+                batch[i] = jobs[slots[i]];
+            }
+            xSemaphoreGive(lock);
+
+            if (count == 0) {
+                continue;  // Cancelled while we checked the printer
+            }
+
+            unsigned long startedAt = millis();
+            bool success;
+            printer->setJobProfile(batch[0].profile);
+            if (batch[0].type == PRINT_JOB_RECEIPT) {
+                Logger::info(TAG, count == 1 ? "Printing job #" + String(batch[0].id)
+                                             : "Printing jobs #" + String(batch[0].id) + "-#" +
+                                               String(batch[count - 1].id) + " as one batch");
+                success = printReceiptBatch(batch, count);
+            } else {
+                Logger::info(TAG, "Printing job #" + String(batch[0].id));
+                success = printJob(batch[0]);
+            }
+            unsigned long elapsed = millis() - startedAt;
+
+            xSemaphoreTake(lock, portMAX_DELAY);
+            for (int i = 0; i < count; i++) {
+                // Slot can't be reused while PRINTING, so it still belongs to this job
+                PrintJob& done = jobs[slots[i]];
+                done.status = success ? PRINT_JOB_DONE : PRINT_JOB_FAILED;
+                done.finishedAt = millis();
+                done.text = "";     // Release payload memory, keep the label
+                done.weather = "";
+                done.caption = "";
+                done.image = nullptr;
+            }
+            if (success && batch[0].type == PRINT_JOB_RECEIPT) {
+                messagesPrinted += count;
+                batchesPrinted++;
+                receiptBusyMs += elapsed;
+            }
+            xSemaphoreGive(lock);
+
+            // Failed jobs are finished too - replaying them after a reboot
+            // would most likely fail the same way
+            if (journal) {
+                for (int i = 0; i < count; i++) {
+                    journal->complete(batch[i].journalId);
+                }
+            }
+
+            Logger::info(TAG, "Job #" + String(batch[0].id) + (count > 1 ? " (+" + String(count - 1) + ")" : String("")) +
+                              " " + statusToString(success ? PRINT_JOB_DONE : PRINT_JOB_FAILED) +
+                              " in " + String(elapsed) + "ms");
+        }
+    }
+}
+
+bool PrintSpooler::printReceiptBatch(const PrintJob* batch, int count) {
+    ReceiptContent receipts[PRINT_COALESCE_MAX_JOBS];
+    for (int i = 0; i < count; i++) {
+        receipts[i].message = &batch[i].text;
+        receipts[i].weather = &batch[i].weather;
+        receipts[i].includeWeatherAndSanitizer = batch[i].includeWeatherAndSanitizer;
+        receipts[i].createdTime = batch[i].createdTime;
+    }
+    printer->setWeather(batch[count - 1].weather);
+    return printer->printReceipts(receipts, count);
+}
+
+bool PrintSpooler::printJob(const PrintJob& job) {
+    switch (job.type) {
+        case PRINT_JOB_RECEIPT:
+            printer->setWeather(job.weather);
+            return printer->printReceipt(job.text, job.includeWeatherAndSanitizer, job.createdTime);
+
+        case PRINT_JOB_GROCERY_LIST: {
+            String items[PRINT_SPOOLER_MAX_LIST_ITEMS];
+            int itemCount = 0;
+            int start = 0;
+            while (start < (int)job.text.length() && itemCount < PRINT_SPOOLER_MAX_LIST_ITEMS) {
+                int end = job.text.indexOf('\n', start);
+                if (end < 0) end = job.text.length();
+                items[itemCount++] = job.text.substring(start, end);
+                start = end + 1;
+            }
+            return printer->printGroceryList(items, itemCount);
+        }
+
+        case PRINT_JOB_TEST:
+            return printer->printTest();
+
+        case PRINT_JOB_IMAGE:
+            return printImage(job.image);
+
+        case PRINT_JOB_BAUD_TEST:
+            // Runs here so the switch never lands in the middle of another job
+            return printer->changeBaudRate(job.baudRate, job.saveBaud) && printer->printBaudTest();
+
+        case PRINT_JOB_QR_CODE:
+            return printer->printQrCode(job.text, job.caption);
+
+        case PRINT_JOB_BARCODE:
+            return printer->printBarcode(job.text);
+
+        case PRINT_JOB_BENCHMARK:
+            // Uses the printer's job buffer, so it queues like a print
+            return printer->runBenchmark();
+
+        case PRINT_JOB_CALIBRATION:
+            return printer->printCalibrationStrip();
+
+        default:
+            Logger::warn(TAG, "Unknown job type: " + String(job.type));
+            return false;
+    }
+}
+
+bool PrintSpooler::printImage(ImageUploadStream* image) {
+    ImageDitherer ditherer;
+    bool success = image->readHeader() &&
+                   ditherer.begin(image->getWidth(), image->getHeight(), PRINTER_HEAD_DOTS, image->getDitherMode());
+
+    if (success) {
+        Logger::debug(TAG, "Dither buffers: " + String(ditherer.getMemoryUsage()) + " bytes");
+        GrayRowSource source = [image](uint8_t* gray, uint16_t width) {
+            return image->readRow(gray, width);
+        };
+        success = printer->printRaster(ditherer.getOutputWidth(), ditherer.getOutputHeight(),
+                                       [&](uint16_t /*row*/, uint8_t* out, uint16_t /*bytesPerRow*/) {
+                                           return ditherer.nextRow(source, out);
+                                       });
+    }
+
+    // Tells a still-running upload to stop feeding us
+    image->close();
+    return success;
+}
+
+int PrintSpooler::findFreeSlot() const {
+    // Prefer empty slots, otherwise reuse the oldest finished job
+    int oldest = -1;
+    for (int i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i].status == PRINT_JOB_EMPTY) {
+            return i;
+        }
+        if (jobs[i].status == PRINT_JOB_DONE ||
+            jobs[i].status == PRINT_JOB_FAILED ||
+            jobs[i].status == PRINT_JOB_CANCELLED) {
+            if (oldest < 0 || jobs[i].id < jobs[oldest].id) {
+                oldest = i;
+            }
+        }
+    }
+    return oldest;
+}
+
+int PrintSpooler::findNextQueued(uint32_t afterId) const {
+    // FIFO: lowest job ID still queued
+    int next = -1;
+    for (int i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i].status == PRINT_JOB_QUEUED && jobs[i].id > afterId) {
+            if (next < 0 || jobs[i].id < jobs[next].id) {
+                next = i;
+            }
+        }
+    }
+    return next;
+}
+
+int PrintSpooler::findQueued(int* slots, const PrintJob** queue) const {
+    // Every queued job in FIFO order
+    int count = 0;
+    for (int slot = findNextQueued(); slot >= 0; slot = findNextQueued(jobs[slot].id)) {
+        slots[count] = slot;
+        queue[count++] = &jobs[slot];
+    }
+    return count;
+}
+
+int PrintSpooler::findJob(uint32_t id) const {
+    for (int i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i].status != PRINT_JOB_EMPTY && jobs[i].id == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+uint32_t PrintSpooler::submit(PrintJob& job) {
+    if (!lock || !taskHandle) {
+        Logger::error(TAG, "Spooler not started");
+        return 0;
+    }
+
+    // Text jobs go to flash before they are accepted
+    bool journaledHere = false;
+    if (journal && job.journalId == 0 &&
+        (job.type == PRINT_JOB_RECEIPT || job.type == PRINT_JOB_GROCERY_LIST)) {
+        job.journalId = journal->append(job.type == PRINT_JOB_RECEIPT ? PRINT_JOURNAL_RECEIPT : PRINT_JOURNAL_GROCERY_LIST,
+                                        job.text, job.includeWeatherAndSanitizer, job.createdTime);
+        journaledHere = job.journalId != 0;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    int slot = findFreeSlot();
+    if (slot < 0) {
+        xSemaphoreGive(lock);
+        if (journaledHere) {
+            journal->complete(job.journalId);  // The caller is told it failed
+        }
+        Logger::warn(TAG, "Print queue is full, rejecting job");
+        return 0;
+    }
+
+    job.id = nextJobId++;
+    job.status = PRINT_JOB_QUEUED;
+    job.queuedAt = millis();
+    jobs[slot] = job;
+    xSemaphoreGive(lock);
+
+    xTaskNotifyGive(taskHandle);
+
+    Logger::debug(TAG, "Job #" + String(job.id) + " queued");
+    return job.id;
+}
+
+uint32_t PrintSpooler::submitReceipt(const String& message, bool includeWeatherAndSanitizer,
+                                     const String& weather, time_t createdTime, uint32_t journalId) {
+    PrintJob job;
+    job.type = PRINT_JOB_RECEIPT;
+    job.text = message;
+    job.weather = weather;
+    job.label = message.substring(0, 30);
+    job.includeWeatherAndSanitizer = includeWeatherAndSanitizer;
+    job.createdTime = createdTime;
+    job.journalId = journalId;
+    job.estimatedLines = printer->estimateReceiptLines(message, includeWeatherAndSanitizer, weather, createdTime);
+    return submit(job);
+}
+
+uint32_t PrintSpooler::submitGroceryList(const String* items, int itemCount, uint32_t journalId) {
+    if (itemCount <= 0) {
+        return 0;
+    }
+
+    PrintJob job;
+    job.type = PRINT_JOB_GROCERY_LIST;
+    for (int i = 0; i < itemCount && i < PRINT_SPOOLER_MAX_LIST_ITEMS; i++) {
+        if (i > 0) job.text += '\n';
+        job.text += items[i];
+    }
+    job.label = "Grocery list (" + String(itemCount) + " items)";
+    job.journalId = journalId;
+    job.estimatedLines = printer->estimateGroceryListLines(items, min(itemCount, PRINT_SPOOLER_MAX_LIST_ITEMS));
+    return submit(job);
+}
+
+uint32_t PrintSpooler::submitTest(PrintProfileId profile) {
+    PrintJob job;
+    job.type = PRINT_JOB_TEST;
+    job.profile = profile;
+    job.label = profile == PRINT_PROFILE_DEFAULT ? String("Test print")
+                                                 : String("Test print (") + PrintProfiles::name(profile) + ")";
+    return submit(job);
+}
+
+uint32_t PrintSpooler::submitImage(ImageUploadStream* image, PrintProfileId profile) {
+    PrintJob job;
+    job.type = PRINT_JOB_IMAGE;
+    job.image = image;
+    job.profile = profile;
+    job.label = "Image";
+    uint32_t id = submit(job);
+    if (id == 0) {
+        image->close();
+    }
+    return id;
+}
+
+uint32_t PrintSpooler::submitBaudTest(uint32_t baud, bool save) {
+    PrintJob job;
+    job.type = PRINT_JOB_BAUD_TEST;
+    job.baudRate = baud;
+    job.saveBaud = save;
+    job.label = "Baud test (" + String(baud) + ")";
+    return submit(job);
+}
+
+uint32_t PrintSpooler::submitQrCode(const String& data, const String& caption) {
+    PrintJob job;
+    job.type = PRINT_JOB_QR_CODE;
+    job.text = data;
+    job.caption = caption;
+    job.label = "QR code: " + data.substring(0, 40);
+    return submit(job);
+}
+
+uint32_t PrintSpooler::submitBarcode(const String& data) {
+    PrintJob job;
+    job.type = PRINT_JOB_BARCODE;
+    job.text = data;
+    job.label = "Barcode: " + data;
+    return submit(job);
+}
+
+uint32_t PrintSpooler::submitBenchmark() {
+    PrintJob job;
+    job.type = PRINT_JOB_BENCHMARK;
+    job.label = "Print benchmark";
+    return submit(job);
+}
+
+uint32_t PrintSpooler::submitCalibration() {
+    PrintJob job;
+    job.type = PRINT_JOB_CALIBRATION;
+    job.label = "Heat calibration strip";
+    return submit(job);
+}
+
+bool PrintSpooler::cancel(uint32_t id) {
+    if (!lock) return false;
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    int slot = findJob(id);
+    // Only queued jobs can be cancelled - a printing job is already on the wire
+    bool cancelled = slot >= 0 && jobs[slot].status == PRINT_JOB_QUEUED;
+    ImageUploadStream* image = nullptr;
+    uint32_t journalId = 0;
+    if (cancelled) {
+        jobs[slot].status = PRINT_JOB_CANCELLED;
+        journalId = jobs[slot].journalId;
+        jobs[slot].finishedAt = millis();
+        jobs[slot].text = "";
+        jobs[slot].weather = "";
+        jobs[slot].caption = "";
+        image = jobs[slot].image;
+        jobs[slot].image = nullptr;
+    }
+    xSemaphoreGive(lock);
+
+    if (image) {
+        image->close();
+    }
+    if (journal) {
+        journal->complete(journalId);
+    }
+
+    if (cancelled) {
+        Logger::info(TAG, "Job #" + String(id) + " cancelled");
+    }
+    return cancelled;
+}
+
+PrintJobStatus PrintSpooler::getStatus(uint32_t id) const {
+    if (!lock) return PRINT_JOB_EMPTY;
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    int slot = findJob(id);
+    PrintJobStatus status = slot >= 0 ? jobs[slot].status : PRINT_JOB_EMPTY;
+    xSemaphoreGive(lock);
+    return status;
+}
+
+int PrintSpooler::getPendingCount() const {
+    if (!lock) return 0;
+
+    int count = 0;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (int i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i].status == PRINT_JOB_QUEUED || jobs[i].status == PRINT_JOB_PRINTING) {
+            count++;
+        }
+    }
+    xSemaphoreGive(lock);
+    return count;
+}
+
+String PrintSpooler::getJobsJSON() const {
+    DynamicJsonDocument doc(2048);
+    JsonArray array = doc.createNestedArray("jobs");
+    int pending = 0;
+
+    if (lock) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        for (int i = 0; i < MAX_JOBS; i++) {
+            const PrintJob& job = jobs[i];
+            if (job.status == PRINT_JOB_EMPTY) continue;
+            if (job.status == PRINT_JOB_QUEUED || job.status == PRINT_JOB_PRINTING) pending++;
+
+            JsonObject entry = array.createNestedObject();
+            entry["id"] = job.id;
+            entry["status"] = statusToString(job.status);
+            entry["label"] = job.label;
+            entry["ageMs"] = millis() - job.queuedAt;
+            if (job.estimatedLines > 0) {
+                entry["lines"] = job.estimatedLines;
+            }
+            if (job.finishedAt > 0 && job.startedAt > 0) {
+                entry["printMs"] = job.finishedAt - job.startedAt;
+            }
+        }
+        xSemaphoreGive(lock);
+    }
+
+    doc["pending"] = pending;
+    doc["maxJobs"] = MAX_JOBS;
+    doc["paused"] = paused || printer->isPaused();
+    doc["printer"] = PrinterStatus::stateToString(printer->getPrinterStatus().getSnapshot().state);
+
+    // Receipt throughput while the printer is busy; compare against
+    // PRINT_COALESCE_WINDOW_MS 0 to see what coalescing buys
+    JsonObject throughput = doc.createNestedObject("throughput");
+    if (lock) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        throughput["messages"] = messagesPrinted;
+        throughput["batches"] = batchesPrinted;
+        throughput["busyMs"] = receiptBusyMs;
+        throughput["messagesPerMinute"] = receiptBusyMs > 0 ? messagesPrinted * 60000.0f / receiptBusyMs : 0.0f;
+        xSemaphoreGive(lock);
+    }
+    throughput["windowMs"] = PRINT_COALESCE_WINDOW_MS;
+
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
+
+const char* PrintSpooler::statusToString(PrintJobStatus status) {
+    switch (status) {
+        case PRINT_JOB_QUEUED: return "queued";
+        case PRINT_JOB_PRINTING: return "printing";
+        case PRINT_JOB_DONE: return "done";
+        case PRINT_JOB_FAILED: return "failed";
+        case PRINT_JOB_CANCELLED: return "cancelled";
+        default: return "unknown";
+    }
+}
@@ -1,335 +1,891 @@
 #include "PrinterService.h"
+#include <ArduinoJson.h>
+#include <Preferences.h>
+#include <new>
 
 const char* PrinterService::TAG = "Printer";
 
-PrinterService::PrinterService(HardwareAbstraction* hw) 
-    : hardware(hw), currentWeather("N/A") {
+static const uint32_t BAUD_RATES[] = PRINTER_BAUD_RATES;
+static const uint8_t BAUD_RATE_COUNT = sizeof(BAUD_RATES) / sizeof(BAUD_RATES[0]);
+static const uint8_t CALIBRATION_TIMES[] = PRINT_CALIBRATION_TIMES;
+static const uint8_t CALIBRATION_STEPS = sizeof(CALIBRATION_TIMES) / sizeof(CALIBRATION_TIMES[0]);
+
+static uint32_t loadSavedBaud() {
+    Preferences prefs;
+    if (!prefs.begin(PRINTER_NVS_NAMESPACE, true)) {
+        return 0;  // Nothing saved yet
+    }
+    uint32_t baud = prefs.getUInt("baud", 0);
+    prefs.end();
+    return baud;
+}
+
+static void saveBaud(uint32_t baud) {
+    Preferences prefs;
+    if (prefs.begin(PRINTER_NVS_NAMESPACE, false)) {
+        prefs.putUInt("baud", baud);
+        prefs.end();
+    }
+}
+
+static void loadSavedProfile(PrintProfileId& profile, uint8_t& calibratedTime) {
+    Preferences prefs;
+    if (!prefs.begin(PRINTER_NVS_NAMESPACE, true)) {
+        return;
+    }
+    uint8_t saved = prefs.getUChar("profile", 0xFF);
+    if (saved < PRINT_PROFILE_COUNT) {
+        profile = (PrintProfileId)saved;
+    }
+    calibratedTime = prefs.getUChar("calTime", 0);
+    prefs.end();
+}
+
+static void saveProfile(PrintProfileId profile, uint8_t calibratedTime) {
+    Preferences prefs;
+    if (prefs.begin(PRINTER_NVS_NAMESPACE, false)) {
+        prefs.putUChar("profile", (uint8_t)profile);
+        prefs.putUChar("calTime", calibratedTime);
+        prefs.end();
+    }
+}
+
+PrinterService::PrinterService(PrinterPort* hw) 
+    : hardware(hw), currentWeather("N/A"), job(PRINTER_JOB_BUFFER_SIZE),
+      lastJobBytes(0), lastJobDurationMs(0), lastRasterRows(0), status(hw), paused(false),
+      baudSource("default"), lastBaudRequest(0), lastBaudVerified(false), lastBaudSaved(false),
+      nativeSymbols(PRINTER_SYMBOLS_ASSUME_NATIVE), symbolSource("config"), qrCodesPrinted(0), barcodesPrinted(0),
+      lastSymbolBytes(0), lastSymbolMs(0), lastSymbolNative(false),
+      uartWaitMs(0), printerWaitMs(0), delayMs(0),
+      jobProfile(PRINT_PROFILE_DEFAULT), appliedProfile(PRINT_PROFILE_DEFAULT), appliedHeatingTime(0),
+      profileChanges(0), dryRun(nullptr), benchmarkRuns(0), benchmarkAt(0),
+      columns(PRINTER_COLUMNS), glyphsResident(false) {
+    static_assert(BAUD_RATE_COUNT <= MAX_BAUD_RATES, "Too many PRINTER_BAUD_RATES");
+    memset(baudResults, 0, sizeof(baudResults));
+    memset(benchmarkResults, 0, sizeof(benchmarkResults));
+    portMUX_INITIALIZE(&profileMux);
+    PrintProfileId savedProfile = PRINTER_DEFAULT_PROFILE;
+    uint8_t calibratedTime = 0;
+    loadSavedProfile(savedProfile, calibratedTime);
+    if (savedProfile == PRINT_PROFILE_CALIBRATED && calibratedTime == 0) {
+        savedProfile = PRINTER_DEFAULT_PROFILE;
+    }
+    profileState.defaultProfile = savedProfile;
+    profileState.calibratedHeatingTime = calibratedTime;
+    profileState.appliedProfile = appliedProfile;
+    profileState.profileChanges = profileChanges;
 }
 
 PrinterService::~PrinterService() {
 }
 
 void PrinterService::sendInitialize() {
-    if (!hardware || !hardware->printerAvailable()) {
-        return; // Safety check
-    }
-    
-    hardware->printerWrite(27);  // ESC
-    hardware->printerWrite('@'); // ESC @ - Printer reset (initializes printer)
-    delay(50);
+    job.initialize();  // ESC @ - Printer reset (initializes printer)
+    appliedProfile = PRINT_PROFILE_DEFAULT;
     
-    // Set character code page to UTF-8/Unicode for better emoji support
-    // Try GBK (255) or Unicode UCS-2 (253) for emoji support
-    // Using CP437 (0) as default for better compatibility
-    setCharacterCodePage(0); // CP437 - U.S.A., Standard Europe (default, most compatible)
-    delay(10);
+    // Start every job on CP437; the transcoder switches to CP850/CP1252
+    // only when a run of text needs a character CP437 lacks
+    setCharacterCodePage(CODE_PAGE_CP437); // CP437 - U.S.A., Standard Europe (default, most compatible)
     
     // Set default line space
     setDefaultLineSpace();
-    delay(10);
+}
+
+void PrinterService::sendJobStart() {
+    // A printer that doesn't answer status queries could have been power
+    // cycled unseen since the last job, so it gets the glyphs every time
+    if (!glyphsResident || (!dryRun && !status.isResponding())) {
+        // ESC @ clears downloaded characters, so reset and download together
+        sendInitialize();
+        UserGlyphs::encodeDownload(job);
+        glyphsResident = true;
+        Logger::info(TAG, "Downloading " + String(UserGlyphs::count()) + " user glyphs to printer");
+    } else {
+        // Restore the modes ESC @ would reset without losing the glyphs
+        sendNormalSize();
+        setBold(false);
+        setUnderline(0);
+        setInverse(false);
+        sendLeftAlign();
+        setCharacterCodePage(CODE_PAGE_CP437);
+        setDefaultLineSpace();
+    }
+    
+    job.userCharacters(true);  // ESC % 1
+    transcoder.setUserGlyphs(true);
+    transcoder.setIconAtlas(PRINTER_INLINE_ICONS ? &icons : nullptr);
+    columns = PRINTER_COLUMNS;
+    applyPrintProfile();
+}
+
+PrintProfile PrinterService::profileSettings(PrintProfileId id, uint8_t calibratedHeatingTime) {
+    PrintProfile profile = PrintProfiles::preset(id);
+    if (id == PRINT_PROFILE_CALIBRATED && calibratedHeatingTime > 0) {
+        profile.heatingTime = calibratedHeatingTime;
+    }
+    return profile;
+}
+
+PrinterService::ProfileState PrinterService::getProfileState() const {
+    portENTER_CRITICAL(&profileMux);
+    ProfileState state = profileState;
+    portEXIT_CRITICAL(&profileMux);
+    return state;
+}
+
+void PrinterService::publishAppliedProfile() {
+    portENTER_CRITICAL(&profileMux);
+    profileState.appliedProfile = appliedProfile;
+    profileState.profileChanges = profileChanges;
+    portEXIT_CRITICAL(&profileMux);
+}
+
+void PrinterService::applyPrintProfile() {
+    ProfileState state = getProfileState();
+    PrintProfileId id = jobProfile == PRINT_PROFILE_DEFAULT ? state.defaultProfile : jobProfile;
+    // A newly selected calibration step is resent even if the profile is the same
+    uint8_t heatingTime = id == PRINT_PROFILE_CALIBRATED ? state.calibratedHeatingTime : 0;
+    if (id == appliedProfile && heatingTime == appliedHeatingTime) {
+        return;
+    }
+    // ESC 7 + DC2 #: 8 bytes, only when the profile changes
+    PrintProfiles::encode(profileSettings(id, state.calibratedHeatingTime), job);
+    appliedProfile = id;
+    appliedHeatingTime = heatingTime;
+    profileChanges++;
+    publishAppliedProfile();
+    Logger::debug(TAG, String("Print profile: ") + PrintProfiles::name(id));
+}
+
+bool PrinterService::setDefaultProfile(PrintProfileId id) {
+    if (id < 0 || id >= PRINT_PROFILE_COUNT) {
+        return false;
+    }
+    
+    portENTER_CRITICAL(&profileMux);
+    uint8_t calibratedTime = profileState.calibratedHeatingTime;
+    bool allowed = id != PRINT_PROFILE_CALIBRATED || calibratedTime > 0;
+    if (allowed) {
+        profileState.defaultProfile = id;
+    }
+    portEXIT_CRITICAL(&profileMux);
+    
+    if (!allowed) {
+        Logger::warn(TAG, "No calibrated profile yet - print the calibration strip first");
+        return false;
+    }
+    saveProfile(id, calibratedTime);
+    Logger::info(TAG, String("Default print profile: ") + PrintProfiles::name(id));
+    return true;
+}
+
+uint8_t PrinterService::getCalibrationStepCount() {
+    return CALIBRATION_STEPS;
+}
+
+bool PrinterService::printCalibrationStrip() {
+    if (!isReady()) {
+        Logger::error(TAG, "Printer not ready");
+        return false;
+    }
+    
+    Logger::info(TAG, "Printing heating calibration strip");
+    
+    sendJobStart();
+    sendCenterAlign();
+    setBold(true);
+    job.println("HEAT CALIBRATION");
+    setBold(false);
+    job.println("Pick the first legible step");
+    sendLeftAlign();
+    job.println("");
+    
+    // Shortest (fastest) burn first; each step gets text and a solid bar
+    PrintProfile step = PrintProfiles::preset(PRINT_PROFILE_BALANCED);
+    const uint8_t barBytes = PRINTER_HEAD_DOTS / 16;
+    const uint8_t barRows = 8;
+    for (uint8_t i = 0; i < CALIBRATION_STEPS; i++) {
+        step.heatingTime = CALIBRATION_TIMES[i];
+        PrintProfiles::encode(step, job);
+        
+        char label[PRINTER_COLUMNS + 1];
+        snprintf(label, sizeof(label), "%u: %4uus Quick brown fox 0123", i + 1, CALIBRATION_TIMES[i] * 10);
+        job.println(label);
+        
+        const uint8_t header[] = {ESCPOS_GS, 'v', '0', 0, barBytes, 0, barRows, 0};
+        job.write(header, sizeof(header));
+        uint8_t* bar = job.reserve((size_t)barBytes * barRows);
+        if (bar) {
+            memset(bar, 0xFF, (size_t)barBytes * barRows);
+            job.commit((size_t)barBytes * barRows);
+        }
+        job.println("");
+    }
+    
+    // The printer is left on the last step; the next job sends its profile
+    appliedProfile = PRINT_PROFILE_DEFAULT;
+    publishAppliedProfile();
+    job.println("");
+    job.println("");
+    sendCutPaper();
+    
+    return sendJob();
+}
+
+bool PrinterService::selectCalibrationStep(uint8_t step) {
+    if (step < 1 || step > CALIBRATION_STEPS) {
+        return false;
+    }
+    uint8_t calibratedTime = CALIBRATION_TIMES[step - 1];
+    
+    // The spooler sees the new time on its next job and resends the profile
+    portENTER_CRITICAL(&profileMux);
+    profileState.calibratedHeatingTime = calibratedTime;
+    profileState.defaultProfile = PRINT_PROFILE_CALIBRATED;
+    portEXIT_CRITICAL(&profileMux);
+    
+    saveProfile(PRINT_PROFILE_CALIBRATED, calibratedTime);
+    Logger::info(TAG, "Calibrated heating time: " + String(calibratedTime * 10) + "us");
+    Logger::info(TAG, String("Default print profile: ") + PrintProfiles::name(PRINT_PROFILE_CALIBRATED));
+    return true;
+}
+
+String PrinterService::getProfileJSON() const {
+    ProfileState state = getProfileState();
+    DynamicJsonDocument doc(1024);
+    doc["default"] = PrintProfiles::name(state.defaultProfile);
+    doc["applied"] = PrintProfiles::name(state.appliedProfile);
+    doc["changes"] = state.profileChanges;
+    
+    JsonArray profiles = doc.createNestedArray("profiles");
+    for (int i = 0; i < PRINT_PROFILE_COUNT; i++) {
+        if (i == PRINT_PROFILE_CALIBRATED && state.calibratedHeatingTime == 0) continue;
+        PrintProfile settings = profileSettings((PrintProfileId)i, state.calibratedHeatingTime);
+        JsonObject entry = profiles.createNestedObject();
+        entry["name"] = PrintProfiles::name((PrintProfileId)i);
+        entry["heatingDots"] = (settings.heatingDots + 1) * 8;
+        entry["heatingTimeUs"] = settings.heatingTime * 10;
+        entry["heatingIntervalUs"] = settings.heatingInterval * 10;
+        entry["densityPercent"] = 50 + settings.density * 5;
+        entry["breakTimeUs"] = settings.breakTime * 250;
+    }
+    
+    JsonArray steps = doc.createNestedArray("calibrationSteps");
+    for (uint8_t i = 0; i < CALIBRATION_STEPS; i++) {
+        steps.add(CALIBRATION_TIMES[i] * 10);
+    }
+    
+    String json;
+    serializeJson(doc, json);
+    return json;
 }
 
 void PrinterService::sendCenterAlign() {
-    hardware->printerWrite(27);  // ESC
-    hardware->printerWrite('a');
-    hardware->printerWrite(1);
-    delay(10);
+    job.align(1);
 }
 
 void PrinterService::sendLeftAlign() {
-    hardware->printerWrite(27);  // ESC
-    hardware->printerWrite('a');
-    hardware->printerWrite(0);
-    delay(10);
+    job.align(0);
 }
 
 void PrinterService::sendDoubleHeight() {
     // ESC ! n - Set character printing method
     // Bit 4 = Double height (16)
-    hardware->printerWrite(27);  // ESC
-    hardware->printerWrite('!');
-    hardware->printerWrite(16);   // Double height only (bit 4 = 1)
-    delay(10);
+    job.printMode(16);   // Double height only (bit 4 = 1)
+    columns = TextLayout::columnsForMode(16);
 }
 
 void PrinterService::sendExtraLarge() {
     // ESC ! n - Set character printing method
     // Bit 4 = Double height (16) + Bit 5 = Double width (32) = 48
-    hardware->printerWrite(27);  // ESC
-    hardware->printerWrite('!');
-    hardware->printerWrite(48);  // Double height + Double width (16 + 32)
-    delay(10);
+    job.printMode(48);  // Double height + Double width (16 + 32)
+    columns = TextLayout::columnsForMode(48);
 }
 
 void PrinterService::sendNormalSize() {
     // ESC ! 0 - Normal size (all bits = 0)
-    hardware->printerWrite(27);  // ESC
-    hardware->printerWrite('!');
-    hardware->printerWrite(0);
-    delay(10);
+    job.printMode(0);
+    columns = TextLayout::columnsForMode(0);
 }
 
 void PrinterService::sendCutPaper() {
     // GS V n - Cut paper command
     // n = 0: Full cut, n = 1: Partial cut
-    hardware->printerWrite(29);  // GS
-    hardware->printerWrite(86);  // V
-    hardware->printerWrite(0);    // Full cut
-    delay(100);
+    job.cut(0);    // Full cut
 }
 
 void PrinterService::setCharacterCodePage(uint8_t page) {
-    if (!hardware || !hardware->printerAvailable()) {
-        return; // Safety check
-    }
     // ESC t n - Select character code page
     // 255 = GBK (supports Chinese and extended characters)
     // 253 = UNICODE UCS-2
     // 0 = CP437 (U.S.A., Standard Europe) - default
-    hardware->printerWrite(27);  // ESC
-    hardware->printerWrite(116); // t
-    hardware->printerWrite(page);
-    delay(10);
+    job.codePage(page);
+    transcoder.reset(page);
 }
 
 void PrinterService::setDefaultLineSpace() {
-    if (!hardware || !hardware->printerAvailable()) {
-        return; // Safety check
-    }
     // ESC 2 - Set line space to default (30 dots)
-    hardware->printerWrite(27);  // ESC
-    hardware->printerWrite(50);  // 2
-    delay(10);
+    job.defaultLineSpace();
 }
 
 void PrinterService::setLineSpacing(uint8_t dots) {
-    if (!hardware || !hardware->printerAvailable()) {
-        return; // Safety check
-    }
     // ESC 3 n - Set line spacing to n dots (0-255)
-    hardware->printerWrite(27);  // ESC
-    hardware->printerWrite(51);  // 3
-    hardware->printerWrite(dots);
-    delay(10);
+    job.lineSpacing(dots);
 }
 
 void PrinterService::setBold(bool enable) {
-    if (!hardware || !hardware->printerAvailable()) {
-        return; // Safety check
-    }
     // ESC E n - Turn emphasized mode on/off (bold)
-    hardware->printerWrite(27);  // ESC
-    hardware->printerWrite(69);  // E
-    hardware->printerWrite(enable ? 1 : 0);
-    delay(10);
+    job.bold(enable);
 }
 
 void PrinterService::setUnderline(uint8_t mode) {
-    if (!hardware || !hardware->printerAvailable()) {
-        return; // Safety check
-    }
     // ESC - n - Set underline mode
     // 0 = off, 1 = 1 dot thick, 2 = 2 dots thick
-    hardware->printerWrite(27);  // ESC
-    hardware->printerWrite(45);  // -
-    hardware->printerWrite(mode);
-    delay(10);
+    job.underline(mode);
 }
 
 void PrinterService::setInverse(bool enable) {
-    if (!hardware || !hardware->printerAvailable()) {
-        return; // Safety check
-    }
     // GS B n - Turn white/black reverse printing mode on/off
-    hardware->printerWrite(29);  // GS
-    hardware->printerWrite(66);  // B
-    hardware->printerWrite(enable ? 1 : 0);
-    delay(10);
-}
-
-String PrinterService::sanitizeForPrinter(const String& text) {
-    // Replace common emojis with text equivalents that thermal printers can handle
-    String result = text;
-    
-    // Love/Heart emojis
-    result.replace("💌", "[LOVE LETTER]");
-    result.replace("💕", "<3");
-    result.replace("❤️", "<3");
-    result.replace("❤", "<3");
-    result.replace("💖", "<3");
-    result.replace("💝", "[GIFT]");
-    result.replace("💗", "<3");
-    result.replace("💓", "<3");
-    result.replace("💞", "<3");
-    result.replace("💟", "<3");
-    result.replace("💋", "[KISS]");
-    
-    // Face emojis
-    result.replace("😊", ":)");
-    result.replace("😍", ":)");
-    result.replace("😘", ":*");
-    result.replace("🥰", ":)");
-    result.replace("😻", ":)");
-    
-    // Nature emojis
-    result.replace("🌵", "[CACTUS]");
-    result.replace("🌹", "[ROSE]");
-    result.replace("🌸", "[FLOWER]");
-    result.replace("🌺", "[FLOWER]");
-    result.replace("🌻", "[FLOWER]");
-    result.replace("🌷", "[FLOWER]");
-    result.replace("💐", "[FLOWERS]");
-    
-    // Symbols
-    result.replace("⭐", "*");
-    result.replace("✨", "*");
-    result.replace("💫", "*");
-    result.replace("🌟", "*");
-    result.replace("🎉", "[PARTY]");
-    result.replace("🎊", "[PARTY]");
-    result.replace("🎈", "[BALLOON]");
-    result.replace("🎁", "[GIFT]");
-    
-    // Utility symbols
-    result.replace("⏰", "[ALARM]");
-    result.replace("📝", "[NOTE]");
-    result.replace("🛒", "[CART]");
-    result.replace("✅", "[OK]");
-    result.replace("❌", "[X]");
-    result.replace("⚠️", "[!]");
-    result.replace("⚠", "[!]");
-    result.replace("🔧", "[TOOL]");
-    result.replace("📡", "[SIGNAL]");
-    result.replace("🖨️", "[PRINTER]");
-    result.replace("🖨", "[PRINTER]");
-    result.replace("💧", "[DROP]");
-    
-    // Remove any remaining multi-byte UTF-8 characters (emojis we didn't catch)
-    String cleaned = "";
-    for (unsigned int i = 0; i < result.length(); i++) {
-        char c = result.charAt(i);
-        // Keep only printable ASCII characters (32-126) plus newline/tab
-        if ((c >= 32 && c <= 126) || c == '\n' || c == '\r' || c == '\t') {
-            cleaned += c;
+    job.inverse(enable);
+}
+
+bool PrinterService::sendJob() {
+    // Ask the printer to report back once it has processed the whole job
+    bool synced = !dryRun && status.isSyncEnabled();
+    if (synced) {
+        status.appendSync(job);
+    }
+    
+    if (job.hasOverflowed()) {
+        Logger::error(TAG, "Print job too large for available memory, dropping");
+        job.reset();
+        glyphsResident = false;
+        status.abandonSyncs();
+        return false;
+    }
+    
+    unsigned long startTime = millis();
+    size_t bytes = job.size();
+    
+    bool written = true;
+    bool drained = true;
+    if (dryRun) {
+        dryRun->feed(job.data(), bytes);
+    } else {
+        // One write for the whole job; the UART driver queues it in its TX ring
+        written = hardware->printerWrite(job.data(), bytes);
+        
+        // Wait for the UART to drain: theoretical wire time plus a margin
+        drained = hardware->printerWaitTxDone(wireTimeMs(bytes) + PRINTER_DRAIN_MARGIN_MS);
+        uartWaitMs += millis() - startTime;
+    }
+    
+    // Then for the printer itself, pausing here if it runs out of paper
+    bool printed = true;
+    if (written && drained && synced) {
+        unsigned long waitStart = millis();
+        printed = awaitPrinter(0);
+        printerWaitMs += millis() - waitStart;
+    } else if (synced) {
+        status.abandonSyncs();
+    }
+    
+    lastJobBytes = bytes;
+    lastJobDurationMs = millis() - startTime;
+    lastRasterRows = 0;
+    job.reset();
+    
+    if (!written || !drained) {
+        // Can't tell how much arrived - download the glyphs again next time
+        glyphsResident = false;
+        Logger::error(TAG, "Printer UART write failed (" + String(bytes) + " bytes)");
+        return false;
+    }
+    if (!printed) {
+        glyphsResident = false;
+        return false;
+    }
+    
+    Logger::debug(TAG, "Job sent: " + String(bytes) + " bytes in " + String(lastJobDurationMs) + "ms");
+    return true;
+}
+
+bool PrinterService::awaitPrinter(uint8_t maxPending) {
+    unsigned long pausedAt = 0;
+    
+    while (!status.awaitSyncs(maxPending, pausedAt ? PRINTER_PAUSE_POLL_MS : PRINTER_SYNC_TIMEOUT_MS)) {
+        // No reply yet - DLE EOT still gets answered while the printer is stopped
+        if (!status.poll()) {
+            Logger::warn(TAG, "Printer stopped answering while printing");
+            status.abandonSyncs();
+            paused = false;
+            return true;
         }
-        // Skip multi-byte UTF-8 sequences
-        else if ((c & 0x80) != 0) {
-            // Skip continuation bytes
-            while (i + 1 < result.length() && (result.charAt(i + 1) & 0xC0) == 0x80) {
-                i++;
+        
+        if (status.canPrint()) {
+            if (!pausedAt) {
+                // Healthy but never replied to GS r
+                status.disableSync();
+                return true;
             }
+            // Paper is back; the printer resumes from its buffer
+            Logger::info(TAG, "Printer ready, resuming after " + String((millis() - pausedAt) / 1000) + "s");
+            pausedAt = 0;
+            paused = false;
+            continue;
+        }
+        
+        if (!pausedAt) {
+            pausedAt = millis();
+            paused = true;
+            Logger::warn(TAG, String("Job paused: printer ") +
+                              PrinterStatus::stateToString(status.getState()));
+        } else if (millis() - pausedAt > PRINTER_PAUSE_TIMEOUT_MS) {
+            Logger::error(TAG, "Printer not ready for too long, abandoning job");
+            status.abandonSyncs();
+            paused = false;
+            return false;
         }
     }
     
-    return cleaned;
+    paused = false;
+    return true;
 }
 
-bool PrinterService::isReady() const {
-    return hardware && hardware->printerAvailable();
+bool PrinterService::refreshStatus() {
+    status.poll();
+    
+    if (!status.isResponding()) {
+        // It may be power cycled while silent, which clears the glyphs;
+        // the next job downloads them again
+        invalidateUserGlyphs();
+    }
+    return status.canPrint();
 }
 
-bool PrinterService::printTest() {
+uint32_t PrinterService::wireTimeMs(size_t bytes) const {
+    // 8N1: 10 bits on the wire per byte
+    return (uint32_t)(((uint64_t)bytes * 10UL * 1000UL) / getBaudRate());
+}
+
+uint32_t PrinterService::getBaudRate() const {
+    return hardware ? hardware->getPrinterBaud() : THERMAL_PRINTER_BAUD;
+}
+
+bool PrinterService::isSupportedBaud(uint32_t baud) {
+    for (uint8_t i = 0; i < BAUD_RATE_COUNT; i++) {
+        if (BAUD_RATES[i] == baud) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PrinterService::detectBaudRate() {
     if (!isReady()) {
-        Logger::error(TAG, "Printer not ready");
         return false;
     }
     
-    Logger::info(TAG, "Printing minimal test (raw text only)...");
+    // The saved rate goes first: a status query at the wrong rate reaches
+    // the printer as noise and can print as a few stray characters
+    uint32_t saved = loadSavedBaud();
+    uint32_t first = isSupportedBaud(saved) ? saved : THERMAL_PRINTER_BAUD;
+    const char* firstSource = first == saved ? "nvs" : "default";
     
-    // No initialization - just send raw text to test serial communication
-    hardware->printerPrintln("TEST");
-    hardware->printerPrintln("1234567890");
-    hardware->printerPrintln("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
-    hardware->printerPrintln("abcdefghijklmnopqrstuvwxyz");
-    hardware->printerPrintln("");
-    hardware->printerPrintln("");
-    hardware->printerPrintln("");
-    delay(100);
+    hardware->setPrinterBaud(first);
+    if (status.poll()) {
+        baudSource = firstSource;
+        Logger::info(TAG, "Printer answering at " + String(first) + " baud (" + firstSource + ")");
+        return true;
+    }
     
-    Logger::info(TAG, "Test print complete");
+    for (uint8_t i = 0; i < BAUD_RATE_COUNT; i++) {
+        if (BAUD_RATES[i] == first) continue;
+        hardware->setPrinterBaud(BAUD_RATES[i]);
+        if (status.poll()) {
+            saveBaud(BAUD_RATES[i]);
+            baudSource = "probe";
+            Logger::info(TAG, "Printer found at " + String(BAUD_RATES[i]) + " baud, saved");
+            return true;
+        }
+    }
+    
+    // No status support (or RX not wired) - keep the configured rate
+    hardware->setPrinterBaud(first);
+    baudSource = firstSource;
+    Logger::warn(TAG, "No status reply at any rate, using " + String(first) + " baud");
+    return false;
+}
+
+bool PrinterService::changeBaudRate(uint32_t baud, bool saveUnverified) {
+    if (!isReady() || !isSupportedBaud(baud)) {
+        return false;
+    }
+    
+    uint32_t current = getBaudRate();
+    bool verifiable = status.isResponding();
+    lastBaudRequest = baud;
+    lastBaudVerified = false;
+    lastBaudSaved = false;
+    
+    if (baud != current) {
+        Logger::info(TAG, "Switching printer from " + String(current) + " to " + String(baud) + " baud");
+        
+        // Tell the printer at the rate it is listening on; it restarts to apply
+        job.reset();
+        job.serialBaudRate(baud);
+        hardware->printerWrite(job.data(), job.size());
+        hardware->printerWaitTxDone(wireTimeMs(job.size()) + PRINTER_DRAIN_MARGIN_MS);
+        job.reset();
+        delay(PRINTER_BAUD_SETTLE_MS);
+        delayMs += PRINTER_BAUD_SETTLE_MS;
+        
+        hardware->setPrinterBaud(baud);
+        invalidateUserGlyphs();  // The restart cleared them
+    }
+    
+    if (verifiable) {
+        lastBaudVerified = status.poll();
+        if (!lastBaudVerified) {
+            Logger::error(TAG, "No reply at " + String(baud) + " baud, reverting to " + String(current));
+            hardware->setPrinterBaud(current);
+            if (!status.poll()) {
+                // Silent at the old rate too: it may have switched after all,
+                // or restarted at its saved rate - search rather than guess
+                Logger::warn(TAG, "No reply at " + String(current) + " baud either, probing");
+                detectBaudRate();
+            }
+            return false;
+        }
+    }
+    
+    // Without status replies only the test print shows whether it worked,
+    // so an unverified rate is kept for this session unless asked to save
+    if (lastBaudVerified || saveUnverified) {
+        saveBaud(baud);
+        lastBaudSaved = true;
+    }
+    baudSource = "api";
     return true;
 }
 
-bool PrinterService::printReceipt(const String& message, bool includeWeatherAndSanitizer, time_t createdTime) {
+bool PrinterService::printBaudTest() {
     if (!isReady()) {
         Logger::error(TAG, "Printer not ready");
         return false;
     }
     
-    // Sanitize message for printer compatibility
-    String cleanMessage = sanitizeForPrinter(message);
+    uint32_t baud = getBaudRate();
     
-    Logger::info(TAG, "Printing receipt: \"" + cleanMessage.substring(0, 30) + "...\"");
+    // Same size at every rate so the timings compare
+    char header[33];
+    snprintf(header, sizeof(header), "BAUD TEST %6lu", (unsigned long)baud);
+    job.println(header);
+    for (uint8_t i = 0; i < 8; i++) {
+        job.println("TEST 1234567890 ABCDEFGHIJKLMNO");
+    }
+    job.println("");
+    job.println("");
+    job.println("");
     
-    // Initialize printer
-    sendInitialize();
-    sendCenterAlign();
+    if (!sendJob()) {
+        return false;
+    }
     
-    // Header
-    hardware->printerPrintln("================================");
-    setBold(true);
-    if (includeWeatherAndSanitizer) {
-        hardware->printerPrintln("SMIT'S MESSAGE");
-    } else {
-        hardware->printerPrintln("REMINDER");
+    for (uint8_t i = 0; i < BAUD_RATE_COUNT; i++) {
+        if (BAUD_RATES[i] == baud) {
+            baudResults[i].bytes = lastJobBytes;
+            baudResults[i].ms = lastJobDurationMs > 0 ? lastJobDurationMs : 1;
+        }
     }
-    setBold(false);
-    hardware->printerPrintln("================================");
-    delay(50);
     
-    // Date/Time
-    if (includeWeatherAndSanitizer) {
-        sendLeftAlign();
-        struct tm timeinfo;
-        if (getLocalTime(&timeinfo)) {
-            char buffer[30];
-            strftime(buffer, sizeof(buffer), "%b %d, %Y %I:%M %p", &timeinfo);
-            hardware->printerPrintln("Date: " + String(buffer));
+    Logger::info(TAG, "Baud test at " + String(baud) + ": " + String(lastJobBytes) + " bytes in " +
+                      String(lastJobDurationMs) + "ms");
+    return true;
+}
+
+String PrinterService::getBaudJSON() const {
+    DynamicJsonDocument doc(1024);
+    doc["baud"] = getBaudRate();
+    doc["source"] = baudSource;
+    doc["statusReplies"] = status.getSnapshot().responding;
+    
+    if (lastBaudRequest > 0) {
+        JsonObject last = doc.createNestedObject("lastChange");
+        last["baud"] = lastBaudRequest;
+        last["verified"] = lastBaudVerified;
+        last["saved"] = lastBaudSaved;
+    }
+    
+    // Reference receipt per rate: wire limit vs what the printer achieved
+    JsonArray rates = doc.createNestedArray("rates");
+    for (uint8_t i = 0; i < BAUD_RATE_COUNT; i++) {
+        JsonObject rate = rates.createNestedObject();
+        rate["baud"] = BAUD_RATES[i];
+        rate["wireBytesPerSecond"] = BAUD_RATES[i] / 10;
+        if (baudResults[i].ms > 0) {
+            rate["referenceBytes"] = baudResults[i].bytes;
+            rate["referenceMs"] = baudResults[i].ms;
+            rate["bytesPerSecond"] = (uint32_t)(((uint64_t)baudResults[i].bytes * 1000) / baudResults[i].ms);
         }
-        hardware->printerPrintln("");
-        delay(50);
-    } else if (createdTime > 0) {
-        sendLeftAlign();
-        struct tm* createdInfo = localtime(&createdTime);
-        if (createdInfo) {
-            char buffer[30];
-            strftime(buffer, sizeof(buffer), "%b %d, %Y %I:%M %p", createdInfo);
-            hardware->printerPrintln("Set on: " + String(buffer));
+    }
+    
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
+
+bool PrinterService::isReady() const {
+    return dryRun || (hardware && hardware->printerAvailable());
+}
+
+bool PrinterService::printTest() {
+    if (!isReady()) {
+        Logger::error(TAG, "Printer not ready");
+        return false;
+    }
+    
+    Logger::info(TAG, "Printing minimal test (raw text only)...");
+    
+    // No initialization - just send raw text to test serial communication
+    // (plus the heating profile, if it changed)
+    applyPrintProfile();
+    job.println("TEST");
+    job.println("1234567890");
+    job.println("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    job.println("abcdefghijklmnopqrstuvwxyz");
+    job.println("");
+    job.println("");
+    job.println("");
+    
+    if (!sendJob()) {
+        return false;
+    }
+    
+    Logger::info(TAG, "Test print complete");
+    return true;
+}
+
+void PrinterService::printTimestamp(const char* label, const struct tm* timeinfo) {
+    char buffer[30];
+    strftime(buffer, sizeof(buffer), "%b %d, %Y %I:%M %p", timeinfo);
+    job.print(label);
+    job.println(buffer);
+}
+
+uint16_t PrinterService::layoutText(const String& text, uint8_t lineColumns, uint8_t indent, bool justify,
+                                    bool emit) {
+    uint8_t width = lineColumns > indent + 1 ? lineColumns - indent : 1;
+    bool firstLine = true;
+    
+    return TextLayout::wrap(text, width, [&](const char* line, size_t length, uint8_t lineWidth, bool paragraphEnd) {
+        if (!emit) return;
+        
+        if (!firstLine) {
+            for (uint8_t i = 0; i < indent; i++) job.write(' ');
+        }
+        firstLine = false;
+        
+        // Transcode UTF-8 straight into the job buffer: accented characters
+        // map to one code page byte (with ESC t only when the page must
+        // change), emoji fall back to their ASCII replacements
+        char justified[PRINTER_COLUMNS * 2 + 64];
+        if (justify && !paragraphEnd &&
+            TextLayout::justify(line, length, lineWidth, width, justified, sizeof(justified))) {
+            transcoder.transcode(justified, strlen(justified), job);
+        } else {
+            transcoder.transcode(line, length, job);
+        }
+        job.println("");
+    });
+}
+
+uint16_t PrinterService::layoutItems(const String* items, int itemCount, uint8_t lineColumns, bool emit) {
+    uint8_t half = lineColumns / 2;
+    uint16_t lines = 0;
+    int i = 0;
+    
+    while (i < itemCount) {
+        char prefix[8];
+        uint8_t prefixWidth = snprintf(prefix, sizeof(prefix), "%d. ", i + 1);
+        uint16_t itemWidth = prefixWidth + TextLayout::measure(items[i]);
+        
+        // Two short items side by side, each in half the line
+        if (GROCERY_LIST_TWO_COLUMNS && i + 1 < itemCount && itemWidth < half) {
+            char nextPrefix[8];
+            uint8_t nextPrefixWidth = snprintf(nextPrefix, sizeof(nextPrefix), "%d. ", i + 2);
+            if (nextPrefixWidth + TextLayout::measure(items[i + 1]) <= half) {
+                if (emit) {
+                    job.print(prefix);
+                    transcoder.transcode(items[i], job);
+                    for (uint16_t pad = itemWidth; pad < half; pad++) job.write(' ');
+                    job.print(nextPrefix);
+                    transcoder.transcode(items[i + 1], job);
+                    job.println("");
+                }
+                lines++;
+                i += 2;
+                continue;
+            }
         }
-        hardware->printerPrintln("");
-        delay(50);
+        
+        // Long item: wrap with a hanging indent under the text
+        if (emit) job.print(prefix);
+        lines += layoutText(items[i], lineColumns, prefixWidth, false, emit);
+        i++;
     }
     
-    // Message (Normal size - matches grocery list style)
-    sendCenterAlign();
-    hardware->printerPrintln(cleanMessage);
-    delay(50);
+    return lines;
+}
+
+uint16_t PrinterService::layoutSlot(TemplateSlot slot, const ReceiptFields& fields, bool emit) {
+    // Looked up per slot, so slots after SLOT_INIT see the reset print mode
+    uint8_t lineColumns = emit ? columns : PRINTER_COLUMNS;
     
-    // Weather and Sanitizer info (for user messages only)
-    if (includeWeatherAndSanitizer) {
-        hardware->printerPrintln("--------------------------------");
-        delay(50);
+    switch (slot) {
+        case SLOT_INIT:
+            if (emit && fields.batchStart) sendJobStart();
+            return 0;
         
-        sendLeftAlign();
-        hardware->printerPrintln("Today's Weather:");
-        hardware->printerPrintln("  " + sanitizeForPrinter(currentWeather));
-        delay(50);
+        case SLOT_CUT:
+            if (fields.batchEnd) {
+                if (emit) sendCutPaper();
+                return 0;
+            }
+            if (emit) {
+                sendCenterAlign();
+                job.println("");
+                job.println("- - - - - - - - - - - - - - - -");
+                job.println("");
+            }
+            return 3;
+        
+        case SLOT_DATE: {
+            if (!emit) return 2;
+            struct tm timeinfo;
+            uint16_t lines = 1;
+            if (getLocalTime(&timeinfo)) {
+                printTimestamp("Date: ", &timeinfo);
+                lines++;
+            }
+            job.println("");
+            return lines;
+        }
+        
+        case SLOT_CREATED:
+            if (fields.createdTime <= 0) return 0;
+            if (emit) {
+                struct tm* createdInfo = localtime(&fields.createdTime);
+                if (createdInfo) {
+                    printTimestamp("Set on: ", createdInfo);
+                }
+                job.println("");
+            }
+            return 2;
+        
+        case SLOT_MESSAGE:
+            // Justified paragraphs; the last line of each stays centered
+            return layoutText(*fields.message, lineColumns, 0, true, emit);
+        
+        case SLOT_WEATHER:
+            // Template prints a two-space indent before the slot
+            return layoutText(*fields.weather, lineColumns, 2, false, emit);
         
-        hardware->printerWriteString("Moisture: ");
-        hardware->printerWriteString(String(hardware->getMoisturePercent(), 1));
-        hardware->printerWriteString("%  Sanitizer: ");
-        hardware->printerWriteString(String(hardware->getSanitizerLevel(), 1));
-        hardware->printerPrintln("%");
-        delay(50);
+        case SLOT_SENSORS: {
+            char line[48];
+            snprintf(line, sizeof(line), "Moisture: %.1f%%  Sanitizer: %.1f%%",
+                     hardware->getMoisturePercent(), hardware->getSanitizerLevel());
+            return layoutText(line, lineColumns, 0, false, emit);
+        }
+        
+        case SLOT_ITEMS:
+            return layoutItems(fields.items, fields.itemCount, lineColumns, emit);
+        
+        default:
+            return 0;
     }
+}
+
+uint16_t PrinterService::renderTemplate(const ReceiptTemplate& tpl, const ReceiptFields& fields, bool emit) {
+    unsigned long startMicros = micros();
+    uint16_t lines = tpl.literalLines;
     
-    // Footer
-    hardware->printerPrintln("================================");
-    delay(50);
+    if (emit) {
+        // Grow the job once up front so the literal copies don't reallocate
+        job.reserve(tpl.literalBytes);
+    }
     
-    sendCutPaper();
+    for (uint8_t i = 0; i < tpl.count; i++) {
+        const TemplateSegment& segment = tpl.segments[i];
+        if (!segment.bytes) {
+            lines += layoutSlot(segment.slot, fields, emit);
+        } else if (emit) {
+            job.write((const uint8_t*)segment.bytes, segment.length);
+        }
+    }
     
-    Logger::info(TAG, "Receipt printed successfully");
+    if (emit) {
+        Logger::debug(TAG, "Template rendered: " + String(job.size()) + " bytes, " + String(lines) +
+                           " lines in " + String(micros() - startMicros) + "us");
+    }
+    return lines;
+}
+
+uint16_t PrinterService::estimateReceiptLines(const String& message, bool includeWeatherAndSanitizer,
+                                              const String& weather, time_t createdTime) {
+    ReceiptFields fields;
+    fields.message = &message;
+    fields.weather = &weather;
+    fields.createdTime = createdTime;
+    return renderTemplate(includeWeatherAndSanitizer ? MESSAGE_RECEIPT_TEMPLATE : REMINDER_RECEIPT_TEMPLATE,
+                          fields, false);
+}
+
+uint16_t PrinterService::estimateGroceryListLines(const String* items, int itemCount) {
+    ReceiptFields fields;
+    fields.items = items;
+    fields.itemCount = itemCount;
+    return renderTemplate(GROCERY_LIST_TEMPLATE, fields, false);
+}
+
+bool PrinterService::printReceipt(const String& message, bool includeWeatherAndSanitizer, time_t createdTime) {
+    ReceiptContent receipt = {&message, &currentWeather, includeWeatherAndSanitizer, createdTime};
+    return printReceipts(&receipt, 1);
+}
+
+bool PrinterService::printReceipts(const ReceiptContent* receipts, int count) {
+    if (!isReady()) {
+        Logger::error(TAG, "Printer not ready");
+        return false;
+    }
+    
+    if (count <= 0) {
+        return false;
+    }
+    
+    if (count == 1) {
+        Logger::info(TAG, "Printing receipt: \"" + receipts[0].message->substring(0, 30) + "...\"");
+    } else {
+        Logger::info(TAG, "Printing " + String(count) + " receipts as one job");
+    }
+    
+    // User messages carry date, weather and sensors; reminders their creation time
+    for (int i = 0; i < count; i++) {
+        ReceiptFields fields;
+        fields.message = receipts[i].message;
+        fields.weather = receipts[i].weather;
+        fields.createdTime = receipts[i].createdTime;
+        fields.batchStart = i == 0;
+        fields.batchEnd = i == count - 1;
+        renderTemplate(receipts[i].includeWeatherAndSanitizer ? MESSAGE_RECEIPT_TEMPLATE : REMINDER_RECEIPT_TEMPLATE,
+                       fields);
+    }
+    
+    if (!sendJob()) {
+        return false;
+    }
+    
+    Logger::info(TAG, count == 1 ? "Receipt printed successfully" : "Receipts printed successfully");
     return true;
 }
 
@@ -346,100 +902,393 @@ bool PrinterService::printGroceryList(const String* items, int itemCount) {
     
     Logger::info(TAG, "Printing grocery list (" + String(itemCount) + " items)");
     
-    // Initialize printer
-    sendInitialize();
-    sendCenterAlign();
+    ReceiptFields fields;
+    fields.items = items;
+    fields.itemCount = itemCount;
+    renderTemplate(GROCERY_LIST_TEMPLATE, fields);
     
-    // Header
-    hardware->printerPrintln("================================");
-    setBold(true);
-    hardware->printerPrintln("GROCERY LIST");
-    setBold(false);
-    hardware->printerPrintln("================================");
-    delay(50);
+    if (!sendJob()) {
+        return false;
+    }
     
-    // Date
-    sendLeftAlign();
-    struct tm timeinfo;
-    if (getLocalTime(&timeinfo)) {
-        char buffer[30];
-        strftime(buffer, sizeof(buffer), "%b %d, %Y %I:%M %p", &timeinfo);
-        hardware->printerPrintln("Date: " + String(buffer));
+    Logger::info(TAG, "Grocery list printed successfully");
+    return true;
+}
+
+bool PrinterService::printBitmap(const uint8_t* bitmap, uint16_t width, uint16_t height) {
+    if (!bitmap) {
+        Logger::error(TAG, "Invalid bitmap parameters");
+        return false;
+    }
+    
+    // Rows are read straight out of the (flash or RAM) array band by band
+    return printRaster(width, height, [bitmap](uint16_t row, uint8_t* out, uint16_t bytesPerRow) {
+        memcpy(out, bitmap + (size_t)row * bytesPerRow, bytesPerRow);
+        return true;
+    });
+}
+
+bool PrinterService::printRaster(uint16_t width, uint16_t height, RasterRowSource source) {
+    if (!isReady()) {
+        Logger::error(TAG, "Printer not ready");
+        return false;
+    }
+    
+    if (!source || width == 0 || height == 0) {
+        Logger::error(TAG, "Invalid raster parameters");
+        return false;
+    }
+    
+    // Width must be a multiple of 8 for raster mode and fit the print head
+    if (width % 8 != 0 || width > PRINTER_HEAD_DOTS) {
+        Logger::error(TAG, "Raster width must be a multiple of 8 and at most " + String(PRINTER_HEAD_DOTS));
+        return false;
+    }
+    
+    Logger::info(TAG, "Printing raster " + String(width) + "x" + String(height));
+    
+    applyPrintProfile();  // Rides along with the first band
+    
+    uint16_t bytesPerRow = width / 8;
+    unsigned long startTime = millis();
+    unsigned long printerFreeAt = startTime;  // When the head should finish the last band sent
+    size_t totalBytes = 0;
+    bool success = true;
+    
+    for (uint16_t bandStart = 0; bandStart < height && success; bandStart += RASTER_BAND_HEIGHT) {
+        uint16_t bandRows = min((uint16_t)RASTER_BAND_HEIGHT, (uint16_t)(height - bandStart));
+        size_t bandBytes = (size_t)bytesPerRow * bandRows;
+        
+        // GS v 0 m xL xH yL yH d1...dk - Print raster bit image (one band)
+        const uint8_t header[] = {
+            ESCPOS_GS, 'v', '0', 0,
+            (uint8_t)(bytesPerRow & 0xFF), (uint8_t)((bytesPerRow >> 8) & 0xFF),
+            (uint8_t)(bandRows & 0xFF), (uint8_t)((bandRows >> 8) & 0xFF)
+        };
+        job.write(header, sizeof(header));
+        
+        // Rows are generated directly into the band - RAM is bounded by one band
+        uint8_t* band = job.reserve(bandBytes);
+        if (!band) {
+            Logger::error(TAG, "Out of memory for raster band");
+            success = false;
+            break;
+        }
+        for (uint16_t r = 0; r < bandRows; r++) {
+            if (!source(bandStart + r, band + (size_t)r * bytesPerRow, bytesPerRow)) {
+                Logger::warn(TAG, "Raster source aborted at row " + String(bandStart + r));
+                success = false;
+                break;
+            }
+        }
+        if (!success) break;
+        job.commit(bandBytes);
+        
+        if (dryRun) {
+            dryRun->feed(job.data(), job.size());
+            totalBytes += job.size();
+            job.reset();
+            continue;
+        }
+        
+        // The previous band was draining while this one was generated; wait
+        // for the UART to finish it, then only hold back if the head would
+        // still be burning the previous band when this one finishes arriving
+        uint32_t bandWireMs = wireTimeMs(job.size());
+        unsigned long waitStart = millis();
+        bool drained = hardware->printerWaitTxDone(bandWireMs + PRINTER_DRAIN_MARGIN_MS);
+        uartWaitMs += millis() - waitStart;
+        if (!drained) {
+            success = false;
+            break;
+        }
+        if (status.isSyncEnabled()) {
+            // Keep at most one unprinted band in the printer, going by its
+            // own replies; the band written now goes out with a sync request
+            waitStart = millis();
+            bool ready = awaitPrinter(1);
+            printerWaitMs += millis() - waitStart;
+            if (!ready) {
+                success = false;
+                break;
+            }
+        } else {
+            long headWaitMs = (long)(printerFreeAt - millis()) - (long)bandWireMs;
+            if (headWaitMs > 0) {
+                delay(headWaitMs);
+                delayMs += headWaitMs;
+            }
+        }
+        if (status.isSyncEnabled()) {
+            status.appendSync(job);
+        }
+        
+        if (!hardware->printerWrite(job.data(), job.size())) {
+            success = false;
+            break;
+        }
+        totalBytes += job.size();
+        job.reset();
+        
+        unsigned long bandArrives = millis() + bandWireMs;
+        unsigned long headStart = bandArrives > printerFreeAt ? bandArrives : printerFreeAt;
+        printerFreeAt = headStart + (bandRows * RASTER_ROW_TIME_US) / 1000;
     }
-    hardware->printerPrintln("");
-    delay(50);
     
-    // Items (sanitize each item for printer compatibility)
-    for (int i = 0; i < itemCount; i++) {
-        hardware->printerWriteString(String(i + 1) + ". ");
-        hardware->printerPrintln(sanitizeForPrinter(items[i]));
-        delay(20);
+    // Line feed after image, then let the last band drain
+    job.reset();
+    job.println("");
+    if (success) {
+        success = sendJob();
+    } else {
+        job.reset();
+        status.abandonSyncs();
     }
     
-    hardware->printerPrintln("================================");
-    delay(50);
+    unsigned long elapsed = millis() - startTime;
+    lastJobBytes = totalBytes;
+    lastJobDurationMs = elapsed;
+    lastRasterRows = height;
+    
+    if (!success) {
+        Logger::error(TAG, "Raster print failed");
+        return false;
+    }
     
+    Logger::info(TAG, "Raster printed: " + String(totalBytes) + " bytes in " + String(elapsed) + "ms (" +
+                      String(getRasterBytesPerSecond()) + " B/s, " + String(getRasterMsPer100Rows()) + " ms/100 rows)");
+    return true;
+}
+
+uint8_t PrinterService::fitModuleDots(uint16_t modules, uint8_t preferred) {
+    uint16_t fit = PRINTER_HEAD_DOTS / modules;
+    return fit < preferred ? fit : preferred;
+}
+
+bool PrinterService::detectSymbolSupport() {
+    if (!isReady() || !status.isResponding()) {
+        // Nothing to ask; raster works on every printer
+        Logger::info(TAG, String("Symbol support not probed, using ") +
+                          (nativeSymbols ? "GS ( k / GS k" : "raster"));
+        return nativeSymbols;
+    }
+    
+    // Store a one-byte QR code and ask for its size. Printers with QR
+    // support answer 0x37 ... NUL; others ignore it or hold a few stray
+    // characters in the line buffer, which the trailing ESC @ discards.
+    hardware->printerFlushInput();
+    job.reset();
+    job.qrCodeStore((const uint8_t*)"1", 1, 1, QR_ERROR_CORRECTION);
+    job.qrCodeTransmitSize();
+    job.initialize();
+    hardware->printerWrite(job.data(), job.size());
+    job.reset();
+    glyphsResident = false;
+    
+    bool header = false;
+    bool complete = false;
+    unsigned long start = millis();
+    while (!complete && millis() - start < PRINTER_SYMBOL_PROBE_MS) {
+        int reply = hardware->printerRead(PRINTER_SYMBOL_PROBE_MS - (millis() - start));
+        if (reply < 0) break;
+        if (!header) {
+            header = reply == 0x37;
+        } else {
+            complete = reply == 0;
+        }
+    }
+    
+    nativeSymbols = header && complete;
+    symbolSource = "probe";
+    Logger::info(TAG, nativeSymbols ? "Printer has native QR / barcode commands"
+                                    : "No QR reply from printer, symbols print as raster");
+    return nativeSymbols;
+}
+
+bool PrinterService::finishSymbol(const String& caption, unsigned long startTime, size_t rasterBytes, bool native) {
+    // Caption, feed and cut go out as the symbol's last job
+    if (caption.length() > 0) {
+        sendCenterAlign();
+        layoutText(caption, columns, 0, false, true);
+        sendLeftAlign();
+    }
+    job.println("");
+    job.println("");
     sendCutPaper();
     
-    Logger::info(TAG, "Grocery list printed successfully");
+    if (!sendJob()) {
+        return false;
+    }
+    
+    lastSymbolBytes = rasterBytes + lastJobBytes;
+    lastSymbolMs = millis() - startTime;
+    lastSymbolNative = native;
+    Logger::info(TAG, String(native ? "Native" : "Raster") + " symbol printed: " + String(lastSymbolBytes) +
+                      " bytes in " + String(lastSymbolMs) + "ms");
     return true;
 }
 
-bool PrinterService::printBitmap(const uint8_t* bitmap, uint16_t width, uint16_t height) {
+bool PrinterService::printQrCode(const String& data, const String& caption) {
     if (!isReady()) {
         Logger::error(TAG, "Printer not ready");
         return false;
     }
     
-    if (!bitmap || width == 0 || height == 0) {
-        Logger::error(TAG, "Invalid bitmap parameters");
+    if (data.length() == 0 || data.length() > maxQrLength()) {
+        Logger::error(TAG, "QR data must be 1-" + String(maxQrLength()) + " bytes");
         return false;
     }
     
-    // Width must be a multiple of 8 for bitmap mode
-    if (width % 8 != 0) {
-        Logger::error(TAG, "Bitmap width must be multiple of 8");
-        return false;
+    Logger::info(TAG, "Printing QR code (" + String(data.length()) + " bytes)");
+    unsigned long startTime = millis();
+    size_t rasterBytes = 0;
+    
+    if (nativeSymbols) {
+        // The printer encodes it; size the modules for the version it will pick
+        uint8_t version = QrEncoder::versionFor(data.length(), QR_ERROR_CORRECTION);
+        sendJobStart();
+        sendCenterAlign();
+        job.qrCodeStore((const uint8_t*)data.c_str(), data.length(),
+                        fitModuleDots(version * 4 + 17 + 8, QR_MODULE_DOTS), QR_ERROR_CORRECTION);
+        job.qrCodePrint();
+        job.println("");
+    } else {
+        if (!printQrRaster(data)) {
+            return false;
+        }
+        rasterBytes = lastJobBytes;
     }
     
-    Logger::info(TAG, "Printing bitmap " + String(width) + "x" + String(height));
+    if (!finishSymbol(caption, startTime, rasterBytes, nativeSymbols)) {
+        return false;
+    }
+    qrCodesPrinted++;
+    return true;
+}
+
+bool PrinterService::printQrRaster(const String& data) {
+    // Only the module bitmap is held; rows are scaled into each band
+    QrEncoder* qr = new (std::nothrow) QrEncoder();
+    if (!qr) {
+        Logger::error(TAG, "Out of memory for QR encoder");
+        return false;
+    }
+    if (!qr->encode((const uint8_t*)data.c_str(), data.length(), QR_ERROR_CORRECTION)) {
+        Logger::error(TAG, "QR data too long for version " + String(QR_MAX_VERSION));
+        delete qr;
+        return false;
+    }
     
-    // Calculate bytes per line
-    uint16_t bytesPerLine = width / 8;
+    // Four-module quiet zone on the sides; the blank lines above and
+    // below give it vertically without sending empty raster rows
+    uint8_t size = qr->getSize();
+    uint8_t scale = fitModuleDots(size + 8, QR_MODULE_DOTS);
+    uint16_t symbolDots = (uint16_t)size * scale;
+    uint16_t left = (PRINTER_HEAD_DOTS - symbolDots) / 2;
+    uint16_t width = (left + symbolDots + 7) & ~7;
     
-    // GS * x y d1...dk - Print downloaded bit image
-    // x = width in bytes (low byte)
-    // y = width in bytes (high byte)
-    hardware->printerWrite(29);  // GS
-    hardware->printerWrite(42);  // *
-    hardware->printerWrite(bytesPerLine & 0xFF);  // xL (width low byte)
-    hardware->printerWrite((bytesPerLine >> 8) & 0xFF);  // xH (width high byte)
+    Logger::debug(TAG, "QR version " + String(qr->getVersion()) + ", " + String(size) + " modules at " +
+                       String(scale) + " dots");
     
-    // Send bitmap data
-    for (uint16_t row = 0; row < height; row++) {
-        for (uint16_t col = 0; col < bytesPerLine; col++) {
-            uint16_t index = row * bytesPerLine + col;
-            hardware->printerWrite(bitmap[index]);
+    sendJobStart();
+    job.println("");
+    bool success = printRaster(width, symbolDots, [qr, scale, left](uint16_t row, uint8_t* out, uint16_t bytesPerRow) {
+        memset(out, 0, bytesPerRow);
+        uint8_t y = row / scale;
+        for (uint8_t x = 0; x < qr->getSize(); x++) {
+            if (!qr->getModule(x, y)) continue;
+            for (uint16_t dot = left + x * scale; dot < left + (x + 1) * scale; dot++) {
+                out[dot >> 3] |= 0x80 >> (dot & 7);
+            }
         }
-        delay(10);  // Small delay between rows
+        return true;
+    });
+    
+    delete qr;
+    return success;
+}
+
+bool PrinterService::printBarcode(const String& data) {
+    if (!isReady()) {
+        Logger::error(TAG, "Printer not ready");
+        return false;
+    }
+    
+    if (!BarcodeEncoder::isEncodable(data.c_str(), data.length())) {
+        Logger::error(TAG, "Barcode data must be 1-" + String(BARCODE_MAX_LENGTH) + " printable ASCII characters");
+        return false;
     }
     
-    // Print the bitmap
-    hardware->printerWrite(29);  // GS
-    hardware->printerWrite(47);  // /
-    hardware->printerWrite(48);  // 0 (print normal density)
+    Logger::info(TAG, "Printing barcode \"" + data + "\"");
+    unsigned long startTime = millis();
+    size_t rasterBytes = 0;
+    
+    // Ten-module quiet zone either side; GS w can't go below 2 dots, so
+    // long codes print as raster at 1 dot even on capable printers
+    uint8_t moduleDots = fitModuleDots(BarcodeEncoder::modulesFor(data.length()) + 20, BARCODE_MODULE_DOTS);
+    bool native = nativeSymbols && moduleDots >= 2;
     
-    hardware->printerPrintln("");  // Line feed after bitmap
-    delay(100);
+    if (native) {
+        sendJobStart();
+        sendCenterAlign();
+        job.barcode128(data.c_str(), data.length(), BARCODE_HEIGHT_DOTS, moduleDots);
+    } else {
+        if (!printBarcodeRaster(data)) {
+            return false;
+        }
+        rasterBytes = lastJobBytes;
+    }
     
-    Logger::info(TAG, "Bitmap printed successfully");
+    if (!finishSymbol(native ? "" : data, startTime, rasterBytes, native)) {
+        return false;
+    }
+    barcodesPrinted++;
     return true;
 }
 
+bool PrinterService::printBarcodeRaster(const String& data) {
+    BarcodeEncoder barcode;
+    if (!barcode.encode(data.c_str(), data.length())) {
+        return false;
+    }
+    
+    uint16_t modules = barcode.getModuleCount();
+    uint8_t scale = fitModuleDots(modules + 20, BARCODE_MODULE_DOTS);
+    uint16_t symbolDots = modules * scale;
+    uint16_t left = (PRINTER_HEAD_DOTS - symbolDots) / 2;
+    uint16_t width = (left + symbolDots + 7) & ~7;
+    
+    // Every row is the same: build it once, copy it for the rest
+    uint8_t bars[PRINTER_HEAD_DOTS / 8];
+    memset(bars, 0, sizeof(bars));
+    for (uint16_t x = 0; x < modules; x++) {
+        if (!barcode.getModule(x)) continue;
+        for (uint16_t dot = left + x * scale; dot < left + (x + 1) * scale; dot++) {
+            bars[dot >> 3] |= 0x80 >> (dot & 7);
+        }
+    }
+    
+    sendJobStart();
+    return printRaster(width, BARCODE_HEIGHT_DOTS, [&bars](uint16_t /*row*/, uint8_t* out, uint16_t bytesPerRow) {
+        memcpy(out, bars, bytesPerRow);
+        return true;
+    });
+}
+
+uint32_t PrinterService::getRasterBytesPerSecond() const {
+    if (lastRasterRows == 0 || lastJobDurationMs == 0) return 0;
+    return (uint32_t)((lastJobBytes * 1000UL) / lastJobDurationMs);
+}
+
+uint32_t PrinterService::getRasterMsPer100Rows() const {
+    if (lastRasterRows == 0) return 0;
+    return (uint32_t)((lastJobDurationMs * 100UL) / lastRasterRows);
+}
+
 /* 
  * Example: How to use printBitmap()
  * 
- * 1. Create a bitmap array (width must be multiple of 8)
+ * 1. Create a bitmap array (width must be multiple of 8, at most 384 dots)
  * 2. Each byte represents 8 horizontal pixels (MSB = leftmost pixel)
  * 3. 1 = black dot, 0 = white/no dot
  * 
@@ -471,4 +1320,205 @@ bool PrinterService::printBitmap(const uint8_t* bitmap, uint16_t width, uint16_t
  * - Use image editing software to create monochrome bitmap
  * - Convert to byte array using online tools or scripts
  * - Ensure width is multiple of 8 (pad if necessary)
+ * 
+ * For images that don't fit in memory, use printRaster() with a row source
+ * that fills one row at a time (from a file, network stream, decoder...):
+ * 
+ * printerService.printRaster(384, height, [](uint16_t row, uint8_t* out, uint16_t bytesPerRow) {
+ *     return readNextRow(out, bytesPerRow);  // false aborts the print
+ * });
  */
+
+// 16x16 heart, the printBitmap() example above
+static const uint8_t BENCHMARK_BITMAP[32] = {
+    0x00, 0x00, 0x0C, 0x30, 0x1E, 0x78, 0x3F, 0xFC, 0x7F, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x7F, 0xFE, 0x3F, 0xFC, 0x1F, 0xF8, 0x0F, 0xF0, 0x07, 0xE0, 0x03, 0xC0, 0x01, 0x80, 0x00, 0x00
+};
+
+void PrinterService::runBenchmarkCase(uint8_t index, const char* name, const std::function<bool()>& print) {
+    // Steady state: the user glyphs were downloaded by an earlier job
+    dryRun->reset();
+    glyphsResident = true;
+    
+    unsigned long startMicros = micros();
+    bool success = print();
+    
+    BenchmarkResult& result = benchmarkResults[index];
+    result.name = name;
+    result.encodeUs = micros() - startMicros;
+    result.bytes = dryRun->getBytes();
+    result.lines = dryRun->getLines();
+    result.paperDots = dryRun->getPaperDots();
+    result.rasterRows = dryRun->getRasterRows();
+    result.headMs = dryRun->getHeadMs();
+    result.cutMs = dryRun->getCutMs();
+    result.success = success;
+}
+
+bool PrinterService::runBenchmark() {
+    Logger::info(TAG, "Running print benchmark (dry run)");
+    
+    // Real jobs' metrics and glyph state survive the run
+    size_t savedJobBytes = lastJobBytes;
+    unsigned long savedJobMs = lastJobDurationMs;
+    uint16_t savedRasterRows = lastRasterRows;
+    bool savedGlyphs = glyphsResident;
+    PrintProfileId savedProfile = appliedProfile;
+    uint8_t savedHeatingTime = appliedHeatingTime;
+    uint32_t savedProfileChanges = profileChanges;
+    
+    EscPosTimingModel model;
+    dryRun = &model;
+    
+    String small = "Good morning! Have a great day.";
+    String medium;
+    while (medium.length() < 300) {
+        medium += "Remember to water the plant and grab milk on the way home. ";
+    }
+    // Longest message the journal accepts, with code page switches
+    String worst;
+    while (worst.length() < PRINT_JOURNAL_MAX_PAYLOAD - 40) {
+        worst += "Cr\xC3\xA8me br\xC3\xBBl\xC3\xA9""e for Zo\xC3\xAB, \xC2\xA1Ol\xC3\xA9! Stra\xC3\x9F""e 5. ";
+    }
+    
+    runBenchmarkCase(0, "receipt-small", [&]() { return printReceipt(small, true); });
+    runBenchmarkCase(1, "receipt-medium", [&]() { return printReceipt(medium, true); });
+    runBenchmarkCase(2, "receipt-worst", [&]() { return printReceipt(worst, true); });
+    worst = "";
+    
+    String* items = new (std::nothrow) String[PRINT_SPOOLER_MAX_LIST_ITEMS];
+    if (items) {
+        for (int i = 0; i < PRINT_SPOOLER_MAX_LIST_ITEMS; i++) {
+            items[i] = i < 15 ? String("Item ") + String(i + 1)
+                              : String("Family size organic wholebean coffee, dark roast #") + String(i + 1);
+        }
+        runBenchmarkCase(3, "grocery-small", [&]() { return printGroceryList(items, 3); });
+        runBenchmarkCase(4, "grocery-medium", [&]() { return printGroceryList(items, 15); });
+        // Every item too long to pair up, so each one wraps
+        runBenchmarkCase(5, "grocery-worst", [&]() {
+            return printGroceryList(items + 15, PRINT_SPOOLER_MAX_LIST_ITEMS - 15);
+        });
+        delete[] items;
+    }
+    
+    RasterRowSource pattern = [](uint16_t row, uint8_t* out, uint16_t bytesPerRow) {
+        for (uint16_t i = 0; i < bytesPerRow; i++) {
+            out[i] = (row + i) & 1 ? 0xAA : 0x55;
+        }
+        return true;
+    };
+    runBenchmarkCase(6, "bitmap-small", [&]() { return printBitmap(BENCHMARK_BITMAP, 16, 16); });
+    runBenchmarkCase(7, "bitmap-medium", [&]() { return printRaster(PRINTER_HEAD_DOTS, 240, pattern); });
+    runBenchmarkCase(8, "bitmap-worst", [&]() { return printRaster(PRINTER_HEAD_DOTS, 1200, pattern); });
+    
+    dryRun = nullptr;
+    lastJobBytes = savedJobBytes;
+    lastJobDurationMs = savedJobMs;
+    lastRasterRows = savedRasterRows;
+    glyphsResident = savedGlyphs;
+    appliedProfile = savedProfile;
+    appliedHeatingTime = savedHeatingTime;
+    profileChanges = savedProfileChanges;
+    publishAppliedProfile();
+    benchmarkRuns++;
+    benchmarkAt = millis();
+    
+    bool success = true;
+    for (uint8_t i = 0; i < BENCHMARK_CASES; i++) {
+        success = success && benchmarkResults[i].success;
+    }
+    Logger::info(TAG, success ? "Print benchmark complete" : "Print benchmark finished with failed cases");
+    return success;
+}
+
+String PrinterService::getBenchmarkJSON() const {
+    DynamicJsonDocument doc(4096);
+    doc["runs"] = benchmarkRuns;
+    if (benchmarkRuns > 0) {
+        doc["ageMs"] = millis() - benchmarkAt;
+    }
+    doc["baud"] = getBaudRate();
+    doc["rowTimeUs"] = RASTER_ROW_TIME_US;
+    doc["cutMs"] = PRINTER_CUT_MS;
+    
+    JsonArray cases = doc.createNestedArray("cases");
+    for (uint8_t i = 0; i < BENCHMARK_CASES && benchmarkRuns > 0; i++) {
+        const BenchmarkResult& result = benchmarkResults[i];
+        JsonObject entry = cases.createNestedObject();
+        entry["name"] = result.name;
+        entry["success"] = result.success;
+        entry["encodeUs"] = result.encodeUs;
+        entry["bytes"] = result.bytes;
+        entry["lines"] = result.lines;
+        entry["paperMm"] = result.paperDots / 8;
+        entry["rasterRows"] = result.rasterRows;
+        entry["headMs"] = result.headMs;
+        
+        // The UART and the head overlap; the slower one sets the pace
+        JsonObject estimates = entry.createNestedObject("estimatedMs");
+        for (uint8_t r = 0; r < BAUD_RATE_COUNT; r++) {
+            uint32_t uartMs = (uint32_t)(((uint64_t)result.bytes * 10UL * 1000UL) / BAUD_RATES[r]);
+            estimates[String(BAUD_RATES[r])] = (uartMs > result.headMs ? uartMs : result.headMs) + result.cutMs;
+        }
+    }
+    
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
+
+String PrinterService::getStatsJSON() const {
+    DynamicJsonDocument doc(1536);
+    doc["lastJobBytes"] = lastJobBytes;
+    doc["lastJobMs"] = lastJobDurationMs;
+    doc["rasterBytesPerSecond"] = getRasterBytesPerSecond();
+    doc["rasterMsPer100Rows"] = getRasterMsPer100Rows();
+    doc["userGlyphsResident"] = glyphsResident;
+    doc["baud"] = getBaudRate();
+    
+    // Inline icons vs the [WORD] replacements they stand in for. Both print
+    // within one 24-dot text line, so the difference is wire time only.
+    JsonObject iconStats = doc.createNestedObject("icons");
+    iconStats["enabled"] = PRINTER_INLINE_ICONS;
+    iconStats["printed"] = icons.getIconsPrinted();
+    iconStats["bytes"] = icons.getIconBytes();
+    iconStats["replacementBytes"] = icons.getReplacementBytes();
+    iconStats["extraWireMs"] = wireTimeMs(icons.getIconBytes() - icons.getReplacementBytes());
+    iconStats["cacheHits"] = icons.getCacheHits();
+    iconStats["cacheMisses"] = icons.getCacheMisses();
+    
+    // Last QR code / barcode: compare lastBytes native vs raster
+    JsonObject symbolStats = doc.createNestedObject("symbols");
+    symbolStats["native"] = nativeSymbols;
+    symbolStats["source"] = symbolSource;
+    symbolStats["qrCodes"] = qrCodesPrinted;
+    symbolStats["barcodes"] = barcodesPrinted;
+    symbolStats["lastBytes"] = lastSymbolBytes;
+    symbolStats["lastMs"] = lastSymbolMs;
+    symbolStats["lastNative"] = lastSymbolNative;
+    
+    // Where print time went while blocked, since boot
+    JsonObject waits = doc.createNestedObject("waits");
+    waits["uartMs"] = uartWaitMs;
+    waits["printerMs"] = printerWaitMs;
+    waits["delayMs"] = delayMs;
+    
+    JsonObject profileStats = doc.createNestedObject("profile");
+    ProfileState profile = getProfileState();
+    profileStats["default"] = PrintProfiles::name(profile.defaultProfile);
+    profileStats["applied"] = PrintProfiles::name(profile.appliedProfile);
+    profileStats["changes"] = profile.profileChanges;
+    
+    JsonObject statusStats = doc.createNestedObject("status");
+    PrinterStatusSnapshot snapshot = status.getSnapshot();
+    statusStats["state"] = PrinterStatus::stateToString(snapshot.state);
+    statusStats["paperNearEnd"] = snapshot.paperNearEnd;
+    statusStats["paused"] = paused;
+    statusStats["syncPacing"] = snapshot.syncEnabled;
+    statusStats["polls"] = snapshot.polls;
+    statusStats["timeouts"] = snapshot.timeouts;
+    
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
@@ -0,0 +1,189 @@
+#include "PrinterStatus.h"
+
+const char* PrinterStatus::TAG = "PrinterStatus";
+
+PrinterStatus::PrinterStatus(PrinterPort* hw)
+    : hardware(hw), responding(false), everResponded(false), syncSupported(true),
+      paperOut(false), paperNearEnd(false), coverOpen(false), error(false),
+      pendingSyncs(0), lastPollAt(0), polls(0), timeouts(0) {
+    portMUX_INITIALIZE(&snapshotMux);
+    publish();
+}
+
+int PrinterStatus::query(uint8_t n) {
+    // DLE EOT n - Transmit real-time status
+    const uint8_t cmd[] = {ESCPOS_DLE, ESCPOS_EOT, n};
+    if (!hardware->printerWrite(cmd, sizeof(cmd))) {
+        return -1;
+    }
+
+    unsigned long start = millis();
+    while (millis() - start < PRINTER_STATUS_TIMEOUT_MS) {
+        int reply = hardware->printerRead(PRINTER_STATUS_TIMEOUT_MS - (millis() - start));
+        if (reply < 0) {
+            break;
+        }
+        if (isRealtimeReply(reply)) {
+            return reply;
+        }
+        // A GS r reply that was already on its way
+        handleSyncReply(reply);
+    }
+    return -1;
+}
+
+void PrinterStatus::handleSyncReply(uint8_t reply) {
+    if (pendingSyncs > 0) {
+        pendingSyncs--;
+    }
+    // GS r 1: bits 0-1 paper near end, bits 2-3 paper end; bits 4 and 7 are 0
+    if ((reply & 0x90) == 0) {
+        paperNearEnd = (reply & 0x03) != 0;
+        paperOut = (reply & 0x0C) != 0;
+    }
+}
+
+bool PrinterStatus::poll() {
+    if (!hardware || !hardware->printerAvailable()) {
+        responding = false;
+        publish();
+        return false;
+    }
+
+    // Stale bytes can only be dropped when no GS r reply is owed
+    if (pendingSyncs == 0) {
+        hardware->printerFlushInput();
+    }
+
+    polls++;
+    lastPollAt = millis();
+
+    int printer = query(1);                   // Printer status
+    int offline = printer >= 0 ? query(2) : -1;  // Offline cause
+    int errors = offline >= 0 ? query(3) : -1;   // Error cause
+    int paper = errors >= 0 ? query(4) : -1;     // Paper roll sensor
+
+    if (paper < 0) {
+        timeouts++;
+        if (responding) {
+            Logger::warn(TAG, "Printer stopped answering status queries");
+        }
+        responding = false;
+        publish();
+        return false;
+    }
+
+    if (!responding) {
+        Logger::info(TAG, everResponded ? "Printer answering status queries again"
+                                        : "Printer supports real-time status");
+    }
+    responding = true;
+    everResponded = true;
+
+    bool wasPaperOut = paperOut;
+    bool wasCoverOpen = coverOpen;
+
+    coverOpen = (offline & 0x04) != 0;
+    paperOut = (paper & 0x60) != 0 || (offline & 0x20) != 0;
+    paperNearEnd = (paper & 0x0C) != 0;
+    // Autocutter, unrecoverable or auto-recoverable error
+    error = (errors & 0x68) != 0;
+
+    if (paperOut != wasPaperOut) {
+        Logger::warn(TAG, paperOut ? "Paper out" : "Paper loaded");
+    }
+    if (coverOpen != wasCoverOpen) {
+        Logger::warn(TAG, coverOpen ? "Cover open" : "Cover closed");
+    }
+    if (printer & 0x08) {
+        Logger::debug(TAG, "Printer offline (status 0x" + String(printer, HEX) + ")");
+    }
+    publish();
+    return true;
+}
+
+void PrinterStatus::appendSync(EscPosEncoder& job) {
+    job.transmitPaperStatus();
+    pendingSyncs++;
+}
+
+bool PrinterStatus::awaitSyncs(uint8_t maxPending, uint32_t timeoutMs) {
+    unsigned long start = millis();
+    while (pendingSyncs > maxPending) {
+        unsigned long elapsed = millis() - start;
+        if (elapsed >= timeoutMs) {
+            return false;
+        }
+        int reply = hardware->printerRead(timeoutMs - elapsed);
+        if (reply < 0) {
+            return false;
+        }
+        if (!isRealtimeReply(reply)) {
+            handleSyncReply(reply);
+            publish();  // GS r also reports the paper sensors
+        }
+    }
+    return true;
+}
+
+void PrinterStatus::abandonSyncs() {
+    pendingSyncs = 0;
+}
+
+void PrinterStatus::disableSync() {
+    if (syncSupported) {
+        Logger::warn(TAG, "No reply to GS r, pacing on UART drain time only");
+    }
+    syncSupported = false;
+    pendingSyncs = 0;
+    publish();
+}
+
+bool PrinterStatus::canPrint() const {
+    // Unknown status is treated as ready, like before status polling existed
+    return !responding || (!paperOut && !coverOpen && !error);
+}
+
+PrinterState PrinterStatus::getState() const {
+    if (!responding) {
+        return everResponded ? PRINTER_STATE_OFFLINE : PRINTER_STATE_UNKNOWN;
+    }
+    if (coverOpen) return PRINTER_STATE_COVER_OPEN;
+    if (paperOut) return PRINTER_STATE_PAPER_OUT;
+    if (error) return PRINTER_STATE_ERROR;
+    return PRINTER_STATE_READY;
+}
+
+void PrinterStatus::publish() {
+    PrinterStatusSnapshot snapshot;
+    snapshot.state = getState();
+    snapshot.canPrint = canPrint();
+    snapshot.responding = responding;
+    snapshot.syncEnabled = isSyncEnabled();
+    snapshot.paperNearEnd = paperNearEnd;
+    snapshot.lastPollAt = lastPollAt;
+    snapshot.polls = polls;
+    snapshot.timeouts = timeouts;
+    
+    portENTER_CRITICAL(&snapshotMux);
+    published = snapshot;
+    portEXIT_CRITICAL(&snapshotMux);
+}
+
+PrinterStatusSnapshot PrinterStatus::getSnapshot() const {
+    portENTER_CRITICAL(&snapshotMux);
+    PrinterStatusSnapshot snapshot = published;
+    portEXIT_CRITICAL(&snapshotMux);
+    return snapshot;
+}
+
+const char* PrinterStatus::stateToString(PrinterState state) {
+    switch (state) {
+        case PRINTER_STATE_READY: return "ready";
+        case PRINTER_STATE_PAPER_OUT: return "paper_out";
+        case PRINTER_STATE_COVER_OPEN: return "cover_open";
+        case PRINTER_STATE_ERROR: return "error";
+        case PRINTER_STATE_OFFLINE: return "offline";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,411 @@
+#include "QrEncoder.h"
+#include <limits.h>
+
+static_assert(QR_MAX_VERSION >= 1 && QR_MAX_VERSION <= 10, "QR_MAX_VERSION must be 1-10");
+
+// Per version (index 0 unused), in QrErrorCorrection order (ISO/IEC 18004 table 9)
+static const uint8_t ECC_CODEWORDS_PER_BLOCK[4][11] = {
+    {0,  7, 10, 15, 20, 26, 18, 20, 24, 30, 18},   // L
+    {0, 10, 16, 26, 18, 24, 16, 18, 22, 22, 26},   // M
+    {0, 13, 22, 18, 26, 18, 24, 18, 22, 20, 24},   // Q
+    {0, 17, 28, 22, 16, 22, 28, 26, 26, 24, 28}    // H
+};
+static const uint8_t ECC_BLOCKS[4][11] = {
+    {0, 1, 1, 1, 1, 1, 2, 2, 2, 2, 4},
+    {0, 1, 1, 1, 2, 2, 4, 4, 4, 5, 5},
+    {0, 1, 1, 2, 2, 4, 4, 6, 6, 8, 8},
+    {0, 1, 1, 2, 4, 4, 4, 5, 6, 8, 8}
+};
+// Format information ECC level bits, in QrErrorCorrection order
+static const uint8_t FORMAT_BITS[4] = {1, 0, 3, 2};
+static const uint8_t MAX_ECC_PER_BLOCK = 30;
+
+// GF(2^8) with the QR polynomial x^8 + x^4 + x^3 + x^2 + 1
+static uint8_t gfMultiply(uint8_t x, uint8_t y) {
+    uint16_t z = 0;
+    for (int i = 7; i >= 0; i--) {
+        z = (z << 1) ^ ((z >> 7) * 0x11D);
+        z ^= ((y >> i) & 1) * x;
+    }
+    return (uint8_t)z;
+}
+
+static void reedSolomonDivisor(uint8_t degree, uint8_t* divisor) {
+    memset(divisor, 0, degree);
+    divisor[degree - 1] = 1;
+    uint8_t root = 1;
+    for (uint8_t i = 0; i < degree; i++) {
+        for (uint8_t j = 0; j < degree; j++) {
+            divisor[j] = gfMultiply(divisor[j], root);
+            if (j + 1 < degree) {
+                divisor[j] ^= divisor[j + 1];
+            }
+        }
+        root = gfMultiply(root, 0x02);
+    }
+}
+
+static void reedSolomonRemainder(const uint8_t* data, uint16_t length, const uint8_t* divisor,
+                                 uint8_t degree, uint8_t* remainder) {
+    memset(remainder, 0, degree);
+    for (uint16_t i = 0; i < length; i++) {
+        uint8_t factor = data[i] ^ remainder[0];
+        memmove(remainder, remainder + 1, degree - 1);
+        remainder[degree - 1] = 0;
+        for (uint8_t j = 0; j < degree; j++) {
+            remainder[j] ^= gfMultiply(divisor[j], factor);
+        }
+    }
+}
+
+static void appendBits(uint8_t* buffer, uint16_t& bitLength, uint32_t value, uint8_t count) {
+    for (int i = count - 1; i >= 0; i--, bitLength++) {
+        if ((value >> i) & 1) {
+            buffer[bitLength >> 3] |= 0x80 >> (bitLength & 7);
+        }
+    }
+}
+
+QrEncoder::QrEncoder() : version(0), size(0) {
+}
+
+uint16_t QrEncoder::rawDataModules(uint8_t ver) {
+    // Modules left for codewords once all function patterns are placed
+    uint16_t result = (16 * ver + 128) * ver + 64;
+    if (ver >= 2) {
+        uint8_t alignCount = ver / 7 + 2;
+        result -= (25 * alignCount - 10) * alignCount - 55;
+        if (ver >= 7) {
+            result -= 36;
+        }
+    }
+    return result;
+}
+
+uint16_t QrEncoder::dataCodewords(uint8_t ver, QrErrorCorrection ecc) {
+    return rawDataModules(ver) / 8 - ECC_CODEWORDS_PER_BLOCK[ecc][ver] * ECC_BLOCKS[ecc][ver];
+}
+
+uint8_t QrEncoder::versionFor(size_t length, QrErrorCorrection ecc) {
+    for (uint8_t ver = 1; ver <= QR_MAX_VERSION; ver++) {
+        // Mode indicator, character count, data
+        uint32_t bits = 4 + (ver < 10 ? 8 : 16) + (uint32_t)length * 8;
+        if (bits <= (uint32_t)dataCodewords(ver, ecc) * 8) {
+            return ver;
+        }
+    }
+    return 0;
+}
+
+size_t QrEncoder::maxLength(QrErrorCorrection ecc) {
+    return (dataCodewords(QR_MAX_VERSION, ecc) * 8 - 4 - (QR_MAX_VERSION < 10 ? 8 : 16)) / 8;
+}
+
+uint8_t QrEncoder::alignmentPositions(uint8_t ver, uint8_t* positions) {
+    if (ver == 1) {
+        return 0;
+    }
+    uint8_t count = ver / 7 + 2;
+    uint8_t step = (ver * 4 + count * 2 + 1) / (count * 2 - 2) * 2;
+    positions[0] = 6;
+    uint8_t pos = ver * 4 + 17 - 7;
+    for (uint8_t i = count - 1; i >= 1; i--, pos -= step) {
+        positions[i] = pos;
+    }
+    return count;
+}
+
+void QrEncoder::setModule(uint8_t x, uint8_t y, bool dark) {
+    uint16_t bit = (uint16_t)y * size + x;
+    if (dark) {
+        modules[bit >> 3] |= 0x80 >> (bit & 7);
+    } else {
+        modules[bit >> 3] &= ~(0x80 >> (bit & 7));
+    }
+}
+
+void QrEncoder::setFunction(uint8_t x, uint8_t y, bool dark) {
+    setModule(x, y, dark);
+    uint16_t bit = (uint16_t)y * size + x;
+    function[bit >> 3] |= 0x80 >> (bit & 7);
+}
+
+bool QrEncoder::isFunction(uint8_t x, uint8_t y) const {
+    uint16_t bit = (uint16_t)y * size + x;
+    return (function[bit >> 3] & (0x80 >> (bit & 7))) != 0;
+}
+
+bool QrEncoder::getModule(uint8_t x, uint8_t y) const {
+    if (x >= size || y >= size) {
+        return false;
+    }
+    uint16_t bit = (uint16_t)y * size + x;
+    return (modules[bit >> 3] & (0x80 >> (bit & 7))) != 0;
+}
+
+void QrEncoder::drawFinder(int x, int y) {
+    for (int dy = -4; dy <= 4; dy++) {
+        for (int dx = -4; dx <= 4; dx++) {
+            int xx = x + dx;
+            int yy = y + dy;
+            if (xx < 0 || xx >= size || yy < 0 || yy >= size) continue;
+            int dist = max(abs(dx), abs(dy));
+            // 3x3 core, light ring, dark ring, light separator
+            setFunction(xx, yy, dist != 2 && dist != 4);
+        }
+    }
+}
+
+void QrEncoder::drawAlignment(int x, int y) {
+    for (int dy = -2; dy <= 2; dy++) {
+        for (int dx = -2; dx <= 2; dx++) {
+            setFunction(x + dx, y + dy, max(abs(dx), abs(dy)) != 1);
+        }
+    }
+}
+
+void QrEncoder::drawFormatBits(QrErrorCorrection ecc, uint8_t mask) {
+    // 5 data bits, BCH(15,5) remainder, fixed XOR pattern
+    uint16_t data = FORMAT_BITS[ecc] << 3 | mask;
+    uint16_t rem = data;
+    for (int i = 0; i < 10; i++) {
+        rem = (rem << 1) ^ ((rem >> 9) * 0x537);
+    }
+    uint16_t bits = (data << 10 | rem) ^ 0x5412;
+
+    // Around the top-left finder
+    for (int i = 0; i <= 5; i++) setFunction(8, i, (bits >> i) & 1);
+    setFunction(8, 7, (bits >> 6) & 1);
+    setFunction(8, 8, (bits >> 7) & 1);
+    setFunction(7, 8, (bits >> 8) & 1);
+    for (int i = 9; i < 15; i++) setFunction(14 - i, 8, (bits >> i) & 1);
+
+    // Split between the other two finders
+    for (int i = 0; i < 8; i++) setFunction(size - 1 - i, 8, (bits >> i) & 1);
+    for (int i = 8; i < 15; i++) setFunction(8, size - 15 + i, (bits >> i) & 1);
+    setFunction(8, size - 8, true);  // Always dark
+}
+
+void QrEncoder::drawVersion() {
+    if (version < 7) {
+        return;
+    }
+    // 6 data bits, BCH(18,6) remainder
+    uint32_t rem = version;
+    for (int i = 0; i < 12; i++) {
+        rem = (rem << 1) ^ ((rem >> 11) * 0x1F25);
+    }
+    uint32_t bits = (uint32_t)version << 12 | rem;
+    for (int i = 0; i < 18; i++) {
+        bool dark = (bits >> i) & 1;
+        uint8_t a = size - 11 + i % 3;
+        uint8_t b = i / 3;
+        setFunction(a, b, dark);
+        setFunction(b, a, dark);
+    }
+}
+
+void QrEncoder::drawFunctionPatterns(QrErrorCorrection ecc) {
+    for (uint8_t i = 0; i < size; i++) {
+        setFunction(6, i, i % 2 == 0);
+        setFunction(i, 6, i % 2 == 0);
+    }
+
+    drawFinder(3, 3);
+    drawFinder(size - 4, 3);
+    drawFinder(3, size - 4);
+
+    uint8_t positions[7];
+    uint8_t count = alignmentPositions(version, positions);
+    for (uint8_t i = 0; i < count; i++) {
+        for (uint8_t j = 0; j < count; j++) {
+            // Not on top of the finders
+            if ((i == 0 && j == 0) || (i == 0 && j == count - 1) || (i == count - 1 && j == 0)) continue;
+            drawAlignment(positions[i], positions[j]);
+        }
+    }
+
+    drawFormatBits(ecc, 0);  // Reserves the area; redrawn once the mask is chosen
+    drawVersion();
+}
+
+void QrEncoder::drawCodewords(const uint8_t* data, uint16_t count) {
+    // Two-module columns from the right, alternating up and down,
+    // skipping the vertical timing pattern
+    uint32_t bit = 0;
+    uint32_t totalBits = (uint32_t)count * 8;
+    for (int right = size - 1; right >= 1; right -= 2) {
+        if (right == 6) right = 5;
+        bool upward = ((right + 1) & 2) == 0;
+        for (int vert = 0; vert < size; vert++) {
+            int y = upward ? size - 1 - vert : vert;
+            for (int j = 0; j < 2; j++) {
+                int x = right - j;
+                if (isFunction(x, y)) continue;
+                // Remainder bits are left light
+                if (bit < totalBits) {
+                    setModule(x, y, (data[bit >> 3] >> (7 - (bit & 7))) & 1);
+                    bit++;
+                }
+            }
+        }
+    }
+}
+
+void QrEncoder::applyMask(uint8_t mask) {
+    // XOR, so applying the same mask again removes it
+    for (uint8_t y = 0; y < size; y++) {
+        for (uint8_t x = 0; x < size; x++) {
+            if (isFunction(x, y)) continue;
+            bool invert;
+            switch (mask) {
+                case 0: invert = (x + y) % 2 == 0; break;
+                case 1: invert = y % 2 == 0; break;
+                case 2: invert = x % 3 == 0; break;
+                case 3: invert = (x + y) % 3 == 0; break;
+                case 4: invert = (x / 3 + y / 2) % 2 == 0; break;
+                case 5: invert = x * y % 2 + x * y % 3 == 0; break;
+                case 6: invert = (x * y % 2 + x * y % 3) % 2 == 0; break;
+                default: invert = ((x + y) % 2 + x * y % 3) % 2 == 0; break;
+            }
+            if (invert) {
+                setModule(x, y, !getModule(x, y));
+            }
+        }
+    }
+}
+
+long QrEncoder::penaltyScore() const {
+    long result = 0;
+
+    for (int pass = 0; pass < 2; pass++) {
+        // pass 0 scans rows, pass 1 columns
+        for (uint8_t a = 0; a < size; a++) {
+            bool runColor = false;
+            uint8_t runLength = 0;
+            uint16_t window = 0;  // Last 11 modules, for finder-like patterns
+            for (uint8_t b = 0; b < size; b++) {
+                bool dark = pass == 0 ? getModule(b, a) : getModule(a, b);
+
+                // N1: runs of five or more of one colour
+                if (b > 0 && dark == runColor) {
+                    runLength++;
+                    if (runLength == 5) result += 3;
+                    else if (runLength > 5) result++;
+                } else {
+                    runColor = dark;
+                    runLength = 1;
+                }
+
+                // N3: 1:1:3:1:1 with four light modules on either side
+                window = ((window << 1) | dark) & 0x7FF;
+                if (b >= 10 && (window == 0x5D0 || window == 0x05D)) {
+                    result += 40;
+                }
+            }
+        }
+    }
+
+    // N2: 2x2 blocks of one colour
+    for (uint8_t y = 0; y + 1 < size; y++) {
+        for (uint8_t x = 0; x + 1 < size; x++) {
+            bool dark = getModule(x, y);
+            if (dark == getModule(x + 1, y) && dark == getModule(x, y + 1) && dark == getModule(x + 1, y + 1)) {
+                result += 3;
+            }
+        }
+    }
+
+    // N4: 10 points per 5% the dark share is away from 50%
+    long dark = 0;
+    for (uint8_t y = 0; y < size; y++) {
+        for (uint8_t x = 0; x < size; x++) {
+            if (getModule(x, y)) dark++;
+        }
+    }
+    long total = (long)size * size;
+    long k = (labs(dark * 20 - total * 10) + total - 1) / total - 1;
+    result += k * 10;
+    return result;
+}
+
+void QrEncoder::addEccAndInterleave(const uint8_t* data, uint8_t ver, QrErrorCorrection ecc, uint8_t* out) {
+    uint8_t blockCount = ECC_BLOCKS[ecc][ver];
+    uint8_t eccLength = ECC_CODEWORDS_PER_BLOCK[ecc][ver];
+    uint16_t rawCodewords = rawDataModules(ver) / 8;
+    uint8_t shortBlocks = blockCount - rawCodewords % blockCount;
+    uint16_t shortDataLength = rawCodewords / blockCount - eccLength;
+    uint16_t dataLength = dataCodewords(ver, ecc);
+
+    uint8_t divisor[MAX_ECC_PER_BLOCK];
+    uint8_t remainder[MAX_ECC_PER_BLOCK];
+    reedSolomonDivisor(eccLength, divisor);
+
+    // Data codewords column by column across the blocks (long blocks have
+    // one extra at the end), then the ECC codewords the same way
+    const uint8_t* block = data;
+    for (uint8_t b = 0; b < blockCount; b++) {
+        uint16_t length = shortDataLength + (b < shortBlocks ? 0 : 1);
+        for (uint16_t i = 0; i < shortDataLength; i++) {
+            out[i * blockCount + b] = block[i];
+        }
+        if (b >= shortBlocks) {
+            out[shortDataLength * blockCount + b - shortBlocks] = block[shortDataLength];
+        }
+
+        reedSolomonRemainder(block, length, divisor, eccLength, remainder);
+        for (uint8_t i = 0; i < eccLength; i++) {
+            out[dataLength + i * blockCount + b] = remainder[i];
+        }
+        block += length;
+    }
+}
+
+bool QrEncoder::encode(const uint8_t* data, size_t length, QrErrorCorrection ecc) {
+    version = 0;
+    size = 0;
+    uint8_t ver = versionFor(length, ecc);
+    if (ver == 0) {
+        return false;
+    }
+
+    // Byte mode segment, terminator, then alternating pad codewords
+    uint16_t capacity = dataCodewords(ver, ecc);
+    uint16_t bitLength = 0;
+    memset(codewords, 0, capacity);
+    appendBits(codewords, bitLength, 0x4, 4);
+    appendBits(codewords, bitLength, length, ver < 10 ? 8 : 16);
+    for (size_t i = 0; i < length; i++) {
+        appendBits(codewords, bitLength, data[i], 8);
+    }
+    bitLength += min(4, capacity * 8 - bitLength);
+    bitLength = (bitLength + 7) & ~7;
+    for (uint16_t i = bitLength / 8; i < capacity; i++) {
+        codewords[i] = (i - bitLength / 8) % 2 == 0 ? 0xEC : 0x11;
+    }
+    addEccAndInterleave(codewords, ver, ecc, interleaved);
+
+    version = ver;
+    size = ver * 4 + 17;
+    memset(modules, 0, sizeof(modules));
+    memset(function, 0, sizeof(function));
+    drawFunctionPatterns(ecc);
+    drawCodewords(interleaved, rawDataModules(ver) / 8);
+
+    // Keep the mask with the lowest penalty
+    uint8_t bestMask = 0;
+    long bestPenalty = LONG_MAX;
+    for (uint8_t mask = 0; mask < 8; mask++) {
+        applyMask(mask);
+        drawFormatBits(ecc, mask);
+        long penalty = penaltyScore();
+        if (penalty < bestPenalty) {
+            bestMask = mask;
+            bestPenalty = penalty;
+        }
+        applyMask(mask);
+    }
+    applyMask(bestMask);
+    drawFormatBits(ecc, bestMask);
+    return true;
+}
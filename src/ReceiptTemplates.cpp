@@ -0,0 +1,68 @@
+#include "ReceiptTemplates.h"
+
+// Adjacent literals are merged by the compiler, so the formatting toggles
+// between two slots cost a single segment
+
+static constexpr TemplateSegment MESSAGE_RECEIPT_SEGMENTS[] = {
+    TPL_SLOT(SLOT_INIT),
+    TPL_LITERAL(TPL_ALIGN_CENTER
+                TPL_RULE TPL_BOLD_ON "SMIT'S MESSAGE" TPL_NL TPL_BOLD_OFF TPL_RULE
+                TPL_ALIGN_LEFT),
+    TPL_SLOT(SLOT_DATE),
+    TPL_LITERAL(TPL_ALIGN_CENTER),
+    TPL_SLOT(SLOT_MESSAGE),
+    TPL_LITERAL(TPL_DIVIDER TPL_ALIGN_LEFT "Today's Weather:" TPL_NL "  "),
+    TPL_SLOT(SLOT_WEATHER),
+    TPL_SLOT(SLOT_SENSORS),
+    TPL_LITERAL(TPL_RULE),
+    TPL_SLOT(SLOT_CUT)
+};
+
+static constexpr TemplateSegment REMINDER_RECEIPT_SEGMENTS[] = {
+    TPL_SLOT(SLOT_INIT),
+    TPL_LITERAL(TPL_ALIGN_CENTER
+                TPL_RULE TPL_BOLD_ON "REMINDER" TPL_NL TPL_BOLD_OFF TPL_RULE
+                TPL_ALIGN_LEFT),
+    TPL_SLOT(SLOT_CREATED),
+    TPL_LITERAL(TPL_ALIGN_CENTER),
+    TPL_SLOT(SLOT_MESSAGE),
+    TPL_LITERAL(TPL_RULE),
+    TPL_SLOT(SLOT_CUT)
+};
+
+static constexpr TemplateSegment GROCERY_LIST_SEGMENTS[] = {
+    TPL_SLOT(SLOT_INIT),
+    TPL_LITERAL(TPL_ALIGN_CENTER
+                TPL_RULE TPL_BOLD_ON "GROCERY LIST" TPL_NL TPL_BOLD_OFF TPL_RULE
+                TPL_ALIGN_LEFT),
+    TPL_SLOT(SLOT_DATE),
+    TPL_SLOT(SLOT_ITEMS),
+    TPL_LITERAL(TPL_RULE),
+    TPL_SLOT(SLOT_CUT)
+};
+
+// C++11 constexpr: literal byte and line totals computed by recursion
+static constexpr uint16_t literalBytes(const TemplateSegment* segments, size_t count) {
+    return count == 0 ? 0 : segments[0].length + literalBytes(segments + 1, count - 1);
+}
+
+static constexpr uint8_t countNewlines(const char* bytes, uint16_t length) {
+    return length == 0 ? 0 : (bytes[0] == '\n' ? 1 : 0) + countNewlines(bytes + 1, length - 1);
+}
+
+static constexpr uint8_t literalLines(const TemplateSegment* segments, size_t count) {
+    return count == 0 ? 0 :
+           (segments[0].bytes ? countNewlines(segments[0].bytes, segments[0].length) : 0) +
+           literalLines(segments + 1, count - 1);
+}
+
+#define TPL_COUNT(a) (sizeof(a) / sizeof((a)[0]))
+#define TPL_DEFINE(name, segments) \
+    const ReceiptTemplate name = { segments, (uint8_t)TPL_COUNT(segments), \
+                                   literalBytes(segments, TPL_COUNT(segments)), \
+                                   literalLines(segments, TPL_COUNT(segments)) }
+
+TPL_DEFINE(MESSAGE_RECEIPT_TEMPLATE, MESSAGE_RECEIPT_SEGMENTS);
+TPL_DEFINE(REMINDER_RECEIPT_TEMPLATE, REMINDER_RECEIPT_SEGMENTS);
+TPL_DEFINE(GROCERY_LIST_TEMPLATE, GROCERY_LIST_SEGMENTS);
+
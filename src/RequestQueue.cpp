@@ -10,7 +10,7 @@ RequestQueue::RequestQueue()
 RequestQueue::~RequestQueue() {
 }
 
-bool RequestQueue::enqueue(RequestType type, const String& path, const String& data) {
+bool RequestQueue::enqueue(RequestType type, const String& path, const String& data, uint32_t journalId) {
     if (isFull()) {
         Logger::warn(TAG, "Queue is full, dropping request");
         return false;
@@ -22,6 +22,7 @@ bool RequestQueue::enqueue(RequestType type, const String& path, const String& d
     queue[queueTail].timestamp = millis();
     queue[queueTail].retryCount = 0;
     queue[queueTail].processed = false;
+    queue[queueTail].journalId = journalId;
     
     queueTail = (queueTail + 1) % MAX_QUEUE_SIZE;
     queueSize++;
@@ -42,6 +43,15 @@ bool RequestQueue::dequeue(QueuedRequest& request) {
     return true;
 }
 
+bool RequestQueue::peek(QueuedRequest& request) const {
+    if (isEmpty()) {
+        return false;
+    }
+    
+    request = queue[queueHead];
+    return true;
+}
+
 void RequestQueue::setProcessInterval(unsigned long intervalMs) {
     processInterval = intervalMs;
     Logger::debug(TAG, "Process interval set to " + String(intervalMs) + "ms");
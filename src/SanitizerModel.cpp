@@ -0,0 +1,244 @@
+#include "SanitizerModel.h"
+#include <ArduinoJson.h>
+#include <Preferences.h>
+#include <esp_rom_crc.h>
+
+const char* SanitizerModel::TAG = "Sanitizer";
+
+static_assert(SANITIZER_RING_SLOTS >= 2 && SANITIZER_RING_SLOTS <= 16, "SANITIZER_RING_SLOTS must be 2-16");
+
+static void slotKey(uint8_t slot, char* key) {
+    snprintf(key, 8, "rec%u", slot);
+}
+
+SanitizerModel::SanitizerModel()
+    : reservoirMl(SANITIZER_RESERVOIR_ML), flowMlPerS(SANITIZER_FLOW_ML_PER_S), flowCalibrated(false),
+      usedMl(0), dispenses(0), persistedUsedMl(0), sequence(0), nextSlot(0), recordWrites(0) {
+    portMUX_INITIALIZE(&levelMux);
+}
+
+uint32_t SanitizerModel::recordCrc(const LevelRecord& record) {
+    return esp_rom_crc32_le(0, (const uint8_t*)&record, offsetof(LevelRecord, crc));
+}
+
+bool SanitizerModel::begin() {
+    Preferences prefs;
+    if (!prefs.begin(SANITIZER_NVS_NAMESPACE, true)) {
+        // Namespace doesn't exist until the first write
+        Logger::info(TAG, "No saved level, assuming a full " + String(reservoirMl, 0) + "ml reservoir");
+        return false;
+    }
+
+    float savedReservoir = prefs.getFloat("reservoirMl", 0);
+    if (savedReservoir > 0) {
+        reservoirMl = savedReservoir;
+    }
+    float savedFlow = prefs.getFloat("flowMlPerS", 0);
+    if (savedFlow > 0) {
+        flowMlPerS = savedFlow;
+        flowCalibrated = true;
+    }
+
+    // Newest valid record; the slot after it is the next one to write
+    bool found = false;
+    for (uint8_t slot = 0; slot < SANITIZER_RING_SLOTS; slot++) {
+        char key[8];
+        slotKey(slot, key);
+        LevelRecord record;
+        if (prefs.getBytes(key, &record, sizeof(record)) != sizeof(record) || record.crc != recordCrc(record)) {
+            continue;
+        }
+        if (!found || record.sequence > sequence) {
+            found = true;
+            sequence = record.sequence;
+            usedMl = record.usedMl;
+            dispenses = record.dispenses;
+            nextSlot = (slot + 1) % SANITIZER_RING_SLOTS;
+        }
+    }
+    prefs.end();
+    persistedUsedMl = usedMl;
+
+    Logger::info(TAG, "Sanitizer " + String(getRemainingMl(), 0) + "/" + String(reservoirMl, 0) + "ml" +
+                      (found ? "" : " (no saved level)") + ", flow " + String(flowMlPerS, 2) + "ml/s" +
+                      (flowCalibrated ? "" : " (uncalibrated)"));
+    return found;
+}
+
+void SanitizerModel::recordDispense(uint32_t onUs) {
+    float ml = flowMlPerS * onUs / 1000000.0f;
+    portENTER_CRITICAL(&levelMux);
+    usedMl += ml;
+    dispenses++;
+    portEXIT_CRITICAL(&levelMux);
+}
+
+void SanitizerModel::readLevel(float& used, uint32_t& count) const {
+    portENTER_CRITICAL(&levelMux);
+    used = usedMl;
+    count = dispenses;
+    portEXIT_CRITICAL(&levelMux);
+}
+
+bool SanitizerModel::writeRecord(float used, uint32_t count) {
+    LevelRecord record;
+    record.sequence = sequence + 1;
+    record.usedMl = used;
+    record.dispenses = count;
+    record.crc = recordCrc(record);
+
+    char key[8];
+    slotKey(nextSlot, key);
+    Preferences prefs;
+    if (!prefs.begin(SANITIZER_NVS_NAMESPACE, false)) {
+        Logger::warn(TAG, "Failed to open NVS for the sanitizer level");
+        return false;
+    }
+    bool written = prefs.putBytes(key, &record, sizeof(record)) == sizeof(record);
+    prefs.end();
+    if (!written) {
+        Logger::warn(TAG, "Failed to save the sanitizer level");
+        return false;
+    }
+
+    sequence = record.sequence;
+    nextSlot = (nextSlot + 1) % SANITIZER_RING_SLOTS;
+    persistedUsedMl = used;
+    recordWrites++;
+    return true;
+}
+
+bool SanitizerModel::persist(bool force) {
+    float used;
+    uint32_t count;
+    readLevel(used, count);
+
+    if (!force && used - persistedUsedMl < SANITIZER_PERSIST_ML) {
+        return false;
+    }
+    return writeRecord(used, count);
+}
+
+void SanitizerModel::refill() {
+    portENTER_CRITICAL(&levelMux);
+    usedMl = 0;
+    dispenses = 0;
+    portEXIT_CRITICAL(&levelMux);
+    persist(true);
+    Logger::info(TAG, "Sanitizer refilled (" + String(reservoirMl, 0) + "ml)");
+}
+
+void SanitizerModel::setPercent(float percent) {
+    if (percent < 0) percent = 0;
+    if (percent > 100) percent = 100;
+    float used = reservoirMl * (100.0f - percent) / 100.0f;
+    portENTER_CRITICAL(&levelMux);
+    usedMl = used;
+    portEXIT_CRITICAL(&levelMux);
+    persist(true);
+}
+
+bool SanitizerModel::setReservoirMl(float ml) {
+    if (ml <= 0 || ml > 10000) {
+        return false;
+    }
+    reservoirMl = ml;
+    Preferences prefs;
+    if (prefs.begin(SANITIZER_NVS_NAMESPACE, false)) {
+        prefs.putFloat("reservoirMl", reservoirMl);
+        prefs.end();
+    }
+    Logger::info(TAG, "Reservoir set to " + String(reservoirMl, 0) + "ml");
+    return true;
+}
+
+bool SanitizerModel::setFlowMlPerS(float mlPerS) {
+    if (mlPerS <= 0 || mlPerS > 100) {
+        return false;
+    }
+    flowMlPerS = mlPerS;
+    flowCalibrated = true;
+    Preferences prefs;
+    if (prefs.begin(SANITIZER_NVS_NAMESPACE, false)) {
+        prefs.putFloat("flowMlPerS", flowMlPerS);
+        prefs.end();
+    }
+    Logger::info(TAG, "Flow rate set to " + String(flowMlPerS, 2) + "ml/s");
+    return true;
+}
+
+bool SanitizerModel::calibrateFlow(float measuredMl, uint32_t onUs) {
+    if (measuredMl <= 0 || onUs == 0) {
+        return false;
+    }
+    return setFlowMlPerS(measuredMl * 1000000.0f / onUs);
+}
+
+float SanitizerModel::remainingMl(float used) const {
+    float remaining = reservoirMl - used;
+    return remaining > 0 ? remaining : 0;
+}
+
+float SanitizerModel::mlPerDispense(float used, uint32_t count, uint32_t doseMs) const {
+    if (count > 0 && used > 0) {
+        return used / count;
+    }
+    return flowMlPerS * doseMs / 1000.0f;
+}
+
+float SanitizerModel::getRemainingMl() const {
+    float used;
+    uint32_t count;
+    readLevel(used, count);
+    return remainingMl(used);
+}
+
+float SanitizerModel::getPercent() const {
+    return getRemainingMl() * 100.0f / reservoirMl;
+}
+
+float SanitizerModel::getMlPerDispense(uint32_t doseMs) const {
+    float used;
+    uint32_t count;
+    readLevel(used, count);
+    return mlPerDispense(used, count, doseMs);
+}
+
+uint32_t SanitizerModel::getDispensesLeft(uint32_t doseMs) const {
+    float used;
+    uint32_t count;
+    readLevel(used, count);
+    float perDispense = mlPerDispense(used, count, doseMs);
+    return perDispense > 0 ? (uint32_t)(remainingMl(used) / perDispense) : 0;
+}
+
+String SanitizerModel::getStatusJSON(uint32_t doseMs) const {
+    // Copy under the lock, build the JSON after releasing it
+    float used;
+    uint32_t count;
+    readLevel(used, count);
+    float remaining = remainingMl(used);
+    float perDispense = mlPerDispense(used, count, doseMs);
+
+    DynamicJsonDocument doc(512);
+    doc["reservoirMl"] = reservoirMl;
+    doc["remainingMl"] = round(remaining * 10) / 10.0;
+    doc["percent"] = round(remaining * 1000.0f / reservoirMl) / 10.0;
+    doc["usedMl"] = round(used * 10) / 10.0;
+    doc["dispenses"] = count;
+    doc["mlPerDispense"] = round(perDispense * 100) / 100.0;
+    doc["dispensesLeft"] = perDispense > 0 ? (uint32_t)(remaining / perDispense) : 0;
+    doc["flowMlPerS"] = flowMlPerS;
+    doc["flowCalibrated"] = flowCalibrated;
+
+    // Up to SANITIZER_PERSIST_ML can be lost on a power cut
+    JsonObject records = doc.createNestedObject("records");
+    records["slots"] = SANITIZER_RING_SLOTS;
+    records["sequence"] = sequence;
+    records["writes"] = recordWrites;
+    records["unsavedMl"] = round((used - persistedUsedMl) * 10) / 10.0;
+
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
@@ -0,0 +1,233 @@
+#include "SensorSampler.h"
+#include <ArduinoJson.h>
+#include <Preferences.h>
+
+const char* SensorSampler::TAG = "Sensors";
+
+static_assert(SENSOR_MEDIAN_WINDOW % 2 == 1 && SENSOR_MEDIAN_WINDOW <= 15, "SENSOR_MEDIAN_WINDOW must be odd, at most 15");
+static_assert(SENSOR_OVERSAMPLE >= 1 && SENSOR_OVERSAMPLE <= 64, "SENSOR_OVERSAMPLE must be 1-64");
+
+static const unsigned long CPU_WINDOW_US = 1000000UL;
+
+SensorSampler::SensorSampler()
+    : windowPos(0), primed(false), taskHandle(nullptr), rateHz(SENSOR_SAMPLE_RATE_HZ),
+      updates(0), lastUpdateUs(0), maxUpdateUs(0), windowBusyUs(0), windowStartUs(0), cpuPercent(0) {
+    portMUX_INITIALIZE(&dataMux);
+    memset(channels, 0, sizeof(channels));
+    channels[SENSOR_MOISTURE].pin = MOISTURE_SENSOR_PIN;
+    channels[SENSOR_LIGHT].pin = LIGHT_SENSOR_PIN;
+}
+
+SensorSampler::~SensorSampler() {
+    if (taskHandle) {
+        vTaskDelete(taskHandle);
+    }
+}
+
+bool SensorSampler::begin() {
+    Preferences prefs;
+    if (prefs.begin(SENSOR_NVS_NAMESPACE, true)) {
+        uint16_t saved = prefs.getUShort("rateHz", 0);
+        if (saved >= 1 && saved <= SENSOR_SAMPLE_RATE_MAX_HZ) {
+            rateHz = saved;
+        }
+        prefs.end();
+    }
+
+    // First update fills the median window and seeds the EMA, so readers
+    // have a value before the task has run
+    sample();
+
+    BaseType_t result = xTaskCreatePinnedToCore(taskEntry, "sensors",
+                                                SENSOR_SAMPLER_STACK_SIZE, this,
+                                                SENSOR_SAMPLER_PRIORITY, &taskHandle,
+                                                SENSOR_SAMPLER_CORE);
+    if (result != pdPASS) {
+        Logger::error(TAG, "Failed to start sensor task - readings won't update");
+        taskHandle = nullptr;
+        return false;
+    }
+
+    Logger::info(TAG, "Sampling at " + String(rateHz) + "Hz, " + String(SENSOR_OVERSAMPLE) +
+                      "x oversampled, median of " + String(SENSOR_MEDIAN_WINDOW));
+    return true;
+}
+
+void SensorSampler::taskEntry(void* param) {
+    static_cast<SensorSampler*>(param)->run();
+}
+
+void SensorSampler::run() {
+    TickType_t lastWake = xTaskGetTickCount();
+    windowStartUs = micros();
+
+    while (true) {
+        TickType_t period = pdMS_TO_TICKS(1000 / rateHz);
+        vTaskDelayUntil(&lastWake, period > 0 ? period : 1);
+
+        unsigned long start = micros();
+        sample();
+        unsigned long now = micros();
+        uint32_t busyUs = now - start;
+
+        portENTER_CRITICAL(&dataMux);
+        updates++;
+        lastUpdateUs = busyUs;
+        if (busyUs > maxUpdateUs) maxUpdateUs = busyUs;
+        windowBusyUs += busyUs;
+        if (now - windowStartUs >= CPU_WINDOW_US) {
+            cpuPercent = windowBusyUs * 100.0f / (now - windowStartUs);
+            windowBusyUs = 0;
+            windowStartUs = now;
+        }
+        portEXIT_CRITICAL(&dataMux);
+    }
+}
+
+uint16_t SensorSampler::median(const uint16_t* values) {
+    uint16_t sorted[SENSOR_MEDIAN_WINDOW];
+    memcpy(sorted, values, sizeof(sorted));
+    for (uint8_t i = 1; i < SENSOR_MEDIAN_WINDOW; i++) {
+        uint16_t value = sorted[i];
+        int8_t j = i - 1;
+        while (j >= 0 && sorted[j] > value) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = value;
+    }
+    return sorted[SENSOR_MEDIAN_WINDOW / 2];
+}
+
+void SensorSampler::sample() {
+    uint16_t means[SENSOR_CHANNEL_COUNT];
+    uint16_t mins[SENSOR_CHANNEL_COUNT];
+    uint16_t maxes[SENSOR_CHANNEL_COUNT];
+
+    for (uint8_t c = 0; c < SENSOR_CHANNEL_COUNT; c++) {
+        // The first conversion after the ADC switches pins still carries
+        // charge from the previous one (the sensor modules are high impedance)
+        analogRead(channels[c].pin);
+
+        uint32_t sum = 0;
+        uint16_t lo = 4095, hi = 0;
+        for (uint8_t i = 0; i < SENSOR_OVERSAMPLE; i++) {
+            uint16_t raw = analogRead(channels[c].pin);
+            sum += raw;
+            if (raw < lo) lo = raw;
+            if (raw > hi) hi = raw;
+        }
+        means[c] = (sum + SENSOR_OVERSAMPLE / 2) / SENSOR_OVERSAMPLE;
+        mins[c] = lo;
+        maxes[c] = hi;
+    }
+
+    // Only this task (or begin(), before it starts) touches the windows
+    float filtered[SENSOR_CHANNEL_COUNT];
+    for (uint8_t c = 0; c < SENSOR_CHANNEL_COUNT; c++) {
+        Channel& channel = channels[c];
+        if (!primed) {
+            for (uint8_t i = 0; i < SENSOR_MEDIAN_WINDOW; i++) {
+                channel.window[i] = means[c];
+            }
+            filtered[c] = means[c];
+        } else {
+            channel.window[windowPos] = means[c];
+            filtered[c] = channel.ema + SENSOR_EMA_ALPHA * (median(channel.window) - channel.ema);
+        }
+    }
+    windowPos = (windowPos + 1) % SENSOR_MEDIAN_WINDOW;
+    primed = true;
+
+    portENTER_CRITICAL(&dataMux);
+    for (uint8_t c = 0; c < SENSOR_CHANNEL_COUNT; c++) {
+        channels[c].ema = filtered[c];
+        channels[c].lastMean = means[c];
+        channels[c].lastMin = mins[c];
+        channels[c].lastMax = maxes[c];
+    }
+    portEXIT_CRITICAL(&dataMux);
+}
+
+bool SensorSampler::setRateHz(uint16_t hz) {
+    if (hz < 1 || hz > SENSOR_SAMPLE_RATE_MAX_HZ) {
+        return false;
+    }
+    rateHz = hz;  // Picked up at the task's next wake
+
+    Preferences prefs;
+    if (prefs.begin(SENSOR_NVS_NAMESPACE, false)) {
+        prefs.putUShort("rateHz", hz);
+        prefs.end();
+    }
+    Logger::info(TAG, "Sample rate set to " + String(hz) + "Hz");
+    return true;
+}
+
+float SensorSampler::getFiltered(SensorChannel channel) const {
+    portENTER_CRITICAL(&dataMux);
+    float value = channels[channel].ema;
+    portEXIT_CRITICAL(&dataMux);
+    return value;
+}
+
+uint16_t SensorSampler::getRaw(SensorChannel channel) const {
+    portENTER_CRITICAL(&dataMux);
+    uint16_t value = channels[channel].lastMean;
+    portEXIT_CRITICAL(&dataMux);
+    return value;
+}
+
+float SensorSampler::getCpuPercent() const {
+    portENTER_CRITICAL(&dataMux);
+    float value = cpuPercent;
+    portEXIT_CRITICAL(&dataMux);
+    return value;
+}
+
+const char* SensorSampler::channelToString(SensorChannel channel) {
+    switch (channel) {
+        case SENSOR_MOISTURE: return "moisture";
+        case SENSOR_LIGHT: return "light";
+        default: return "unknown";
+    }
+}
+
+String SensorSampler::getStatusJSON() const {
+    Channel snapshot[SENSOR_CHANNEL_COUNT];
+    portENTER_CRITICAL(&dataMux);
+    memcpy(snapshot, channels, sizeof(snapshot));
+    uint32_t updateCount = updates;
+    uint32_t lastUs = lastUpdateUs;
+    uint32_t maxUs = maxUpdateUs;
+    float cpu = cpuPercent;
+    portEXIT_CRITICAL(&dataMux);
+
+    DynamicJsonDocument doc(768);
+    doc["running"] = taskHandle != nullptr;
+    doc["rateHz"] = rateHz;
+    doc["oversample"] = SENSOR_OVERSAMPLE;
+    doc["medianWindow"] = SENSOR_MEDIAN_WINDOW;
+    doc["emaAlpha"] = SENSOR_EMA_ALPHA;
+
+    JsonObject values = doc.createNestedObject("channels");
+    for (uint8_t c = 0; c < SENSOR_CHANNEL_COUNT; c++) {
+        JsonObject channel = values.createNestedObject(channelToString((SensorChannel)c));
+        channel["pin"] = snapshot[c].pin;
+        channel["filtered"] = round(snapshot[c].ema * 10) / 10.0;
+        channel["raw"] = snapshot[c].lastMean;
+        channel["spread"] = snapshot[c].lastMax - snapshot[c].lastMin;  // Within the newest burst
+    }
+
+    // Time spent converting and filtering on the sensor task
+    JsonObject cpuCost = doc.createNestedObject("cpu");
+    cpuCost["percent"] = round(cpu * 100) / 100.0;
+    cpuCost["updates"] = updateCount;
+    cpuCost["lastUpdateUs"] = lastUs;
+    cpuCost["maxUpdateUs"] = maxUs;
+    cpuCost["conversionsPerSecond"] = (uint32_t)rateHz * SENSOR_CHANNEL_COUNT * (SENSOR_OVERSAMPLE + 1);
+
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
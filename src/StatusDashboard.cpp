@@ -0,0 +1,437 @@
+#include "StatusDashboard.h"
+
+const char* StatusDashboard::TAG = "Dashboard";
+
+// 480x320 landscape, 2 columns x 3 rows
+static const int16_t SCREEN_W = 480;
+static const int16_t SCREEN_H = 320;
+static const int16_t CELL_W = SCREEN_W / 2;
+static const int16_t CELL_H = SCREEN_H / 3;
+static const int16_t PAD = 8;
+static const int16_t TEXT_W = CELL_W - 2 * PAD;  // Every text line is padded to this width
+static const int16_t LABEL_Y = 6;
+static const int16_t VALUE_Y = 30;
+static const int16_t DETAIL_Y = 66;
+
+static const uint8_t LABEL_FONT = 2;   // 16px
+static const uint8_t VALUE_FONT = 4;   // 26px
+static const uint8_t DETAIL_FONT = 2;
+
+static const uint16_t BACKGROUND = TFT_BLACK;
+static const uint16_t LABEL_COLOR = TFT_DARKGREY;
+static const uint16_t TEXT_COLOR = TFT_WHITE;
+
+// Over SPI the ILI9486 takes 18-bit colour: three bytes per pixel on the wire
+static const uint8_t WIRE_BYTES_PER_PIXEL = 3;
+static const uint32_t FULL_FRAME_BYTES = (uint32_t)SCREEN_W * SCREEN_H * WIRE_BYTES_PER_PIXEL;
+
+StatusDashboard::StatusDashboard(HardwareAbstraction* hw)
+    : hardware(hw), tft(hw ? hw->getDisplay() : nullptr), dma(nullptr), lineSprite(nullptr), useDma(false),
+      taskHandle(nullptr), stateLock(nullptr), heapCost(0), frameDrawn(false), pausedAt(0), pauseMs(0),
+      updates(0), skipped(0), widgetRedraws(0), fullRedraws(0),
+      lastFrameUs(0), maxFrameUs(0), lastBytes(0), totalBytes(0), lastWidgets(0), lastDma(false),
+      loopUs(0), maxLoopUs(0) {
+    static const char* const labels[WIDGET_COUNT] = {
+        "SANITIZER", "MOISTURE", "WEATHER", "NEXT REMINDER", "PRINT QUEUE", "WIFI"
+    };
+    for (uint8_t i = 0; i < WIDGET_COUNT; i++) {
+        widgets[i].label = labels[i];
+        widgets[i].x = (i % 2) * CELL_W;
+        widgets[i].y = (i / 2) * CELL_H;
+        widgets[i].color = TEXT_COLOR;
+        widgets[i].dirty = true;
+    }
+    memset(&cpuStats, 0, sizeof(cpuStats));
+    memset(&dmaStats, 0, sizeof(dmaStats));
+}
+
+StatusDashboard::~StatusDashboard() {
+    if (taskHandle) {
+        vTaskDelete(taskHandle);
+    }
+    if (lineSprite) {
+        lineSprite->deleteSprite();
+        delete lineSprite;
+    }
+    delete dma;
+    if (stateLock) {
+        vSemaphoreDelete(stateLock);
+    }
+}
+
+bool StatusDashboard::begin() {
+    if (!tft) {
+        return false;
+    }
+    uint32_t heapBefore = ESP.getFreeHeap();
+
+    stateLock = xSemaphoreCreateMutex();
+    if (!stateLock) {
+        Logger::error(TAG, "Failed to create dashboard lock");
+        return false;
+    }
+
+#if DISPLAY_DMA_ENABLED
+    // One text line, 1 bit per pixel: 224 x 26 = 728 bytes
+    lineSprite = new TFT_eSprite(tft);
+    lineSprite->setColorDepth(1);
+    int16_t lineHeight = max(tft->fontHeight(VALUE_FONT), tft->fontHeight(DETAIL_FONT));
+    dma = new TftDmaWriter(tft);
+    if (!lineSprite->createSprite(TEXT_W, lineHeight) || !dma->begin()) {
+        Logger::warn(TAG, "Display DMA unavailable - using CPU writes");
+        lineSprite->deleteSprite();
+        delete lineSprite;
+        lineSprite = nullptr;
+        delete dma;
+        dma = nullptr;
+    }
+    useDma = dma != nullptr;
+#endif
+
+    BaseType_t result = xTaskCreatePinnedToCore(taskEntry, "display",
+                                                DISPLAY_TASK_STACK_SIZE, this,
+                                                DISPLAY_TASK_PRIORITY, &taskHandle,
+                                                DISPLAY_TASK_CORE);
+    if (result != pdPASS) {
+        Logger::error(TAG, "Failed to start display task - dashboard disabled");
+        taskHandle = nullptr;
+        return false;
+    }
+    heapCost = heapBefore - ESP.getFreeHeap();
+
+    xTaskNotifyGive(taskHandle);  // Draw the frame
+    Logger::info(TAG, "Dashboard started (update every " + String(DASHBOARD_UPDATE_MS) + "ms, " +
+                      (useDma ? "DMA" : "CPU") + " writes, " + String(heapCost) + " bytes heap)");
+    return true;
+}
+
+void StatusDashboard::taskEntry(void* param) {
+    StatusDashboard* self = static_cast<StatusDashboard*>(param);
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        self->render();
+    }
+}
+
+void StatusDashboard::invalidate() {
+    xSemaphoreTake(stateLock, portMAX_DELAY);
+    frameDrawn = false;
+    xSemaphoreGive(stateLock);
+}
+
+void StatusDashboard::pause(uint32_t ms) {
+    xSemaphoreTake(stateLock, portMAX_DELAY);
+    pausedAt = millis();
+    pauseMs = ms;
+    frameDrawn = false;
+    xSemaphoreGive(stateLock);
+}
+
+bool StatusDashboard::pausedLocked() const {
+    return pauseMs > 0 && millis() - pausedAt < pauseMs;
+}
+
+bool StatusDashboard::isPaused() const {
+    xSemaphoreTake(stateLock, portMAX_DELAY);
+    bool paused = pausedLocked();
+    xSemaphoreGive(stateLock);
+    return paused;
+}
+
+bool StatusDashboard::setDmaEnabled(bool enabled) {
+    if (enabled && !dma) {
+        return false;
+    }
+    xSemaphoreTake(stateLock, portMAX_DELAY);
+    useDma = enabled;
+    for (uint8_t i = 0; i < WIDGET_COUNT; i++) {
+        widgets[i].dirty = true;  // Fresh sample on the new path
+    }
+    xSemaphoreGive(stateLock);
+
+    Logger::info(TAG, String("Widget pushes now by ") + (enabled ? "DMA" : "CPU"));
+    if (taskHandle) {
+        xTaskNotifyGive(taskHandle);
+    }
+    return true;
+}
+
+String StatusDashboard::fitText(const String& text, uint8_t font) const {
+    // Built-in fonts are 7-bit ASCII; drop what they can't draw ("°")
+    String fitted;
+    fitted.reserve(text.length());
+    for (unsigned int i = 0; i < text.length(); i++) {
+        char c = text[i];
+        if (c >= 32 && c <= 126) {
+            fitted += c;
+        }
+    }
+    if (tft->textWidth(fitted, font) <= TEXT_W) {
+        return fitted;
+    }
+    while (fitted.length() > 0 && tft->textWidth(fitted + "..", font) > TEXT_W) {
+        fitted.remove(fitted.length() - 1);
+    }
+    return fitted + "..";
+}
+
+void StatusDashboard::setWidget(DashboardWidget id, const String& value, const String& detail, uint16_t color) {
+    Widget& widget = widgets[id];
+    String fittedValue = fitText(value, VALUE_FONT);
+    String fittedDetail = fitText(detail, DETAIL_FONT);
+    if (widget.value != fittedValue || widget.detail != fittedDetail || widget.color != color) {
+        widget.value = fittedValue;
+        widget.detail = fittedDetail;
+        widget.color = color;
+        widget.dirty = true;
+    }
+}
+
+uint32_t StatusDashboard::drawText(const String& text, int16_t x, int16_t y, uint8_t font, uint16_t color, bool viaDma) {
+    int16_t height = tft->fontHeight(font);
+    if (viaDma) {
+        // Render the line into the 1-bit sprite, then stream it out with
+        // both colours expanded on the way; same region as the CPU path
+        lineSprite->fillSprite(0);
+        lineSprite->setTextColor(1);
+        lineSprite->drawString(text, 0, 0, font);
+        return dma->pushMono(x, y, TEXT_W, height, (const uint8_t*)lineSprite->getPointer(),
+                             TEXT_W / 8, color, BACKGROUND);
+    }
+
+    // Text with a background colour and padding overwrites the old text
+    // in one pass over the line's region
+    tft->setTextColor(color, BACKGROUND);
+    tft->setTextPadding(TEXT_W);
+    tft->drawString(text, x, y, font);
+    return (uint32_t)TEXT_W * height * WIRE_BYTES_PER_PIXEL;
+}
+
+uint32_t StatusDashboard::drawFrame() {
+    tft->fillScreen(BACKGROUND);
+    for (int16_t row = 1; row < 3; row++) {
+        tft->drawFastHLine(0, row * CELL_H, SCREEN_W, LABEL_COLOR);
+    }
+    tft->drawFastVLine(CELL_W, 0, SCREEN_H, LABEL_COLOR);
+
+    uint32_t bytes = FULL_FRAME_BYTES;
+    tft->setTextDatum(TL_DATUM);
+    for (uint8_t i = 0; i < WIDGET_COUNT; i++) {
+        bytes += drawText(widgets[i].label, widgets[i].x + PAD, widgets[i].y + LABEL_Y, LABEL_FONT, LABEL_COLOR, false);
+    }
+    return bytes;
+}
+
+uint32_t StatusDashboard::drawWidget(const Widget& widget, bool viaDma) {
+    uint32_t bytes = drawText(widget.value, widget.x + PAD, widget.y + VALUE_Y, VALUE_FONT, widget.color, viaDma);
+    bytes += drawText(widget.detail, widget.x + PAD, widget.y + DETAIL_Y, DETAIL_FONT, TEXT_COLOR, viaDma);
+    return bytes;
+}
+
+void StatusDashboard::update(const DashboardData& data) {
+    if (!tft || !taskHandle) {
+        return;
+    }
+    unsigned long start = micros();
+
+    // Format everything; only text that differs from what's on screen is drawn
+    uint16_t levelColor = data.sanitizerPercent < DASHBOARD_SANITIZER_LOW ? TFT_RED :
+                          data.sanitizerPercent < 2 * DASHBOARD_SANITIZER_LOW ? TFT_YELLOW : TFT_GREEN;
+    String weatherValue = data.weather;
+    String weatherDetail;
+    int comma = data.weather.indexOf(',');
+    if (comma > 0) {
+        weatherValue = data.weather.substring(0, comma);
+        weatherDetail = data.weather.substring(comma + 1);
+        weatherDetail.trim();
+    }
+
+    xSemaphoreTake(stateLock, portMAX_DELAY);
+    if (pausedLocked()) {
+        xSemaphoreGive(stateLock);
+        return;
+    }
+
+    setWidget(WIDGET_SANITIZER, String(data.sanitizerPercent, 0) + "%",
+              String(data.sanitizerMl) + " ml, ~" + String(data.dispensesLeft) + " doses", levelColor);
+
+    setWidget(WIDGET_MOISTURE, String(data.moisturePercent, 0) + "%",
+              "Light " + String(data.lightPercent, 0) + "%", TEXT_COLOR);
+
+    setWidget(WIDGET_WEATHER, weatherValue, weatherDetail, TEXT_COLOR);
+
+    if (data.nextReminderTime > 0) {
+        struct tm timeinfo;
+        localtime_r(&data.nextReminderTime, &timeinfo);
+        char when[16];
+        strftime(when, sizeof(when), "%a %H:%M", &timeinfo);
+        setWidget(WIDGET_REMINDER, when, data.nextReminder, TFT_CYAN);
+    } else {
+        setWidget(WIDGET_REMINDER, "None", "", LABEL_COLOR);
+    }
+
+    setWidget(WIDGET_PRINT_QUEUE, String(data.printQueueDepth),
+              data.printQueueDepth == 0 ? "Idle" : (data.printQueueDepth == 1 ? "job waiting" : "jobs waiting"),
+              data.printQueueDepth == 0 ? TEXT_COLOR : TFT_CYAN);
+
+    // RSSI in 5dB steps so normal wobble doesn't redraw the widget every second
+    int rssi = (data.wifiRssi / 5) * 5;
+    setWidget(WIDGET_WIFI, data.wifiConnected ? "Connected" : "Offline",
+              data.wifiConnected ? data.ip + "  " + String(rssi) + " dBm" : "Reconnecting",
+              data.wifiConnected ? TFT_GREEN : TFT_RED);
+
+    bool changed = !frameDrawn;
+    for (uint8_t i = 0; i < WIDGET_COUNT && !changed; i++) {
+        changed = widgets[i].dirty;
+    }
+    if (!changed) {
+        skipped++;
+    }
+    loopUs = micros() - start;
+    if (loopUs > maxLoopUs) maxLoopUs = loopUs;
+    xSemaphoreGive(stateLock);
+
+    if (changed) {
+        xTaskNotifyGive(taskHandle);
+    }
+}
+
+void StatusDashboard::render() {
+    // Display tests draw under the same lock
+    hardware->lockDisplay();
+
+    // Take the changed widgets and let update() carry on formatting
+    // while they're pushed
+    Widget pending[WIDGET_COUNT];
+    uint8_t count = 0;
+    xSemaphoreTake(stateLock, portMAX_DELAY);
+    if (pausedLocked()) {
+        xSemaphoreGive(stateLock);
+        hardware->unlockDisplay();
+        return;
+    }
+    bool withFrame = !frameDrawn;
+    for (uint8_t i = 0; i < WIDGET_COUNT; i++) {
+        if (withFrame || widgets[i].dirty) {
+            pending[count++] = widgets[i];
+            widgets[i].dirty = false;
+        }
+    }
+    frameDrawn = true;
+    bool viaDma = useDma;
+    xSemaphoreGive(stateLock);
+
+    if (count == 0) {
+        hardware->unlockDisplay();
+        return;
+    }
+
+    unsigned long start = micros();
+    uint32_t bytes = 0;
+    tft->startWrite();
+    if (withFrame) {
+        bytes += drawFrame();
+    }
+    unsigned long widgetStart = micros();
+    uint32_t widgetBytes = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        widgetBytes += drawWidget(pending[i], viaDma);
+    }
+    uint32_t widgetUs = micros() - widgetStart;
+    tft->endWrite();
+    uint32_t frameUs = micros() - start;
+    hardware->unlockDisplay();
+    bytes += widgetBytes;
+
+    xSemaphoreTake(stateLock, portMAX_DELAY);
+    updates++;
+    if (withFrame) fullRedraws++;
+    widgetRedraws += count;
+    lastWidgets = count;
+    lastDma = viaDma;
+    lastFrameUs = frameUs;
+    if (frameUs > maxFrameUs) maxFrameUs = frameUs;
+    lastBytes = bytes;
+    totalBytes += bytes;
+
+    PathStats& path = viaDma ? dmaStats : cpuStats;
+    path.updates++;
+    path.lastUs = widgetUs;
+    if (widgetUs > path.maxUs) path.maxUs = widgetUs;
+    path.totalUs += widgetUs;
+    path.totalBytes += widgetBytes;
+    xSemaphoreGive(stateLock);
+}
+
+void StatusDashboard::addPathStats(JsonObject out, const PathStats& stats) {
+    out["updates"] = stats.updates;
+    out["lastUs"] = stats.lastUs;
+    out["maxUs"] = stats.maxUs;
+    out["meanUs"] = stats.updates > 0 ? (uint32_t)(stats.totalUs / stats.updates) : 0;
+    out["meanBytes"] = stats.updates > 0 ? (uint32_t)(stats.totalBytes / stats.updates) : 0;
+    // Effective rate, comparable between the paths whatever changed
+    out["kbPerSec"] = stats.totalUs > 0 ? (uint32_t)(stats.totalBytes * 1000000ULL / stats.totalUs / 1024) : 0;
+}
+
+const char* StatusDashboard::widgetToString(DashboardWidget widget) {
+    switch (widget) {
+        case WIDGET_SANITIZER: return "sanitizer";
+        case WIDGET_MOISTURE: return "moisture";
+        case WIDGET_WEATHER: return "weather";
+        case WIDGET_REMINDER: return "reminder";
+        case WIDGET_PRINT_QUEUE: return "printQueue";
+        case WIDGET_WIFI: return "wifi";
+        default: return "unknown";
+    }
+}
+
+String StatusDashboard::getStatusJSON() const {
+    DynamicJsonDocument doc(1536);
+    doc["enabled"] = taskHandle != nullptr;
+    doc["paused"] = isPaused();
+    doc["updateMs"] = DASHBOARD_UPDATE_MS;
+    doc["heapCost"] = heapCost;
+
+    JsonObject dmaInfo = doc.createNestedObject("dma");
+    dmaInfo["available"] = dma != nullptr;
+    if (dma) {
+        dmaInfo["buffers"] = 2;
+        dmaInfo["bufferBytes"] = dma->getBufferBytes();
+        dmaInfo["heapCost"] = dma->getHeapCost();
+    }
+
+    xSemaphoreTake(stateLock, portMAX_DELAY);
+    doc["path"] = useDma ? "dma" : "cpu";
+    doc["updates"] = updates;
+    doc["unchanged"] = skipped;
+    doc["widgetRedraws"] = widgetRedraws;
+    doc["fullRedraws"] = fullRedraws;
+
+    // Pixel data written to the panel (region writes, excluding SPI command bytes)
+    JsonObject frame = doc.createNestedObject("lastUpdate");
+    frame["widgets"] = lastWidgets;
+    frame["path"] = lastDma ? "dma" : "cpu";
+    frame["frameUs"] = lastFrameUs;
+    frame["bytes"] = lastBytes;
+    doc["maxFrameUs"] = maxFrameUs;
+    doc["meanBytes"] = updates > 0 ? (uint32_t)(totalBytes / updates) : 0;
+    doc["fullFrameBytes"] = FULL_FRAME_BYTES;
+
+    // update() on the caller: formatting only, the task does the SPI work
+    doc["loopUs"] = loopUs;
+    doc["maxLoopUs"] = maxLoopUs;
+
+    JsonObject paths = doc.createNestedObject("paths");
+    addPathStats(paths.createNestedObject("cpu"), cpuStats);
+    addPathStats(paths.createNestedObject("dma"), dmaStats);
+
+    JsonObject shown = doc.createNestedObject("widgets");
+    for (uint8_t i = 0; i < WIDGET_COUNT; i++) {
+        shown[widgetToString((DashboardWidget)i)] = widgets[i].value;
+    }
+    xSemaphoreGive(stateLock);
+
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
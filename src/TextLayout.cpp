@@ -0,0 +1,148 @@
+#include "TextLayout.h"
+#include "CodePageTranscoder.h"
+#include "config.h"
+
+uint8_t TextLayout::columnsForMode(uint8_t printMode) {
+    // ESC ! bit 5 = double width; double height doesn't change the pitch
+    return (printMode & 32) ? PRINTER_COLUMNS / 2 : PRINTER_COLUMNS;
+}
+
+uint16_t TextLayout::measure(const char* text, size_t length) {
+    uint16_t width = 0;
+    size_t i = 0;
+    while (i < length) {
+        size_t consumed;
+        width += CodePageTranscoder::printedWidth(text + i, length - i, &consumed);
+        i += consumed;
+    }
+    return width;
+}
+
+uint16_t TextLayout::wrap(const char* text, size_t length, uint8_t columns, const LayoutLineSink& sink) {
+    uint16_t lines = 0;
+    size_t i = 0;
+    bool done = false;
+
+    while (!done) {
+        size_t lineStart = i;
+        size_t lineEnd = i;
+        uint16_t width = 0;
+        bool paragraphEnd = false;
+
+        // Last space seen on this line: where to break if the next word overflows
+        size_t breakAt = 0;
+        uint16_t breakWidth = 0;
+        bool haveBreak = false;
+
+        while (true) {
+            if (i >= length) {
+                lineEnd = i;
+                paragraphEnd = true;
+                done = true;
+                break;
+            }
+
+            char c = text[i];
+            if (c == '\n' || (c == '\r' && i + 1 < length && text[i + 1] == '\n')) {
+                lineEnd = i;
+                i += c == '\r' ? 2 : 1;
+                paragraphEnd = true;
+                break;
+            }
+
+            size_t consumed;
+            uint8_t w = CodePageTranscoder::printedWidth(text + i, length - i, &consumed);
+
+            if (c == ' ') {
+                breakAt = i;
+                breakWidth = width;
+                haveBreak = true;
+            }
+
+            if (width + w > columns && width > 0) {
+                if (c == ' ') {
+                    lineEnd = i;
+                } else if (haveBreak) {
+                    // Move the partial word down to the next line
+                    lineEnd = breakAt;
+                    width = breakWidth;
+                    i = breakAt;
+                } else {
+                    // Single word wider than the line - hard break
+                    lineEnd = i;
+                }
+                break;
+            }
+
+            width += w;
+            i += consumed;
+        }
+
+        while (lineEnd > lineStart && text[lineEnd - 1] == ' ') {
+            lineEnd--;
+            width--;
+        }
+
+        if (sink) {
+            sink(text + lineStart, lineEnd - lineStart, width, paragraphEnd);
+        }
+        lines++;
+
+        // A wrapped line's continuation doesn't start with the break spaces
+        if (!paragraphEnd) {
+            while (i < length && text[i] == ' ') {
+                i++;
+            }
+        }
+    }
+
+    return lines;
+}
+
+bool TextLayout::justify(const char* text, size_t length, uint8_t width, uint8_t columns,
+                         char* out, size_t outSize) {
+    // Stretching a short line (e.g. before a hard-broken word) leaves
+    // rivers of spaces; leave it ragged instead
+    if (width >= columns || width * 4 < columns * 3) {
+        return false;
+    }
+
+    // A gap is a run of spaces between two words; leading indentation
+    // and trailing spaces are left alone
+    uint8_t gaps = 0;
+    bool seenWord = false;
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] != ' ') {
+            seenWord = true;
+        } else if (seenWord && i + 1 < length && text[i + 1] != ' ') {
+            gaps++;
+        }
+    }
+
+    uint8_t extra = columns - width;
+    if (gaps == 0 || length + extra + 1 > outSize) {
+        return false;
+    }
+
+    // Spread the padding evenly, leftmost gaps take the remainder
+    uint8_t perGap = extra / gaps;
+    uint8_t remainder = extra % gaps;
+    uint8_t gap = 0;
+    size_t o = 0;
+    seenWord = false;
+
+    for (size_t i = 0; i < length; i++) {
+        out[o++] = text[i];
+        if (text[i] != ' ') {
+            seenWord = true;
+        } else if (seenWord && i + 1 < length && text[i + 1] != ' ') {
+            uint8_t pad = perGap + (gap < remainder ? 1 : 0);
+            for (uint8_t p = 0; p < pad; p++) {
+                out[o++] = ' ';
+            }
+            gap++;
+        }
+    }
+    out[o] = '\0';
+    return true;
+}
@@ -0,0 +1,169 @@
+#include "TextSanitizer.h"
+
+// Sorted by codepoint - checked at compile time below.
+// Variation selectors (U+FE0F after ❤ ⚠ 🖨) are dropped like any other
+// unmapped non-ASCII character.
+static constexpr EmojiReplacement EMOJI_TABLE[] = {
+    {0x023F0, "[ALARM]"},         // ⏰
+    {0x026A0, "[!]"},             // ⚠
+    {0x02705, "[OK]"},            // ✅
+    {0x02728, "*"},               // ✨
+    {0x0274C, "[X]"},             // ❌
+    {0x02764, "<3"},              // ❤
+    {0x02B50, "*"},               // ⭐
+    {0x1F31F, "*"},               // 🌟
+    {0x1F335, "[CACTUS]"},        // 🌵
+    {0x1F337, "[FLOWER]"},        // 🌷
+    {0x1F338, "[FLOWER]"},        // 🌸
+    {0x1F339, "[ROSE]"},          // 🌹
+    {0x1F33A, "[FLOWER]"},        // 🌺
+    {0x1F33B, "[FLOWER]"},        // 🌻
+    {0x1F381, "[GIFT]"},          // 🎁
+    {0x1F388, "[BALLOON]"},       // 🎈
+    {0x1F389, "[PARTY]"},         // 🎉
+    {0x1F38A, "[PARTY]"},         // 🎊
+    {0x1F48B, "[KISS]"},          // 💋
+    {0x1F48C, "[LOVE LETTER]"},   // 💌
+    {0x1F490, "[FLOWERS]"},       // 💐
+    {0x1F493, "<3"},              // 💓
+    {0x1F495, "<3"},              // 💕
+    {0x1F496, "<3"},              // 💖
+    {0x1F497, "<3"},              // 💗
+    {0x1F49D, "[GIFT]"},          // 💝
+    {0x1F49E, "<3"},              // 💞
+    {0x1F49F, "<3"},              // 💟
+    {0x1F4A7, "[DROP]"},          // 💧
+    {0x1F4AB, "*"},               // 💫
+    {0x1F4DD, "[NOTE]"},          // 📝
+    {0x1F4E1, "[SIGNAL]"},        // 📡
+    {0x1F527, "[TOOL]"},          // 🔧
+    {0x1F5A8, "[PRINTER]"},       // 🖨
+    {0x1F60A, ":)"},              // 😊
+    {0x1F60D, ":)"},              // 😍
+    {0x1F618, ":*"},              // 😘
+    {0x1F63B, ":)"},              // 😻
+    {0x1F6D2, "[CART]"},          // 🛒
+    {0x1F970, ":)"},              // 🥰
+};
+
+static constexpr size_t EMOJI_TABLE_SIZE = sizeof(EMOJI_TABLE) / sizeof(EMOJI_TABLE[0]);
+
+static constexpr bool isTableSorted(size_t i) {
+    return i + 1 >= EMOJI_TABLE_SIZE ||
+           (EMOJI_TABLE[i].codepoint < EMOJI_TABLE[i + 1].codepoint && isTableSorted(i + 1));
+}
+static_assert(isTableSorted(0), "EMOJI_TABLE must be sorted by codepoint for binary search");
+
+uint32_t TextSanitizer::decodeUtf8(const uint8_t* text, size_t length, size_t* consumed) {
+    *consumed = 1;
+    uint8_t lead = text[0];
+    
+    if (lead < 0x80) {
+        return lead;
+    }
+    
+    size_t sequenceLength;
+    uint32_t codepoint;
+    if ((lead & 0xE0) == 0xC0) {
+        sequenceLength = 2;
+        codepoint = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+        sequenceLength = 3;
+        codepoint = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0) {
+        sequenceLength = 4;
+        codepoint = lead & 0x07;
+    } else {
+        return UTF8_INVALID;  // Stray continuation byte or invalid lead
+    }
+    
+    if (sequenceLength > length) {
+        return UTF8_INVALID;
+    }
+    
+    for (size_t i = 1; i < sequenceLength; i++) {
+        if ((text[i] & 0xC0) != 0x80) {
+            return UTF8_INVALID;
+        }
+        codepoint = (codepoint << 6) | (text[i] & 0x3F);
+    }
+    
+    *consumed = sequenceLength;
+    return codepoint;
+}
+
+const char* TextSanitizer::lookupReplacement(uint32_t codepoint) {
+    size_t low = 0;
+    size_t high = EMOJI_TABLE_SIZE;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (EMOJI_TABLE[mid].codepoint < codepoint) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low < EMOJI_TABLE_SIZE && EMOJI_TABLE[low].codepoint == codepoint) {
+        return EMOJI_TABLE[low].text;
+    }
+    return nullptr;
+}
+
+size_t TextSanitizer::sanitize(const char* text, size_t length, char* out, size_t outSize) {
+    const uint8_t* input = (const uint8_t*)text;
+    size_t needed = 0;
+    size_t i = 0;
+    
+    while (i < length) {
+        uint8_t c = input[i];
+        
+        // Fast path: printable ASCII plus newline/tab
+        if (c < 0x80) {
+            if ((c >= 32 && c <= 126) || c == '\n' || c == '\r' || c == '\t') {
+                if (out && needed < outSize) out[needed] = (char)c;
+                needed++;
+            }
+            i++;
+            continue;
+        }
+        
+        size_t consumed;
+        uint32_t codepoint = decodeUtf8(input + i, length - i, &consumed);
+        i += consumed;
+        
+        const char* replacement = codepoint != UTF8_INVALID ? lookupReplacement(codepoint) : nullptr;
+        if (replacement) {
+            for (const char* p = replacement; *p; p++) {
+                if (out && needed < outSize) out[needed] = *p;
+                needed++;
+            }
+        }
+    }
+    
+    return needed;
+}
+
+String TextSanitizer::sanitize(const String& text) {
+    size_t needed = sanitize(text.c_str(), text.length(), nullptr, 0);
+    
+    String result;
+    if (needed == 0 || !result.reserve(needed)) {
+        return result;
+    }
+    
+    // Small results go through the stack, larger ones through one heap block
+    char stackBuffer[128];
+    char* buffer = needed < sizeof(stackBuffer) ? stackBuffer : (char*)malloc(needed + 1);
+    if (!buffer) {
+        return result;
+    }
+    
+    sanitize(text.c_str(), text.length(), buffer, needed);
+    buffer[needed] = '\0';
+    result = buffer;
+    
+    if (buffer != stackBuffer) {
+        free(buffer);
+    }
+    return result;
+}
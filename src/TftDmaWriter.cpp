@@ -0,0 +1,134 @@
+#include "TftDmaWriter.h"
+#include <esp_heap_caps.h>
+
+const char* TftDmaWriter::TAG = "TftDMA";
+
+// TFT_eSPI drives the panel through the Arduino SPI object (VSPI)
+static const spi_host_device_t TFT_SPI_HOST = SPI3_HOST;
+
+static_assert(DISPLAY_DMA_BUFFER_BYTES % 3 == 0, "DISPLAY_DMA_BUFFER_BYTES must hold whole pixels (3 bytes each)");
+
+TftDmaWriter::TftDmaWriter(TFT_eSPI* display)
+    : tft(display), device(nullptr), busInitialized(false), bufferBytes(DISPLAY_DMA_BUFFER_BYTES), heapCost(0) {
+    buffers[0] = buffers[1] = nullptr;
+    memset(transactions, 0, sizeof(transactions));
+}
+
+TftDmaWriter::~TftDmaWriter() {
+    if (device) {
+        spi_bus_remove_device(device);
+    }
+    if (busInitialized) {
+        spi_bus_free(TFT_SPI_HOST);
+    }
+    for (uint8_t i = 0; i < 2; i++) {
+        if (buffers[i]) heap_caps_free(buffers[i]);
+    }
+}
+
+bool TftDmaWriter::begin() {
+    uint32_t heapBefore = ESP.getFreeHeap();
+
+    for (uint8_t i = 0; i < 2; i++) {
+        buffers[i] = (uint8_t*)heap_caps_malloc(bufferBytes, MALLOC_CAP_DMA);
+        if (!buffers[i]) {
+            Logger::error(TAG, "No DMA-capable RAM for the line buffers");
+            return false;
+        }
+    }
+
+    // Descriptors are sized by max_transfer_sz, so they stay small too
+    spi_bus_config_t bus;
+    memset(&bus, 0, sizeof(bus));
+    bus.mosi_io_num = TFT_MOSI;
+    bus.miso_io_num = TFT_MISO;
+    bus.sclk_io_num = TFT_SCLK;
+    bus.quadwp_io_num = -1;
+    bus.quadhd_io_num = -1;
+    bus.max_transfer_sz = bufferBytes;
+    if (spi_bus_initialize(TFT_SPI_HOST, &bus, SPI_DMA_CH_AUTO) != ESP_OK) {
+        Logger::error(TAG, "Failed to set up SPI DMA");
+        return false;
+    }
+    busInitialized = true;
+
+    // No CS pin: TFT_eSPI holds the panel selected around each push
+    spi_device_interface_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.mode = 0;
+    config.clock_speed_hz = SPI_FREQUENCY;
+    config.spics_io_num = -1;
+    config.flags = SPI_DEVICE_NO_DUMMY;
+    config.queue_size = 2;
+    if (spi_bus_add_device(TFT_SPI_HOST, &config, &device) != ESP_OK) {
+        Logger::error(TAG, "Failed to add the DMA SPI device");
+        device = nullptr;
+        return false;
+    }
+
+    heapCost = heapBefore - ESP.getFreeHeap();
+    Logger::info(TAG, "Display DMA ready: 2 x " + String(bufferBytes) + " byte buffers, " +
+                      String(heapCost) + " bytes of heap in total");
+    return true;
+}
+
+uint32_t TftDmaWriter::pushMono(int16_t x, int16_t y, int16_t w, int16_t h,
+                                const uint8_t* bits, uint16_t strideBytes, uint16_t fg, uint16_t bg) {
+    if (!device || w <= 0 || h <= 0) {
+        return 0;
+    }
+
+    // RGB565 -> the three bytes the panel takes (same as TFT_eSPI's 18-bit writes)
+    const uint8_t colors[2][3] = {
+        {(uint8_t)((bg & 0xF800) >> 8), (uint8_t)((bg & 0x07E0) >> 3), (uint8_t)((bg & 0x001F) << 3)},
+        {(uint8_t)((fg & 0xF800) >> 8), (uint8_t)((fg & 0x07E0) >> 3), (uint8_t)((fg & 0x001F) << 3)}
+    };
+    const size_t bufferPixels = bufferBytes / BYTES_PER_PIXEL;
+    const uint32_t totalPixels = (uint32_t)w * h;
+
+    tft->setAddrWindow(x, y, w, h);
+
+    uint32_t pixel = 0;
+    uint16_t px = 0;
+    uint16_t py = 0;
+    uint8_t next = 0;
+    uint8_t inFlight = 0;
+    while (pixel < totalPixels) {
+        // Both buffers queued: the older one is next - wait for it
+        if (inFlight == 2) {
+            spi_transaction_t* done;
+            spi_device_get_trans_result(device, &done, portMAX_DELAY);
+            inFlight--;
+        }
+
+        uint8_t* out = buffers[next];
+        size_t count = 0;
+        while (count < bufferPixels && pixel < totalPixels) {
+            const uint8_t* color = colors[(bits[py * strideBytes + (px >> 3)] >> (7 - (px & 7))) & 1];
+            *out++ = color[0];
+            *out++ = color[1];
+            *out++ = color[2];
+            count++;
+            pixel++;
+            if (++px == w) {
+                px = 0;
+                py++;
+            }
+        }
+
+        spi_transaction_t& transaction = transactions[next];
+        memset(&transaction, 0, sizeof(transaction));
+        transaction.tx_buffer = buffers[next];
+        transaction.length = count * BYTES_PER_PIXEL * 8;  // Bits
+        spi_device_queue_trans(device, &transaction, portMAX_DELAY);
+        inFlight++;
+        next ^= 1;
+    }
+    while (inFlight > 0) {
+        spi_transaction_t* done;
+        spi_device_get_trans_result(device, &done, portMAX_DELAY);
+        inFlight--;
+    }
+
+    return totalPixels * BYTES_PER_PIXEL;
+}
@@ -0,0 +1,528 @@
+#include "TouchController.h"
+#include "HardwareAbstraction.h"
+#include <ArduinoJson.h>
+#include <Preferences.h>
+#include <esp_rom_crc.h>
+
+const char* TouchController::TAG = "Touch";
+
+// XPT2046 control bytes: start bit, channel, 12-bit differential. The low
+// two bits keep the ADC powered through a burst (PENIRQ off); the
+// power-down command turns PENIRQ back on.
+static const uint8_t CMD_X = 0xD3;
+static const uint8_t CMD_Y = 0x93;
+static const uint8_t CMD_Z1 = 0xB3;
+static const uint8_t CMD_Z2 = 0xC3;
+static const uint8_t CMD_POWER_DOWN = 0xD0;
+
+static const uint16_t ADC_MAX = 4095;
+static const float MIN_DETERMINANT = 10000.0f;  // Calibration points ~100 raw units apart or closer
+static const int16_t TARGET_MARGIN = 40;
+static const int16_t TARGET_SIZE = 12;
+
+static_assert(TOUCH_BURST_SAMPLES % 2 == 1, "TOUCH_BURST_SAMPLES must be odd");
+
+static uint16_t medianOf(uint16_t* values, uint8_t count) {
+    for (uint8_t i = 1; i < count; i++) {
+        uint16_t value = values[i];
+        int8_t j = i - 1;
+        while (j >= 0 && values[j] > value) {
+            values[j + 1] = values[j];
+            j--;
+        }
+        values[j + 1] = value;
+    }
+    return values[count / 2];
+}
+
+TouchController::TouchController()
+    : spi(nullptr), tft(nullptr), busLock(nullptr), taskHandle(nullptr), events(nullptr), lock(nullptr),
+      screenW(480), screenH(320), armed(false),
+      calibration(CALIBRATION_NONE), calibrationStep(0), calibrationStartedAt(0), targetPending(false),
+      pressed(false), lastX(0), lastY(0),
+      historyCount(0), historyNext(0), sequence(0),
+      presses(0), readings(0), busSkips(0), dropped(0), lastBurstUs(0), maxBurstUs(0) {
+    memset(&matrix, 0, sizeof(matrix));
+    memset(&lastRaw, 0, sizeof(lastRaw));
+    memset(history, 0, sizeof(history));
+}
+
+TouchController::~TouchController() {
+    if (taskHandle) {
+        detachInterrupt(digitalPinToInterrupt(TOUCH_IRQ_PIN));
+        vTaskDelete(taskHandle);
+    }
+}
+
+bool TouchController::begin(TFT_eSPI* display, SemaphoreHandle_t displayBusLock) {
+    if (!display) {
+        Logger::warn(TAG, "No display - touch disabled (it shares the display's SPI bus)");
+        return false;
+    }
+    tft = display;
+    spi = &tft->getSPIinstance();
+    busLock = displayBusLock;
+    screenW = tft->width();
+    screenH = tft->height();
+
+    // Spread out and not in a line, so the matrix is well conditioned
+    targetX[0] = TARGET_MARGIN;           targetY[0] = TARGET_MARGIN;
+    targetX[1] = screenW - TARGET_MARGIN; targetY[1] = screenH / 2;
+    targetX[2] = screenW / 2;             targetY[2] = screenH - TARGET_MARGIN;
+
+    pinMode(TOUCH_CS_PIN, OUTPUT);
+    digitalWrite(TOUCH_CS_PIN, HIGH);  // CS high = not selected
+    pinMode(TOUCH_IRQ_PIN, INPUT_PULLUP);
+
+    lock = xSemaphoreCreateMutex();
+    events = xQueueCreate(TOUCH_EVENT_QUEUE_LENGTH, sizeof(TouchEvent));
+    if (!lock || !events) {
+        Logger::error(TAG, "Failed to create touch queue");
+        return false;
+    }
+    loadCalibration();
+
+    // The controller powers up with PENIRQ off until the first power-down command
+    xSemaphoreTake(busLock, portMAX_DELAY);
+    spi->beginTransaction(SPISettings(TOUCH_SPI_FREQUENCY, MSBFIRST, SPI_MODE0));
+    digitalWrite(TOUCH_CS_PIN, LOW);
+    readChannel(CMD_POWER_DOWN);
+    digitalWrite(TOUCH_CS_PIN, HIGH);
+    spi->endTransaction();
+    xSemaphoreGive(busLock);
+
+    BaseType_t result = xTaskCreatePinnedToCore(taskEntry, "touch",
+                                                TOUCH_TASK_STACK_SIZE, this,
+                                                TOUCH_TASK_PRIORITY, &taskHandle,
+                                                TOUCH_TASK_CORE);
+    if (result != pdPASS) {
+        Logger::error(TAG, "Failed to start touch task");
+        taskHandle = nullptr;
+        return false;
+    }
+
+    armed = true;
+    attachInterruptArg(digitalPinToInterrupt(TOUCH_IRQ_PIN), handleIrq, this, FALLING);
+
+    Logger::info(TAG, "Touch ready on CS " + String(TOUCH_CS_PIN) + ", IRQ " + String(TOUCH_IRQ_PIN) +
+                      (calibration == CALIBRATION_SAVED ? " (calibrated)" : " (not calibrated - default mapping)"));
+    return true;
+}
+
+void IRAM_ATTR TouchController::handleIrq(void* param) {
+    TouchController* self = static_cast<TouchController*>(param);
+    if (!self->armed) {
+        return;  // Our own conversions, or a press already being tracked
+    }
+    self->armed = false;
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(self->taskHandle, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void TouchController::taskEntry(void* param) {
+    static_cast<TouchController*>(param)->run();
+}
+
+void TouchController::run() {
+    while (true) {
+        // Calibration gives up if nobody touches the screen
+        TickType_t wait = portMAX_DELAY;
+        if (isCalibrating()) {
+            unsigned long elapsed = millis() - calibrationStartedAt;
+            wait = elapsed >= TOUCH_CALIBRATION_TIMEOUT_MS ? 0 : pdMS_TO_TICKS(TOUCH_CALIBRATION_TIMEOUT_MS - elapsed);
+        }
+        if (ulTaskNotifyTake(pdTRUE, wait) == 0) {
+            if (isCalibrating()) {
+                finishCalibration(CALIBRATION_TIMED_OUT);
+            }
+            continue;
+        }
+
+        if (targetPending) {
+            targetPending = false;
+            drawTarget(0);
+            // Falls through: a press may share this wake, and re-arming below covers it
+        }
+
+        while (true) {
+            trackPress();
+
+            // Conversions toggle PENIRQ; only an edge after this counts
+            ulTaskNotifyTake(pdTRUE, 0);
+            armed = true;
+            if (digitalRead(TOUCH_IRQ_PIN) == HIGH) {
+                break;
+            }
+            armed = false;  // Pressed again before re-arming - no edge is coming
+        }
+    }
+}
+
+void TouchController::trackPress() {
+    bool calibrating = isCalibrating();
+    bool down = false;
+    int16_t x = 0;
+    int16_t y = 0;
+    uint32_t sumX = 0;
+    uint32_t sumY = 0;
+    uint16_t count = 0;
+
+    while (true) {
+        Reading reading;
+        ReadResult result = sample(reading);
+        if (result == READ_RELEASED) {
+            break;
+        }
+        if (result == READ_OK) {
+            if (calibrating) {
+                // Averaged over the whole press, recorded on release
+                sumX += reading.rawX;
+                sumY += reading.rawY;
+                count++;
+            } else {
+                int16_t newX;
+                int16_t newY;
+                toScreen(reading, newX, newY);
+                bool moved = abs(newX - x) >= TOUCH_MOVE_THRESHOLD || abs(newY - y) >= TOUCH_MOVE_THRESHOLD;
+                if (!down || moved) {
+                    publish(down ? TOUCH_MOVE : TOUCH_DOWN, newX, newY, reading.z);
+                    x = newX;
+                    y = newY;
+                }
+
+                xSemaphoreTake(lock, portMAX_DELAY);
+                lastX = x;
+                lastY = y;
+                xSemaphoreGive(lock);
+                pressed = true;
+            }
+            down = true;
+        }
+        vTaskDelay(pdMS_TO_TICKS(TOUCH_SAMPLE_MS));
+    }
+
+    pressed = false;
+    if (calibrating) {
+        if (count > 0) {
+            Reading average = {(uint16_t)(sumX / count), (uint16_t)(sumY / count), 0};
+            calibrationPoint(average);
+        }
+    } else if (down) {
+        publish(TOUCH_UP, x, y, 0);
+    }
+}
+
+TouchController::ReadResult TouchController::sample(Reading& reading) {
+    // Never inside a display transfer; a reading that has to wait long is skipped
+    if (xSemaphoreTake(busLock, pdMS_TO_TICKS(TOUCH_BUS_WAIT_MS)) != pdTRUE) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        busSkips++;
+        xSemaphoreGive(lock);
+        return READ_BUS_BUSY;
+    }
+
+    unsigned long start = micros();
+    spi->beginTransaction(SPISettings(TOUCH_SPI_FREQUENCY, MSBFIRST, SPI_MODE0));
+    digitalWrite(TOUCH_CS_PIN, LOW);
+
+    // Pressure first: a lift doesn't need X and Y
+    uint16_t z1 = readChannel(CMD_Z1);
+    uint16_t z2 = readChannel(CMD_Z2);
+    int32_t z = (int32_t)ADC_MAX + z1 - z2;
+    bool touched = z >= TOUCH_PRESSURE_MIN;
+    if (touched) {
+        uint16_t xs[TOUCH_BURST_SAMPLES];
+        uint16_t ys[TOUCH_BURST_SAMPLES];
+        readChannel(CMD_X);  // First conversion after switching axes is still settling
+        for (uint8_t i = 0; i < TOUCH_BURST_SAMPLES; i++) {
+            xs[i] = readChannel(CMD_X);
+        }
+        readChannel(CMD_Y);
+        for (uint8_t i = 0; i < TOUCH_BURST_SAMPLES; i++) {
+            ys[i] = readChannel(CMD_Y);
+        }
+        reading.rawX = medianOf(xs, TOUCH_BURST_SAMPLES);
+        reading.rawY = medianOf(ys, TOUCH_BURST_SAMPLES);
+        reading.z = (uint16_t)z;
+    }
+    readChannel(CMD_POWER_DOWN);
+
+    digitalWrite(TOUCH_CS_PIN, HIGH);
+    spi->endTransaction();
+    uint32_t burstUs = micros() - start;
+    xSemaphoreGive(busLock);
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    readings++;
+    lastBurstUs = burstUs;
+    if (burstUs > maxBurstUs) maxBurstUs = burstUs;
+    if (touched) {
+        lastRaw = reading;
+    }
+    xSemaphoreGive(lock);
+
+    return touched ? READ_OK : READ_RELEASED;
+}
+
+uint16_t TouchController::readChannel(uint8_t command) {
+    spi->transfer(command);
+    return (spi->transfer16(0) >> 3) & ADC_MAX;  // 12 bits after the busy bit
+}
+
+void TouchController::toScreen(const Reading& reading, int16_t& x, int16_t& y) const {
+    float fx = matrix.a * reading.rawX + matrix.b * reading.rawY + matrix.c;
+    float fy = matrix.d * reading.rawX + matrix.e * reading.rawY + matrix.f;
+    x = (int16_t)constrain(fx + 0.5f, 0.0f, (float)(screenW - 1));
+    y = (int16_t)constrain(fy + 0.5f, 0.0f, (float)(screenH - 1));
+}
+
+void TouchController::publish(TouchEventType type, int16_t x, int16_t y, uint16_t z) {
+    TouchEvent event;
+    event.type = type;
+    event.x = x;
+    event.y = y;
+    event.z = z;
+    event.timeMs = millis();
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    event.sequence = ++sequence;
+    if (type == TOUCH_DOWN) presses++;
+    history[historyNext] = event;
+    historyNext = (historyNext + 1) % TOUCH_HISTORY_LENGTH;
+    if (historyCount < TOUCH_HISTORY_LENGTH) historyCount++;
+    xSemaphoreGive(lock);
+
+    if (xQueueSend(events, &event, 0) != pdTRUE) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        dropped++;
+        xSemaphoreGive(lock);
+    }
+}
+
+bool TouchController::receiveEvent(TouchEvent& event, TickType_t wait) {
+    return events && xQueueReceive(events, &event, wait) == pdTRUE;
+}
+
+bool TouchController::getLastPoint(int16_t* x, int16_t* y) const {
+    if (!pressed) {
+        return false;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (x) *x = lastX;
+    if (y) *y = lastY;
+    xSemaphoreGive(lock);
+    return true;
+}
+
+bool TouchController::startCalibration() {
+    if (!taskHandle) {
+        return false;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (calibration == CALIBRATION_RUNNING) {
+        xSemaphoreGive(lock);
+        return false;
+    }
+    calibration = CALIBRATION_RUNNING;
+    calibrationStep = 0;
+    calibrationStartedAt = millis();
+    xSemaphoreGive(lock);
+
+    // The touch task draws the first target, off the caller's time
+    targetPending = true;
+    xTaskNotifyGive(taskHandle);
+    Logger::info(TAG, "Touch calibration started");
+    return true;
+}
+
+void TouchController::calibrationPoint(const Reading& reading) {
+    sampledX[calibrationStep] = reading.rawX;
+    sampledY[calibrationStep] = reading.rawY;
+    Logger::debug(TAG, "Calibration point " + String(calibrationStep + 1) + ": raw " +
+                       String(reading.rawX) + "," + String(reading.rawY));
+    if (++calibrationStep < CALIBRATION_POINTS) {
+        drawTarget(calibrationStep);
+        return;
+    }
+
+    // Solve screen = M * (rawX, rawY, 1) through the three points
+    // (Cramer's rule on the differences to point 2)
+    float x0 = (float)sampledX[0] - sampledX[2], y0 = (float)sampledY[0] - sampledY[2];
+    float x1 = (float)sampledX[1] - sampledX[2], y1 = (float)sampledY[1] - sampledY[2];
+    float det = x0 * y1 - x1 * y0;
+    if (fabsf(det) < MIN_DETERMINANT) {
+        Logger::warn(TAG, "Calibration points too close together - keeping the old calibration");
+        finishCalibration(CALIBRATION_FAILED);
+        return;
+    }
+    float sx0 = targetX[0] - targetX[2], sx1 = targetX[1] - targetX[2];
+    float sy0 = targetY[0] - targetY[2], sy1 = targetY[1] - targetY[2];
+
+    CalibrationRecord record;
+    record.a = (sx0 * y1 - sx1 * y0) / det;
+    record.b = (x0 * sx1 - x1 * sx0) / det;
+    record.c = targetX[2] - record.a * sampledX[2] - record.b * sampledY[2];
+    record.d = (sy0 * y1 - sy1 * y0) / det;
+    record.e = (x0 * sy1 - x1 * sy0) / det;
+    record.f = targetY[2] - record.d * sampledX[2] - record.e * sampledY[2];
+    record.crc = recordCrc(record);
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    matrix = record;
+    xSemaphoreGive(lock);
+    if (!saveCalibration()) {
+        Logger::warn(TAG, "Calibration applied but not saved to NVS");
+    }
+    finishCalibration(CALIBRATION_SAVED);
+}
+
+void TouchController::finishCalibration(CalibrationState result) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    calibration = result;
+    xSemaphoreGive(lock);
+    targetPending = false;
+
+    Logger::info(TAG, String("Touch calibration ") + calibrationToString(result));
+    publish(TOUCH_CALIBRATION_DONE, 0, 0, 0);
+}
+
+void TouchController::drawTarget(uint8_t step) {
+    int16_t x = targetX[step];
+    int16_t y = targetY[step];
+
+    xSemaphoreTake(busLock, portMAX_DELAY);
+    tft->startWrite();
+    tft->fillScreen(TFT_BLACK);
+    tft->drawFastHLine(x - TARGET_SIZE, y, 2 * TARGET_SIZE + 1, TFT_WHITE);
+    tft->drawFastVLine(x, y - TARGET_SIZE, 2 * TARGET_SIZE + 1, TFT_WHITE);
+    tft->drawCircle(x, y, TARGET_SIZE / 2, TFT_RED);
+    tft->setTextColor(TFT_WHITE, TFT_BLACK);
+    tft->setTextPadding(0);
+    tft->setTextDatum(MC_DATUM);
+    tft->drawString("Touch the target (" + String(step + 1) + "/" + String(CALIBRATION_POINTS) + ")",
+                    screenW / 2, screenH / 2, 2);
+    tft->setTextDatum(TL_DATUM);
+    tft->endWrite();
+    xSemaphoreGive(busLock);
+}
+
+uint32_t TouchController::recordCrc(const CalibrationRecord& record) {
+    return esp_rom_crc32_le(0, (const uint8_t*)&record, offsetof(CalibrationRecord, crc));
+}
+
+void TouchController::loadCalibration() {
+    CalibrationRecord record;
+    Preferences prefs;
+    bool loaded = false;
+    if (prefs.begin(TOUCH_NVS_NAMESPACE, true)) {
+        loaded = prefs.getBytes("matrix", &record, sizeof(record)) == sizeof(record) &&
+                 record.crc == recordCrc(record);
+        prefs.end();
+    }
+
+    if (loaded) {
+        matrix = record;
+        calibration = CALIBRATION_SAVED;
+        return;
+    }
+    // Until calibrated: the full ADC range stretched over the screen
+    memset(&matrix, 0, sizeof(matrix));
+    matrix.a = (float)screenW / (ADC_MAX + 1);
+    matrix.e = (float)screenH / (ADC_MAX + 1);
+    calibration = CALIBRATION_NONE;
+}
+
+bool TouchController::saveCalibration() {
+    Preferences prefs;
+    if (!prefs.begin(TOUCH_NVS_NAMESPACE, false)) {
+        return false;
+    }
+    bool written = prefs.putBytes("matrix", &matrix, sizeof(matrix)) == sizeof(matrix);
+    prefs.end();
+    return written;
+}
+
+const char* TouchController::eventTypeToString(TouchEventType type) {
+    switch (type) {
+        case TOUCH_DOWN: return "down";
+        case TOUCH_MOVE: return "move";
+        case TOUCH_UP: return "up";
+        case TOUCH_CALIBRATION_DONE: return "calibrationDone";
+        default: return "unknown";
+    }
+}
+
+const char* TouchController::calibrationToString(CalibrationState state) {
+    switch (state) {
+        case CALIBRATION_NONE: return "none";
+        case CALIBRATION_RUNNING: return "running";
+        case CALIBRATION_SAVED: return "saved";
+        case CALIBRATION_FAILED: return "failed";
+        case CALIBRATION_TIMED_OUT: return "timedOut";
+        default: return "unknown";
+    }
+}
+
+String TouchController::getStatusJSON(uint32_t since) const {
+    DynamicJsonDocument doc(3072);
+    doc["running"] = taskHandle != nullptr;
+    doc["pressed"] = pressed;
+    doc["irqState"] = digitalRead(TOUCH_IRQ_PIN);
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    doc["calibration"] = calibrationToString(calibration);
+    if (calibration == CALIBRATION_RUNNING) {
+        doc["calibrationStep"] = calibrationStep + 1;
+    }
+    JsonArray coefficients = doc.createNestedArray("matrix");
+    coefficients.add(matrix.a);
+    coefficients.add(matrix.b);
+    coefficients.add(matrix.c);
+    coefficients.add(matrix.d);
+    coefficients.add(matrix.e);
+    coefficients.add(matrix.f);
+
+    JsonObject last = doc.createNestedObject("last");
+    last["x"] = lastX;
+    last["y"] = lastY;
+    last["rawX"] = lastRaw.rawX;
+    last["rawY"] = lastRaw.rawY;
+    last["z"] = lastRaw.z;
+
+    doc["presses"] = presses;
+    doc["readings"] = readings;
+    doc["busSkips"] = busSkips;
+    doc["dropped"] = dropped;
+    // Bus time per reading, lock held
+    doc["lastBurstUs"] = lastBurstUs;
+    doc["maxBurstUs"] = maxBurstUs;
+
+    // Oldest first
+    doc["sequence"] = sequence;
+    JsonArray recent = doc.createNestedArray("events");
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < historyCount; i++) {
+        const TouchEvent& event = history[(historyNext + TOUCH_HISTORY_LENGTH - historyCount + i) % TOUCH_HISTORY_LENGTH];
+        if (event.sequence <= since) {
+            continue;
+        }
+        JsonObject entry = recent.createNestedObject();
+        entry["sequence"] = event.sequence;
+        entry["type"] = eventTypeToString(event.type);
+        if (event.type != TOUCH_CALIBRATION_DONE) {
+            entry["x"] = event.x;
+            entry["y"] = event.y;
+            entry["z"] = event.z;
+        }
+        entry["ageMs"] = now - event.timeMs;
+    }
+    xSemaphoreGive(lock);
+
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
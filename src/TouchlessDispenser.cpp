@@ -0,0 +1,268 @@
+#include "TouchlessDispenser.h"
+#include <ArduinoJson.h>
+
+const char* TouchlessDispenser::TAG = "Touchless";
+
+const uint16_t TouchlessDispenser::LATENCY_BUCKET_MS[LATENCY_BUCKETS - 1] = {10, 20, 30, 40, 50, 75, 100};
+
+static const UBaseType_t EVENT_QUEUE_LENGTH = 8;
+
+TouchlessDispenser::TouchlessDispenser(HardwareAbstraction* hal)
+    : hardware(hal), taskHandle(nullptr), events(nullptr), lock(nullptr), debounceTimer(nullptr),
+      debouncing(false), firstEdgeMicros(0), stablePresent(false),
+      enabled(TOUCHLESS_DISPENSE_ENABLED), state(DISPENSER_IDLE), handPresent(false), dispenseStartedAt(0),
+      detections(0), dispenses(0), refused(0),
+      latencyMinUs(0), latencyMaxUs(0), latencyTotalUs(0), overTarget(0) {
+    portMUX_INITIALIZE(&edgeMux);
+    memset(latencyCounts, 0, sizeof(latencyCounts));
+}
+
+TouchlessDispenser::~TouchlessDispenser() {
+    detachInterrupt(digitalPinToInterrupt(IR_SENSOR_PIN));
+    if (debounceTimer) {
+        esp_timer_stop(debounceTimer);
+        esp_timer_delete(debounceTimer);
+    }
+    if (taskHandle) {
+        vTaskDelete(taskHandle);
+    }
+}
+
+bool TouchlessDispenser::begin() {
+    lock = xSemaphoreCreateMutex();
+    events = xQueueCreate(EVENT_QUEUE_LENGTH, sizeof(SensorEvent));
+    if (!lock || !events) {
+        Logger::error(TAG, "Failed to create dispenser queue");
+        return false;
+    }
+
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = handleDebounce;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "irDebounce";
+    if (esp_timer_create(&timerArgs, &debounceTimer) != ESP_OK) {
+        Logger::error(TAG, "Failed to create debounce timer");
+        debounceTimer = nullptr;
+        return false;
+    }
+
+    BaseType_t result = xTaskCreatePinnedToCore(taskEntry, "dispenser",
+                                                DISPENSER_TASK_STACK_SIZE, this,
+                                                DISPENSER_TASK_PRIORITY, &taskHandle,
+                                                DISPENSER_TASK_CORE);
+    if (result != pdPASS) {
+        Logger::error(TAG, "Failed to start dispenser task");
+        taskHandle = nullptr;
+        return false;
+    }
+
+    // A hand already there at boot has to leave before the first dispense
+    stablePresent = digitalRead(IR_SENSOR_PIN) == LOW;
+    handPresent = stablePresent;
+    state = stablePresent ? DISPENSER_WAIT_CLEAR : DISPENSER_IDLE;
+    attachInterruptArg(digitalPinToInterrupt(IR_SENSOR_PIN), handleEdge, this, CHANGE);
+
+    Logger::info(TAG, String("Touchless dispensing ") + (enabled ? "enabled" : "disabled") +
+                      " (debounce " + String(IR_DEBOUNCE_MS) + "ms)");
+    return true;
+}
+
+void IRAM_ATTR TouchlessDispenser::handleEdge(void* param) {
+    TouchlessDispenser* self = static_cast<TouchlessDispenser*>(param);
+
+    portENTER_CRITICAL_ISR(&self->edgeMux);
+    if (!self->debouncing) {
+        self->debouncing = true;
+        self->firstEdgeMicros = micros();
+    }
+    portEXIT_CRITICAL_ISR(&self->edgeMux);
+
+    // Every edge pushes the sample point back, so it lands IR_DEBOUNCE_MS
+    // after the sensor stops bouncing
+    esp_timer_stop(self->debounceTimer);
+    esp_timer_start_once(self->debounceTimer, (uint64_t)IR_DEBOUNCE_MS * 1000ULL);
+}
+
+void TouchlessDispenser::handleDebounce(void* param) {
+    TouchlessDispenser* self = static_cast<TouchlessDispenser*>(param);
+    bool present = digitalRead(IR_SENSOR_PIN) == LOW;
+
+    portENTER_CRITICAL(&self->edgeMux);
+    unsigned long edgeMicros = self->firstEdgeMicros;
+    self->debouncing = false;
+    portEXIT_CRITICAL(&self->edgeMux);
+
+    if (present == self->stablePresent) {
+        return;  // Glitch - back where it started
+    }
+    self->stablePresent = present;
+
+    SensorEvent event = {present, edgeMicros};
+    xQueueSend(self->events, &event, 0);
+}
+
+void TouchlessDispenser::taskEntry(void* param) {
+    static_cast<TouchlessDispenser*>(param)->run();
+}
+
+void TouchlessDispenser::run() {
+    while (true) {
+        // The HAL's timer switches the pump off; wake when the dose is
+        // over to re-arm
+        TickType_t wait = portMAX_DELAY;
+        if (state == DISPENSER_DISPENSING) {
+            unsigned long elapsed = millis() - dispenseStartedAt;
+            uint32_t dose = hardware->getActiveDoseMs();
+            wait = elapsed >= dose ? 0 : pdMS_TO_TICKS(dose - elapsed);
+        }
+
+        SensorEvent event;
+        if (xQueueReceive(events, &event, wait) == pdTRUE) {
+            handleEvent(event);
+        } else if (state == DISPENSER_DISPENSING) {
+            // A hand still there has to leave before the next dose
+            state = handPresent ? DISPENSER_WAIT_CLEAR : DISPENSER_IDLE;
+        }
+    }
+}
+
+void TouchlessDispenser::handleEvent(const SensorEvent& event) {
+    handPresent = event.present;
+
+    if (!event.present) {
+        // A dose runs to the end even if the hand is pulled away
+        if (state == DISPENSER_WAIT_CLEAR) {
+            state = DISPENSER_IDLE;
+        }
+        return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    detections++;
+    xSemaphoreGive(lock);
+
+    if (state != DISPENSER_IDLE || !enabled) {
+        return;
+    }
+
+    // A remote dispense in progress or the cooldown refuses this hand; it
+    // has to leave and come back
+    if (hardware->isDispensing() || !hardware->checkCooldown() || !hardware->startPump()) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        refused++;
+        xSemaphoreGive(lock);
+        state = DISPENSER_WAIT_CLEAR;
+        Logger::debug(TAG, "Hand detected, dispense refused (cooldown or pump busy)");
+        return;
+    }
+
+    dispenseStartedAt = millis();
+    state = DISPENSER_DISPENSING;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    dispenses++;
+    xSemaphoreGive(lock);
+    recordLatency(hardware->getPumpStartMicros() - event.edgeMicros);
+}
+
+void TouchlessDispenser::recordLatency(uint32_t latencyUs) {
+    uint8_t bucket = 0;
+    while (bucket < LATENCY_BUCKETS - 1 && latencyUs > (uint32_t)LATENCY_BUCKET_MS[bucket] * 1000UL) {
+        bucket++;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    latencyCounts[bucket]++;
+    if (latencyMinUs == 0 || latencyUs < latencyMinUs) latencyMinUs = latencyUs;
+    if (latencyUs > latencyMaxUs) latencyMaxUs = latencyUs;
+    latencyTotalUs += latencyUs;
+    if (latencyUs > (uint32_t)DISPENSE_LATENCY_TARGET_MS * 1000UL) {
+        overTarget++;
+    }
+    xSemaphoreGive(lock);
+
+    if (latencyUs > (uint32_t)DISPENSE_LATENCY_TARGET_MS * 1000UL) {
+        Logger::warn(TAG, "Hand to pump latency " + String(latencyUs / 1000.0, 1) + "ms, target " +
+                          String(DISPENSE_LATENCY_TARGET_MS) + "ms");
+    } else {
+        Logger::debug(TAG, "Hand to pump latency " + String(latencyUs / 1000.0, 1) + "ms");
+    }
+}
+
+void TouchlessDispenser::setEnabled(bool enable) {
+    // A dispense already running finishes normally
+    enabled = enable;
+    Logger::info(TAG, String("Touchless dispensing ") + (enable ? "enabled" : "disabled"));
+}
+
+const char* TouchlessDispenser::stateToString(DispenserState state) {
+    switch (state) {
+        case DISPENSER_IDLE: return "idle";
+        case DISPENSER_DISPENSING: return "dispensing";
+        case DISPENSER_WAIT_CLEAR: return "wait_clear";
+        default: return "unknown";
+    }
+}
+
+String TouchlessDispenser::getStatusJSON() const {
+    DynamicJsonDocument doc(1024);
+    doc["enabled"] = (bool)enabled;
+    doc["running"] = taskHandle != nullptr;
+    doc["state"] = stateToString(state);
+    doc["handPresent"] = handPresent;
+    doc["debounceMs"] = IR_DEBOUNCE_MS;
+    doc["doseMs"] = hardware->getDoseMs();
+    doc["maxDispenseMs"] = MAX_DISPENSE_DURATION_MS;
+    doc["softStartMs"] = PUMP_SOFT_START_MS;
+    doc["cooldownMs"] = DISPENSE_COOLDOWN_MS;
+
+    if (lock) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        doc["detections"] = detections;
+        doc["dispenses"] = dispenses;
+        doc["refused"] = refused;
+
+        // Hand detected (first sensor edge) -> pump GPIO on
+        uint32_t latencyCount = 0;
+        for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) {
+            latencyCount += latencyCounts[i];
+        }
+        JsonObject latency = doc.createNestedObject("latency");
+        latency["count"] = latencyCount;
+        latency["targetMs"] = DISPENSE_LATENCY_TARGET_MS;
+        latency["overTarget"] = overTarget;
+        if (latencyCount > 0) {
+            latency["minMs"] = latencyMinUs / 1000.0;
+            latency["maxMs"] = latencyMaxUs / 1000.0;
+            latency["meanMs"] = (float)(latencyTotalUs / latencyCount) / 1000.0;
+        }
+        JsonArray bounds = latency.createNestedArray("bucketsMs");
+        for (uint8_t i = 0; i < LATENCY_BUCKETS - 1; i++) {
+            bounds.add(LATENCY_BUCKET_MS[i]);
+        }
+        JsonArray counts = latency.createNestedArray("counts");
+        for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) {
+            counts.add(latencyCounts[i]);
+        }
+        xSemaphoreGive(lock);
+    }
+
+    // Timer-ended doses (any source): measured on-time minus requested
+    DoseStats stats = hardware->getDoseStats();
+    JsonObject dose = doc.createNestedObject("dose");
+    dose["count"] = stats.doses;
+    dose["stoppedEarly"] = stats.stoppedEarly;
+    if (stats.doses + stats.stoppedEarly > 0) {
+        dose["lastMs"] = stats.lastDoseMs;
+        dose["lastOnMs"] = stats.lastOnUs / 1000.0;
+    }
+    if (stats.doses > 0) {
+        dose["jitterMinUs"] = stats.jitterMinUs;
+        dose["jitterMaxUs"] = stats.jitterMaxUs;
+        dose["jitterMeanAbsUs"] = (uint32_t)(stats.jitterAbsTotalUs / stats.doses);
+    }
+
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
@@ -0,0 +1,143 @@
+#include "UserGlyphs.h"
+
+enum GlyphIndex {
+    GLYPH_HEART,
+    GLYPH_STAR,
+    GLYPH_SMILE,
+    GLYPH_FLOWER,
+    GLYPH_ROSE,
+    GLYPH_CACTUS,
+    GLYPH_DROP,
+    GLYPH_COUNT
+};
+
+// 12x24 bitmaps, one 12-bit row per entry (bit 11 = leftmost dot). Each is
+// assigned an ASCII code that is rare in messages; while ESC % 1 is active
+// the printer prints the glyph for that code instead.
+static const UserGlyph GLYPHS[GLYPH_COUNT] = {
+    {'{', {  // heart
+        0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x618,
+        0xF3C, 0xFFC, 0xFFC, 0xFFC, 0x7F8, 0x3F0, 0x1E0, 0x0C0,
+        0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000
+    }},
+    {'|', {  // star
+        0x000, 0x000, 0x000, 0x000, 0x040, 0x040, 0x0E0, 0x0E0,
+        0xFFE, 0x7FC, 0x3F8, 0x1F0, 0x1B0, 0x318, 0x208, 0x000,
+        0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000
+    }},
+    {'}', {  // smile
+        0x000, 0x000, 0x000, 0x000, 0x1F0, 0x208, 0x404, 0x912,
+        0x912, 0x802, 0xA0A, 0x912, 0x4E4, 0x208, 0x1F0, 0x000,
+        0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000
+    }},
+    {'~', {  // flower
+        0x000, 0x000, 0x000, 0x000, 0x0C0, 0x1E0, 0x5E8, 0xF3C,
+        0x6D8, 0x120, 0x6D8, 0xF3C, 0x5E8, 0x1E0, 0x0C0, 0x0C0,
+        0x2D0, 0x1D0, 0x0C0, 0x000, 0x000, 0x000, 0x000, 0x000
+    }},
+    {'`', {  // rose
+        0x000, 0x000, 0x000, 0x000, 0x1E0, 0x330, 0x6D8, 0x528,
+        0x568, 0x6D8, 0x330, 0x1E0, 0x0C0, 0x0D8, 0x6F0, 0x3C0,
+        0x0C0, 0x0C0, 0x0C0, 0x000, 0x000, 0x000, 0x000, 0x000
+    }},
+    {'^', {  // cactus
+        0x000, 0x000, 0x000, 0x000, 0x0C0, 0x1E0, 0x1E0, 0x1EC,
+        0xDEC, 0xDEC, 0xDEC, 0xDFC, 0xDF8, 0xFE0, 0x7E0, 0x1E0,
+        0x1E0, 0x3F0, 0x3F0, 0x1E0, 0x000, 0x000, 0x000, 0x000
+    }},
+    {'\\', {  // drop
+        0x000, 0x000, 0x000, 0x000, 0x040, 0x040, 0x0E0, 0x0E0,
+        0x1F0, 0x3F8, 0x3B8, 0x7BC, 0x77C, 0x77C, 0x378, 0x1F0,
+        0x0E0, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000
+    }},
+};
+
+// Sorted by codepoint - checked at compile time below
+static constexpr UserGlyphMapping GLYPH_MAP[] = {
+    {0x02665, GLYPH_HEART},     // ♥
+    {0x02728, GLYPH_STAR},      // ✨
+    {0x02764, GLYPH_HEART},     // ❤
+    {0x02B50, GLYPH_STAR},      // ⭐
+    {0x1F31F, GLYPH_STAR},      // 🌟
+    {0x1F335, GLYPH_CACTUS},    // 🌵
+    {0x1F337, GLYPH_FLOWER},    // 🌷
+    {0x1F338, GLYPH_FLOWER},    // 🌸
+    {0x1F339, GLYPH_ROSE},      // 🌹
+    {0x1F33A, GLYPH_FLOWER},    // 🌺
+    {0x1F33B, GLYPH_FLOWER},    // 🌻
+    {0x1F490, GLYPH_FLOWER},    // 💐
+    {0x1F493, GLYPH_HEART},     // 💓
+    {0x1F495, GLYPH_HEART},     // 💕
+    {0x1F496, GLYPH_HEART},     // 💖
+    {0x1F497, GLYPH_HEART},     // 💗
+    {0x1F49E, GLYPH_HEART},     // 💞
+    {0x1F49F, GLYPH_HEART},     // 💟
+    {0x1F4A7, GLYPH_DROP},      // 💧
+    {0x1F4AB, GLYPH_STAR},      // 💫
+    {0x1F60A, GLYPH_SMILE},     // 😊
+    {0x1F60D, GLYPH_SMILE},     // 😍
+    {0x1F63B, GLYPH_SMILE},     // 😻
+    {0x1F642, GLYPH_SMILE},     // 🙂
+    {0x1F970, GLYPH_SMILE},     // 🥰
+};
+
+static constexpr size_t GLYPH_MAP_SIZE = sizeof(GLYPH_MAP) / sizeof(GLYPH_MAP[0]);
+
+static constexpr bool isMapSorted(size_t i) {
+    return i + 1 >= GLYPH_MAP_SIZE ||
+           (GLYPH_MAP[i].codepoint < GLYPH_MAP[i + 1].codepoint && isMapSorted(i + 1));
+}
+
+static_assert(isMapSorted(0), "GLYPH_MAP must be sorted by codepoint for binary search");
+
+uint8_t UserGlyphs::lookup(uint32_t codepoint) {
+    size_t low = 0;
+    size_t high = GLYPH_MAP_SIZE;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (GLYPH_MAP[mid].codepoint < codepoint) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low < GLYPH_MAP_SIZE && GLYPH_MAP[low].codepoint == codepoint) {
+        return GLYPHS[GLYPH_MAP[low].glyph].code;
+    }
+    return 0;
+}
+
+bool UserGlyphs::isReservedCode(uint8_t code) {
+    for (size_t i = 0; i < GLYPH_COUNT; i++) {
+        if (GLYPHS[i].code == code) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void UserGlyphs::encodeDownload(EscPosEncoder& out) {
+    // ESC & wants column-major data: 3 bytes per column, top byte first,
+    // MSB = top dot
+    uint8_t columns[USER_GLYPH_WIDTH * 3];
+
+    for (size_t i = 0; i < GLYPH_COUNT; i++) {
+        const UserGlyph& glyph = GLYPHS[i];
+        memset(columns, 0, sizeof(columns));
+
+        for (uint8_t y = 0; y < USER_GLYPH_HEIGHT; y++) {
+            uint16_t row = glyph.rows[y];
+            for (uint8_t x = 0; x < USER_GLYPH_WIDTH; x++) {
+                if (row & (0x800 >> x)) {
+                    columns[x * 3 + y / 8] |= 0x80 >> (y % 8);
+                }
+            }
+        }
+
+        out.defineCharacter(glyph.code, USER_GLYPH_WIDTH, columns);
+    }
+}
+
+size_t UserGlyphs::count() {
+    return GLYPH_COUNT;
+}
@@ -30,10 +30,19 @@
 #include "OTAUpdateService.h"
 #include "HealthMonitor.h"
 #include "RequestQueue.h"
+#include "PrintSpooler.h"
+#include "PrintJournal.h"
+#include "ImageUploadStream.h"
+#include "TouchlessDispenser.h"
+#include "StatusDashboard.h"
 
 // Global service instances
 HardwareAbstraction* hardware;
+TouchlessDispenser* touchlessDispenser;
+StatusDashboard* dashboard = nullptr;
 PrinterService* printerService;
+PrintSpooler* printSpooler;
+PrintJournal* printJournal;
 FirebaseService* firebase;
 ReminderService* reminderService;
 OTAUpdateService* otaService;
@@ -51,6 +60,12 @@ String authToken = "";  // Simple session token
 unsigned long authTokenExpiry = 0;
 const unsigned long AUTH_TOKEN_DURATION = 3600000;  // 1 hour
 
+// Image upload currently being streamed to the spooler
+ImageUploadStream* imageUpload = nullptr;
+uint32_t imageUploadJobId = 0;
+int imageUploadStatusCode = 0;     // Set when the upload was rejected
+String imageUploadError = "";
+
 // Grocery list
 #define MAX_GROCERY_ITEMS 50
 String groceryItems[MAX_GROCERY_ITEMS];
@@ -65,8 +80,10 @@ void pollFirebaseCommands();
 void updateFirebaseStatus();
 void loadGroceries();
 void saveGroceries();
-void printGroceryList();
+uint32_t printGroceryList();
 void processRequestQueue();  // Process queued requests asynchronously
+void replayPrintJournal();   // Re-submit jobs left unfinished by a reboot
+DashboardData collectDashboardData();
 
 // Web server handlers
 void handleRoot();
@@ -75,6 +92,11 @@ void handleLogout();
 bool isAuthenticated();
 void handleGetStatus();
 void handleResetSanitizer();
+void handleGetSanitizer();
+void handleGetSensors();
+void handleGetLED();
+void handleSetSensors();
+void handleCalibrateSanitizer();
 void handleAddReminder();
 void handleGetReminders();
 void handleDeleteReminder();
@@ -86,6 +108,23 @@ void handleDeleteGrocery();
 void handleFavicon();
 void handleHealth();
 void handleQueueStatus();
+void handleGetPrintJobs();
+void handleCancelPrintJob();
+void handlePrintImage();
+void handlePrinterStats();
+void handlePrintJournal();
+void handleGetPrinterBaudRate();
+void handleSetPrinterBaudRate();
+void handlePrintQrCode();
+void handlePrintBarcode();
+void handleGetPrinterBenchmark();
+void handleRunPrinterBenchmark();
+void handleGetPrinterProfile();
+void handleGetDispenser();
+void handleSetDispenser();
+void handleSetPrinterProfile();
+void handleCalibratePrinter();
+void handlePrintImageUpload();
 void handleTestPage();
 void handleTestLED();
 void handleTestPump();
@@ -95,7 +134,11 @@ void handleSetAutomation();
 void handleTestPrinter();
 void handleTestSensors();
 void handleTestDisplay();
+void handleGetDashboard();
+void handleSetDashboard();
 void handleTestTouch();
+void handleGetTouch();
+void handleTouchCalibrate();
 
 // Time configuration
 const char* ntpServer = NTP_SERVER;
@@ -155,9 +198,29 @@ void setup() {
         Logger::warn("Main", "Continuing with limited hardware functionality");
     }
     
+    // Touchless dispensing runs off the IR sensor interrupt, independent of loop()
+    touchlessDispenser = new TouchlessDispenser(hardware);
+    if (!touchlessDispenser->begin()) {
+        Logger::error("Main", "Touchless dispenser failed to start - dispensing by command only");
+    }
+    
     // Initialize printer service
     printerService = new PrinterService(hardware);
-    Logger::info("Main", "Printer service initialized");
+    printerService->detectBaudRate();  // Saved rate, else probe - before the spooler starts printing
+    printerService->detectSymbolSupport();  // Native QR / barcode commands, asked once per boot
+    Logger::info("Main", "Printer service initialized at " + String(printerService->getBaudRate()) + " baud");
+    
+    // Start print spooler task - all printing goes through it from here on
+    printSpooler = new PrintSpooler(printerService);
+    if (!printSpooler->begin()) {
+        Logger::error("Main", "Print spooler failed to start - printing disabled");
+    }
+    
+    // Journal print jobs to flash; unfinished ones are replayed from loop()
+    printJournal = new PrintJournal();
+    if (printJournal->begin()) {
+        printSpooler->setJournal(printJournal);
+    }
     
     // Additional delay before WiFi setup for external power stability
     // WiFi radio needs stable power before initialization
@@ -198,6 +261,7 @@ void setup() {
     // Initialize health monitor
     healthMonitor = new HealthMonitor();
     healthMonitor->setCheckInterval(60000);
+    healthMonitor->setPrinter(printerService);
     Logger::info("Main", "Health monitor initialized");
     
     // Initialize request queue
@@ -214,6 +278,12 @@ void setup() {
     // Setup web server
     setupWebServer();
     
+    // Status dashboard replaces the boot test pattern
+    if (DASHBOARD_ENABLED && hardware->displayAvailable()) {
+        dashboard = new StatusDashboard(hardware);
+        dashboard->begin();
+    }
+    
     Logger::info("Main", "Setup complete!");
     Logger::info("Main", "Starting main loop...");
 }
@@ -261,7 +331,7 @@ void loop() {
     if (millis() - lastReminderCheck > 60000) {
         reminderService->checkReminders([](const Reminder& r) {
             Logger::info("Main", "⏰ Printing scheduled reminder: " + r.message);
-            printerService->printReceipt(r.message, false, r.createdTime);
+            printSpooler->submitReceipt(r.message, false, currentWeather, r.createdTime);
         });
         
         // Queue save after checking (in case any reminders were marked as printed or removed)
@@ -278,6 +348,13 @@ void loop() {
     // Process queued requests asynchronously (non-blocking)
     processRequestQueue();
     
+    // Offer journaled jobs from before a reboot to the spooler
+    static unsigned long lastJournalReplay = 0;
+    if (millis() - lastJournalReplay > PRINT_JOURNAL_REPLAY_MS) {
+        replayPrintJournal();
+        lastJournalReplay = millis();
+    }
+    
     // Poll Firebase commands periodically (every 30 seconds)
     static unsigned long lastCommandPoll = 0;
     const unsigned long COMMAND_POLL_INTERVAL = 30000;  // 30 seconds
@@ -326,6 +403,8 @@ void loop() {
         statusDoc["irSensor"] = hardware->isIRDetected();
         statusDoc["dispensing"] = hardware->isDispensing();
         statusDoc["sanitizerLevel"] = hardware->getSanitizerLevel();
+        statusDoc["sanitizerMl"] = (int)hardware->getSanitizer().getRemainingMl();
+        statusDoc["dispensesLeft"] = hardware->getSanitizer().getDispensesLeft(hardware->getDoseMs());
         statusDoc["moistureSensor"] = hardware->getMoisturePercent();
         statusDoc["lightSensor"] = hardware->getLightPercent();
         statusDoc["ledBrightness"] = hardware->getLEDBrightness();
@@ -340,12 +419,38 @@ void loop() {
         lastStatusUpdate = millis();
     }
     
+    // Touch events arrive on a queue from the touch task
+    TouchEvent touchEvent;
+    while (hardware->getTouch().receiveEvent(touchEvent)) {
+        if (touchEvent.type == TOUCH_CALIBRATION_DONE) {
+            if (dashboard) dashboard->pause(0);  // Back from the calibration targets
+        } else if (touchEvent.type == TOUCH_UP) {
+            Logger::debug("Main", "Tap at " + String(touchEvent.x) + "," + String(touchEvent.y));
+            // A tap ends a display test early
+            if (dashboard && dashboard->isPaused()) dashboard->pause(0);
+        }
+    }
+    
+    // Dashboard: only widgets whose values changed are drawn
+    static unsigned long lastDashboardUpdate = 0;
+    if (dashboard && millis() - lastDashboardUpdate > DASHBOARD_UPDATE_MS) {
+        dashboard->update(collectDashboardData());
+        lastDashboardUpdate = millis();
+    }
+    
+    // Auto-brightness: reads the filtered light level; a change fades in hardware
+    static unsigned long lastBrightnessUpdate = 0;
+    if (millis() - lastBrightnessUpdate > LED_AUTO_UPDATE_MS) {
+        hardware->updateLEDBrightness();
+        lastBrightnessUpdate = millis();
+    }
+    
     // Read sensors periodically (every 10 seconds)
     static unsigned long lastSensorCheck = 0;
     if (millis() - lastSensorCheck > SENSOR_CHECK_INTERVAL) {
         hardware->readMoistureSensor();
         hardware->readIRSensor();
-        hardware->updateLEDBrightness();  // Reads light sensor and updates LED brightness inversely
+        hardware->getSanitizer().persist();  // Flash write once SANITIZER_PERSIST_ML more is used
         lastSensorCheck = millis();
     }
     
@@ -413,6 +518,34 @@ void setupWiFi() {
     }
 }
 
+DashboardData collectDashboardData() {
+    DashboardData data;
+    SanitizerModel& sanitizer = hardware->getSanitizer();
+    data.sanitizerPercent = sanitizer.getPercent();
+    data.sanitizerMl = (uint32_t)sanitizer.getRemainingMl();
+    data.dispensesLeft = sanitizer.getDispensesLeft(hardware->getDoseMs());
+    data.moisturePercent = hardware->readMoistureSensor();  // Memory reads of the sampler
+    data.lightPercent = hardware->readLightSensor();
+    data.weather = currentWeather;
+    
+    // Earliest reminder still to print
+    data.nextReminderTime = 0;
+    for (int i = 0; i < reminderService->getReminderCount(); i++) {
+        const Reminder* reminder = reminderService->getReminder(i);
+        if (reminder && reminder->active && !reminder->printed &&
+            (data.nextReminderTime == 0 || reminder->scheduledTime < data.nextReminderTime)) {
+            data.nextReminderTime = reminder->scheduledTime;
+            data.nextReminder = reminder->message;
+        }
+    }
+    
+    data.printQueueDepth = printSpooler->getPendingCount();
+    data.wifiConnected = WiFi.status() == WL_CONNECTED;
+    data.wifiRssi = data.wifiConnected ? WiFi.RSSI() : 0;
+    data.ip = deviceIP;
+    return data;
+}
+
 void setupTime() {
     configTime(gmtOffset_sec, daylightOffset_sec, ntpServer);
     Logger::info("Time", "NTP time server configured");
@@ -442,7 +575,6 @@ void getWeatherData() {
             float temp = doc["main"]["temp"];
             String description = doc["weather"][0]["description"];
             currentWeather = String(temp, 1) + "°F, " + description;
-            printerService->setWeather(currentWeather);
             Logger::info("Weather", currentWeather);
         } else {
             Logger::warn("Weather", "Parsing error");
@@ -486,8 +618,8 @@ void pollFirebaseCommands() {
             
             // Process commands
             if (commandType == "dispense_start" || commandType == "water_start") {
-                // Queue pump start (non-blocking)
-                requestQueue->enqueue(REQUEST_DISPENSE_START);
+                // Queue pump start (non-blocking); data may carry the dose in ms
+                requestQueue->enqueue(REQUEST_DISPENSE_START, "", commandData);
             }
             else if (commandType == "dispense_stop" || commandType == "water_stop") {
                 // Queue pump stop (non-blocking)
@@ -499,12 +631,21 @@ void pollFirebaseCommands() {
             }
             else if (commandType == "print") {
                 Logger::info("Firebase", "🖨️ Queuing print command: " + commandData);
+                // Journal before the command is deleted so a reboot can't lose it
+                uint32_t journalId = printJournal->append(PRINT_JOURNAL_RECEIPT, commandData, true);
+                if (journalId == 0 && printJournal->isAvailable()) {
+                    Logger::warn("Firebase", "Print journal full, leaving command for the next poll");
+                    continue;
+                }
                 // Queue print operation (non-blocking)
-                requestQueue->enqueue(REQUEST_PRINT, "", commandData);
+                if (!requestQueue->enqueue(REQUEST_PRINT, "", commandData, journalId)) {
+                    printJournal->complete(journalId);
+                    continue;
+                }
             }
             else if (commandType == "test_print") {
                 Logger::info("Firebase", "🧪 Test print");
-                printerService->printTest();
+                printSpooler->submitTest();
             }
             else if (commandType == "gpio_status" || commandType == "status") {
                 hardware->printDiagnostics();
@@ -537,6 +678,8 @@ void updateFirebaseStatus() {
     doc["irSensor"] = hardware->isIRDetected();
     doc["dispensing"] = hardware->isDispensing();
     doc["sanitizerLevel"] = hardware->getSanitizerLevel();
+    doc["sanitizerMl"] = (int)hardware->getSanitizer().getRemainingMl();
+    doc["dispensesLeft"] = hardware->getSanitizer().getDispensesLeft(hardware->getDoseMs());
     doc["moistureSensor"] = hardware->getMoisturePercent();
     doc["weather"] = currentWeather;
     doc["ip"] = deviceIP;
@@ -613,14 +756,37 @@ void saveGroceries() {
     Logger::info("Groceries", "Queued save to Firebase (" + String(groceryCount) + " items)");
 }
 
-void printGroceryList() {
+uint32_t printGroceryList() {
     if (groceryCount == 0) {
         Logger::warn("Groceries", "List is empty");
-        return;
+        return 0;
     }
     
-    Logger::info("Groceries", "🛒 Printing list (" + String(groceryCount) + " items)");
-    printerService->printGroceryList(groceryItems, groceryCount);
+    Logger::info("Groceries", "🛒 Queuing list for print (" + String(groceryCount) + " items)");
+    return printSpooler->submitGroceryList(groceryItems, groceryCount);
+}
+
+void replayPrintJournal() {
+    int replayed = printJournal->replay([](const PrintJournalEntry& entry) {
+        if (entry.type == PRINT_JOURNAL_GROCERY_LIST) {
+            String items[PRINT_SPOOLER_MAX_LIST_ITEMS];
+            int itemCount = 0;
+            int start = 0;
+            while (start < (int)entry.text.length() && itemCount < PRINT_SPOOLER_MAX_LIST_ITEMS) {
+                int end = entry.text.indexOf('\n', start);
+                if (end < 0) end = entry.text.length();
+                items[itemCount++] = entry.text.substring(start, end);
+                start = end + 1;
+            }
+            return printSpooler->submitGroceryList(items, itemCount, entry.id) != 0;
+        }
+        return printSpooler->submitReceipt(entry.text, entry.includeWeatherAndSanitizer, currentWeather,
+                                           entry.createdTime, entry.id) != 0;
+    });
+    
+    if (replayed > 0) {
+        Logger::info("Journal", "♻️ Re-queued " + String(replayed) + " unfinished print job(s)");
+    }
 }
 
 bool isAuthenticated() {
@@ -687,7 +853,26 @@ void setupWebServer() {
     server.on("/api/status", HTTP_GET, handleGetStatus);
     server.on("/api/health", HTTP_GET, handleHealth);
     server.on("/api/queue", HTTP_GET, handleQueueStatus);
+    server.on("/api/print/jobs", HTTP_GET, handleGetPrintJobs);
+    server.on("/api/printer/stats", HTTP_GET, handlePrinterStats);
+    server.on("/api/print/journal", HTTP_GET, handlePrintJournal);
+    server.on("/api/printer/baudrate", HTTP_GET, handleGetPrinterBaudRate);
+    server.on("/api/printer/baudrate", HTTP_POST, handleSetPrinterBaudRate);
+    server.on("/api/print/qr", HTTP_POST, handlePrintQrCode);
+    server.on("/api/print/barcode", HTTP_POST, handlePrintBarcode);
+    server.on("/api/printer/benchmark", HTTP_GET, handleGetPrinterBenchmark);
+    server.on("/api/printer/benchmark", HTTP_POST, handleRunPrinterBenchmark);
+    server.on("/api/printer/profile", HTTP_GET, handleGetPrinterProfile);
+    server.on("/api/printer/profile", HTTP_POST, handleSetPrinterProfile);
+    server.on("/api/printer/calibrate", HTTP_POST, handleCalibratePrinter);
     server.on("/api/reset-sanitizer", HTTP_POST, handleResetSanitizer);
+    server.on("/api/sanitizer", HTTP_GET, handleGetSanitizer);
+    server.on("/api/sensors", HTTP_GET, handleGetSensors);
+    server.on("/api/sensors", HTTP_POST, handleSetSensors);
+    server.on("/api/led", HTTP_GET, handleGetLED);
+    server.on("/api/sanitizer/calibrate", HTTP_POST, handleCalibrateSanitizer);
+    server.on("/api/dispenser", HTTP_GET, handleGetDispenser);
+    server.on("/api/dispenser", HTTP_POST, handleSetDispenser);
     
     // Hardware test endpoints
     server.on("/test", HTTP_GET, handleTestPage);
@@ -699,7 +884,11 @@ void setupWebServer() {
     server.on("/api/test/printer", HTTP_POST, handleTestPrinter);
     server.on("/api/test/sensors", HTTP_GET, handleTestSensors);
     server.on("/api/test/display", HTTP_POST, handleTestDisplay);
+    server.on("/api/display/dashboard", HTTP_GET, handleGetDashboard);
+    server.on("/api/display/dashboard", HTTP_POST, handleSetDashboard);
     server.on("/api/test/touch", HTTP_GET, handleTestTouch);
+    server.on("/api/touch", HTTP_GET, handleGetTouch);
+    server.on("/api/touch/calibrate", HTTP_POST, handleTouchCalibrate);
     
     // Reminder endpoints
     server.on("/api/reminders", HTTP_GET, handleGetReminders);
@@ -710,6 +899,7 @@ void setupWebServer() {
     server.on("/api/groceries", HTTP_POST, handleAddGrocery);
     server.on("/api/groceries", HTTP_DELETE, handleClearGroceries);
     server.on("/api/groceries/print", HTTP_POST, handlePrintGroceries);
+    server.on("/api/image/print", HTTP_POST, handlePrintImage, handlePrintImageUpload);
     
     server.on("/favicon.ico", handleFavicon);
     
@@ -727,6 +917,10 @@ void setupWebServer() {
             handleDeleteGrocery();
             return;
         }
+        if (uri.startsWith("/api/print/jobs/") && method == HTTP_DELETE) {
+            handleCancelPrintJob();
+            return;
+        }
         
         // Handle static files
         if (uri == "/favicon.ico" || uri == "/robots.txt") {
@@ -768,6 +962,334 @@ void handleQueueStatus() {
     server.send(200, "application/json", response);
 }
 
+void handleGetPrintJobs() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    server.send(200, "application/json", printSpooler->getJobsJSON());
+}
+
+void handlePrinterStats() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    server.send(200, "application/json", printerService->getStatsJSON());
+}
+
+void handlePrintJournal() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    server.send(200, "application/json", printJournal->getStatsJSON());
+}
+
+void handleGetPrinterBaudRate() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    server.send(200, "application/json", printerService->getBaudJSON());
+}
+
+void handleSetPrinterBaudRate() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    uint32_t baud = server.arg("baud").toInt();
+    if (!PrinterService::isSupportedBaud(baud)) {
+        server.send(400, "application/json", "{\"success\":false,\"message\":\"Unsupported baud rate\"}");
+        return;
+    }
+    
+    // The switch and the reference receipt run on the spooler between jobs
+    bool save = server.arg("save") == "1";
+    uint32_t jobId = printSpooler->submitBaudTest(baud, save);
+    
+    DynamicJsonDocument response(256);
+    response["success"] = jobId != 0;
+    response["message"] = jobId != 0 ? "Baud change queued" : "Print queue is full";
+    response["jobId"] = jobId;
+    response["baud"] = baud;
+    
+    String responseStr;
+    serializeJson(response, responseStr);
+    server.send(jobId != 0 ? 202 : 503, "application/json", responseStr);
+}
+
+void handleGetPrinterBenchmark() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    server.send(200, "application/json", printerService->getBenchmarkJSON());
+}
+
+void handleRunPrinterBenchmark() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    // Runs on the spooler between jobs; read the results with GET
+    uint32_t jobId = printSpooler->submitBenchmark();
+    
+    DynamicJsonDocument response(256);
+    response["success"] = jobId != 0;
+    response["message"] = jobId != 0 ? "Benchmark queued" : "Print queue is full";
+    response["jobId"] = jobId;
+    
+    String responseStr;
+    serializeJson(response, responseStr);
+    server.send(jobId != 0 ? 202 : 503, "application/json", responseStr);
+}
+
+void handleGetSanitizer() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    server.send(200, "application/json", hardware->getSanitizer().getStatusJSON(hardware->getDoseMs()));
+}
+
+void handleCalibrateSanitizer() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    SanitizerModel& sanitizer = hardware->getSanitizer();
+    String error = "";
+    bool changed = false;
+    
+    if (server.hasArg("reservoirMl")) {
+        changed = true;
+        if (!sanitizer.setReservoirMl(server.arg("reservoirMl").toFloat())) error = "reservoirMl must be above 0 and at most 10000";
+    }
+    if (error.length() == 0 && server.hasArg("flowMlPerS")) {
+        changed = true;
+        if (!sanitizer.setFlowMlPerS(server.arg("flowMlPerS").toFloat())) error = "flowMlPerS must be above 0 and at most 100";
+    }
+    if (error.length() == 0 && server.hasArg("measuredMl")) {
+        // What the last dose put in a measuring cup, against its measured on-time
+        changed = true;
+        DoseStats stats = hardware->getDoseStats();
+        if (hardware->isDispensing() || stats.lastOnUs == 0) {
+            error = "Run one dose first and wait for it to finish";
+        } else if (!sanitizer.calibrateFlow(server.arg("measuredMl").toFloat(), stats.lastOnUs)) {
+            error = "measuredMl must be above 0";
+        }
+    }
+    if (error.length() == 0 && server.hasArg("percent")) {
+        changed = true;
+        hardware->setSanitizerLevel(server.arg("percent").toFloat());
+    }
+    
+    if (!changed) {
+        error = "Pass reservoirMl, flowMlPerS, measuredMl and/or percent";
+    }
+    if (error.length() > 0) {
+        DynamicJsonDocument response(192);
+        response["success"] = false;
+        response["message"] = error;
+        String responseStr;
+        serializeJson(response, responseStr);
+        server.send(400, "application/json", responseStr);
+        return;
+    }
+    server.send(200, "application/json", sanitizer.getStatusJSON(hardware->getDoseMs()));
+}
+
+void handleGetSensors() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    server.send(200, "application/json", hardware->getSensorSampler().getStatusJSON());
+}
+
+void handleSetSensors() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    if (!server.hasArg("rateHz") || !hardware->getSensorSampler().setRateHz(server.arg("rateHz").toInt())) {
+        server.send(400, "application/json", "{\"success\":false,\"message\":\"rateHz must be 1-" +
+                                             String(SENSOR_SAMPLE_RATE_MAX_HZ) + "\"}");
+        return;
+    }
+    server.send(200, "application/json", hardware->getSensorSampler().getStatusJSON());
+}
+
+void handleGetLED() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    server.send(200, "application/json", hardware->getLedDimmer().getStatusJSON());
+}
+
+void handleGetDispenser() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    server.send(200, "application/json", touchlessDispenser->getStatusJSON());
+}
+
+void handleSetDispenser() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    String enabled = server.arg("enabled");
+    if ((server.hasArg("enabled") && enabled != "0" && enabled != "1") ||
+        (!server.hasArg("enabled") && !server.hasArg("doseMs"))) {
+        server.send(400, "application/json", "{\"success\":false,\"message\":\"Pass enabled=0|1 and/or doseMs\"}");
+        return;
+    }
+    if (server.hasArg("doseMs") && !hardware->setDoseMs(server.arg("doseMs").toInt())) {
+        server.send(400, "application/json", "{\"success\":false,\"message\":\"doseMs must be " +
+                                             String(DISPENSE_MIN_DOSE_MS) + "-" + String(MAX_DISPENSE_DURATION_MS) + "\"}");
+        return;
+    }
+    if (server.hasArg("enabled")) {
+        touchlessDispenser->setEnabled(enabled == "1");
+    }
+    server.send(200, "application/json", touchlessDispenser->getStatusJSON());
+}
+
+void handleGetPrinterProfile() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    server.send(200, "application/json", printerService->getProfileJSON());
+}
+
+void handleSetPrinterProfile() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    PrintProfileId profile = PrintProfiles::parse(server.arg("name"));
+    if (profile == PRINT_PROFILE_DEFAULT || !printerService->setDefaultProfile(profile)) {
+        server.send(400, "application/json", "{\"success\":false,\"message\":\"Unknown or uncalibrated profile\"}");
+        return;
+    }
+    server.send(200, "application/json", printerService->getProfileJSON());
+}
+
+void handleCalibratePrinter() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    // ?step=N picks a step from the printed strip and makes it the default
+    if (server.hasArg("step")) {
+        long step = server.arg("step").toInt();
+        if (step < 1 || step > PrinterService::getCalibrationStepCount() ||
+            !printerService->selectCalibrationStep((uint8_t)step)) {
+            server.send(400, "application/json", "{\"success\":false,\"message\":\"Step must be 1-" +
+                                                 String(PrinterService::getCalibrationStepCount()) + "\"}");
+            return;
+        }
+        server.send(200, "application/json", printerService->getProfileJSON());
+        return;
+    }
+    
+    uint32_t jobId = printSpooler->submitCalibration();
+    
+    DynamicJsonDocument response(256);
+    response["success"] = jobId != 0;
+    response["message"] = jobId != 0 ? "Calibration strip queued" : "Print queue is full";
+    response["jobId"] = jobId;
+    response["steps"] = PrinterService::getCalibrationStepCount();
+    
+    String responseStr;
+    serializeJson(response, responseStr);
+    server.send(jobId != 0 ? 202 : 503, "application/json", responseStr);
+}
+
+void handlePrintQrCode() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    String data = server.arg("data");
+    if (data.length() == 0 || data.length() > PrinterService::maxQrLength()) {
+        server.send(400, "application/json", "{\"success\":false,\"message\":\"QR data must be 1-" +
+                                             String(PrinterService::maxQrLength()) + " bytes\"}");
+        return;
+    }
+    
+    uint32_t jobId = printSpooler->submitQrCode(data, server.arg("caption"));
+    
+    DynamicJsonDocument response(256);
+    response["success"] = jobId != 0;
+    response["message"] = jobId != 0 ? "QR code queued" : "Print queue is full";
+    response["jobId"] = jobId;
+    
+    String responseStr;
+    serializeJson(response, responseStr);
+    server.send(jobId != 0 ? 202 : 503, "application/json", responseStr);
+}
+
+void handlePrintBarcode() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    String data = server.arg("data");
+    if (!BarcodeEncoder::isEncodable(data.c_str(), data.length())) {
+        server.send(400, "application/json", "{\"success\":false,\"message\":\"Barcode data must be 1-" +
+                                             String(BARCODE_MAX_LENGTH) + " printable ASCII characters\"}");
+        return;
+    }
+    
+    uint32_t jobId = printSpooler->submitBarcode(data);
+    
+    DynamicJsonDocument response(256);
+    response["success"] = jobId != 0;
+    response["message"] = jobId != 0 ? "Barcode queued" : "Print queue is full";
+    response["jobId"] = jobId;
+    
+    String responseStr;
+    serializeJson(response, responseStr);
+    server.send(jobId != 0 ? 202 : 503, "application/json", responseStr);
+}
+
+void handleCancelPrintJob() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    String uri = server.uri();
+    int lastSlash = uri.lastIndexOf('/');
+    uint32_t id = (uint32_t)uri.substring(lastSlash + 1).toInt();
+    
+    bool cancelled = printSpooler->cancel(id);
+    
+    DynamicJsonDocument responseDoc(128);
+    responseDoc["success"] = cancelled;
+    responseDoc["id"] = id;
+    responseDoc["status"] = PrintSpooler::statusToString(printSpooler->getStatus(id));
+    
+    String response;
+    serializeJson(responseDoc, response);
+    server.send(cancelled ? 200 : 409, "application/json", response);
+}
+
 void handleGetStatus() {
     if (!isAuthenticated()) {
         server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
@@ -778,6 +1300,8 @@ void handleGetStatus() {
     DynamicJsonDocument doc(256);
     doc["moisture"] = String(hardware->getMoisturePercent(), 1);
     doc["sanitizer"] = String(hardware->getSanitizerLevel(), 1);
+    doc["sanitizerMl"] = String(hardware->getSanitizer().getRemainingMl(), 0);
+    doc["dispensesLeft"] = hardware->getSanitizer().getDispensesLeft(hardware->getDoseMs());
     
     String response;
     serializeJson(doc, response);
@@ -1049,14 +1573,127 @@ void handlePrintGroceries() {
         return;
     }
     
-    printGroceryList();
+    uint32_t jobId = printGroceryList();
     
     DynamicJsonDocument doc(128);
-    doc["success"] = true;
-    doc["message"] = "Printing grocery list";
+    doc["success"] = jobId != 0;
+    doc["message"] = jobId != 0 ? "Grocery list queued for printing" : "Print queue is full";
+    doc["jobId"] = jobId;
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
+}
+
+void rejectImageUpload(int statusCode, const String& message) {
+    imageUploadStatusCode = statusCode;
+    imageUploadError = message;
+    Logger::warn("WebServer", "Image upload rejected: " + message);
+}
+
+void handlePrintImageUpload() {
+    HTTPUpload& upload = server.upload();
+    
+    if (upload.status == UPLOAD_FILE_START) {
+        imageUploadJobId = 0;
+        imageUploadStatusCode = 0;
+        imageUploadError = "";
+        
+        if (!isAuthenticated()) {
+            rejectImageUpload(401, "Unauthorized");
+            return;
+        }
+        
+        // Format from ?format=, otherwise from the file extension
+        String format = server.arg("format");
+        String filename = upload.filename;
+        filename.toLowerCase();
+        if (format.length() == 0) {
+            format = filename.endsWith(".pgm") ? "pgm" : filename.endsWith(".png") ? "png" : "raw";
+        }
+        
+        ImageFormat imageFormat;
+        uint16_t width = 0;
+        uint16_t height = 0;
+        if (format == "pgm") {
+            imageFormat = IMAGE_FORMAT_PGM;
+        } else if (format == "raw") {
+            imageFormat = IMAGE_FORMAT_RAW_GRAY;
+            width = server.arg("width").toInt();
+            height = server.arg("height").toInt();
+            if (width == 0 || height == 0) {
+                rejectImageUpload(400, "Raw grayscale uploads need width and height");
+                return;
+            }
+        } else {
+            rejectImageUpload(415, "Unsupported format - upload binary PGM (P5) or raw 8-bit grayscale");
+            return;
+        }
+        
+        imageUpload = new ImageUploadStream(imageFormat, width, height, ImageDitherer::parseMode(server.arg("dither")));
+        if (!imageUpload->isValid()) {
+            imageUpload->close();
+            imageUpload->finish(true);
+            imageUpload = nullptr;
+            rejectImageUpload(500, "Out of memory");
+            return;
+        }
+        
+        // Uploads block at printer speed - keep the pump timeout serviced meanwhile
+        imageUpload->setWaitCallback([]() {
+            hardware->checkDispenseTimeout();
+        });
+        
+        imageUploadJobId = printSpooler->submitImage(imageUpload, PrintProfiles::parse(server.arg("profile")));
+        if (imageUploadJobId == 0) {
+            imageUpload->finish(true);
+            imageUpload = nullptr;
+            rejectImageUpload(503, "Print queue is full");
+            return;
+        }
+        Logger::info("WebServer", "Streaming image upload to print job #" + String(imageUploadJobId));
+    } else if (upload.status == UPLOAD_FILE_WRITE) {
+        if (imageUpload && !imageUpload->write(upload.buf, upload.currentSize)) {
+            // Printer side finished or gave up; discard the rest of the body
+            imageUpload->finish(true);
+            imageUpload = nullptr;
+        }
+    } else if (upload.status == UPLOAD_FILE_END || upload.status == UPLOAD_FILE_ABORTED) {
+        if (imageUpload) {
+            imageUpload->finish(upload.status == UPLOAD_FILE_ABORTED);
+            imageUpload = nullptr;
+        }
+    }
+}
+
+void handlePrintImage() {
+    if (imageUploadStatusCode != 0) {
+        DynamicJsonDocument doc(256);
+        doc["success"] = false;
+        doc["message"] = imageUploadError;
+        String response;
+        serializeJson(doc, response);
+        server.send(imageUploadStatusCode, "application/json", response);
+        return;
+    }
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    if (imageUploadJobId == 0) {
+        server.send(400, "application/json", "{\"success\":false,\"message\":\"No image uploaded\"}");
+        return;
+    }
+    
+    PrintJobStatus status = printSpooler->getStatus(imageUploadJobId);
+    
+    DynamicJsonDocument doc(192);
+    doc["success"] = status != PRINT_JOB_FAILED && status != PRINT_JOB_CANCELLED;
+    doc["jobId"] = imageUploadJobId;
+    doc["status"] = PrintSpooler::statusToString(status);
     String response;
     serializeJson(doc, response);
     server.send(200, "application/json", response);
+    imageUploadJobId = 0;
 }
 
 void handleFavicon() {
@@ -2053,19 +2690,32 @@ void processRequestQueue() {
             break;
         }
         case REQUEST_PRINT: {
-            Logger::info("Queue", "🖨️ Printing queued message: " + request.data.substring(0, 30) + "...");
+            Logger::info("Queue", "🖨️ Spooling queued message: " + request.data.substring(0, 30) + "...");
             if (currentWeather == "N/A") {
                 getWeatherData();
-                delay(500);  // Wait for weather
             }
-            success = printerService->printReceipt(request.data, true);
+            // Hand off to the spooler task; a full spool is retried like any failed request
+            uint32_t jobId = printSpooler->submitReceipt(request.data, true, currentWeather, 0, request.journalId);
+            success = jobId != 0;
             if (success) {
-                Logger::info("Queue", "✅ Print completed successfully");
+                Logger::info("Queue", "✅ Print job #" + String(jobId) + " queued");
+            }
+            
+            // Hand over prints queued right behind this one now rather than one
+            // per queue interval, so the spooler can coalesce them into one job
+            QueuedRequest next;
+            while (success && requestQueue->peek(next) && next.type == REQUEST_PRINT) {
+                jobId = printSpooler->submitReceipt(next.data, true, currentWeather, 0, next.journalId);
+                if (jobId == 0) {
+                    break;  // Spool full - leave it queued for the next interval
+                }
+                requestQueue->dequeue(next);
+                Logger::info("Queue", "✅ Print job #" + String(jobId) + " queued");
             }
             break;
         }
         case REQUEST_DISPENSE_START: {
-            success = hardware->startPump();
+            success = hardware->startPump(request.data.toInt());  // No number = default dose
             break;
         }
         case REQUEST_DISPENSE_STOP: {
@@ -2086,9 +2736,11 @@ void processRequestQueue() {
         if (request.retryCount < 3) {
             request.retryCount++;
             Logger::debug("Queue", "Re-queuing request for retry");
-            requestQueue->enqueue(request.type, request.path, request.data);
+            requestQueue->enqueue(request.type, request.path, request.data, request.journalId);
         } else {
             Logger::error("Queue", "❌ Request failed after max retries, dropping");
+            // Still journaled - the replay will offer it to the spooler again
+            printJournal->release(request.journalId);
         }
     }
     
@@ -2242,8 +2894,28 @@ void handleTestPage() {
         </div>
         
         <div class="test-section">
-            <h2>🖨️ Printer Test (9600 baud)</h2>
+            <h2>🖨️ Printer Test</h2>
             <button onclick="testPrinter()">Print Test Page</button>
+            <div style="display: grid; grid-template-columns: 1fr 1fr; gap: 10px; margin-top: 10px;">
+                <button onclick="testBaudRate(9600)">9600 baud</button>
+                <button onclick="testBaudRate(19200)">19200 baud</button>
+                <button onclick="testBaudRate(38400)">38400 baud</button>
+                <button onclick="testBaudRate(115200)">115200 baud</button>
+            </div>
+            <div style="display: grid; grid-template-columns: 1fr 1fr; gap: 10px; margin-top: 10px;">
+                <button onclick="testQrCode()">QR Code (Web UI Link)</button>
+                <button onclick="testBarcode()">Barcode</button>
+            </div>
+            <div style="display: grid; grid-template-columns: 1fr 1fr 1fr; gap: 10px; margin-top: 10px;">
+                <button onclick="testPrinter('fast')">Test: Fast</button>
+                <button onclick="testPrinter('balanced')">Test: Balanced</button>
+                <button onclick="testPrinter('dark')">Test: Dark</button>
+            </div>
+            <div style="display: grid; grid-template-columns: 1fr 1fr 1fr; gap: 10px; margin-top: 10px;">
+                <button onclick="printSymbol('/api/printer/calibrate', '')">Calibration Strip</button>
+                <input type="number" id="calibration-step" min="1" value="1" placeholder="Step">
+                <button onclick="useCalibrationStep()">Use Step</button>
+            </div>
             <div id="printer-status"></div>
         </div>
         
@@ -2274,16 +2946,21 @@ void handleTestPage() {
                 <button onclick="testDisplayDebug()" style="width: 28%;">Show Debug</button>
             </div>
             <div id="display-status"></div>
+            <button onclick="getDashboardStats()" style="margin-top: 10px;">Dashboard Stats</button>
+            <button onclick="setDashboardDma(1)">Widgets by DMA</button>
+            <button onclick="setDashboardDma(0)">Widgets by CPU</button>
+            <div id="dashboard-stats"></div>
         </div>
         
         <div class="test-section">
             <h2>👆 Touch Screen Test</h2>
-            <p style="color: #666; margin-bottom: 10px;">Test touch screen functionality (GPIO 25, 26)</p>
+            <p style="color: #666; margin-bottom: 10px;">Test touch screen functionality (CS GPIO 25, IRQ GPIO 4)</p>
             <button onclick="testTouch()">Check Touch</button>
+            <button onclick="calibrateTouch()">Calibrate Touch</button>
             <div style="margin-top: 10px;">
                 <label style="display: flex; align-items: center; margin-bottom: 10px;">
                     <input type="checkbox" id="live-touch-toggle" onchange="toggleLiveTouch(this.checked)" style="margin-right: 10px; width: 20px; height: 20px;">
-                    <span style="font-size: 16px;">Live Touch Monitoring</span>
+                    <span style="font-size: 16px;">Live Touch Events</span>
                 </label>
             </div>
             <div id="touch-status"></div>
@@ -2382,11 +3059,11 @@ void handleTestPage() {
             });
         }
         
-        function testPrinter() {
+        function testPrinter(profile) {
             const statusDiv = document.getElementById('printer-status');
             statusDiv.innerHTML = '<div class="status info">Sending test print...</div>';
             
-            fetch(addAuthToken('/api/test/printer'), {
+            fetch(addAuthToken('/api/test/printer' + (profile ? '?profile=' + profile : '')), {
                 method: 'POST',
                 headers: {'Content-Type': 'application/json'}
             })
@@ -2403,24 +3080,70 @@ void handleTestPage() {
             });
         }
         
-        function testBaudRate(baud) {
+        function testBaudRate(baud, save) {
             const statusDiv = document.getElementById('printer-status');
             statusDiv.innerHTML = '<div class="status info">🔧 Changing to ' + baud + ' baud and printing test...<br>Check your printer output!</div>';
             
-            fetch(addAuthToken('/api/printer/baudrate?baud=' + baud), {
+            fetch(addAuthToken('/api/printer/baudrate?baud=' + baud + (save ? '&save=1' : '')), {
                 method: 'POST',
                 headers: {'Content-Type': 'application/json'}
             })
             .then(r => r.json())
+            .then(data => {
+                if (!data.success) {
+                    statusDiv.innerHTML = '<div class="status error">❌ Error: ' + (data.message || 'Failed') + '</div>';
+                    return;
+                }
+                // The change runs on the print spooler; read the outcome back
+                setTimeout(() => showBaudResult(baud), 4000);
+            })
+            .catch(err => {
+                statusDiv.innerHTML = '<div class="status error">❌ Error: ' + err.message + '</div>';
+            });
+        }
+        
+        function testQrCode() {
+            const url = window.location.origin + '/';
+            printSymbol('/api/print/qr', 'data=' + encodeURIComponent(url) + '&caption=' + encodeURIComponent(url));
+        }
+        
+        function testBarcode() {
+            printSymbol('/api/print/barcode', 'data=PRINT-N-PRICK');
+        }
+        
+        function printSymbol(path, body) {
+            const statusDiv = document.getElementById('printer-status');
+            fetch(addAuthToken(path), {
+                method: 'POST',
+                headers: {'Content-Type': 'application/x-www-form-urlencoded'},
+                body: body
+            })
+            .then(r => r.json())
             .then(data => {
                 if (data.success) {
-                    statusDiv.innerHTML = '<div class="status success">✅ Test printed at ' + baud + ' baud!<br><br>' +
-                        '<strong>Check your printer:</strong><br>' +
-                        'If you see clean readable text like "TEST 1234567890 ABC...", you found it!<br><br>' +
-                        '<strong>To make it permanent:</strong><br>' +
-                        'Edit config.h line 22:<br>' +
-                        '<code style="background: #333; color: #0f0; padding: 2px 6px; border-radius: 4px;">#define THERMAL_PRINTER_BAUD ' + baud + '</code><br>' +
-                        'Then recompile and upload.</div>';
+                    statusDiv.innerHTML = '<div class="status success">✅ ' + data.message + ' (job ' + data.jobId + ')</div>';
+                } else {
+                    statusDiv.innerHTML = '<div class="status error">❌ Error: ' + (data.message || 'Failed') + '</div>';
+                }
+            })
+            .catch(err => {
+                statusDiv.innerHTML = '<div class="status error">❌ Error: ' + err.message + '</div>';
+            });
+        }
+        
+        function useCalibrationStep() {
+            const statusDiv = document.getElementById('printer-status');
+            const step = document.getElementById('calibration-step').value;
+            fetch(addAuthToken('/api/printer/calibrate?step=' + step), {
+                method: 'POST',
+                headers: {'Content-Type': 'application/json'}
+            })
+            .then(r => r.json())
+            .then(data => {
+                if (data.default === 'calibrated') {
+                    const calibrated = data.profiles.find(p => p.name === 'calibrated');
+                    statusDiv.innerHTML = '<div class="status success">✅ Step ' + step + ' saved as the default (' +
+                        calibrated.heatingTimeUs + 'us heating)</div>';
                 } else {
                     statusDiv.innerHTML = '<div class="status error">❌ Error: ' + (data.message || 'Failed') + '</div>';
                 }
@@ -2430,6 +3153,33 @@ void handleTestPage() {
             });
         }
         
+        function showBaudResult(baud) {
+            const statusDiv = document.getElementById('printer-status');
+            fetch(addAuthToken('/api/printer/baudrate'))
+            .then(r => r.json())
+            .then(data => {
+                let rates = '';
+                data.rates.forEach(rate => {
+                    if (rate.bytesPerSecond) {
+                        rates += rate.baud + ' baud: ' + rate.bytesPerSecond + ' B/s (wire limit ' + rate.wireBytesPerSecond + ')<br>';
+                    }
+                });
+                if (data.baud !== baud) {
+                    statusDiv.innerHTML = '<div class="status error">❌ Printer did not answer at ' + baud + ' baud, still at ' + data.baud + '</div>';
+                } else if (data.lastChange && data.lastChange.saved) {
+                    statusDiv.innerHTML = '<div class="status success">✅ Printing at ' + baud + ' baud' +
+                        (data.lastChange.verified ? ' (confirmed by the printer)' : '') + ', saved for next boot.<br><br>' + rates + '</div>';
+                } else {
+                    statusDiv.innerHTML = '<div class="status success">✅ Test printed at ' + baud + ' baud.<br><br>' +
+                        '<strong>Check your printer:</strong> if the text is clean and readable, keep this rate.<br>' +
+                        '<button onclick="testBaudRate(' + baud + ', true)">Keep ' + baud + ' baud</button><br><br>' + rates + '</div>';
+                }
+            })
+            .catch(err => {
+                statusDiv.innerHTML = '<div class="status error">❌ Error: ' + err.message + '</div>';
+            });
+        }
+        
         
         function toggleAutoBrightness(enabled) {
             const statusDiv = document.getElementById('auto-brightness-status');
@@ -2476,6 +3226,8 @@ void handleTestPage() {
         
         let liveMonitoringInterval = null;
         let liveTouchInterval = null;
+        let touchSequence = 0;
+        let touchEventLog = [];
         
         function testSensors() {
             const statusDiv = document.getElementById('sensor-status');
@@ -2555,6 +3307,58 @@ void handleTestPage() {
             });
         }
         
+        function getDashboardStats() {
+            const statsDiv = document.getElementById('dashboard-stats');
+            fetch(addAuthToken('/api/display/dashboard'))
+            .then(r => r.json())
+            .then(data => {
+                if (!data.enabled) {
+                    statsDiv.innerHTML = '<div class="status error">Dashboard not running (no display)</div>';
+                    return;
+                }
+                showDashboardStats(data);
+            })
+            .catch(err => {
+                statsDiv.innerHTML = '<div class="status error">❌ Error: ' + err.message + '</div>';
+            });
+        }
+        
+        function setDashboardDma(on) {
+            const statsDiv = document.getElementById('dashboard-stats');
+            fetch(addAuthToken('/api/display/dashboard?dma=' + on), {method: 'POST'})
+            .then(r => r.json())
+            .then(data => {
+                if (data.success === false) {
+                    statsDiv.innerHTML = '<div class="status error">❌ ' + data.message + '</div>';
+                    return;
+                }
+                showDashboardStats(data);
+            })
+            .catch(err => {
+                statsDiv.innerHTML = '<div class="status error">❌ Error: ' + err.message + '</div>';
+            });
+        }
+        
+        function showDashboardStats(data) {
+            const statsDiv = document.getElementById('dashboard-stats');
+            const last = data.lastUpdate;
+            const path = p => p.updates + ' updates, mean ' + (p.meanUs / 1000).toFixed(1) + 'ms / ' +
+                (p.meanBytes / 1024).toFixed(1) + 'KB, max ' + (p.maxUs / 1000).toFixed(1) + 'ms, ' + p.kbPerSec + 'KB/s';
+            statsDiv.innerHTML = '<div class="status info">' +
+                '<strong>Writes:</strong> ' + data.path.toUpperCase() + ' (heap ' + (data.heapCost / 1024).toFixed(1) + 'KB' +
+                (data.dma.available ? ', DMA ' + data.dma.buffers + ' x ' + data.dma.bufferBytes + ' bytes' : ', no DMA') + ')<br>' +
+                '<strong>Widget pushes, CPU:</strong> ' + path(data.paths.cpu) + '<br>' +
+                '<strong>Widget pushes, DMA:</strong> ' + path(data.paths.dma) + '<br>' +
+                '<strong>Loop time:</strong> ' + data.loopUs + 'us (max ' + data.maxLoopUs + 'us)<br>' +
+                '<strong>Last update:</strong> ' + last.widgets + ' widget(s) by ' + last.path.toUpperCase() + ', ' +
+                (last.frameUs / 1000).toFixed(1) + 'ms, ' + (last.bytes / 1024).toFixed(1) + 'KB<br>' +
+                '<strong>Mean:</strong> ' + (data.meanBytes / 1024).toFixed(1) + 'KB per update (full frame ' +
+                (data.fullFrameBytes / 1024).toFixed(0) + 'KB), max ' + (data.maxFrameUs / 1000).toFixed(1) + 'ms<br>' +
+                '<strong>Updates:</strong> ' + data.updates + ' drawn, ' + data.unchanged + ' unchanged, ' +
+                data.fullRedraws + ' full redraws' + (data.paused ? ' (paused for a display test)' : '') +
+                '</div>';
+        }
+        
         function testDisplayDebug() {
             const text = document.getElementById('debug-text-input').value || 'Debug Test';
             const statusDiv = document.getElementById('display-status');
@@ -2608,27 +3412,55 @@ void handleTestPage() {
                 '<div style="margin-top: 15px;">' +
                 '<div><strong>Touch Pressed:</strong> <span class="sensor-value">' + (data.pressed ? 'YES' : 'NO') + '</span></div>' +
                 '<div style="margin-top: 10px;"><strong>IRQ Pin State:</strong> <span class="sensor-value">' + data.irqState + '</span></div>' +
-                '<div style="margin-top: 5px; font-size: 14px; color: #666;">GPIO 26 (0=LOW=touch, 1=HIGH=no touch)</div>' +
+                '<div style="margin-top: 5px; font-size: 14px; color: #666;">GPIO 4 (0=LOW=touch, 1=HIGH=no touch)</div>' +
                 (data.hasTouch ? '<div style="margin-top: 10px;"><strong>Touch Coordinates:</strong> <span class="sensor-value">X: ' + data.x + ', Y: ' + data.y + '</span></div>' : '') +
                 '</div>';
         }
         
+        function calibrateTouch() {
+            const statusDiv = document.getElementById('touch-status');
+            fetch(addAuthToken('/api/touch/calibrate'), {method: 'POST'})
+            .then(r => r.json())
+            .then(data => {
+                statusDiv.innerHTML = '<div class="status ' + (data.success ? 'info' : 'error') + '">' + data.message + '</div>';
+            })
+            .catch(err => {
+                statusDiv.innerHTML = '<div class="status error">❌ Error: ' + err.message + '</div>';
+            });
+        }
+        
+        function updateTouchEvents(data, valuesDiv) {
+            // Newest first; events come from the device's queue history, so none are missed between fetches
+            data.events.forEach(e => {
+                touchEventLog.unshift('#' + e.sequence + ' ' + e.type + (e.x !== undefined ? ' at ' + e.x + ',' + e.y : ''));
+            });
+            touchEventLog.length = Math.min(touchEventLog.length, 10);
+            valuesDiv.innerHTML =
+                '<div style="margin-top: 15px;">' +
+                '<div><strong>Calibration:</strong> <span class="sensor-value">' + data.calibration +
+                (data.calibrationStep ? ' (target ' + data.calibrationStep + '/3)' : '') + '</span></div>' +
+                '<div style="margin-top: 5px;"><strong>Pressed:</strong> ' + (data.pressed ? 'YES at ' + data.last.x + ', ' + data.last.y : 'NO') + '</div>' +
+                '<div style="margin-top: 5px; font-size: 14px; color: #666;">Reading: ' + data.lastBurstUs + 'us bus time (max ' +
+                data.maxBurstUs + 'us), ' + data.busSkips + ' skipped for display updates</div>' +
+                '<div style="margin-top: 10px; font-family: monospace;">' + (touchEventLog.join('<br>') || 'No events yet') + '</div>' +
+                '</div>';
+        }
+        
         function toggleLiveTouch(enabled) {
             if (enabled) {
                 const valuesDiv = document.getElementById('touch-values');
-                valuesDiv.innerHTML = '<div class="status info">Starting live touch monitoring...</div>';
+                valuesDiv.innerHTML = '<div class="status info">Waiting for touch events...</div>';
                 liveTouchInterval = setInterval(() => {
-                    fetch(addAuthToken('/api/test/touch'))
+                    fetch(addAuthToken('/api/touch?since=' + touchSequence))
                     .then(r => r.json())
                     .then(data => {
-                        if (data.success) {
-                            updateTouchDisplay(data, valuesDiv);
-                        }
+                        touchSequence = data.sequence;
+                        updateTouchEvents(data, valuesDiv);
                     })
                     .catch(err => {
-                        console.error('Live touch monitoring error:', err);
+                        console.error('Live touch events error:', err);
                     });
-                }, 200);  // Update every 200ms for touch
+                }, 250);
             } else {
                 if (liveTouchInterval) {
                     clearInterval(liveTouchInterval);
@@ -2740,8 +3572,8 @@ void handleTestPump() {
     Logger::info("WebServer", "🧪 Pump test request: " + String(state ? "ON" : "OFF"));
     
     if (state) {
-        // Turn pump ON
-        bool started = hardware->startPump();
+        // Turn pump ON for one dose (optional "doseMs", else the default)
+        bool started = hardware->startPump(doc["doseMs"] | 0);
         if (!started) {
             // Check if it's a cooldown issue
             String reason = "Pump could not start";
@@ -2832,13 +3664,16 @@ void handleTestPrinter() {
         return;
     }
     
-    Logger::info("WebServer", "🧪 Printer test: Sending test print");
+    Logger::info("WebServer", "🧪 Printer test: Queuing test print");
     
-    bool success = printerService->printTest();
+    // Optional ?profile=fast|balanced|dark|calibrated for this print only
+    uint32_t jobId = printSpooler->submitTest(PrintProfiles::parse(server.arg("profile")));
+    bool success = jobId != 0;
     
     DynamicJsonDocument response(128);
     response["success"] = success;
-    response["message"] = success ? "Test print sent" : "Printer test failed";
+    response["message"] = success ? "Test print queued" : "Print queue is full";
+    response["jobId"] = jobId;
     
     String responseStr;
     serializeJson(response, responseStr);
@@ -2853,7 +3688,7 @@ void handleTestSensors() {
     
     Logger::info("WebServer", "🧪 Sensor test: Reading sensors");
     
-    // Read sensors
+    // Latest filtered values from the sensor task - no conversions here
     float moisture = hardware->readMoistureSensor();
     bool irDetected = hardware->readIRSensor();
     float light = hardware->readLightSensor();
@@ -2861,7 +3696,7 @@ void handleTestSensors() {
     
     // Read raw IR sensor pin value for debugging
     int rawIRValue = digitalRead(IR_SENSOR_PIN);
-    int rawLightValue = analogRead(LIGHT_SENSOR_PIN);
+    int rawLightValue = hardware->getSensorSampler().getRaw(SENSOR_LIGHT);
     
     DynamicJsonDocument response(512);
     response["success"] = true;
@@ -2909,6 +3744,13 @@ void handleTestDisplay() {
         return;
     }
     
+    // Keep the dashboard off the screen long enough to see the test
+    if (dashboard) {
+        dashboard->pause(DASHBOARD_TEST_HOLD_MS);
+    }
+    
+    // Waits out a dashboard redraw in progress on the display task
+    hardware->lockDisplay();
     if (testType == "clear") {
         uint16_t color = 0x0000;  // Black
         if (doc.containsKey("color")) {
@@ -2940,6 +3782,7 @@ void handleTestDisplay() {
         success = false;
         message = "Unknown test type: " + testType;
     }
+    hardware->unlockDisplay();
     
     DynamicJsonDocument response(256);
     response["success"] = success;
@@ -2951,6 +3794,39 @@ void handleTestDisplay() {
     server.send(200, "application/json", responseStr);
 }
 
+void handleGetDashboard() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    if (!dashboard) {
+        server.send(200, "application/json", "{\"enabled\":false}");
+        return;
+    }
+    server.send(200, "application/json", dashboard->getStatusJSON());
+}
+
+void handleSetDashboard() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    if (!dashboard) {
+        server.send(400, "application/json", "{\"success\":false,\"message\":\"Dashboard not running\"}");
+        return;
+    }
+    
+    if (!server.hasArg("dma")) {
+        server.send(400, "application/json", "{\"success\":false,\"message\":\"dma must be 0 or 1\"}");
+        return;
+    }
+    if (!dashboard->setDmaEnabled(server.arg("dma") == "1" || server.arg("dma") == "true")) {
+        server.send(400, "application/json", "{\"success\":false,\"message\":\"Display DMA not available\"}");
+        return;
+    }
+    server.send(200, "application/json", dashboard->getStatusJSON());
+}
+
 void handleTestTouch() {
     if (!isAuthenticated()) {
         server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
@@ -2980,3 +3856,38 @@ void handleTestTouch() {
     serializeJson(response, responseStr);
     server.send(200, "application/json", responseStr);
 }
+
+void handleGetTouch() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    // Events newer than the caller's last sequence number
+    uint32_t since = server.hasArg("since") ? strtoul(server.arg("since").c_str(), nullptr, 10) : 0;
+    server.send(200, "application/json", hardware->getTouch().getStatusJSON(since));
+}
+
+void handleTouchCalibrate() {
+    if (!isAuthenticated()) {
+        server.send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    TouchController& touch = hardware->getTouch();
+    if (!touch.isRunning()) {
+        server.send(400, "application/json", "{\"success\":false,\"message\":\"Touch not available\"}");
+        return;
+    }
+    if (touch.isCalibrating()) {
+        server.send(400, "application/json", "{\"success\":false,\"message\":\"Calibration already running\"}");
+        return;
+    }
+    
+    // The targets need the screen; the dashboard comes back when calibration ends
+    if (dashboard) {
+        dashboard->pause(TOUCH_CALIBRATION_TIMEOUT_MS);
+    }
+    touch.startCalibration();
+    server.send(200, "application/json", "{\"success\":true,\"message\":\"Touch the 3 targets on the screen\"}");
+}
@@ -0,0 +1,209 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// Just enough of the Arduino core for the host-portable modules to build in
+// the native test environment (pio test -e native). String is a working
+// std::string wrapper; millis()/micros() read a simulated clock that only
+// moves through delay() and NativeClock::advanceUs(), so tests of waits and
+// timeouts are reproducible. Host wall time for benchmarks is std::chrono.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+#define PROGMEM
+#define IRAM_ATTR
+#define F(text) (text)
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+
+using std::min;
+using std::max;
+
+template <class T>
+inline T constrain(T value, T low, T high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+namespace NativeClock {
+    inline uint64_t& nowUs() {
+        static uint64_t us = 0;
+        return us;
+    }
+    inline void advanceUs(uint64_t us) { nowUs() += us; }
+    inline void reset() { nowUs() = 0; }
+}
+
+inline unsigned long millis() { return (unsigned long)(NativeClock::nowUs() / 1000); }
+inline unsigned long micros() { return (unsigned long)NativeClock::nowUs(); }
+inline void delay(unsigned long ms) { NativeClock::advanceUs((uint64_t)ms * 1000); }
+inline void delayMicroseconds(unsigned int us) { NativeClock::advanceUs(us); }
+inline void yield() {}
+
+// No SNTP on the host: receipts print without the date line
+inline bool getLocalTime(struct tm* info, uint32_t ms = 5000) {
+    (void)info;
+    (void)ms;
+    return false;
+}
+
+class String {
+private:
+    std::string text;
+
+    static std::string formatUnsigned(unsigned long long value, int base) {
+        if (base == DEC) return std::to_string(value);
+        const char* digits = "0123456789abcdef";
+        std::string out;
+        do {
+            out.insert(out.begin(), digits[value % base]);
+            value /= base;
+        } while (value);
+        return out;
+    }
+
+public:
+    String() {}
+    String(const char* value) : text(value ? value : "") {}
+    String(const std::string& value) : text(value) {}
+    explicit String(char value) : text(1, value) {}
+    String(int value, unsigned char base = DEC)
+        : text(base == DEC ? std::to_string(value) : formatUnsigned((unsigned)value, base)) {}
+    String(unsigned int value, unsigned char base = DEC) : text(formatUnsigned(value, base)) {}
+    String(long value, unsigned char base = DEC)
+        : text(base == DEC ? std::to_string(value) : formatUnsigned((unsigned long)value, base)) {}
+    String(unsigned long value, unsigned char base = DEC) : text(formatUnsigned(value, base)) {}
+    String(long long value) : text(std::to_string(value)) {}
+    String(unsigned long long value) : text(std::to_string(value)) {}
+    String(double value, unsigned int decimals = 2) {
+        char buffer[48];
+        snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+        text = buffer;
+    }
+    String(float value, unsigned int decimals = 2) : String((double)value, decimals) {}
+
+    size_t length() const { return text.size(); }  // size_t, as on the ESP32 (ArduinoJson checks)
+    const char* c_str() const { return text.c_str(); }
+    bool reserve(unsigned int size) { text.reserve(size); return true; }
+    bool isEmpty() const { return text.empty(); }
+
+    char charAt(unsigned int index) const { return index < text.size() ? text[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return text[index]; }
+    void setCharAt(unsigned int index, char c) { if (index < text.size()) text[index] = c; }
+
+    bool concat(const String& value) { text += value.text; return true; }
+    bool concat(const char* value) { if (!value) return false; text += value; return true; }
+    bool concat(const char* value, unsigned int length) { if (!value) return false; text.append(value, length); return true; }
+    bool concat(char value) { text += value; return true; }
+    bool concat(int value) { return concat(String(value)); }
+    bool concat(unsigned int value) { return concat(String(value)); }
+    bool concat(long value) { return concat(String(value)); }
+    bool concat(unsigned long value) { return concat(String(value)); }
+    bool concat(double value) { return concat(String(value)); }
+    template <class T>
+    String& operator+=(const T& value) { concat(value); return *this; }
+
+    bool equals(const String& other) const { return text == other.text; }
+    bool equalsIgnoreCase(const String& other) const {
+        if (text.size() != other.text.size()) return false;
+        for (size_t i = 0; i < text.size(); i++) {
+            if (tolower((unsigned char)text[i]) != tolower((unsigned char)other.text[i])) return false;
+        }
+        return true;
+    }
+    bool operator==(const String& other) const { return text == other.text; }
+    bool operator==(const char* other) const { return text == (other ? other : ""); }
+    bool operator!=(const String& other) const { return text != other.text; }
+    bool operator!=(const char* other) const { return !(*this == other); }
+    bool operator<(const String& other) const { return text < other.text; }
+    bool startsWith(const String& prefix) const { return text.compare(0, prefix.text.size(), prefix.text) == 0; }
+    bool endsWith(const String& suffix) const {
+        return text.size() >= suffix.text.size() &&
+               text.compare(text.size() - suffix.text.size(), suffix.text.size(), suffix.text) == 0;
+    }
+
+    int indexOf(char c, unsigned int from = 0) const { return position(text.find(c, from)); }
+    int indexOf(const String& value, unsigned int from = 0) const { return position(text.find(value.text, from)); }
+    int lastIndexOf(char c) const { return position(text.rfind(c)); }
+    int lastIndexOf(const String& value) const { return position(text.rfind(value.text)); }
+    static int position(size_t found) { return found == std::string::npos ? -1 : (int)found; }
+
+    String substring(unsigned int from) const { return from < text.size() ? String(text.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        if (from >= text.size()) return String();
+        return String(text.substr(from, to - from));
+    }
+
+    void replace(char find, char with) { std::replace(text.begin(), text.end(), find, with); }
+    void replace(const String& find, const String& with) {
+        if (find.text.empty()) return;
+        size_t at = 0;
+        while ((at = text.find(find.text, at)) != std::string::npos) {
+            text.replace(at, find.text.size(), with.text);
+            at += with.text.size();
+        }
+    }
+    void remove(unsigned int index) { if (index < text.size()) text.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < text.size()) text.erase(index, count); }
+    void trim() {
+        size_t start = 0;
+        while (start < text.size() && isspace((unsigned char)text[start])) start++;
+        size_t end = text.size();
+        while (end > start && isspace((unsigned char)text[end - 1])) end--;
+        text = text.substr(start, end - start);
+    }
+    void toLowerCase() { for (char& c : text) c = tolower((unsigned char)c); }
+    void toUpperCase() { for (char& c : text) c = toupper((unsigned char)c); }
+    long toInt() const { return atol(text.c_str()); }
+    float toFloat() const { return atof(text.c_str()); }
+    double toDouble() const { return atof(text.c_str()); }
+};
+
+inline String operator+(const String& a, const String& b) { String out(a); out.concat(b); return out; }
+inline String operator+(const String& a, const char* b) { String out(a); out.concat(b); return out; }
+inline String operator+(const char* a, const String& b) { String out(a); out.concat(b); return out; }
+inline String operator+(const String& a, char b) { String out(a); out.concat(b); return out; }
+
+// Logger output; quiet unless a test turns it on
+class NativeSerial {
+public:
+    bool enabled;
+    NativeSerial() : enabled(false) {}
+    void begin(unsigned long baud) { (void)baud; }
+    int printf(const char* format, ...) {
+        if (!enabled) return 0;
+        va_list args;
+        va_start(args, format);
+        int written = vprintf(format, args);
+        va_end(args);
+        return written;
+    }
+    size_t print(const String& text) { return enabled ? fputs(text.c_str(), stdout), text.length() : 0; }
+    size_t println(const String& text = String()) { return print(text + "\n"); }
+};
+
+inline NativeSerial& nativeSerial() {
+    static NativeSerial serial;
+    return serial;
+}
+#define Serial nativeSerial()
+
+#endif // NATIVE_ARDUINO_H
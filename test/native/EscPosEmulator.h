@@ -0,0 +1,486 @@
+#ifndef ESC_POS_EMULATOR_H
+#define ESC_POS_EMULATOR_H
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "EmulatorFont.h"
+#include "EscPosEncoder.h"
+#include "QrEncoder.h"
+#include "BarcodeEncoder.h"
+#include "config.h"
+
+// Host-side thermal printer for the native tests. Interprets the ESC/POS
+// stream PrinterService sends and draws the paper as a PRINTER_HEAD_DOTS
+// wide 1-bit image, which writePbm() saves for a look at the receipt.
+//
+// Covers what the firmware emits: Font A text (12x24 cells drawn from a
+// 5x7 CP437 font, so CP850/CP1252 accents show as their CP437 neighbours),
+// double height/width, bold, underline, inverse, alignment, line spacing,
+// user-defined characters (ESC & / ESC %, cleared by ESC @), inline 24-dot
+// bit images (ESC *), GS v 0 rasters, QR codes (GS ( k, drawn with
+// QrEncoder), CODE128 barcodes (GS k 73) and cuts. Heating, density,
+// baud rate setup and status requests are parsed and ignored.
+//
+// Alongside the image it keeps the text of every printed line, with
+// user-defined characters as their code and inline images as '#', so tests
+// can assert on content without decoding pixels.
+class EscPosEmulator {
+public:
+    static const uint16_t WIDTH = PRINTER_HEAD_DOTS;
+    static const uint8_t CELL_WIDTH = 12;
+    static const uint8_t CELL_HEIGHT = 24;
+
+private:
+    static const uint8_t ROW_BYTES = WIDTH / 8;
+    static const uint8_t LINE_ROWS = CELL_HEIGHT * 2;  // Tallest thing on a text line
+
+    struct Glyph {
+        uint8_t width;
+        std::vector<uint8_t> columns;  // 3 bytes per column, MSB = top dot
+    };
+
+    std::vector<uint8_t> page;     // ROW_BYTES per dot row
+    uint32_t paperY;               // Next dot row to print on
+    std::vector<uint32_t> cutRows;
+    std::vector<std::string> lines;
+
+    // Line being assembled, bottom-aligned in LINE_ROWS rows
+    std::vector<uint8_t> line;
+    uint16_t lineX;
+    uint8_t lineHeight;            // 0 = nothing on the line yet
+    std::string lineText;
+
+    // Modes
+    uint8_t printMode;
+    bool bold;
+    uint8_t underline;
+    bool inverse;
+    uint8_t align;
+    uint8_t lineSpacing;
+    uint8_t codePage;
+    bool userCharacters;
+    std::map<uint8_t, Glyph> glyphs;
+
+    // Symbols
+    uint8_t qrModuleDots;
+    uint8_t qrErrorCorrection;
+    std::vector<uint8_t> qrData;
+    uint8_t barcodeHeight;
+    uint8_t barcodeModule;
+    uint8_t barcodeText;
+
+    std::vector<uint8_t> pending;  // Command collected so far
+    uint32_t bytes;
+    uint32_t inits;
+
+    void setDot(std::vector<uint8_t>& rows, uint32_t x, uint32_t y, bool dark) {
+        if (x >= WIDTH) return;
+        size_t index = (size_t)y * ROW_BYTES + x / 8;
+        if (index >= rows.size()) rows.resize((size_t)(y + 1) * ROW_BYTES, 0);
+        if (dark) {
+            rows[index] |= 0x80 >> (x % 8);
+        } else {
+            rows[index] &= ~(0x80 >> (x % 8));
+        }
+    }
+
+    void pageDot(uint32_t x, uint32_t y) {
+        if (page.size() < (size_t)(y + 1) * ROW_BYTES) page.resize((size_t)(y + 1) * ROW_BYTES, 0);
+        setDot(page, x, y, true);
+    }
+
+    uint16_t alignOffset(uint16_t used) const {
+        if (used >= WIDTH) return 0;
+        if (align == 1) return (WIDTH - used) / 2;
+        if (align == 2) return WIDTH - used;
+        return 0;
+    }
+
+    void resetModes() {
+        printMode = 0;
+        bold = false;
+        underline = 0;
+        inverse = false;
+        align = 0;
+        lineSpacing = PRINTER_LINE_SPACING_DOTS;
+        codePage = 0;
+        userCharacters = false;
+        barcodeHeight = 162;
+        barcodeModule = 3;
+        barcodeText = 0;
+    }
+
+    void clearLine() {
+        line.assign((size_t)LINE_ROWS * ROW_BYTES, 0);
+        lineX = 0;
+        lineHeight = 0;
+        lineText.clear();
+    }
+
+    // Print the line at the current alignment and feed past it
+    void lineFeed() {
+        uint16_t offset = alignOffset(lineX);
+        for (uint8_t row = LINE_ROWS - lineHeight; row < LINE_ROWS; row++) {
+            for (uint16_t x = 0; x < lineX; x++) {
+                if (line[(size_t)row * ROW_BYTES + x / 8] & (0x80 >> (x % 8))) {
+                    pageDot(x + offset, paperY + row - (LINE_ROWS - lineHeight));
+                }
+            }
+        }
+        paperY += lineHeight > lineSpacing ? lineHeight : lineSpacing;
+        lines.push_back(lineText);
+        clearLine();
+    }
+
+    void flushLine() {
+        if (lineX > 0) lineFeed();
+    }
+
+    // Make room for width dots, wrapping like the printer when the line is full
+    void fitOnLine(uint16_t width) {
+        if (lineX > 0 && lineX + width > WIDTH) lineFeed();
+    }
+
+    void drawColumns(const uint8_t* columns, uint8_t width, uint8_t scaleX, uint8_t scaleY) {
+        uint8_t height = CELL_HEIGHT * scaleY;
+        for (uint8_t col = 0; col < width; col++) {
+            for (uint8_t y = 0; y < CELL_HEIGHT; y++) {
+                if (!(columns[col * 3 + y / 8] & (0x80 >> (y % 8)))) continue;
+                for (uint8_t sx = 0; sx < scaleX; sx++) {
+                    for (uint8_t sy = 0; sy < scaleY; sy++) {
+                        setDot(line, lineX + col * scaleX + sx, LINE_ROWS - height + y * scaleY + sy, true);
+                    }
+                }
+            }
+        }
+    }
+
+    void drawCharacter(uint8_t code) {
+        uint8_t scaleX = (printMode & 0x20) ? 2 : 1;
+        uint8_t scaleY = (printMode & 0x10) ? 2 : 1;
+        std::map<uint8_t, Glyph>::const_iterator user = glyphs.find(code);
+        bool useGlyph = userCharacters && user != glyphs.end();
+        uint8_t cellWidth = (useGlyph ? user->second.width : CELL_WIDTH) * scaleX;
+        uint8_t cellHeight = CELL_HEIGHT * scaleY;
+
+        fitOnLine(cellWidth);
+        if (useGlyph) {
+            drawColumns(user->second.columns.data(), user->second.width, scaleX, scaleY);
+        } else {
+            // 5x7 scaled 2x3 into the 12x24 cell, one dot in from the left
+            const uint8_t* font = &EMULATOR_FONT[code * 5];
+            for (uint8_t col = 0; col < 5; col++) {
+                for (uint8_t y = 0; y < 8; y++) {
+                    if (!(font[col] & (1 << y))) continue;
+                    for (uint8_t dx = 0; dx < 2 * scaleX + ((bold || (printMode & 0x08)) ? 1 : 0); dx++) {
+                        for (uint8_t dy = 0; dy < 3 * scaleY; dy++) {
+                            setDot(line, lineX + (1 + col * 2) * scaleX + dx,
+                                   LINE_ROWS - cellHeight + y * 3 * scaleY + dy, true);
+                        }
+                    }
+                }
+            }
+        }
+
+        uint8_t underlineRows = underline ? underline : ((printMode & 0x80) ? 1 : 0);
+        for (uint8_t row = 0; row < underlineRows; row++) {
+            for (uint8_t x = 0; x < cellWidth; x++) setDot(line, lineX + x, LINE_ROWS - 1 - row, true);
+        }
+        if (inverse) {
+            for (uint8_t y = 0; y < cellHeight; y++) {
+                for (uint8_t x = 0; x < cellWidth; x++) {
+                    uint32_t dotX = lineX + x;
+                    uint32_t dotY = LINE_ROWS - cellHeight + y;
+                    bool dark = line[(size_t)dotY * ROW_BYTES + dotX / 8] & (0x80 >> (dotX % 8));
+                    setDot(line, dotX, dotY, !dark);
+                }
+            }
+        }
+
+        lineX += cellWidth;
+        if (cellHeight > lineHeight) lineHeight = cellHeight;
+        lineText += (char)code;
+    }
+
+    void bitImage(const uint8_t* columns, uint16_t width) {
+        fitOnLine(width);
+        drawColumns(columns, width, 1, 1);
+        lineX += width;
+        if (lineHeight < CELL_HEIGHT) lineHeight = CELL_HEIGHT;
+        lineText += '#';
+    }
+
+    // Rows of packed dots, aligned as a block
+    void raster(const uint8_t* data, uint16_t widthBytes, uint16_t rows) {
+        flushLine();
+        uint16_t offset = alignOffset(widthBytes * 8);
+        for (uint16_t row = 0; row < rows; row++) {
+            for (uint16_t x = 0; x < widthBytes * 8; x++) {
+                if (data[(size_t)row * widthBytes + x / 8] & (0x80 >> (x % 8))) {
+                    pageDot(x + offset, paperY + row);
+                }
+            }
+        }
+        paperY += rows;
+    }
+
+    void printQrCode() {
+        static QrEncoder qr;
+        flushLine();
+        if (!qr.encode(qrData.data(), qrData.size(), (QrErrorCorrection)qrErrorCorrection)) return;
+        uint16_t side = qr.getSize() * qrModuleDots;
+        uint16_t offset = alignOffset(side);
+        for (uint16_t y = 0; y < side; y++) {
+            for (uint16_t x = 0; x < side; x++) {
+                if (qr.getModule(x / qrModuleDots, y / qrModuleDots)) pageDot(x + offset, paperY + y);
+            }
+        }
+        paperY += side;
+        lines.push_back("[QR]");
+    }
+
+    void printBarcode(const uint8_t* data, uint8_t length) {
+        // "{B" selects code set B; "{{" is a literal brace
+        std::string text;
+        for (uint8_t i = 2; i < length; i++) {
+            if (data[i] == '{' && i + 1 < length) i++;
+            text += (char)data[i];
+        }
+        BarcodeEncoder barcode;
+        flushLine();
+        if (!barcode.encode(text.c_str(), text.size())) return;
+        uint16_t width = barcode.getModuleCount() * barcodeModule;
+        uint16_t offset = alignOffset(width);
+        for (uint16_t y = 0; y < barcodeHeight; y++) {
+            for (uint16_t x = 0; x < width; x++) {
+                if (barcode.getModule(x / barcodeModule)) pageDot(x + offset, paperY + y);
+            }
+        }
+        paperY += barcodeHeight;
+        lines.push_back("[BARCODE " + text + "]");
+        if (barcodeText == 2 || barcodeText == 3) {
+            for (size_t i = 0; i < text.size(); i++) drawCharacter((uint8_t)text[i]);
+            lines.pop_back();
+            flushLine();
+        }
+    }
+
+    void defineCharacters(const std::vector<uint8_t>& cmd) {
+        uint8_t height = cmd[2];
+        size_t at = 5;
+        for (uint16_t code = cmd[3]; code <= cmd[4]; code++) {
+            Glyph glyph;
+            glyph.width = cmd[at++];
+            glyph.columns.assign((size_t)glyph.width * 3, 0);
+            for (uint8_t col = 0; col < glyph.width; col++) {
+                for (uint8_t b = 0; b < height; b++) {
+                    if (b < 3) glyph.columns[col * 3 + b] = cmd[at];
+                    at++;
+                }
+            }
+            glyphs[code] = glyph;
+        }
+    }
+
+    // Bytes in the command that starts pending, or 0 until that is known
+    size_t commandSize() const {
+        const std::vector<uint8_t>& c = pending;
+        size_t n = c.size();
+        if (n < 2) return 0;
+        if (c[0] == ESCPOS_ESC) {
+            switch (c[1]) {
+                case '@':
+                case '2':
+                    return 2;
+                case '7':
+                    return 5;
+                case '*':
+                    if (n < 5) return 0;
+                    return 5 + (size_t)(c[3] | (c[4] << 8)) * (c[2] >= 32 ? 3 : 1);
+                case '&': {
+                    if (n < 5) return 0;
+                    size_t at = 5;
+                    for (uint16_t code = c[3]; code <= c[4]; code++) {
+                        if (n <= at) return 0;
+                        at += 1 + (size_t)c[at] * c[2];
+                    }
+                    return at;
+                }
+                default:
+                    return 3;
+            }
+        }
+        if (c[0] == ESCPOS_GS) {
+            switch (c[1]) {
+                case 'v':
+                    if (n < 8) return 0;
+                    return 8 + (size_t)(c[4] | (c[5] << 8)) * (c[6] | (c[7] << 8));
+                case '(':
+                    if (n < 5) return 0;
+                    return 5 + (size_t)(c[3] | (c[4] << 8));
+                case 'V':
+                    if (n < 3) return 0;
+                    return c[2] >= 65 ? 4 : 3;
+                case 'k':
+                    if (n < 4) return 0;
+                    if (c[2] < 65) return c[n - 1] == 0 && n > 3 ? n : 0;
+                    return 4 + (size_t)c[3];
+                default:
+                    return 3;
+            }
+        }
+        return 3;  // DLE EOT n, DC2 # n
+    }
+
+    void execute() {
+        const std::vector<uint8_t>& c = pending;
+        if (c[0] == ESCPOS_ESC) {
+            switch (c[1]) {
+                case '@':
+                    inits++;
+                    flushLine();
+                    resetModes();
+                    glyphs.clear();
+                    break;
+                case '2': lineSpacing = PRINTER_LINE_SPACING_DOTS; break;
+                case '3': lineSpacing = c[2]; break;
+                case '!': printMode = c[2]; break;
+                case 'E': bold = c[2] & 1; break;
+                case '-': underline = c[2] > 2 ? c[2] - 48 : c[2]; break;
+                case 'a': align = c[2] > 2 ? c[2] - 48 : c[2]; break;
+                case 't': codePage = c[2]; break;
+                case '%': userCharacters = c[2] & 1; break;
+                case '&': defineCharacters(c); break;
+                case '*':
+                    if (c[2] >= 32) bitImage(&c[5], c[3] | (c[4] << 8));
+                    break;
+                case 'J':
+                    flushLine();
+                    paperY += c[2];
+                    break;
+                case 'd':
+                    for (uint8_t i = 0; i < c[2]; i++) lineFeed();
+                    break;
+                default:
+                    break;
+            }
+        } else if (c[0] == ESCPOS_GS) {
+            switch (c[1]) {
+                case 'B': inverse = c[2] & 1; break;
+                case 'h': barcodeHeight = c[2]; break;
+                case 'w': barcodeModule = c[2]; break;
+                case 'H': barcodeText = c[2] > 3 ? c[2] - 48 : c[2]; break;
+                case 'V':
+                    flushLine();
+                    cutRows.push_back(paperY);
+                    break;
+                case 'v':
+                    raster(&c[8], c[4] | (c[5] << 8), c[6] | (c[7] << 8));
+                    break;
+                case 'k':
+                    if (c[2] == 73) printBarcode(&c[4], c[3]);
+                    break;
+                case '(':
+                    if (c[2] == 'k' && c.size() >= 8 && c[5] == 49) {
+                        if (c[6] == 67) qrModuleDots = c[7];
+                        if (c[6] == 69) qrErrorCorrection = c[7] - 48;
+                        if (c[6] == 80) qrData.assign(c.begin() + 8, c.end());
+                        if (c[6] == 81) printQrCode();
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+public:
+    EscPosEmulator() { reset(); }
+
+    void reset() {
+        page.clear();
+        paperY = 0;
+        cutRows.clear();
+        lines.clear();
+        glyphs.clear();
+        resetModes();
+        clearLine();
+        qrModuleDots = 3;
+        qrErrorCorrection = 0;
+        qrData.clear();
+        pending.clear();
+        bytes = 0;
+        inits = 0;
+    }
+
+    void feed(const uint8_t* data, size_t length) {
+        bytes += length;
+        for (size_t i = 0; i < length; i++) {
+            uint8_t b = data[i];
+            if (pending.empty()) {
+                if (b == ESCPOS_ESC || b == ESCPOS_GS || b == ESCPOS_DLE || b == ESCPOS_DC2) {
+                    pending.push_back(b);
+                } else if (b == '\n') {
+                    lineFeed();
+                } else if (b >= 0x20) {
+                    drawCharacter(b);
+                }
+                continue;
+            }
+            pending.push_back(b);
+            size_t size = commandSize();
+            if (size > 0 && pending.size() >= size) {
+                execute();
+                pending.clear();
+            }
+        }
+    }
+
+    uint32_t getBytes() const { return bytes; }
+    uint32_t getInits() const { return inits; }      // ESC @ received
+    uint32_t getPaperRows() const { return paperY; }
+    const std::vector<uint32_t>& getCuts() const { return cutRows; }
+    const std::vector<std::string>& getLines() const { return lines; }
+    bool isGlyphDefined(uint8_t code) const { return glyphs.count(code) > 0; }
+
+    bool getDot(uint16_t x, uint32_t y) const {
+        size_t index = (size_t)y * ROW_BYTES + x / 8;
+        return x < WIDTH && index < page.size() && (page[index] & (0x80 >> (x % 8)));
+    }
+
+    uint32_t countDots(uint32_t fromRow, uint32_t toRow) const {
+        uint32_t dots = 0;
+        for (uint32_t y = fromRow; y < toRow; y++) {
+            for (uint16_t x = 0; x < WIDTH; x++) dots += getDot(x, y) ? 1 : 0;
+        }
+        return dots;
+    }
+
+    // Binary PBM (P4) of the paper so far, cuts drawn as dashed lines
+    bool writePbm(const char* path) const {
+        FILE* file = fopen(path, "wb");
+        if (!file) return false;
+        uint32_t height = paperY;
+        if (!cutRows.empty() && cutRows.back() >= height) height = cutRows.back() + 1;
+        if (height == 0) height = 1;
+        fprintf(file, "P4\n%u %u\n", (unsigned)WIDTH, (unsigned)height);
+        std::vector<uint8_t> row(ROW_BYTES);
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint8_t i = 0; i < ROW_BYTES; i++) {
+                size_t index = (size_t)y * ROW_BYTES + i;
+                row[i] = index < page.size() ? page[index] : 0;
+            }
+            for (size_t c = 0; c < cutRows.size(); c++) {
+                if (cutRows[c] == y) {
+                    for (uint8_t i = 0; i < ROW_BYTES; i++) row[i] |= 0xF0;
+                }
+            }
+            fwrite(row.data(), 1, row.size(), file);
+        }
+        return fclose(file) == 0;
+    }
+};
+
+#endif // ESC_POS_EMULATOR_H
@@ -0,0 +1,139 @@
+#ifndef MOCK_PRINTER_PORT_H
+#define MOCK_PRINTER_PORT_H
+
+#include <Arduino.h>
+#include <deque>
+#include <vector>
+#include "PrinterPort.h"
+#include "EscPosTimingModel.h"
+#include "EscPosEncoder.h"
+#include "EscPosEmulator.h"
+#include "config.h"
+
+// Printer end of the serial link for the native tests. Keeps every byte
+// PrinterService writes, feeds them to an EscPosTimingModel and, when one
+// is attached, an EscPosEmulator. Each write advances the simulated clock
+// by its wire time at the current baud rate.
+//
+// With answering set it behaves like a printer with real-time status:
+// DLE EOT n gets a status byte at once, and a job ending in GS r 1 gets a
+// paper status reply once the head has printed everything before it (per
+// the timing model), but only while the host baud matches deviceBaud.
+class MockPrinterPort : public PrinterPort {
+private:
+    struct Reply {
+        uint8_t value;
+        uint64_t readyAtUs;
+    };
+
+    std::deque<Reply> replies;
+    uint64_t headFreeAtUs;        // When the head finishes what it has been sent
+
+public:
+    std::vector<uint8_t> written;
+    uint32_t writes;
+    uint64_t lastByteAtUs;        // When the last byte written reached the printer
+    uint32_t baud;
+    uint32_t deviceBaud;          // What the printer listens at
+    bool answering;
+    bool paperNearEnd;
+    bool paperOut;
+    bool coverOpen;
+    bool failWrites;
+    float moisture;
+    float sanitizer;
+    EscPosTimingModel model;
+    EscPosEmulator* emulator;
+
+    MockPrinterPort()
+        : headFreeAtUs(0), writes(0), lastByteAtUs(0), baud(THERMAL_PRINTER_BAUD), deviceBaud(THERMAL_PRINTER_BAUD),
+          answering(false), paperNearEnd(false), paperOut(false), coverOpen(false),
+          failWrites(false), moisture(42.0f), sanitizer(87.5f), emulator(nullptr) {}
+
+    void clear() {
+        written.clear();
+        writes = 0;
+        lastByteAtUs = 0;
+        replies.clear();
+        model.reset();
+        headFreeAtUs = 0;
+    }
+
+    bool printerWrite(const uint8_t* data, size_t length) override {
+        if (failWrites) return false;
+        writes++;
+        written.insert(written.end(), data, data + length);
+        uint32_t printerMs = model.getHeadMs() + model.getCutMs();
+        model.feed(data, length);
+        printerMs = model.getHeadMs() + model.getCutMs() - printerMs;
+        if (emulator) emulator->feed(data, length);
+
+        // The head starts as the bytes arrive and overlaps the wire time
+        uint64_t startUs = NativeClock::nowUs();
+        if (headFreeAtUs < startUs) headFreeAtUs = startUs;
+        headFreeAtUs += (uint64_t)printerMs * 1000;
+        NativeClock::advanceUs((uint64_t)length * 10 * 1000000 / baud);  // 10 bits per byte
+        lastByteAtUs = NativeClock::nowUs();
+        if (headFreeAtUs < NativeClock::nowUs()) headFreeAtUs = NativeClock::nowUs();
+
+        if (!listening()) return true;
+        if (length == 3 && data[0] == ESCPOS_DLE && data[1] == ESCPOS_EOT) {
+            Reply reply = {realtimeStatus(data[2]), NativeClock::nowUs()};
+            replies.push_back(reply);
+        } else if (length >= 3 && data[length - 3] == ESCPOS_GS && data[length - 2] == 'r' && data[length - 1] == 1) {
+            Reply reply = {paperStatus(), headFreeAtUs};
+            replies.push_back(reply);
+        }
+        return true;
+    }
+
+    // printerWrite already spent the wire time
+    bool printerWaitTxDone(uint32_t timeoutMs) override {
+        (void)timeoutMs;
+        return !failWrites;
+    }
+
+    int printerRead(uint32_t timeoutMs) override {
+        uint64_t deadlineUs = NativeClock::nowUs() + (uint64_t)timeoutMs * 1000;
+        if (replies.empty() || replies.front().readyAtUs > deadlineUs) {
+            NativeClock::nowUs() = deadlineUs;
+            return -1;
+        }
+        if (replies.front().readyAtUs > NativeClock::nowUs()) {
+            NativeClock::nowUs() = replies.front().readyAtUs;
+        }
+        int reply = replies.front().value;
+        replies.pop_front();
+        return reply;
+    }
+
+    void printerFlushInput() override { replies.clear(); }
+    bool printerAvailable() const override { return true; }
+    bool setPrinterBaud(uint32_t rate) override { baud = rate; return true; }
+    uint32_t getPrinterBaud() const override { return baud; }
+    float getMoisturePercent() const override { return moisture; }
+    float getSanitizerLevel() const override { return sanitizer; }
+
+    size_t pendingReplies() const { return replies.size(); }
+
+private:
+    bool listening() const { return answering && baud == deviceBaud; }
+
+    uint8_t realtimeStatus(uint8_t n) const {
+        uint8_t reply = 0x12;  // Bits 1 and 4 fixed high
+        if (n == 2) {
+            if (coverOpen) reply |= 0x04;
+            if (paperOut) reply |= 0x20;
+        } else if (n == 4) {
+            if (paperNearEnd) reply |= 0x0C;
+            if (paperOut) reply |= 0x60;
+        }
+        return reply;
+    }
+
+    uint8_t paperStatus() const {
+        return (paperNearEnd ? 0x03 : 0) | (paperOut ? 0x0C : 0);
+    }
+};
+
+#endif // MOCK_PRINTER_PORT_H
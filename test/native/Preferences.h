@@ -0,0 +1,78 @@
+#ifndef NATIVE_PREFERENCES_H
+#define NATIVE_PREFERENCES_H
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// In-memory NVS for the native tests. Values live until Preferences::wipe()
+// (call from setUp() so a test doesn't see the last one's saved settings).
+class Preferences {
+private:
+    typedef std::map<std::string, std::vector<uint8_t> > Namespace;
+
+    static std::map<std::string, Namespace>& storage() {
+        static std::map<std::string, Namespace> namespaces;
+        return namespaces;
+    }
+
+    Namespace* open;
+    bool readOnly;
+
+    template <class T>
+    T get(const char* key, T fallback) const {
+        T value = fallback;
+        return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : fallback;
+    }
+
+    template <class T>
+    size_t put(const char* key, T value) { return putBytes(key, &value, sizeof(value)); }
+
+public:
+    Preferences() : open(nullptr), readOnly(false) {}
+
+    static void wipe() { storage().clear(); }
+
+    bool begin(const char* name, bool readOnlyMode = false) {
+        open = &storage()[name];
+        readOnly = readOnlyMode;
+        return true;
+    }
+    void end() { open = nullptr; }
+
+    size_t getBytesLength(const char* key) const {
+        if (!open) return 0;
+        Namespace::const_iterator found = open->find(key);
+        return found == open->end() ? 0 : found->second.size();
+    }
+    size_t getBytes(const char* key, void* out, size_t length) const {
+        if (!open) return 0;
+        Namespace::const_iterator found = open->find(key);
+        if (found == open->end() || found->second.size() > length) return 0;
+        memcpy(out, found->second.data(), found->second.size());
+        return found->second.size();
+    }
+    size_t putBytes(const char* key, const void* value, size_t length) {
+        if (!open || readOnly) return 0;
+        const uint8_t* bytes = static_cast<const uint8_t*>(value);
+        (*open)[key].assign(bytes, bytes + length);
+        return length;
+    }
+    bool isKey(const char* key) const { return getBytesLength(key) > 0; }
+    bool remove(const char* key) { return open && !readOnly && open->erase(key) > 0; }
+    bool clear() { if (!open || readOnly) return false; open->clear(); return true; }
+
+    uint8_t getUChar(const char* key, uint8_t fallback = 0) const { return get(key, fallback); }
+    size_t putUChar(const char* key, uint8_t value) { return put(key, value); }
+    uint16_t getUShort(const char* key, uint16_t fallback = 0) const { return get(key, fallback); }
+    size_t putUShort(const char* key, uint16_t value) { return put(key, value); }
+    uint32_t getUInt(const char* key, uint32_t fallback = 0) const { return get(key, fallback); }
+    size_t putUInt(const char* key, uint32_t value) { return put(key, value); }
+    float getFloat(const char* key, float fallback = 0) const { return get(key, fallback); }
+    size_t putFloat(const char* key, float value) { return put(key, value); }
+    bool getBool(const char* key, bool fallback = false) const { return get(key, fallback); }
+    size_t putBool(const char* key, bool value) { return put(key, value); }
+};
+
+#endif // NATIVE_PREFERENCES_H
@@ -0,0 +1,180 @@
+// Host benchmark of the print paths: small, medium and worst-case inputs
+// for printReceipt, printGroceryList and printBitmap, the same cases as
+// the on-device dry run (PrinterService::runBenchmark). Each case goes
+// through the real sendJob path into a mock printer that answers status
+// queries, so the GS r pacing runs too.
+//
+// Reported per case: host encode time (median of BENCHMARK_RUNS, wall
+// clock), bytes on the wire, the timing model's estimate at the default
+// baud rate, and the time the firmware spent waiting on the simulated
+// clock. Raster cases add the throughput figures the device reports
+// (getRasterBytesPerSecond, getRasterMsPer100Rows), here on the simulated
+// clock. Host times only compare runs on the same machine; the bytes and
+// modeled times are exact and are what the assertions hold to.
+
+#include <unity.h>
+#include <Preferences.h>
+#include <chrono>
+#include <functional>
+#include "PrinterService.h"
+#include "MockPrinterPort.h"
+
+static const int BENCHMARK_RUNS = 25;
+
+static MockPrinterPort* port;
+static PrinterService* printer;
+
+struct CaseResult {
+    bool success;
+    double encodeUs;
+    uint32_t bytes;
+    uint32_t writes;
+    uint32_t estimatedMs;
+    uint32_t waitedMs;
+    uint32_t rasterBytesPerSecond;   // Raster cases only
+    uint32_t rasterMsPer100Rows;
+};
+
+void setUp(void) {
+    NativeClock::reset();
+    Preferences::wipe();
+    port = new MockPrinterPort();
+    port->answering = true;
+    printer = new PrinterService(port);
+    printer->refreshStatus();
+}
+
+void tearDown(void) {
+    delete printer;
+    delete port;
+}
+
+static CaseResult runCase(const char* name, const std::function<bool()>& print, bool raster = false) {
+    // Steady state: the glyphs went down with an earlier job
+    print();
+
+    CaseResult result = {true, 0, 0, 0, 0, 0, 0, 0};
+    std::vector<double> times;
+    for (int i = 0; i < BENCHMARK_RUNS; i++) {
+        port->clear();
+        unsigned long simulatedStart = millis();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        result.success = print() && result.success;
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        result.waitedMs = millis() - simulatedStart;
+    }
+    std::sort(times.begin(), times.end());
+    result.encodeUs = times[times.size() / 2];
+    result.bytes = port->written.size();
+    result.writes = port->writes;
+    result.estimatedMs = port->model.getEstimatedMs(THERMAL_PRINTER_BAUD);
+    result.rasterBytesPerSecond = printer->getRasterBytesPerSecond();
+    result.rasterMsPer100Rows = printer->getRasterMsPer100Rows();
+
+    char line[200];
+    int length = snprintf(line, sizeof(line), "%-16s %9.1f us %7u bytes %4u writes %7u ms modeled %7u ms waited",
+                          name, result.encodeUs, (unsigned)result.bytes, (unsigned)result.writes,
+                          (unsigned)result.estimatedMs, (unsigned)result.waitedMs);
+    if (raster) {
+        snprintf(line + length, sizeof(line) - length, " %7u bytes/s %5u ms/100 rows",
+                 (unsigned)result.rasterBytesPerSecond, (unsigned)result.rasterMsPer100Rows);
+    }
+    TEST_MESSAGE(line);
+    return result;
+}
+
+// Everything after the first write is paced by the firmware, which should
+// never wait much past the printer's own time for the job
+static void assertPaced(const CaseResult& result) {
+    TEST_ASSERT_TRUE(result.success);
+    TEST_ASSERT_GREATER_THAN(0, result.bytes);
+    TEST_ASSERT_LESS_OR_EQUAL(result.estimatedMs + result.writes * PRINTER_DRAIN_MARGIN_MS, result.waitedMs);
+}
+
+void test_benchmark_receipts(void) {
+    String small = "Good morning! Have a great day.";
+    String medium;
+    while (medium.length() < 300) {
+        medium += "Remember to water the plant and grab milk on the way home. ";
+    }
+    String worst;
+    while (worst.length() < PRINT_JOURNAL_MAX_PAYLOAD - 40) {
+        worst += "Cr\xC3\xA8me br\xC3\xBBl\xC3\xA9""e for Zo\xC3\xAB, \xC2\xA1Ol\xC3\xA9! Stra\xC3\x9F""e 5. ";
+    }
+
+    CaseResult smallResult = runCase("receipt-small", [&]() { return printer->printReceipt(small, true); });
+    CaseResult mediumResult = runCase("receipt-medium", [&]() { return printer->printReceipt(medium, true); });
+    CaseResult worstResult = runCase("receipt-worst", [&]() { return printer->printReceipt(worst, true); });
+
+    assertPaced(smallResult);
+    assertPaced(mediumResult);
+    assertPaced(worstResult);
+    // One write per receipt, whatever its length
+    TEST_ASSERT_EQUAL(smallResult.writes, worstResult.writes);
+    TEST_ASSERT_GREATER_THAN(mediumResult.bytes, worstResult.bytes);
+}
+
+void test_benchmark_grocery_lists(void) {
+    String items[PRINT_SPOOLER_MAX_LIST_ITEMS];
+    for (int i = 0; i < PRINT_SPOOLER_MAX_LIST_ITEMS; i++) {
+        items[i] = i < 15 ? String("Item ") + String(i + 1)
+                          : String("Family size organic wholebean coffee, dark roast #") + String(i + 1);
+    }
+
+    CaseResult smallResult = runCase("grocery-small", [&]() { return printer->printGroceryList(items, 3); });
+    CaseResult mediumResult = runCase("grocery-medium", [&]() { return printer->printGroceryList(items, 15); });
+    // Every item too long to pair up, so each one wraps
+    CaseResult worstResult = runCase("grocery-worst", [&]() {
+        return printer->printGroceryList(items + 15, PRINT_SPOOLER_MAX_LIST_ITEMS - 15);
+    });
+
+    assertPaced(smallResult);
+    assertPaced(mediumResult);
+    assertPaced(worstResult);
+    TEST_ASSERT_EQUAL(smallResult.writes, worstResult.writes);
+}
+
+void test_benchmark_bitmaps(void) {
+    static const uint8_t heart[32] = {
+        0x00, 0x00, 0x0C, 0x30, 0x1E, 0x78, 0x3F, 0xFC, 0x7F, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0x7F, 0xFE, 0x3F, 0xFC, 0x1F, 0xF8, 0x0F, 0xF0, 0x07, 0xE0, 0x03, 0xC0, 0x01, 0x80, 0x00, 0x00
+    };
+    RasterRowSource pattern = [](uint16_t row, uint8_t* out, uint16_t bytesPerRow) {
+        for (uint16_t i = 0; i < bytesPerRow; i++) {
+            out[i] = (row + i) & 1 ? 0xAA : 0x55;
+        }
+        return true;
+    };
+
+    CaseResult smallResult = runCase("bitmap-small", [&]() { return printer->printBitmap(heart, 16, 16); });
+    CaseResult mediumResult = runCase("bitmap-medium", [&]() {
+        return printer->printRaster(PRINTER_HEAD_DOTS, 240, pattern);
+    }, true);
+    CaseResult worstResult = runCase("bitmap-worst", [&]() {
+        return printer->printRaster(PRINTER_HEAD_DOTS, 1200, pattern);
+    }, true);
+
+    assertPaced(smallResult);
+    assertPaced(mediumResult);
+    assertPaced(worstResult);
+    // Full-width rows are all payload past the band headers
+    TEST_ASSERT_GREATER_OR_EQUAL((uint32_t)PRINTER_HEAD_DOTS / 8 * 1200, worstResult.bytes);
+
+    // Paced by the head, not the wire: no faster than the UART, and the
+    // same per-row cost at either height
+    uint32_t wireBytesPerSecond = THERMAL_PRINTER_BAUD / 10;
+    TEST_ASSERT_GREATER_THAN(0, mediumResult.rasterBytesPerSecond);
+    TEST_ASSERT_LESS_OR_EQUAL(wireBytesPerSecond, mediumResult.rasterBytesPerSecond);
+    TEST_ASSERT_LESS_OR_EQUAL(wireBytesPerSecond, worstResult.rasterBytesPerSecond);
+    TEST_ASSERT_UINT32_WITHIN(worstResult.rasterMsPer100Rows / 20, worstResult.rasterMsPer100Rows,
+                              mediumResult.rasterMsPer100Rows);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_benchmark_receipts);
+    RUN_TEST(test_benchmark_grocery_lists);
+    RUN_TEST(test_benchmark_bitmaps);
+    return UNITY_END();
+}
@@ -0,0 +1,167 @@
+// PrintCoalescer: which queued receipts share one init and cut, and how
+// long the spooler holds a receipt waiting for more. A batch then goes
+// through PrinterService::printReceipts into the emulator as one job.
+
+#include <unity.h>
+#include <Preferences.h>
+#include "PrintCoalescer.h"
+#include "PrinterService.h"
+#include "MockPrinterPort.h"
+#include "EscPosEmulator.h"
+
+static const int QUEUE = PRINT_SPOOLER_QUEUE_SIZE;
+
+static PrintJob jobs[QUEUE];
+static const PrintJob* queue[QUEUE];
+
+void setUp(void) {
+    for (int i = 0; i < QUEUE; i++) {
+        jobs[i] = PrintJob();
+        jobs[i].id = i + 1;
+        jobs[i].status = PRINT_JOB_QUEUED;
+        jobs[i].queuedAt = 1000;
+        queue[i] = &jobs[i];
+    }
+}
+
+void tearDown(void) {}
+
+void test_receipts_with_the_same_profile_join(void) {
+    TEST_ASSERT_TRUE(PrintCoalescer::canJoin(jobs[0], jobs[1]));
+    TEST_ASSERT_EQUAL(3, PrintCoalescer::batchSize(queue, 3));
+
+    jobs[0].profile = PRINT_PROFILE_DARK;
+    jobs[1].profile = PRINT_PROFILE_DARK;
+    TEST_ASSERT_EQUAL(2, PrintCoalescer::batchSize(queue, 3));
+}
+
+void test_a_different_profile_ends_the_batch(void) {
+    jobs[1].profile = PRINT_PROFILE_FAST;
+    TEST_ASSERT_FALSE(PrintCoalescer::canJoin(jobs[0], jobs[1]));
+    TEST_ASSERT_EQUAL(1, PrintCoalescer::batchSize(queue, 3));
+
+    // Receipts behind it don't jump the queue, even with a matching profile
+    jobs[2].profile = PRINT_PROFILE_DEFAULT;
+    TEST_ASSERT_EQUAL(1, PrintCoalescer::batchSize(queue, 3));
+}
+
+void test_only_receipts_are_coalesced(void) {
+    const PrintJobType others[] = {PRINT_JOB_GROCERY_LIST, PRINT_JOB_TEST, PRINT_JOB_IMAGE, PRINT_JOB_BAUD_TEST,
+                                   PRINT_JOB_QR_CODE, PRINT_JOB_BARCODE, PRINT_JOB_BENCHMARK, PRINT_JOB_CALIBRATION};
+    for (size_t i = 0; i < sizeof(others) / sizeof(others[0]); i++) {
+        setUp();
+        // At the front: prints alone and straight away
+        jobs[0].type = others[i];
+        TEST_ASSERT_FALSE(PrintCoalescer::canJoin(jobs[0], jobs[1]));
+        TEST_ASSERT_EQUAL(1, PrintCoalescer::batchSize(queue, 3));
+        TEST_ASSERT_EQUAL(0, PrintCoalescer::holdMs(queue, 3, 1000));
+
+        // Behind a receipt: ends the batch
+        setUp();
+        jobs[1].type = others[i];
+        TEST_ASSERT_FALSE(PrintCoalescer::canJoin(jobs[0], jobs[1]));
+        TEST_ASSERT_EQUAL(1, PrintCoalescer::batchSize(queue, 3));
+    }
+}
+
+void test_batch_is_capped_at_max_jobs(void) {
+    TEST_ASSERT_LESS_THAN(QUEUE, PRINT_COALESCE_MAX_JOBS);
+    TEST_ASSERT_EQUAL(PRINT_COALESCE_MAX_JOBS, PrintCoalescer::batchSize(queue, QUEUE));
+    TEST_ASSERT_EQUAL(PRINT_COALESCE_MAX_JOBS, PrintCoalescer::batchSize(queue, PRINT_COALESCE_MAX_JOBS));
+    TEST_ASSERT_EQUAL(PRINT_COALESCE_MAX_JOBS - 1, PrintCoalescer::batchSize(queue, PRINT_COALESCE_MAX_JOBS - 1));
+    TEST_ASSERT_EQUAL(0, PrintCoalescer::batchSize(queue, 0));
+}
+
+void test_hold_until_the_window_expires(void) {
+    if (PRINT_COALESCE_WINDOW_MS == 0) {
+        TEST_IGNORE_MESSAGE("Coalescing is off");
+    }
+    TEST_ASSERT_EQUAL(PRINT_COALESCE_WINDOW_MS, PrintCoalescer::holdMs(queue, 1, 1000));
+    TEST_ASSERT_EQUAL(PRINT_COALESCE_WINDOW_MS - 400, PrintCoalescer::holdMs(queue, 2, 1400));
+    TEST_ASSERT_EQUAL(1, PrintCoalescer::holdMs(queue, 1, 1000 + PRINT_COALESCE_WINDOW_MS - 1));
+    TEST_ASSERT_EQUAL(0, PrintCoalescer::holdMs(queue, 1, 1000 + PRINT_COALESCE_WINDOW_MS));
+    TEST_ASSERT_EQUAL(0, PrintCoalescer::holdMs(queue, 1, 1000 + PRINT_COALESCE_WINDOW_MS * 5));
+
+    // The window runs from the oldest receipt, not the latest
+    jobs[1].queuedAt = 1000 + PRINT_COALESCE_WINDOW_MS - 10;
+    TEST_ASSERT_EQUAL(0, PrintCoalescer::holdMs(queue, 2, 1000 + PRINT_COALESCE_WINDOW_MS));
+
+    // Across the millis() rollover
+    jobs[0].queuedAt = (unsigned long)0 - 0x100;
+    TEST_ASSERT_EQUAL(PRINT_COALESCE_WINDOW_MS - 0x150, PrintCoalescer::holdMs(queue, 1, 0x50));
+}
+
+void test_no_hold_once_the_batch_is_full(void) {
+    TEST_ASSERT_EQUAL(0, PrintCoalescer::holdMs(queue, PRINT_COALESCE_MAX_JOBS, 1000));
+    TEST_ASSERT_EQUAL(0, PrintCoalescer::holdMs(queue, QUEUE, 1000));
+    TEST_ASSERT_GREATER_THAN(0, PrintCoalescer::holdMs(queue, PRINT_COALESCE_MAX_JOBS - 1, 1000));
+}
+
+void test_no_hold_when_the_batch_cannot_grow(void) {
+    // A grocery list or another profile behind the receipt would print
+    // between it and anything submitted later, so waiting gains nothing
+    jobs[1].type = PRINT_JOB_GROCERY_LIST;
+    TEST_ASSERT_EQUAL(0, PrintCoalescer::holdMs(queue, 2, 1000));
+
+    setUp();
+    jobs[2].profile = PRINT_PROFILE_FAST;
+    TEST_ASSERT_EQUAL(0, PrintCoalescer::holdMs(queue, 3, 1000));
+
+    // Other-profile receipts don't count towards a full batch either
+    setUp();
+    for (int i = 1; i < QUEUE; i++) jobs[i].profile = PRINT_PROFILE_FAST;
+    TEST_ASSERT_EQUAL(1, PrintCoalescer::batchSize(queue, QUEUE));
+    TEST_ASSERT_EQUAL(0, PrintCoalescer::holdMs(queue, QUEUE, 1000));
+}
+
+void test_batch_prints_with_one_init_and_one_cut(void) {
+    NativeClock::reset();
+    Preferences::wipe();
+    MockPrinterPort port;
+    EscPosEmulator paper;
+    port.emulator = &paper;
+    PrinterService printer(&port);
+
+    const String messages[PRINT_COALESCE_MAX_JOBS] = {"First note", "Second note", "Third note", "Fourth note"};
+    const String weather = "Sunny 21C";
+    ReceiptContent receipts[PRINT_COALESCE_MAX_JOBS];
+    for (int i = 0; i < PRINT_COALESCE_MAX_JOBS; i++) {
+        receipts[i].message = &messages[i % 4];
+        receipts[i].weather = &weather;
+        receipts[i].includeWeatherAndSanitizer = i % 2 == 0;
+        receipts[i].createdTime = 0;
+    }
+    TEST_ASSERT_TRUE(printer.printReceipts(receipts, PRINT_COALESCE_MAX_JOBS));
+
+    TEST_ASSERT_EQUAL(1, paper.getInits());
+    TEST_ASSERT_EQUAL(1, paper.getCuts().size());
+    TEST_ASSERT_EQUAL(1, port.writes);
+    std::string text;
+    for (size_t i = 0; i < paper.getLines().size(); i++) text += paper.getLines()[i] + "\n";
+    size_t at = 0;
+    for (int i = 0; i < PRINT_COALESCE_MAX_JOBS; i++) {
+        at = text.find(messages[i % 4].c_str(), at);
+        TEST_ASSERT_TRUE_MESSAGE(at != std::string::npos, messages[i % 4].c_str());
+    }
+
+    // The same receipts one at a time
+    paper.reset();
+    for (int i = 0; i < PRINT_COALESCE_MAX_JOBS; i++) {
+        TEST_ASSERT_TRUE(printer.printReceipts(&receipts[i], 1));
+    }
+    TEST_ASSERT_EQUAL(PRINT_COALESCE_MAX_JOBS, paper.getInits());
+    TEST_ASSERT_EQUAL(PRINT_COALESCE_MAX_JOBS, paper.getCuts().size());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_receipts_with_the_same_profile_join);
+    RUN_TEST(test_a_different_profile_ends_the_batch);
+    RUN_TEST(test_only_receipts_are_coalesced);
+    RUN_TEST(test_batch_is_capped_at_max_jobs);
+    RUN_TEST(test_hold_until_the_window_expires);
+    RUN_TEST(test_no_hold_once_the_batch_is_full);
+    RUN_TEST(test_no_hold_when_the_batch_cannot_grow);
+    RUN_TEST(test_batch_prints_with_one_init_and_one_cut);
+    return UNITY_END();
+}
@@ -0,0 +1,296 @@
+// ImageDitherer: both kernels on small images, output size and row
+// mapping when scaling, and memory that does not grow with the image.
+// Ends with a host benchmark of both kernels in rows per second.
+
+#include <unity.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "ImageDitherer.h"
+#include "config.h"
+
+// Grayscale image served one row at a time, counting the rows read
+struct TestImage {
+    uint16_t width;
+    uint16_t height;
+    std::vector<uint8_t> pixels;
+    uint16_t rowsRead;
+
+    TestImage(uint16_t w, uint16_t h, uint8_t fill = 0) : width(w), height(h), pixels((size_t)w * h, fill), rowsRead(0) {}
+
+    uint8_t& at(uint16_t x, uint16_t y) { return pixels[(size_t)y * width + x]; }
+
+    GrayRowSource source() {
+        return [this](uint8_t* gray, uint16_t w) {
+            if (rowsRead >= height || w != width) return false;
+            memcpy(gray, &pixels[(size_t)rowsRead * width], width);
+            rowsRead++;
+            return true;
+        };
+    }
+};
+
+// Every output row, packed, in one vector
+static std::vector<uint8_t> ditherAll(TestImage& image, uint16_t targetWidth, DitherMode mode) {
+    ImageDitherer ditherer;
+    TEST_ASSERT_TRUE(ditherer.begin(image.width, image.height, targetWidth, mode));
+    uint16_t rowBytes = ditherer.getOutputWidth() / 8;
+    std::vector<uint8_t> out((size_t)rowBytes * ditherer.getOutputHeight());
+    GrayRowSource source = image.source();
+    for (uint16_t y = 0; y < ditherer.getOutputHeight(); y++) {
+        TEST_ASSERT_TRUE(ditherer.nextRow(source, &out[(size_t)y * rowBytes]));
+    }
+    uint8_t extra[48];
+    TEST_ASSERT_FALSE(ditherer.nextRow(source, extra));
+    return out;
+}
+
+static uint32_t blackDots(const std::vector<uint8_t>& packed) {
+    uint32_t dots = 0;
+    for (size_t i = 0; i < packed.size(); i++) {
+        for (uint8_t b = packed[i]; b; b &= b - 1) dots++;
+    }
+    return dots;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_solid_black_and_white(void) {
+    const DitherMode modes[] = {DITHER_FLOYD_STEINBERG, DITHER_ATKINSON};
+    for (uint8_t m = 0; m < 2; m++) {
+        TestImage black(16, 8, 0);
+        TestImage white(16, 8, 255);
+        std::vector<uint8_t> blackOut = ditherAll(black, 16, modes[m]);
+        std::vector<uint8_t> whiteOut = ditherAll(white, 16, modes[m]);
+        TEST_ASSERT_EQUAL(16 * 8, blackDots(blackOut));
+        TEST_ASSERT_EQUAL(0, blackDots(whiteOut));
+    }
+}
+
+void test_floyd_steinberg_row_by_hand(void) {
+    // Gray 100: 7/16 of the error to the next pixel
+    // x0 100 B e=100  -> +43
+    // x1 143 W e=-112 -> -49
+    // x2  51 B e=51   -> +22
+    // x3 122 B e=122  -> +53
+    // x4 153 W e=-102 -> -44
+    // x5  56 B e=56   -> +24
+    // x6 124 B e=124  -> +54
+    // x7 154 W
+    TestImage image(8, 1, 100);
+    std::vector<uint8_t> out = ditherAll(image, 8, DITHER_FLOYD_STEINBERG);
+    TEST_ASSERT_EQUAL(1, out.size());
+    TEST_ASSERT_EQUAL_HEX8(0xB6, out[0]);
+}
+
+void test_floyd_steinberg_carries_error_down(void) {
+    // Two rows of 64: the first row's error lands on the second, so they
+    // differ even though the source rows are the same
+    TestImage image(8, 2, 64);
+    std::vector<uint8_t> out = ditherAll(image, 8, DITHER_FLOYD_STEINBERG);
+    TEST_ASSERT_EQUAL(2, out.size());
+    TEST_ASSERT_TRUE(out[0] != out[1]);
+}
+
+void test_atkinson_row_by_hand(void) {
+    // Gray 100: 1/8 of the error to each of the next two pixels
+    // x0 100 B e=100 -> +12 to x1, x2
+    // x1 112 B e=112 -> +14 to x2, x3
+    // x2 126 B e=126 -> +15 to x3, x4
+    // x3 129 W e=-126 -> -15 to x4, x5
+    // x4 100 B e=100 -> +12 to x5, x6
+    // x5  97 B e=97  -> +12 to x6, x7
+    // x6 124 B e=124 -> +15 to x7
+    // x7 127 B
+    TestImage image(8, 1, 100);
+    std::vector<uint8_t> out = ditherAll(image, 8, DITHER_ATKINSON);
+    TEST_ASSERT_EQUAL(1, out.size());
+    TEST_ASSERT_EQUAL_HEX8(0xEF, out[0]);
+}
+
+void test_mid_gray_density(void) {
+    // Floyd-Steinberg keeps the average; Atkinson drops a quarter of the
+    // error, so it leaves mid-gray lighter and with less texture
+    TestImage image(64, 64, 128);
+    uint32_t fs = blackDots(ditherAll(image, 64, DITHER_FLOYD_STEINBERG));
+    image.rowsRead = 0;
+    uint32_t atkinson = blackDots(ditherAll(image, 64, DITHER_ATKINSON));
+    TEST_ASSERT_UINT32_WITHIN(64 * 64 / 50, 64 * 64 / 2, fs);
+    TEST_ASSERT_LESS_OR_EQUAL(fs, atkinson);
+}
+
+void test_gradient_density_follows_the_gray_level(void) {
+    // Each column band's share of black dots tracks its darkness
+    TestImage image(64, 32);
+    for (uint16_t y = 0; y < 32; y++) {
+        for (uint16_t x = 0; x < 64; x++) {
+            image.at(x, y) = (uint8_t)(x / 16 * 85);   // 0, 85, 170, 255
+        }
+    }
+    std::vector<uint8_t> out = ditherAll(image, 64, DITHER_FLOYD_STEINBERG);
+    for (uint8_t band = 0; band < 4; band++) {
+        uint32_t dots = 0;
+        for (uint16_t y = 0; y < 32; y++) {
+            for (uint16_t b = band * 2; b < band * 2 + 2; b++) {
+                for (uint8_t v = out[y * 8 + b]; v; v &= v - 1) dots++;
+            }
+        }
+        uint32_t expected = (uint32_t)(16 * 32) * (255 - band * 85) / 255;
+        TEST_ASSERT_UINT32_WITHIN(16 * 32 / 10, expected, dots);
+    }
+}
+
+void test_output_size_scales_height_with_width(void) {
+    ImageDitherer ditherer;
+    TEST_ASSERT_TRUE(ditherer.begin(100, 50, 64, DITHER_FLOYD_STEINBERG));
+    TEST_ASSERT_EQUAL(64, ditherer.getOutputWidth());
+    TEST_ASSERT_EQUAL(32, ditherer.getOutputHeight());
+
+    // Target width rounds down to whole bytes; height rounds to nearest
+    TEST_ASSERT_TRUE(ditherer.begin(640, 481, 390, DITHER_ATKINSON));
+    TEST_ASSERT_EQUAL(384, ditherer.getOutputWidth());
+    TEST_ASSERT_EQUAL(289, ditherer.getOutputHeight());
+
+    TEST_ASSERT_TRUE(ditherer.begin(8, 4, 32, DITHER_FLOYD_STEINBERG));
+    TEST_ASSERT_EQUAL(16, ditherer.getOutputHeight());
+
+    // A sliver still gets one row
+    TEST_ASSERT_TRUE(ditherer.begin(1000, 1, 8, DITHER_FLOYD_STEINBERG));
+    TEST_ASSERT_EQUAL(1, ditherer.getOutputHeight());
+
+    TEST_ASSERT_FALSE(ditherer.begin(0, 10, 64, DITHER_FLOYD_STEINBERG));
+    TEST_ASSERT_FALSE(ditherer.begin(10, 0, 64, DITHER_FLOYD_STEINBERG));
+    TEST_ASSERT_FALSE(ditherer.begin(10, 10, 7, DITHER_FLOYD_STEINBERG));
+}
+
+void test_downscale_reads_each_source_row_once(void) {
+    // Rows alternate black and white in blocks of 4; halving keeps blocks of 2
+    TestImage image(16, 16);
+    for (uint16_t y = 0; y < 16; y++) {
+        for (uint16_t x = 0; x < 16; x++) image.at(x, y) = (y / 4) % 2 ? 255 : 0;
+    }
+    std::vector<uint8_t> out = ditherAll(image, 8, DITHER_FLOYD_STEINBERG);
+    TEST_ASSERT_EQUAL(8, out.size());
+    const uint8_t expected[8] = {0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, out.data(), 8);
+    // Output row 7 maps to source row 14; row 15 is never needed
+    TEST_ASSERT_EQUAL(15, image.rowsRead);
+}
+
+void test_upscale_repeats_source_rows(void) {
+    TestImage image(4, 2);
+    for (uint16_t x = 0; x < 4; x++) {
+        image.at(x, 0) = x < 2 ? 0 : 255;
+        image.at(x, 1) = x < 2 ? 255 : 0;
+    }
+    std::vector<uint8_t> out = ditherAll(image, 8, DITHER_ATKINSON);
+    TEST_ASSERT_EQUAL(4, out.size());
+    const uint8_t expected[4] = {0xF0, 0xF0, 0x0F, 0x0F};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, out.data(), 4);
+    TEST_ASSERT_EQUAL(2, image.rowsRead);
+}
+
+void test_source_ending_early_stops_output(void) {
+    TestImage image(16, 16, 0);
+    image.height = 5;  // Source claims 16 rows but stops after 5
+    ImageDitherer ditherer;
+    TEST_ASSERT_TRUE(ditherer.begin(16, 16, 16, DITHER_FLOYD_STEINBERG));
+    GrayRowSource source = image.source();
+    uint8_t row[2];
+    uint16_t rows = 0;
+    while (ditherer.nextRow(source, row)) rows++;
+    TEST_ASSERT_EQUAL(5, rows);
+}
+
+void test_memory_is_bounded_by_width_not_height(void) {
+    ImageDitherer ditherer;
+    TEST_ASSERT_TRUE(ditherer.begin(640, 10, 384, DITHER_FLOYD_STEINBERG));
+    size_t shortImage = ditherer.getMemoryUsage();
+    TEST_ASSERT_TRUE(ditherer.begin(640, 60000, 384, DITHER_FLOYD_STEINBERG));
+    TEST_ASSERT_EQUAL(shortImage, ditherer.getMemoryUsage());
+
+    // One source row plus two (Floyd-Steinberg) or three (Atkinson) padded
+    // 16-bit error rows
+    TEST_ASSERT_EQUAL(640 + 2 * (384 + 3) * sizeof(int16_t), shortImage);
+    TEST_ASSERT_TRUE(ditherer.begin(640, 60000, 384, DITHER_ATKINSON));
+    TEST_ASSERT_EQUAL(640 + 3 * (384 + 3) * sizeof(int16_t), ditherer.getMemoryUsage());
+
+    // Largest upload the printer takes stays a few KB
+    TEST_ASSERT_TRUE(ditherer.begin(4096, 4096, PRINTER_HEAD_DOTS, DITHER_ATKINSON));
+    TEST_ASSERT_LESS_OR_EQUAL(4096 + 3 * (PRINTER_HEAD_DOTS + 3) * 2, ditherer.getMemoryUsage());
+
+    ditherer.end();
+    TEST_ASSERT_EQUAL(0, ditherer.getMemoryUsage());
+}
+
+void test_parse_mode(void) {
+    TEST_ASSERT_EQUAL(DITHER_ATKINSON, ImageDitherer::parseMode("atkinson"));
+    TEST_ASSERT_EQUAL(DITHER_FLOYD_STEINBERG, ImageDitherer::parseMode("floyd-steinberg"));
+    TEST_ASSERT_EQUAL(DITHER_FLOYD_STEINBERG, ImageDitherer::parseMode(""));
+}
+
+static const int BENCHMARK_RUNS = 9;
+static const uint16_t BENCHMARK_ROWS = 2000;
+
+// Median rows per second over BENCHMARK_RUNS passes of a diagonal gradient,
+// sourceWidth wide, dithered to the full head width
+static double rowsPerSecond(uint16_t sourceWidth, DitherMode mode) {
+    TestImage image(sourceWidth, BENCHMARK_ROWS);
+    for (uint16_t y = 0; y < image.height; y++) {
+        for (uint16_t x = 0; x < image.width; x++) {
+            image.at(x, y) = (uint8_t)((x + y) * 255 / (image.width + image.height));
+        }
+    }
+
+    std::vector<double> rates;
+    uint8_t out[PRINTER_HEAD_DOTS / 8];
+    for (int run = 0; run < BENCHMARK_RUNS; run++) {
+        ImageDitherer ditherer;
+        TEST_ASSERT_TRUE(ditherer.begin(image.width, image.height, PRINTER_HEAD_DOTS, mode));
+        image.rowsRead = 0;
+        GrayRowSource source = image.source();
+        uint16_t rows = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        while (ditherer.nextRow(source, out)) rows++;
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        TEST_ASSERT_EQUAL(ditherer.getOutputHeight(), rows);
+        rates.push_back(rows / std::chrono::duration<double>(end - start).count());
+    }
+    std::sort(rates.begin(), rates.end());
+    return rates[rates.size() / 2];
+}
+
+void test_benchmark_rows_per_second(void) {
+    const DitherMode modes[] = {DITHER_FLOYD_STEINBERG, DITHER_ATKINSON};
+    const char* names[] = {"floyd-steinberg", "atkinson"};
+    const uint16_t widths[] = {PRINTER_HEAD_DOTS, 640};  // As printed, and downscaled from a photo
+    for (uint8_t m = 0; m < 2; m++) {
+        for (uint8_t w = 0; w < 2; w++) {
+            double rate = rowsPerSecond(widths[w], modes[m]);
+            char line[128];
+            snprintf(line, sizeof(line), "%-16s %4u -> %u dots %10.0f rows/s", names[m],
+                     (unsigned)widths[w], (unsigned)PRINTER_HEAD_DOTS, rate);
+            TEST_MESSAGE(line);
+            TEST_ASSERT_TRUE_MESSAGE(rate > 0, line);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_solid_black_and_white);
+    RUN_TEST(test_floyd_steinberg_row_by_hand);
+    RUN_TEST(test_floyd_steinberg_carries_error_down);
+    RUN_TEST(test_atkinson_row_by_hand);
+    RUN_TEST(test_mid_gray_density);
+    RUN_TEST(test_gradient_density_follows_the_gray_level);
+    RUN_TEST(test_output_size_scales_height_with_width);
+    RUN_TEST(test_downscale_reads_each_source_row_once);
+    RUN_TEST(test_upscale_repeats_source_rows);
+    RUN_TEST(test_source_ending_early_stops_output);
+    RUN_TEST(test_memory_is_bounded_by_width_not_height);
+    RUN_TEST(test_parse_mode);
+    RUN_TEST(test_benchmark_rows_per_second);
+    return UNITY_END();
+}
@@ -0,0 +1,164 @@
+// Prints through PrinterService into the ESC/POS emulator and checks the
+// paper. Each test saves its page as .pio/emulator_<name>.pbm.
+
+#include <unity.h>
+#include <Preferences.h>
+#include "PrinterService.h"
+#include "MockPrinterPort.h"
+#include "EscPosEmulator.h"
+
+static MockPrinterPort* port;
+static EscPosEmulator* paper;
+static PrinterService* printer;
+
+void setUp(void) {
+    NativeClock::reset();
+    Preferences::wipe();
+    port = new MockPrinterPort();
+    paper = new EscPosEmulator();
+    port->emulator = paper;
+    printer = new PrinterService(port);
+}
+
+void tearDown(void) {
+    delete printer;
+    delete paper;
+    delete port;
+}
+
+static bool printedLine(const char* text) {
+    const std::vector<std::string>& lines = paper->getLines();
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (lines[i].find(text) != std::string::npos) return true;
+    }
+    return false;
+}
+
+static void savePage(const char* name) {
+    String path = String(".pio/emulator_") + name + ".pbm";
+    TEST_ASSERT_TRUE_MESSAGE(paper->writePbm(path.c_str()), path.c_str());
+}
+
+void test_receipt_prints_message_and_cuts_once(void) {
+    TEST_ASSERT_TRUE(printer->printReceipt("Water the basil on the windowsill", true));
+    savePage("receipt");
+
+    TEST_ASSERT_TRUE(printedLine("Water the basil on the"));
+    TEST_ASSERT_TRUE(printedLine("windowsill"));
+    TEST_ASSERT_EQUAL(1, paper->getCuts().size());
+    TEST_ASSERT_EQUAL(paper->getPaperRows(), paper->getCuts()[0]);
+    TEST_ASSERT_GREATER_THAN(0, paper->countDots(0, paper->getPaperRows()));
+    TEST_ASSERT_EQUAL(port->model.getCuts(), paper->getCuts().size());
+}
+
+void test_receipt_text_stays_within_the_head(void) {
+    TEST_ASSERT_TRUE(printer->printReceipt(
+        "A long message that has to wrap over several lines of the receipt, "
+        "with words like internationalisation that nearly fill a line.", true));
+    savePage("receipt_wrapped");
+
+    const std::vector<std::string>& lines = paper->getLines();
+    for (size_t i = 0; i < lines.size(); i++) {
+        TEST_ASSERT_LESS_OR_EQUAL(PRINTER_COLUMNS, lines[i].size());
+    }
+    TEST_ASSERT_TRUE(printedLine("internationalisation"));
+}
+
+void test_grocery_list_prints_items_in_order(void) {
+    const String items[] = {"Milk", "Eggs", "Sourdough bread", "Tomatoes"};
+    TEST_ASSERT_TRUE(printer->printGroceryList(items, 4));
+    savePage("grocery");
+
+    // Short items share a line two to a row; order still reads across
+    std::string text;
+    for (size_t i = 0; i < paper->getLines().size(); i++) text += paper->getLines()[i] + "\n";
+    size_t at = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        at = text.find(items[i].c_str(), at);
+        TEST_ASSERT_TRUE_MESSAGE(at != std::string::npos, items[i].c_str());
+    }
+    TEST_ASSERT_EQUAL(1, paper->getCuts().size());
+}
+
+void test_bitmap_lands_dot_for_dot(void) {
+    const uint16_t width = 64;
+    const uint16_t height = 40;
+    uint8_t bitmap[width / 8 * height];
+    for (uint16_t y = 0; y < height; y++) {
+        for (uint16_t x = 0; x < width / 8; x++) {
+            bitmap[y * (width / 8) + x] = ((x + y / 8) & 1) ? 0xFF : 0x81;
+        }
+    }
+    TEST_ASSERT_TRUE(printer->printBitmap(bitmap, width, height));
+    savePage("bitmap");
+
+    // Find the raster: first row with a dot, at the alignment's left edge
+    uint32_t top = 0;
+    while (top < paper->getPaperRows() && paper->countDots(top, top + 1) == 0) top++;
+    uint16_t left = 0;
+    while (left < EscPosEmulator::WIDTH && !paper->getDot(left, top)) left++;
+
+    for (uint16_t y = 0; y < height; y++) {
+        for (uint16_t x = 0; x < width; x++) {
+            bool expected = bitmap[y * (width / 8) + x / 8] & (0x80 >> (x % 8));
+            TEST_ASSERT_EQUAL_MESSAGE(expected, paper->getDot(left + x, top + y),
+                                      (String(x) + "," + String(y)).c_str());
+        }
+    }
+}
+
+void test_receipt_downloads_user_glyphs(void) {
+    TEST_ASSERT_TRUE(printer->printReceipt("Glyphs", true));
+    TEST_ASSERT_TRUE(printer->areUserGlyphsResident());
+    bool anyDefined = false;
+    for (uint16_t code = 0x20; code < 0x100; code++) {
+        anyDefined = anyDefined || paper->isGlyphDefined(code);
+    }
+    TEST_ASSERT_TRUE(anyDefined);
+}
+
+// ESC 7 n1 n2 n3 with the given heating time, anywhere in what was sent
+static bool sentHeatingTime(uint8_t heatingTime) {
+    const std::vector<uint8_t>& bytes = port->written;
+    for (size_t i = 0; i + 4 < bytes.size(); i++) {
+        if (bytes[i] == ESCPOS_ESC && bytes[i + 1] == '7' && bytes[i + 3] == heatingTime) return true;
+    }
+    return false;
+}
+
+void test_calibration_step_goes_out_with_the_next_job(void) {
+    // Web handlers only change the saved settings; the next job sends them
+    const uint8_t times[] = PRINT_CALIBRATION_TIMES;
+    port->answering = true;  // A silent printer gets the profile with every job
+    TEST_ASSERT_TRUE(printer->refreshStatus());
+    TEST_ASSERT_TRUE(printer->printReceipt("Before", true));
+    TEST_ASSERT_TRUE(printer->selectCalibrationStep(2));
+    TEST_ASSERT_EQUAL(PRINT_PROFILE_CALIBRATED, printer->getDefaultProfile());
+
+    port->clear();
+    TEST_ASSERT_TRUE(printer->printReceipt("Calibrated", true));
+    TEST_ASSERT_TRUE(sentHeatingTime(times[1]));
+    TEST_ASSERT_TRUE(printer->getProfileJSON().indexOf("\"applied\":\"calibrated\"") >= 0);
+
+    // Another step keeps the profile but changes the time, so it is resent
+    TEST_ASSERT_TRUE(printer->selectCalibrationStep(4));
+    port->clear();
+    TEST_ASSERT_TRUE(printer->printReceipt("Recalibrated", true));
+    TEST_ASSERT_TRUE(sentHeatingTime(times[3]));
+
+    // Unchanged settings are not sent again
+    port->clear();
+    TEST_ASSERT_TRUE(printer->printReceipt("Same again", true));
+    TEST_ASSERT_FALSE(sentHeatingTime(times[3]));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_receipt_prints_message_and_cuts_once);
+    RUN_TEST(test_receipt_text_stays_within_the_head);
+    RUN_TEST(test_grocery_list_prints_items_in_order);
+    RUN_TEST(test_bitmap_lands_dot_for_dot);
+    RUN_TEST(test_receipt_downloads_user_glyphs);
+    RUN_TEST(test_calibration_step_goes_out_with_the_next_job);
+    return UNITY_END();
+}
@@ -0,0 +1,142 @@
+#ifndef BASELINE_JOBS_H
+#define BASELINE_JOBS_H
+
+#include <stdint.h>
+
+// What the printer received from PrinterService before jobs were buffered:
+// every command and line went out as separate HardwareSerial writes with
+// fixed delay() calls in between. Generated by building that PrinterService
+// (commit bb0999d) on the host against a recording HAL on a 9600 baud
+// UART with no TX ring buffer (writes block while the 128-byte FIFO is
+// full), moisture 42.0 and sanitizer 87.5, no SNTP time.
+//
+// The helpers are single commands; the jobs are whole printTest() /
+// printReceipt() / printGroceryList() calls. Their timing is when the old
+// call returned (delays plus FIFO stalls) and when the last byte reached
+// the printer.
+
+struct BaselineTiming {
+    uint32_t returnedMs;
+    uint32_t sentMs;
+};
+
+// INITIALIZE: 7 bytes
+static const uint8_t BASELINE_INITIALIZE[] = {
+    0x1B, 0x40, 0x1B, 0x74, 0x00, 0x1B, 0x32,
+};
+
+// CENTER_ALIGN: 3 bytes
+static const uint8_t BASELINE_CENTER_ALIGN[] = {
+    0x1B, 0x61, 0x01,
+};
+
+// LEFT_ALIGN: 3 bytes
+static const uint8_t BASELINE_LEFT_ALIGN[] = {
+    0x1B, 0x61, 0x00,
+};
+
+// DOUBLE_HEIGHT: 3 bytes
+static const uint8_t BASELINE_DOUBLE_HEIGHT[] = {
+    0x1B, 0x21, 0x10,
+};
+
+// EXTRA_LARGE: 3 bytes
+static const uint8_t BASELINE_EXTRA_LARGE[] = {
+    0x1B, 0x21, 0x30,
+};
+
+// NORMAL_SIZE: 3 bytes
+static const uint8_t BASELINE_NORMAL_SIZE[] = {
+    0x1B, 0x21, 0x00,
+};
+
+// CUT_PAPER: 3 bytes
+static const uint8_t BASELINE_CUT_PAPER[] = {
+    0x1D, 0x56, 0x00,
+};
+
+// LINE_SPACING_24: 3 bytes
+static const uint8_t BASELINE_LINE_SPACING_24[] = {
+    0x1B, 0x33, 0x18,
+};
+
+// BOLD_ON: 3 bytes
+static const uint8_t BASELINE_BOLD_ON[] = {
+    0x1B, 0x45, 0x01,
+};
+
+// UNDERLINE_2: 3 bytes
+static const uint8_t BASELINE_UNDERLINE_2[] = {
+    0x1B, 0x2D, 0x02,
+};
+
+// INVERSE_ON: 3 bytes
+static const uint8_t BASELINE_INVERSE_ON[] = {
+    0x1D, 0x42, 0x01,
+};
+
+// PRINT_TEST: 80 bytes, caller blocked 100 ms, last byte at the printer after 83 ms
+static const uint8_t BASELINE_PRINT_TEST[] = {
+    0x54, 0x45, 0x53, 0x54, 0x0D, 0x0A, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x30,
+    0x0D, 0x0A, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E,
+    0x4F, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x0D, 0x0A, 0x61, 0x62,
+    0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F, 0x70, 0x71, 0x72,
+    0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x0D, 0x0A, 0x0D, 0x0A, 0x0D, 0x0A, 0x0D, 0x0A,
+};
+static const BaselineTiming BASELINE_PRINT_TEST_TIMING = {100, 83};
+
+// RECEIPT: 259 bytes, caller blocked 600 ms, last byte at the printer after 503 ms
+static const uint8_t BASELINE_RECEIPT[] = {
+    0x1B, 0x40, 0x1B, 0x74, 0x00, 0x1B, 0x32, 0x1B, 0x61, 0x01, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x0D, 0x0A, 0x1B, 0x45, 0x01, 0x53,
+    0x4D, 0x49, 0x54, 0x27, 0x53, 0x20, 0x4D, 0x45, 0x53, 0x53, 0x41, 0x47, 0x45, 0x0D, 0x0A, 0x1B,
+    0x45, 0x00, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x0D, 0x0A, 0x1B, 0x61, 0x00, 0x0D, 0x0A, 0x1B, 0x61, 0x01, 0x57, 0x61, 0x74, 0x65,
+    0x72, 0x20, 0x74, 0x68, 0x65, 0x20, 0x62, 0x61, 0x73, 0x69, 0x6C, 0x0D, 0x0A, 0x2D, 0x2D, 0x2D,
+    0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D,
+    0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x2D, 0x0D, 0x0A, 0x1B,
+    0x61, 0x00, 0x54, 0x6F, 0x64, 0x61, 0x79, 0x27, 0x73, 0x20, 0x57, 0x65, 0x61, 0x74, 0x68, 0x65,
+    0x72, 0x3A, 0x0D, 0x0A, 0x20, 0x20, 0x4E, 0x2F, 0x41, 0x0D, 0x0A, 0x4D, 0x6F, 0x69, 0x73, 0x74,
+    0x75, 0x72, 0x65, 0x3A, 0x20, 0x34, 0x32, 0x2E, 0x30, 0x25, 0x20, 0x20, 0x53, 0x61, 0x6E, 0x69,
+    0x74, 0x69, 0x7A, 0x65, 0x72, 0x3A, 0x20, 0x38, 0x37, 0x2E, 0x35, 0x25, 0x0D, 0x0A, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x0D, 0x0A,
+    0x1D, 0x56, 0x00,
+};
+static const BaselineTiming BASELINE_RECEIPT_TIMING = {600, 503};
+
+// REMINDER: 153 bytes, caller blocked 380 ms, last byte at the printer after 283 ms
+static const uint8_t BASELINE_REMINDER[] = {
+    0x1B, 0x40, 0x1B, 0x74, 0x00, 0x1B, 0x32, 0x1B, 0x61, 0x01, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x0D, 0x0A, 0x1B, 0x45, 0x01, 0x52,
+    0x45, 0x4D, 0x49, 0x4E, 0x44, 0x45, 0x52, 0x0D, 0x0A, 0x1B, 0x45, 0x00, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x0D, 0x0A, 0x1B, 0x61,
+    0x01, 0x54, 0x61, 0x6B, 0x65, 0x20, 0x6F, 0x75, 0x74, 0x20, 0x74, 0x68, 0x65, 0x20, 0x62, 0x69,
+    0x6E, 0x73, 0x0D, 0x0A, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x0D, 0x0A, 0x1D, 0x56, 0x00,
+};
+static const BaselineTiming BASELINE_REMINDER_TIMING = {380, 283};
+
+// GROCERY_LIST: 191 bytes, caller blocked 460 ms, last byte at the printer after 363 ms
+static const uint8_t BASELINE_GROCERY_LIST[] = {
+    0x1B, 0x40, 0x1B, 0x74, 0x00, 0x1B, 0x32, 0x1B, 0x61, 0x01, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x0D, 0x0A, 0x1B, 0x45, 0x01, 0x47,
+    0x52, 0x4F, 0x43, 0x45, 0x52, 0x59, 0x20, 0x4C, 0x49, 0x53, 0x54, 0x0D, 0x0A, 0x1B, 0x45, 0x00,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x0D, 0x0A, 0x1B, 0x61, 0x00, 0x0D, 0x0A, 0x31, 0x2E, 0x20, 0x4D, 0x69, 0x6C, 0x6B, 0x0D, 0x0A,
+    0x32, 0x2E, 0x20, 0x45, 0x67, 0x67, 0x73, 0x0D, 0x0A, 0x33, 0x2E, 0x20, 0x53, 0x6F, 0x75, 0x72,
+    0x64, 0x6F, 0x75, 0x67, 0x68, 0x20, 0x62, 0x72, 0x65, 0x61, 0x64, 0x0D, 0x0A, 0x34, 0x2E, 0x20,
+    0x54, 0x6F, 0x6D, 0x61, 0x74, 0x6F, 0x65, 0x73, 0x0D, 0x0A, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D,
+    0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x3D, 0x0D, 0x0A, 0x1D, 0x56, 0x00,
+};
+static const BaselineTiming BASELINE_GROCERY_LIST_TIMING = {460, 363};
+
+#endif // BASELINE_JOBS_H
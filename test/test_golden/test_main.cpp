@@ -0,0 +1,235 @@
+// Buffered jobs against what the old byte-per-write PrinterService sent
+// (baseline_jobs.h). Commands must encode byte for byte the same and
+// whole jobs print the same paper. The timing tests report when each job
+// is on the wire and when the call returns, next to the delay() path.
+
+#include <unity.h>
+#include <Preferences.h>
+#include <functional>
+#include "PrinterService.h"
+#include "PrintProfiles.h"
+#include "MockPrinterPort.h"
+#include "EscPosEmulator.h"
+#include "baseline_jobs.h"
+
+static MockPrinterPort* port;
+static PrinterService* printer;
+
+void setUp(void) {
+    NativeClock::reset();
+    Preferences::wipe();
+    port = new MockPrinterPort();
+    printer = new PrinterService(port);
+}
+
+void tearDown(void) {
+    delete printer;
+    delete port;
+}
+
+static void assertBytes(const uint8_t* expected, size_t expectedLength, const uint8_t* actual, size_t actualLength) {
+    TEST_ASSERT_EQUAL(expectedLength, actualLength);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, actual, expectedLength);
+}
+
+#define ASSERT_ENCODES(baseline, encoder) \
+    assertBytes(baseline, sizeof(baseline), (encoder).data(), (encoder).size())
+
+void test_commands_encode_like_the_baseline(void) {
+    EscPosEncoder job;
+    job.initialize().codePage(0).defaultLineSpace();
+    ASSERT_ENCODES(BASELINE_INITIALIZE, job);
+
+    const struct {
+        const uint8_t* baseline;
+        size_t length;
+        std::function<void(EscPosEncoder&)> encode;
+    } commands[] = {
+        {BASELINE_CENTER_ALIGN, sizeof(BASELINE_CENTER_ALIGN), [](EscPosEncoder& e) { e.align(1); }},
+        {BASELINE_LEFT_ALIGN, sizeof(BASELINE_LEFT_ALIGN), [](EscPosEncoder& e) { e.align(0); }},
+        {BASELINE_DOUBLE_HEIGHT, sizeof(BASELINE_DOUBLE_HEIGHT), [](EscPosEncoder& e) { e.printMode(16); }},
+        {BASELINE_EXTRA_LARGE, sizeof(BASELINE_EXTRA_LARGE), [](EscPosEncoder& e) { e.printMode(48); }},
+        {BASELINE_NORMAL_SIZE, sizeof(BASELINE_NORMAL_SIZE), [](EscPosEncoder& e) { e.printMode(0); }},
+        {BASELINE_CUT_PAPER, sizeof(BASELINE_CUT_PAPER), [](EscPosEncoder& e) { e.cut(); }},
+        {BASELINE_LINE_SPACING_24, sizeof(BASELINE_LINE_SPACING_24), [](EscPosEncoder& e) { e.lineSpacing(24); }},
+        {BASELINE_BOLD_ON, sizeof(BASELINE_BOLD_ON), [](EscPosEncoder& e) { e.bold(true); }},
+        {BASELINE_UNDERLINE_2, sizeof(BASELINE_UNDERLINE_2), [](EscPosEncoder& e) { e.underline(2); }},
+        {BASELINE_INVERSE_ON, sizeof(BASELINE_INVERSE_ON), [](EscPosEncoder& e) { e.inverse(true); }},
+    };
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        job.reset();
+        commands[i].encode(job);
+        assertBytes(commands[i].baseline, commands[i].length, job.data(), job.size());
+    }
+}
+
+void test_print_test_sends_the_baseline_bytes(void) {
+    // The first job also carries the default heating profile
+    EscPosEncoder profile;
+    PrintProfiles::encode(PrintProfiles::preset(PRINTER_DEFAULT_PROFILE), profile);
+
+    TEST_ASSERT_TRUE(printer->printTest());
+    TEST_ASSERT_EQUAL(1, port->writes);
+    assertBytes(profile.data(), profile.size(), port->written.data(), profile.size());
+    assertBytes(BASELINE_PRINT_TEST, sizeof(BASELINE_PRINT_TEST),
+                port->written.data() + profile.size(), port->written.size() - profile.size());
+
+    port->clear();
+    TEST_ASSERT_TRUE(printer->printTest());
+    assertBytes(BASELINE_PRINT_TEST, sizeof(BASELINE_PRINT_TEST), port->written.data(), port->written.size());
+}
+
+// Prints the job and the baseline's bytes on two emulated printers
+struct Comparison {
+    EscPosEmulator baseline;
+    EscPosEmulator current;
+
+    Comparison(const uint8_t* baselineBytes, size_t length, const std::function<bool()>& print) {
+        baseline.feed(baselineBytes, length);
+        port->emulator = &current;
+        TEST_ASSERT_TRUE(print());
+        port->emulator = nullptr;
+    }
+
+    bool samePaper() const {
+        if (baseline.getPaperRows() != current.getPaperRows()) return false;
+        for (uint32_t y = 0; y < baseline.getPaperRows(); y++) {
+            for (uint16_t x = 0; x < EscPosEmulator::WIDTH; x++) {
+                if (baseline.getDot(x, y) != current.getDot(x, y)) return false;
+            }
+        }
+        return baseline.getCuts() == current.getCuts();
+    }
+};
+
+void test_reminder_prints_the_same_paper(void) {
+    Comparison paper(BASELINE_REMINDER, sizeof(BASELINE_REMINDER),
+                     []() { return printer->printReceipt("Take out the bins", false); });
+    TEST_ASSERT_TRUE(paper.samePaper());
+}
+
+void test_receipt_prints_the_same_lines(void) {
+    Comparison paper(BASELINE_RECEIPT, sizeof(BASELINE_RECEIPT),
+                     []() { return printer->printReceipt("Water the basil", true); });
+
+    // Same lines and length; the sensor line now wraps between words
+    // instead of wherever the printer ran out of columns
+    const std::vector<std::string>& before = paper.baseline.getLines();
+    const std::vector<std::string>& after = paper.current.getLines();
+    TEST_ASSERT_EQUAL(before.size(), after.size());
+    for (size_t i = 0; i < before.size(); i++) {
+        if (before[i].compare(0, 9, "Moisture:") == 0) {
+            TEST_ASSERT_EQUAL_STRING("Moisture: 42.0%  Sanitizer:", after[i].c_str());
+            TEST_ASSERT_EQUAL_STRING("87.5%", after[++i].c_str());
+            continue;
+        }
+        TEST_ASSERT_EQUAL_STRING(before[i].c_str(), after[i].c_str());
+    }
+    TEST_ASSERT_EQUAL(paper.baseline.getPaperRows(), paper.current.getPaperRows());
+    TEST_ASSERT_TRUE(paper.baseline.getCuts() == paper.current.getCuts());
+}
+
+void test_grocery_list_prints_the_same_items(void) {
+    const String items[] = {"Milk", "Eggs", "Sourdough bread", "Tomatoes"};
+    Comparison paper(BASELINE_GROCERY_LIST, sizeof(BASELINE_GROCERY_LIST),
+                     [&]() { return printer->printGroceryList(items, 4); });
+
+    // Header identical; short items now pair up, so the list is shorter
+    for (size_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_STRING(paper.baseline.getLines()[i].c_str(), paper.current.getLines()[i].c_str());
+    }
+    std::string text;
+    for (size_t i = 0; i < paper.current.getLines().size(); i++) text += paper.current.getLines()[i] + "\n";
+    size_t at = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        at = text.find((String(i + 1) + ". " + items[i]).c_str(), at);
+        TEST_ASSERT_TRUE_MESSAGE(at != std::string::npos, items[i].c_str());
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(paper.baseline.getPaperRows(), paper.current.getPaperRows());
+    TEST_ASSERT_EQUAL(1, paper.current.getCuts().size());
+}
+
+static uint32_t wireMs(size_t bytes) {
+    return (uint32_t)(bytes * 10 * 1000 / THERMAL_PRINTER_BAUD);
+}
+
+// One job timed the way the baseline was: when the call returns and when
+// the last byte reaches the printer. Returns the sent time.
+static uint32_t timeJob(const char* name, const BaselineTiming& baseline, const std::function<bool()>& print,
+                        uint32_t* returned = nullptr) {
+    port->clear();
+    unsigned long start = millis();
+    TEST_ASSERT_TRUE(print());
+    uint32_t returnedMs = millis() - start;
+    uint32_t sentMs = (uint32_t)(port->lastByteAtUs / 1000) - start;
+
+    char line[160];
+    snprintf(line, sizeof(line), "%-13s %4u bytes  sent %4u ms (was %4u)  returned %4u ms (was %4u)",
+             name, (unsigned)port->written.size(), (unsigned)sentMs, (unsigned)baseline.sentMs,
+             (unsigned)returnedMs, (unsigned)baseline.returnedMs);
+    TEST_MESSAGE(line);
+
+    // One write, so the wire never idles between lines
+    TEST_ASSERT_EQUAL(1, port->writes);
+    TEST_ASSERT_UINT32_WITHIN(1, wireMs(port->written.size()), sentMs);
+    if (returned) *returned = returnedMs;
+    return sentMs;
+}
+
+void test_jobs_reach_the_printer_sooner_than_with_delays(void) {
+    // Steady state on a printer that answers status: glyphs and heating
+    // profile already sent. The call now returns once the paper is printed
+    // (GS r reply), where the old one returned while the printer was busy.
+    port->answering = true;
+    printer->refreshStatus();
+    printer->printReceipt("Warm up", false);
+
+    const String items[] = {"Milk", "Eggs", "Sourdough bread", "Tomatoes"};
+    // The old printTest had no delays between lines either; it only gains
+    // the 3-byte GS r request
+    uint32_t testMs = timeJob("print-test", BASELINE_PRINT_TEST_TIMING, []() { return printer->printTest(); });
+    TEST_ASSERT_LESS_OR_EQUAL(BASELINE_PRINT_TEST_TIMING.sentMs + wireMs(3), testMs);
+
+    uint32_t receiptMs = timeJob("receipt", BASELINE_RECEIPT_TIMING,
+                                 []() { return printer->printReceipt("Water the basil", true); });
+    uint32_t reminderMs = timeJob("reminder", BASELINE_REMINDER_TIMING,
+                                  []() { return printer->printReceipt("Take out the bins", false); });
+    uint32_t groceryMs = timeJob("grocery-list", BASELINE_GROCERY_LIST_TIMING,
+                                 [&]() { return printer->printGroceryList(items, 4); });
+    TEST_ASSERT_LESS_THAN(BASELINE_RECEIPT_TIMING.sentMs, receiptMs);
+    TEST_ASSERT_LESS_THAN(BASELINE_REMINDER_TIMING.sentMs, reminderMs);
+    TEST_ASSERT_LESS_THAN(BASELINE_GROCERY_LIST_TIMING.sentMs, groceryMs);
+}
+
+void test_silent_printer_waits_only_for_the_uart(void) {
+    // No status replies: the call returns once the UART has drained. The
+    // glyphs go along with every job in case the printer was power cycled,
+    // so a short job can take longer than the old delay() path did.
+    const String items[] = {"Milk", "Eggs", "Sourdough bread", "Tomatoes"};
+    const struct {
+        const char* name;
+        const BaselineTiming& baseline;
+        std::function<bool()> print;
+    } jobs[] = {
+        {"receipt", BASELINE_RECEIPT_TIMING, []() { return printer->printReceipt("Water the basil", true); }},
+        {"reminder", BASELINE_REMINDER_TIMING, []() { return printer->printReceipt("Take out the bins", false); }},
+        {"grocery-list", BASELINE_GROCERY_LIST_TIMING, [&]() { return printer->printGroceryList(items, 4); }},
+    };
+    for (size_t i = 0; i < sizeof(jobs) / sizeof(jobs[0]); i++) {
+        uint32_t returnedMs = 0;
+        uint32_t sentMs = timeJob(jobs[i].name, jobs[i].baseline, jobs[i].print, &returnedMs);
+        TEST_ASSERT_EQUAL(sentMs, returnedMs);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_commands_encode_like_the_baseline);
+    RUN_TEST(test_print_test_sends_the_baseline_bytes);
+    RUN_TEST(test_reminder_prints_the_same_paper);
+    RUN_TEST(test_receipt_prints_the_same_lines);
+    RUN_TEST(test_grocery_list_prints_the_same_items);
+    RUN_TEST(test_jobs_reach_the_printer_sooner_than_with_delays);
+    RUN_TEST(test_silent_printer_waits_only_for_the_uart);
+    return UNITY_END();
+}
@@ -0,0 +1,175 @@
+// IconAtlas: every icon decodes to a full 24x24 image, the LRU cache keeps
+// the most recently used ICON_CACHE_SLOTS icons, and a host benchmark of
+// cache hits against misses.
+
+#include <unity.h>
+#include <Preferences.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "IconAtlas.h"
+#include "PrinterService.h"
+#include "MockPrinterPort.h"
+#include "EscPosEmulator.h"
+
+static const uint32_t ICONS[] = {0x023F0, 0x02705, 0x1F381, 0x1F388, 0x1F389, 0x1F6D2};
+static const size_t ICON_COUNT = sizeof(ICONS) / sizeof(ICONS[0]);
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static uint32_t dots(const uint8_t* columns) {
+    uint32_t count = 0;
+    for (size_t i = 0; i < ICON_BYTES; i++) {
+        for (uint8_t b = columns[i]; b; b &= b - 1) count++;
+    }
+    return count;
+}
+
+void test_every_icon_unpacks_to_72_bytes(void) {
+    // get() only returns columns when PackBits produced exactly ICON_BYTES
+    TEST_ASSERT_EQUAL(72, ICON_BYTES);
+    std::vector<std::vector<uint8_t> > decoded;
+    for (size_t i = 0; i < ICON_COUNT; i++) {
+        IconAtlas atlas;
+        TEST_ASSERT_TRUE(IconAtlas::contains(ICONS[i]));
+        const uint8_t* columns = atlas.get(ICONS[i]);
+        TEST_ASSERT_NOT_NULL(columns);
+        // Something drawn, not a solid block
+        TEST_ASSERT_GREATER_THAN(20, dots(columns));
+        TEST_ASSERT_LESS_THAN(ICON_BYTES * 8 - 20, dots(columns));
+        decoded.push_back(std::vector<uint8_t>(columns, columns + ICON_BYTES));
+    }
+    for (size_t i = 0; i < ICON_COUNT; i++) {
+        for (size_t j = i + 1; j < ICON_COUNT; j++) {
+            TEST_ASSERT_FALSE(decoded[i] == decoded[j]);
+        }
+    }
+}
+
+void test_codepoints_without_icons(void) {
+    IconAtlas atlas;
+    const uint32_t others[] = {0, 'A', 0x023EF, 0x023F1, 0x1F6D1, 0x1F6D3, 0x1F600, 0x10FFFF};
+    for (size_t i = 0; i < sizeof(others) / sizeof(others[0]); i++) {
+        TEST_ASSERT_FALSE(IconAtlas::contains(others[i]));
+        TEST_ASSERT_NULL(atlas.get(others[i]));
+    }
+    TEST_ASSERT_EQUAL(0, atlas.getCacheHits() + atlas.getCacheMisses());
+    TEST_ASSERT_EQUAL(0, atlas.getIconsPrinted());
+}
+
+void test_cache_hits_return_the_same_columns(void) {
+    IconAtlas atlas;
+    std::vector<uint8_t> first(atlas.get(ICONS[0]), atlas.get(ICONS[0]) + ICON_BYTES);
+    for (int i = 0; i < 10; i++) {
+        const uint8_t* again = atlas.get(ICONS[0]);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(first.data(), again, ICON_BYTES);
+    }
+    TEST_ASSERT_EQUAL(1, atlas.getCacheMisses());
+    TEST_ASSERT_EQUAL(11, atlas.getCacheHits());
+}
+
+void test_cache_evicts_the_least_recently_used(void) {
+    IconAtlas atlas;
+    for (uint8_t i = 0; i < ICON_CACHE_SLOTS; i++) atlas.get(ICONS[i]);
+    TEST_ASSERT_EQUAL(ICON_CACHE_SLOTS, atlas.getCacheMisses());
+
+    atlas.get(ICONS[0]);                     // Refresh the oldest
+    atlas.get(ICONS[ICON_CACHE_SLOTS]);      // Evicts ICONS[1]
+    TEST_ASSERT_EQUAL(ICON_CACHE_SLOTS + 1, atlas.getCacheMisses());
+
+    uint32_t hits = atlas.getCacheHits();
+    atlas.get(ICONS[0]);
+    for (uint8_t i = 2; i <= ICON_CACHE_SLOTS; i++) atlas.get(ICONS[i]);
+    TEST_ASSERT_EQUAL(hits + ICON_CACHE_SLOTS, atlas.getCacheHits());
+    TEST_ASSERT_EQUAL(ICON_CACHE_SLOTS + 1, atlas.getCacheMisses());
+
+    atlas.get(ICONS[1]);
+    TEST_ASSERT_EQUAL(ICON_CACHE_SLOTS + 2, atlas.getCacheMisses());
+}
+
+void test_byte_counters(void) {
+    IconAtlas atlas;
+    atlas.get(0x023F0);   // [ALARM]
+    atlas.get(0x1F6D2);   // [CART]
+    atlas.get(0x023F0);
+    TEST_ASSERT_EQUAL(3, atlas.getIconsPrinted());
+    TEST_ASSERT_EQUAL(3 * (5 + ICON_BYTES), atlas.getIconBytes());   // ESC * 33 nL nH + columns
+    TEST_ASSERT_EQUAL(7 + 6 + 7, atlas.getReplacementBytes());
+}
+
+void test_receipt_prints_icons_inline(void) {
+    if (!PRINTER_INLINE_ICONS) {
+        TEST_IGNORE_MESSAGE("PRINTER_INLINE_ICONS is off");
+    }
+    NativeClock::reset();
+    Preferences::wipe();
+    MockPrinterPort port;
+    EscPosEmulator paper;
+    port.emulator = &paper;
+    PrinterService printer(&port);
+    TEST_ASSERT_TRUE(printer.printReceipt("Shop \xF0\x9F\x9B\x92 then party \xF0\x9F\x8E\x89", true));
+
+    bool found = false;
+    for (size_t i = 0; i < paper.getLines().size(); i++) {
+        found = found || paper.getLines()[i].find("Shop # then party #") != std::string::npos;
+    }
+    TEST_ASSERT_TRUE(found);
+}
+
+template <class F>
+static double nsPerGet(F run, int gets) {
+    std::vector<double> times;
+    for (int i = 0; i < 21; i++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        run();
+        times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2] / gets;
+}
+
+void test_benchmark_cache_hits_and_misses(void) {
+    const int gets = 10000;
+    volatile uint8_t sink = 0;
+
+    // One icon over and over: all hits after the first
+    IconAtlas hitAtlas;
+    double hitNs = nsPerGet([&]() {
+        for (int i = 0; i < gets; i++) sink = sink + hitAtlas.get(ICONS[0])[0];
+    }, gets);
+
+    // One more icon than slots, round robin: LRU misses every time
+    IconAtlas missAtlas;
+    double missNs = nsPerGet([&]() {
+        for (int i = 0; i < gets; i++) sink = sink + missAtlas.get(ICONS[i % (ICON_CACHE_SLOTS + 1)])[0];
+    }, gets);
+    TEST_ASSERT_EQUAL(0, missAtlas.getCacheHits());
+
+    // A message-like mix: mostly a couple of favourites
+    IconAtlas mixAtlas;
+    const uint8_t mix[] = {0, 0, 1, 0, 2, 0, 1, 3, 0, 4, 0, 1, 5, 0, 1, 0};
+    double mixNs = nsPerGet([&]() {
+        for (int i = 0; i < gets; i++) sink = sink + mixAtlas.get(ICONS[mix[i % sizeof(mix)]])[0];
+    }, gets);
+    uint32_t mixHitPercent = mixAtlas.getCacheHits() * 100 / (mixAtlas.getCacheHits() + mixAtlas.getCacheMisses());
+
+    char line[128];
+    snprintf(line, sizeof(line), "hit %.1f ns/get, miss %.1f ns/get, message mix %.1f ns/get (%u%% hits)",
+             hitNs, missNs, mixNs, (unsigned)mixHitPercent);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_TRUE_MESSAGE(hitNs < missNs, line);
+    TEST_ASSERT_GREATER_OR_EQUAL(70, mixHitPercent);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_every_icon_unpacks_to_72_bytes);
+    RUN_TEST(test_codepoints_without_icons);
+    RUN_TEST(test_cache_hits_return_the_same_columns);
+    RUN_TEST(test_cache_evicts_the_least_recently_used);
+    RUN_TEST(test_byte_counters);
+    RUN_TEST(test_receipt_prints_icons_inline);
+    RUN_TEST(test_benchmark_cache_hits_and_misses);
+    return UNITY_END();
+}
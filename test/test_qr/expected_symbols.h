@@ -0,0 +1,230 @@
+// Reference symbols for QrEncoder, made with the python "qrcode" package
+// (8.2) in byte mode. Each row is one line of modules, leftmost module in
+// the highest bit (bit size - 1), 1 = dark.
+//
+// Mask choice is left to the encoder by the standard and the reference
+// scores finder-like patterns at the edge differently, so the reference
+// was run with the mask QrEncoder picks (noted per symbol); everything
+// else - version, codewords, ECC, placement, format and version info - is
+// the reference's own.
+
+#ifndef EXPECTED_SYMBOLS_H
+#define EXPECTED_SYMBOLS_H
+
+#include <stdint.h>
+#include "QrEncoder.h"
+
+struct ExpectedSymbol {
+    const char* name;
+    QrErrorCorrection ecc;
+    const char* data;
+    uint16_t length;
+    uint8_t version;
+    const uint64_t* rows;
+};
+
+// hello_m: version 1, mask 4
+static const uint64_t SYMBOL_HELLO_M[21] = {
+    0x00000000001FDA7FULL, 0x0000000000104D41ULL, 0x0000000000174F5DULL,
+    0x000000000017525DULL, 0x000000000017515DULL, 0x0000000000105641ULL,
+    0x00000000001FD57FULL, 0x0000000000001F00ULL, 0x0000000000117EF9ULL,
+    0x000000000003972FULL, 0x0000000000165672ULL, 0x00000000001C88D0ULL,
+    0x000000000005C9C6ULL, 0x0000000000001DCBULL, 0x00000000001FD98AULL,
+    0x0000000000104322ULL, 0x0000000000175275ULL, 0x000000000017430BULL,
+    0x0000000000174E78ULL, 0x00000000001048C0ULL, 0x00000000001FD1F5ULL
+};
+
+// url_l: version 2, mask 6
+static const uint64_t SYMBOL_URL_L[25] = {
+    0x0000000001FD347FULL, 0x000000000104C141ULL, 0x0000000001745D5DULL,
+    0x000000000174195DULL, 0x000000000174AD5DULL, 0x0000000001045541ULL,
+    0x0000000001FD557FULL, 0x0000000000016B00ULL, 0x0000000001B4E941ULL,
+    0x0000000001139FBEULL, 0x00000000012C6BB9ULL, 0x0000000000D0F8EFULL,
+    0x0000000001CFBB61ULL, 0x0000000001400F12ULL, 0x0000000001AC3B5FULL,
+    0x00000000017220EDULL, 0x00000000015645F6ULL, 0x0000000000017D16ULL,
+    0x0000000001FC2151ULL, 0x000000000104D712ULL, 0x0000000001759FF1ULL,
+    0x00000000017545C3ULL, 0x000000000174969FULL, 0x000000000105C637ULL,
+    0x0000000001FD4D49ULL
+};
+
+// repeat_h: version 2, mask 1
+static const uint64_t SYMBOL_REPEAT_H[25] = {
+    0x0000000001FC077FULL, 0x0000000001051441ULL, 0x000000000175B55DULL,
+    0x0000000001752F5DULL, 0x000000000175EB5DULL, 0x0000000001058541ULL,
+    0x0000000001FD557FULL, 0x0000000000008B00ULL, 0x00000000004F9DBEULL,
+    0x00000000014A3620ULL, 0x000000000054F2D5ULL, 0x0000000000F2568AULL,
+    0x00000000007ED0FFULL, 0x0000000000E39420ULL, 0x0000000001BE7215ULL,
+    0x00000000001A104AULL, 0x0000000001F7ABFFULL, 0x0000000000011110ULL,
+    0x0000000001FDF355ULL, 0x000000000105E719ULL, 0x0000000001748DFEULL,
+    0x00000000017429C0ULL, 0x000000000175FCD7ULL, 0x0000000001040628ULL,
+    0x0000000001FC5B7DULL
+};
+
+// wifi_q: version 3, mask 3
+static const uint64_t SYMBOL_WIFI_Q[29] = {
+    0x000000001FC9B27FULL, 0x000000001059DC41ULL, 0x00000000175DA45DULL,
+    0x0000000017467E5DULL, 0x00000000174AF65DULL, 0x000000001040FB41ULL,
+    0x000000001FD5557FULL, 0x00000000000DBC00ULL, 0x000000000EC47106ULL,
+    0x000000000E9B6EF6ULL, 0x0000000012D4010AULL, 0x00000000160677A2ULL,
+    0x000000001B6B30B8ULL, 0x00000000003116C3ULL, 0x000000001ED20F51ULL,
+    0x000000000E979F48ULL, 0x00000000117B5EB4ULL, 0x000000000C8491ABULL,
+    0x000000001342F1E0ULL, 0x0000000003310864ULL, 0x0000000008F2CBF6ULL,
+    0x000000000012711AULL, 0x000000001FC8DB52ULL, 0x00000000105FA511ULL,
+    0x000000001744A5F2ULL, 0x0000000017571592ULL, 0x00000000175DFB4DULL,
+    0x00000000105195BAULL, 0x000000001FC5BF7AULL
+};
+
+// letters_m: version 4, mask 0
+static const uint64_t SYMBOL_LETTERS_M[33] = {
+    0x00000001FC4AAA7FULL, 0x000000010546AA41ULL, 0x0000000174AD555DULL,
+    0x00000001747C555DULL, 0x0000000175FDAA5DULL, 0x00000001045AAA41ULL,
+    0x00000001FD55557FULL, 0x0000000000BAAA00ULL, 0x0000000154EAAA12ULL,
+    0x00000001A0FD554DULL, 0x000000014FF55517ULL, 0x00000000B13EAAB2ULL,
+    0x0000000186B6AAE8ULL, 0x0000000168ED554DULL, 0x00000001BD6D5517ULL,
+    0x00000000624AAAB2ULL, 0x000000011D8AAAE8ULL, 0x00000000C365554DULL,
+    0x00000001A7495517ULL, 0x000000007806AAB2ULL, 0x0000000136CEAAE8ULL,
+    0x000000003BA9554DULL, 0x000000010C855517ULL, 0x00000000D146AAB2ULL,
+    0x00000001161AABFAULL, 0x000000000189551DULL, 0x00000001FC255757ULL,
+    0x00000001043AA912ULL, 0x0000000175F6A9F8ULL, 0x000000017465561DULL,
+    0x00000001755954B5ULL, 0x000000010416A9E2ULL, 0x00000001FD92AB4BULL
+};
+
+// sentence_l: version 5, mask 7
+static const uint64_t SYMBOL_SENTENCE_L[37] = {
+    0x0000001FC9E22E7FULL, 0x0000001053F9B341ULL, 0x000000175F4D305DULL,
+    0x000000174E64775DULL, 0x0000001750F0AF5DULL, 0x000000105A2A8A41ULL,
+    0x0000001FD555557FULL, 0x00000000197DA700ULL, 0x0000001A6495B976ULL,
+    0x00000016AE098841ULL, 0x00000017D4178C0BULL, 0x0000001A90E1DC02ULL,
+    0x0000001261EB9841ULL, 0x00000009930358E9ULL, 0x000000017510F4DDULL,
+    0x00000018B98EEB82ULL, 0x000000125EFBB0E5ULL, 0x0000000BB055BD59ULL,
+    0x0000001BF4895519ULL, 0x0000000B1EB8F4C4ULL, 0x0000001DFF53AC51ULL,
+    0x000000183799B56FULL, 0x00000001F3C295EFULL, 0x0000001FBFB48D88ULL,
+    0x00000018467B9BC0ULL, 0x000000090ECF8CEFULL, 0x00000011EAD4F135ULL,
+    0x0000000F16299E02ULL, 0x00000019E18FF5F7ULL, 0x0000000015C02F1AULL,
+    0x0000001FD3458753ULL, 0x000000104D689317ULL, 0x000000174010BDFAULL,
+    0x000000175A5CD918ULL, 0x000000174403C897ULL, 0x000000105060FD00ULL,
+    0x0000001FD93BBB63ULL
+};
+
+// letters_q: version 5, mask 1
+static const uint64_t SYMBOL_LETTERS_Q[37] = {
+    0x0000001FCA53CC7FULL, 0x0000001044981141ULL, 0x000000174259BB5DULL,
+    0x000000175220CC5DULL, 0x000000174486CC5DULL, 0x0000001057241141ULL,
+    0x0000001FD555557FULL, 0x000000001C484400ULL, 0x0000000C4E563368ULL,
+    0x00000003025D3361ULL, 0x00000019567CEED5ULL, 0x0000001D3C7B448AULL,
+    0x0000001D48EC336BULL, 0x0000001616BC3361ULL, 0x0000000566D7EED5ULL,
+    0x00000004B105448AULL, 0x00000005D136F36BULL, 0x0000001C83E83361ULL,
+    0x000000185E02EED5ULL, 0x0000000F8DF14489ULL, 0x0000001A60BE336AULL,
+    0x0000000E89853361ULL, 0x0000000B5859EED5ULL, 0x0000001EAC2F448AULL,
+    0x000000154572336BULL, 0x0000000D16823361ULL, 0x0000001FF498EED5ULL,
+    0x000000038E59448AULL, 0x0000001F725033FBULL, 0x000000001CA6B111ULL,
+    0x0000001FC8E22D55ULL, 0x0000001049EC871AULL, 0x000000174806B3FBULL,
+    0x0000001745A03293ULL, 0x0000001754C6EF97ULL, 0x0000001056F44528ULL,
+    0x0000001FC0F73179ULL
+};
+
+// binary_m: version 7, mask 3
+static const uint64_t SYMBOL_BINARY_M[45] = {
+    0x00001FD6A679417FULL, 0x0000105DBBAE3A41ULL, 0x000017444252125DULL,
+    0x00001758AD66A35DULL, 0x000017449DFC9F5DULL, 0x000010445F14E041ULL,
+    0x00001FD55555557FULL, 0x0000001A4D12BF00ULL, 0x000016EDADFD484BULL,
+    0x000001A7D460EB1CULL, 0x000002E0790D1A5DULL, 0x000014A23EDE1BC1ULL,
+    0x00001E424508CC42ULL, 0x00001A909E460270ULL, 0x00000D7483A7E2F8ULL,
+    0x00001201C224E66FULL, 0x00001A7FE2F61AE9ULL, 0x0000042431B01C1AULL,
+    0x000011FC9458C836ULL, 0x000008B5632F2D11ULL, 0x00001DF6BBF505F4ULL,
+    0x00001B1F91197311ULL, 0x00001350895A6559ULL, 0x00001B1B2B1F0510ULL,
+    0x000003F3D5FEA9F6ULL, 0x00000D0D13541041ULL, 0x00000CEFC7A0AE3EULL,
+    0x00001681B4D57474ULL, 0x000000C19002DF8CULL, 0x00001E2185B9869BULL,
+    0x00000D7B596C8732ULL, 0x00001095F0823C50ULL, 0x00000D52C1E360C2ULL,
+    0x00001E843D0850CCULL, 0x0000016A11CE1053ULL, 0x00000F09BD6EB8F9ULL,
+    0x000013668FF2E1F0ULL, 0x00000019611D891CULL, 0x00001FD75B57D15AULL,
+    0x000010596F1CEB14ULL, 0x0000174E69F4B9FBULL, 0x0000175FC5DA95D5ULL,
+    0x000017534B48F346ULL, 0x0000104C0013A0F9ULL, 0x00001FD41E47E5B4ULL
+};
+
+// utf8_h: version 10, mask 2
+static const uint64_t SYMBOL_UTF8_H[57] = {
+    0x01FDF072DC696E7FULL, 0x010542D6E5471241ULL, 0x017585BEE97E7E5DULL,
+    0x0174018D5E15A25DULL, 0x0174A9ACFCEE1A5DULL, 0x01054F4C47710C41ULL,
+    0x01FD55555555557FULL, 0x0001E6A5470F4900ULL, 0x007543D9FD26B0E7ULL,
+    0x000111C912AC1BE4ULL, 0x00D5131579403122ULL, 0x00435CAD3CBF542AULL,
+    0x00F4E72B26821014ULL, 0x00F917DAF7DE33B5ULL, 0x014DE71EB7810F6EULL,
+    0x00508E4870A15424ULL, 0x01154FF3F3A424D1ULL, 0x01237D93BB9DC171ULL,
+    0x00CEE1FC5B828F5EULL, 0x001966BA8E6309FEULL, 0x015EC4E73080F521ULL,
+    0x00623AFC953D4EE9ULL, 0x01E4B87A4BC30412ULL, 0x000226D598504918ULL,
+    0x000DDF4F0FE2F944ULL, 0x014AAB988C3853DEULL, 0x01DF1370FD86CBF4ULL,
+    0x015142E945F2411EULL, 0x01753A9AD52E3154ULL, 0x00D15DE8C616891DULL,
+    0x013FE696FCD67DFDULL, 0x0069E0A2645D5627ULL, 0x01DCA11C6D93D130ULL,
+    0x0073077AEB9D7109ULL, 0x004F86099AE20FDCULL, 0x001BFA2E49F3143EULL,
+    0x007F9B8C95B8E721ULL, 0x01B99526ABB1C29BULL, 0x004E6DAE01E90F2AULL,
+    0x00132049DAA3279DULL, 0x01B46714AF884F30ULL, 0x01A34B45B820E7E5ULL,
+    0x01FF8A3182590949ULL, 0x002B65B1829F4341ULL, 0x001D47599076F238ULL,
+    0x002B526FE62CCB65ULL, 0x014C28E3B2307D65ULL, 0x01F2E9CF83AE575FULL,
+    0x0004123D7DE40BF4ULL, 0x000185B6479EA71DULL, 0x01FC710BD7326B5DULL,
+    0x0104FB0DC5E55D17ULL, 0x01750CB17C9BC5F0ULL, 0x01758B7F5EC54014ULL,
+    0x0175586FAC5A3D4CULL, 0x0104B4D1BEC6BB94ULL, 0x01FCBDA9E02D24EEULL
+};
+
+// max_m: version 10, mask 1
+static const uint64_t SYMBOL_MAX_M[57] = {
+    0x01FDCA216666667FULL, 0x01043935DDDDD241ULL, 0x0175E94A88888E5DULL,
+    0x0174054B66666A5DULL, 0x01743A81FE66625DULL, 0x010505B5C5DDDC41ULL,
+    0x01FD55555555557FULL, 0x00002A65C7777500ULL, 0x0146D3347D999825ULL,
+    0x01ABCFBE59999A97ULL, 0x01D7FC4AA2222229ULL, 0x00391E65B7777579ULL,
+    0x0076D03C19999892ULL, 0x00DBC8B259999A97ULL, 0x01EF3E46A2222229ULL,
+    0x00395D6DB777757AULL, 0x001ED82C19999891ULL, 0x009BC6A259999A97ULL,
+    0x018F7CAAA2222229ULL, 0x00595EB9B7777579ULL, 0x000CC83019999892ULL,
+    0x009B26B259999A97ULL, 0x0096EC7AA2222229ULL, 0x00DA4E59B7777579ULL,
+    0x000FE8F019999892ULL, 0x019B96E259999A97ULL, 0x009FF0BA7E2223F9ULL,
+    0x0151522947777719ULL, 0x01D5C830D5999B52ULL, 0x005194A2C5999B17ULL,
+    0x019FF4BA7E2221F9ULL, 0x000A6625DF7777D9ULL, 0x0084CD3049999B82ULL,
+    0x015293AA25999A66ULL, 0x01E6F0B626222068ULL, 0x0029EB2DDF7777D8ULL,
+    0x00840D1C49999B83ULL, 0x011212BE25999A67ULL, 0x01A6F37226222069ULL,
+    0x0059AB61DF7777D9ULL, 0x008CED4C49999B82ULL, 0x010A12BA25999A67ULL,
+    0x01AE436226222069ULL, 0x00C97BD1DF7777D9ULL, 0x010D9D5C49999B82ULL,
+    0x011262BA25999A67ULL, 0x014F63C226222069ULL, 0x01F16F11DF7777D9ULL,
+    0x0007A7DCFD999BF2ULL, 0x000166BAC5999917ULL, 0x01FD79C2D6222159ULL,
+    0x0104651147777519ULL, 0x0174ABD07D9999F2ULL, 0x017466BAF5999B74ULL,
+    0x017574CA9A22219BULL, 0x0104E1195B777598ULL, 0x01FDA5E061999A21ULL
+};
+
+// max_l: version 10, mask 1
+static const uint64_t SYMBOL_MAX_L[57] = {
+    0x01FDA11155555E7FULL, 0x01052222CCCCCA41ULL, 0x01741777CCCCCE5DULL,
+    0x01741BBBAAAAAA5DULL, 0x0175C111FD55525DULL, 0x0105E222C4CCCC41ULL,
+    0x01FD55555555557FULL, 0x00018888C7333000ULL, 0x01CD14447D5554F3ULL,
+    0x0103AEEE2AAAAAA3ULL, 0x01DDCDDD73333135ULL, 0x01F92888B333303AULL,
+    0x00C4D44415555453ULL, 0x013A9EEE2AAAAAA3ULL, 0x00A61DDD73333135ULL,
+    0x01735888B333303AULL, 0x01EED44415555453ULL, 0x013BAEEE2AAAAAA3ULL,
+    0x00FE9DDD73333135ULL, 0x013A2888B333303AULL, 0x008E1C4415555453ULL,
+    0x01AA72EE2AAAAAA3ULL, 0x008591DD73333135ULL, 0x008AAC88B333303BULL,
+    0x01142C4415555450ULL, 0x002A9EEE2AAAAAA3ULL, 0x00BF35DDFF3331F5ULL,
+    0x0171DC88C733311AULL, 0x00352844D5555753ULL, 0x01316EEEC6AAA913ULL,
+    0x007FC5DD7F3331F5ULL, 0x01DB3C884F3333CAULL, 0x010C3444CD5556C3ULL,
+    0x0059FEEE6AAAA8A3ULL, 0x0035C1DD17333255ULL, 0x001890884F3333CAULL,
+    0x017DCC44CD5556C3ULL, 0x01D032EE6AAAA8A0ULL, 0x00A575DD17333257ULL,
+    0x015940884F3333CAULL, 0x01E47444CD5556C3ULL, 0x00AB0AEE6AAAA8A3ULL,
+    0x011CADDD17333255ULL, 0x003194884F3333CAULL, 0x01640044CD5556C3ULL,
+    0x01B876EE6AAAA8A3ULL, 0x014F09DD17333255ULL, 0x01F21C884F3333CAULL,
+    0x00049C44FD5557F3ULL, 0x000172EE46AAAB13ULL, 0x01FCD5DD57333355ULL,
+    0x010554884733311AULL, 0x0174E8447D5557F3ULL, 0x01741EEEF2AAAB30ULL,
+    0x017579DDD7333157ULL, 0x01053C88AB3332A8ULL, 0x01FD4C4471555731ULL
+};
+
+static const ExpectedSymbol EXPECTED_SYMBOLS[] = {
+    {"hello_m", QR_ECC_MEDIUM, "HELLO", 5, 1, SYMBOL_HELLO_M},
+    {"url_l", QR_ECC_LOW, "https://example.com", 19, 2, SYMBOL_URL_L},
+    {"repeat_h", QR_ECC_HIGH, "AAAAAAAAAA", 10, 2, SYMBOL_REPEAT_H},
+    {"wifi_q", QR_ECC_QUARTILE, "WIFI:S:Home;T:WPA;P:secret;;", 28, 3, SYMBOL_WIFI_Q},
+    {"letters_m", QR_ECC_MEDIUM, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx", 60, 4, SYMBOL_LETTERS_M},
+    {"sentence_l", QR_ECC_LOW, "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. ", 90, 5, SYMBOL_SENTENCE_L},
+    {"letters_q", QR_ECC_QUARTILE, "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", 58, 5, SYMBOL_LETTERS_Q},
+    {"binary_m", QR_ECC_MEDIUM, "\x07\x08\x09\x0A\x0B\x0C\x0D\x0E\x0F\x10\x11\x12\x13\x14\x15\x16\x17\x18\x19\x1A\x1B\x1C\x1D\x1E\x1F !\x22#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\x5C]^_`abcdefghijklmnopqrstuvwxyz{|}~", 120, 7, SYMBOL_BINARY_M},
+    {"utf8_h", QR_ECC_HIGH, "Cr\xC3\xA8me br\xC3\xBBl\xC3\xA9\x65, \xC2\xA1Ol\xC3\xA9! Cr\xC3\xA8me br\xC3\xBBl\xC3\xA9\x65, \xC2\xA1Ol\xC3\xA9! Cr\xC3\xA8me br\xC3\xBBl\xC3\xA9\x65, \xC2\xA1Ol\xC3\xA9! Cr\xC3\xA8me br\xC3\xBBl\xC3\xA9\x65, \xC2\xA1Ol\xC3\xA9! ", 100, 10, SYMBOL_UTF8_H},
+    {"max_m", QR_ECC_MEDIUM, "zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz", 213, 10, SYMBOL_MAX_M},
+    {"max_l", QR_ECC_LOW, "qqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqq", 271, 10, SYMBOL_MAX_L},
+};
+
+static const size_t EXPECTED_SYMBOL_COUNT = sizeof(EXPECTED_SYMBOLS) / sizeof(EXPECTED_SYMBOLS[0]);
+
+#endif // EXPECTED_SYMBOLS_H
@@ -0,0 +1,78 @@
+// QrEncoder against reference symbols from an independent encoder
+// (expected_symbols.h): every module of every symbol, at each error
+// correction level, versions 1 to QR_MAX_VERSION including the version
+// information blocks from version 7.
+
+#include <unity.h>
+#include <string.h>
+#include "QrEncoder.h"
+#include "expected_symbols.h"
+
+static QrEncoder qr;  // About 1.5KB, kept off the stack
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void assertSymbol(const ExpectedSymbol& expected) {
+    TEST_ASSERT_TRUE_MESSAGE(qr.encode((const uint8_t*)expected.data, expected.length, expected.ecc), expected.name);
+    TEST_ASSERT_EQUAL_MESSAGE(expected.version, qr.getVersion(), expected.name);
+    TEST_ASSERT_EQUAL_MESSAGE(expected.version * 4 + 17, qr.getSize(), expected.name);
+
+    uint8_t size = qr.getSize();
+    for (uint8_t y = 0; y < size; y++) {
+        uint64_t row = 0;
+        for (uint8_t x = 0; x < size; x++) {
+            row = (row << 1) | (qr.getModule(x, y) ? 1 : 0);
+        }
+        if (row != expected.rows[y]) {
+            char message[96];
+            snprintf(message, sizeof(message), "%s row %u: %016llX expected %016llX", expected.name, (unsigned)y,
+                     (unsigned long long)row, (unsigned long long)expected.rows[y]);
+            TEST_FAIL_MESSAGE(message);
+        }
+    }
+}
+
+void test_symbols_match_the_reference(void) {
+    for (size_t i = 0; i < EXPECTED_SYMBOL_COUNT; i++) {
+        assertSymbol(EXPECTED_SYMBOLS[i]);
+    }
+}
+
+void test_every_error_correction_level_is_covered(void) {
+    bool covered[4] = {false, false, false, false};
+    bool versionInfo = false;
+    for (size_t i = 0; i < EXPECTED_SYMBOL_COUNT; i++) {
+        covered[EXPECTED_SYMBOLS[i].ecc] = true;
+        versionInfo = versionInfo || EXPECTED_SYMBOLS[i].version >= 7;
+    }
+    for (int i = 0; i < 4; i++) TEST_ASSERT_TRUE(covered[i]);
+    TEST_ASSERT_TRUE(versionInfo);
+}
+
+void test_longest_data_fits_the_largest_version(void) {
+    // max_m and max_l are QR_MAX_VERSION's byte capacity at M and L
+    TEST_ASSERT_EQUAL(213, QrEncoder::maxLength(QR_ECC_MEDIUM));
+    TEST_ASSERT_EQUAL(271, QrEncoder::maxLength(QR_ECC_LOW));
+
+    static uint8_t data[300];
+    memset(data, 'z', sizeof(data));
+    TEST_ASSERT_FALSE(qr.encode(data, QrEncoder::maxLength(QR_ECC_MEDIUM) + 1, QR_ECC_MEDIUM));
+    TEST_ASSERT_EQUAL(0, qr.getVersion());
+    TEST_ASSERT_EQUAL(0, QrEncoder::versionFor(QrEncoder::maxLength(QR_ECC_HIGH) + 1, QR_ECC_HIGH));
+}
+
+void test_encoder_is_reusable(void) {
+    // A larger symbol must not leave modules behind in a smaller one
+    assertSymbol(EXPECTED_SYMBOLS[EXPECTED_SYMBOL_COUNT - 1]);
+    assertSymbol(EXPECTED_SYMBOLS[0]);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_symbols_match_the_reference);
+    RUN_TEST(test_every_error_correction_level_is_covered);
+    RUN_TEST(test_longest_data_fits_the_largest_version);
+    RUN_TEST(test_encoder_is_reusable);
+    return UNITY_END();
+}
@@ -0,0 +1,159 @@
+// printRaster against the exact byte stream it should send: one GS v 0
+// band header per RASTER_BAND_HEIGHT rows, each band's rows straight from
+// the source, one UART write per band.
+
+#include <unity.h>
+#include <Preferences.h>
+#include <vector>
+#include "PrinterService.h"
+#include "PrintProfiles.h"
+#include "MockPrinterPort.h"
+
+static MockPrinterPort* port;
+static PrinterService* printer;
+
+void setUp(void) {
+    NativeClock::reset();
+    Preferences::wipe();
+    port = new MockPrinterPort();
+    printer = new PrinterService(port);
+}
+
+void tearDown(void) {
+    delete printer;
+    delete port;
+}
+
+static uint8_t patternByte(uint16_t row, uint16_t column) {
+    return (uint8_t)(row * 7 + column * 13 + 1);
+}
+
+static bool pattern(uint16_t row, uint8_t* out, uint16_t bytesPerRow) {
+    for (uint16_t i = 0; i < bytesPerRow; i++) {
+        out[i] = patternByte(row, i);
+    }
+    return true;
+}
+
+// What the printer should get for a width x height raster, first job on a
+// fresh PrinterService: heating profile, the bands, a line feed
+static std::vector<uint8_t> expectedStream(uint16_t width, uint16_t height, bool synced) {
+    EscPosEncoder profile;
+    PrintProfiles::encode(PrintProfiles::preset(PRINTER_DEFAULT_PROFILE), profile);
+    std::vector<uint8_t> bytes(profile.data(), profile.data() + profile.size());
+
+    uint16_t bytesPerRow = width / 8;
+    for (uint16_t start = 0; start < height; start += RASTER_BAND_HEIGHT) {
+        uint16_t rows = min((uint16_t)RASTER_BAND_HEIGHT, (uint16_t)(height - start));
+        const uint8_t header[] = {ESCPOS_GS, 'v', '0', 0,
+                                  (uint8_t)(bytesPerRow & 0xFF), (uint8_t)(bytesPerRow >> 8),
+                                  (uint8_t)(rows & 0xFF), (uint8_t)(rows >> 8)};
+        bytes.insert(bytes.end(), header, header + sizeof(header));
+        for (uint16_t r = 0; r < rows; r++) {
+            for (uint16_t i = 0; i < bytesPerRow; i++) {
+                bytes.push_back(patternByte(start + r, i));
+            }
+        }
+        if (synced) {
+            const uint8_t sync[] = {ESCPOS_GS, 'r', 1};
+            bytes.insert(bytes.end(), sync, sync + sizeof(sync));
+        }
+    }
+    bytes.push_back('\r');
+    bytes.push_back('\n');
+    if (synced) {
+        const uint8_t sync[] = {ESCPOS_GS, 'r', 1};
+        bytes.insert(bytes.end(), sync, sync + sizeof(sync));
+    }
+    return bytes;
+}
+
+static void assertStream(const std::vector<uint8_t>& expected) {
+    TEST_ASSERT_EQUAL(expected.size(), port->written.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.data(), port->written.data(), expected.size());
+}
+
+static uint16_t bandCount(uint16_t height) {
+    return (height + RASTER_BAND_HEIGHT - 1) / RASTER_BAND_HEIGHT;
+}
+
+void test_full_width_raster_is_sent_in_bands(void) {
+    const uint16_t height = RASTER_BAND_HEIGHT * 3;
+    TEST_ASSERT_TRUE(printer->printRaster(PRINTER_HEAD_DOTS, height, pattern));
+    assertStream(expectedStream(PRINTER_HEAD_DOTS, height, false));
+    // One write per band, then the line feed
+    TEST_ASSERT_EQUAL(bandCount(height) + 1, port->writes);
+}
+
+void test_last_band_holds_the_remaining_rows(void) {
+    const uint16_t height = RASTER_BAND_HEIGHT * 2 + 5;
+    TEST_ASSERT_TRUE(printer->printRaster(64, height, pattern));
+    assertStream(expectedStream(64, height, false));
+    TEST_ASSERT_EQUAL(port->model.getRasterRows(), height);
+}
+
+void test_single_row_and_single_byte_rasters(void) {
+    TEST_ASSERT_TRUE(printer->printRaster(8, 1, pattern));
+    assertStream(expectedStream(8, 1, false));
+}
+
+void test_bands_carry_a_sync_request_when_the_printer_answers(void) {
+    port->answering = true;
+    printer->refreshStatus();
+    port->clear();
+
+    const uint16_t height = RASTER_BAND_HEIGHT * 4 + 1;
+    TEST_ASSERT_TRUE(printer->printRaster(PRINTER_HEAD_DOTS, height, pattern));
+    assertStream(expectedStream(PRINTER_HEAD_DOTS, height, true));
+    TEST_ASSERT_EQUAL(0, port->pendingReplies());
+}
+
+void test_print_bitmap_reads_rows_from_the_array(void) {
+    const uint16_t width = 24;
+    const uint16_t height = RASTER_BAND_HEIGHT + 3;
+    std::vector<uint8_t> bitmap(width / 8 * height);
+    for (uint16_t row = 0; row < height; row++) {
+        for (uint16_t i = 0; i < width / 8; i++) {
+            bitmap[row * (width / 8) + i] = patternByte(row, i);
+        }
+    }
+    TEST_ASSERT_TRUE(printer->printBitmap(bitmap.data(), width, height));
+    assertStream(expectedStream(width, height, false));
+}
+
+void test_invalid_widths_send_nothing(void) {
+    TEST_ASSERT_FALSE(printer->printRaster(12, 10, pattern));
+    TEST_ASSERT_FALSE(printer->printRaster(PRINTER_HEAD_DOTS + 8, 10, pattern));
+    TEST_ASSERT_FALSE(printer->printRaster(0, 10, pattern));
+    TEST_ASSERT_FALSE(printer->printRaster(64, 0, pattern));
+    TEST_ASSERT_FALSE(printer->printRaster(64, 10, RasterRowSource()));
+    TEST_ASSERT_EQUAL(0, port->written.size());
+}
+
+void test_source_abort_stops_before_the_band(void) {
+    const uint16_t abortRow = RASTER_BAND_HEIGHT + 2;
+    uint16_t calls = 0;
+    bool printed = printer->printRaster(64, RASTER_BAND_HEIGHT * 3, [&](uint16_t row, uint8_t* out, uint16_t bytesPerRow) {
+        calls++;
+        return row < abortRow && pattern(row, out, bytesPerRow);
+    });
+    TEST_ASSERT_FALSE(printed);
+    TEST_ASSERT_EQUAL(abortRow + 1, calls);
+
+    // Only the first band went out, whole
+    std::vector<uint8_t> firstBand = expectedStream(64, RASTER_BAND_HEIGHT, false);
+    firstBand.resize(firstBand.size() - 2);  // No closing line feed
+    assertStream(firstBand);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_full_width_raster_is_sent_in_bands);
+    RUN_TEST(test_last_band_holds_the_remaining_rows);
+    RUN_TEST(test_single_row_and_single_byte_rasters);
+    RUN_TEST(test_bands_carry_a_sync_request_when_the_printer_answers);
+    RUN_TEST(test_print_bitmap_reads_rows_from_the_array);
+    RUN_TEST(test_invalid_widths_send_nothing);
+    RUN_TEST(test_source_abort_stops_before_the_band);
+    return UNITY_END();
+}
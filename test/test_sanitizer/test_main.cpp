@@ -0,0 +1,222 @@
+// TextSanitizer against the String::replace chain it replaced (copied
+// below from PrinterService::sanitizeForPrinter), plus a host benchmark of
+// both on emoji-heavy text.
+
+#include <unity.h>
+#include <chrono>
+#include <vector>
+#include "TextSanitizer.h"
+
+static String legacySanitize(const String& text) {
+    String result = text;
+
+    result.replace("💌", "[LOVE LETTER]");
+    result.replace("💕", "<3");
+    result.replace("❤️", "<3");
+    result.replace("❤", "<3");
+    result.replace("💖", "<3");
+    result.replace("💝", "[GIFT]");
+    result.replace("💗", "<3");
+    result.replace("💓", "<3");
+    result.replace("💞", "<3");
+    result.replace("💟", "<3");
+    result.replace("💋", "[KISS]");
+
+    result.replace("😊", ":)");
+    result.replace("😍", ":)");
+    result.replace("😘", ":*");
+    result.replace("🥰", ":)");
+    result.replace("😻", ":)");
+
+    result.replace("🌵", "[CACTUS]");
+    result.replace("🌹", "[ROSE]");
+    result.replace("🌸", "[FLOWER]");
+    result.replace("🌺", "[FLOWER]");
+    result.replace("🌻", "[FLOWER]");
+    result.replace("🌷", "[FLOWER]");
+    result.replace("💐", "[FLOWERS]");
+
+    result.replace("⭐", "*");
+    result.replace("✨", "*");
+    result.replace("💫", "*");
+    result.replace("🌟", "*");
+    result.replace("🎉", "[PARTY]");
+    result.replace("🎊", "[PARTY]");
+    result.replace("🎈", "[BALLOON]");
+    result.replace("🎁", "[GIFT]");
+
+    result.replace("⏰", "[ALARM]");
+    result.replace("📝", "[NOTE]");
+    result.replace("🛒", "[CART]");
+    result.replace("✅", "[OK]");
+    result.replace("❌", "[X]");
+    result.replace("⚠️", "[!]");
+    result.replace("⚠", "[!]");
+    result.replace("🔧", "[TOOL]");
+    result.replace("📡", "[SIGNAL]");
+    result.replace("🖨️", "[PRINTER]");
+    result.replace("🖨", "[PRINTER]");
+    result.replace("💧", "[DROP]");
+
+    String cleaned = "";
+    for (unsigned int i = 0; i < result.length(); i++) {
+        char c = result.charAt(i);
+        if ((c >= 32 && c <= 126) || c == '\n' || c == '\r' || c == '\t') {
+            cleaned += c;
+        } else if ((c & 0x80) != 0) {
+            while (i + 1 < result.length() && (result.charAt(i + 1) & 0xC0) == 0x80) {
+                i++;
+            }
+        }
+    }
+    return cleaned;
+}
+
+// Every emoji the old chain knew, plus the variation-selector forms
+static const char* const EMOJI[] = {
+    "💌", "💕", "❤️", "❤", "💖", "💝", "💗", "💓", "💞", "💟", "💋",
+    "😊", "😍", "😘", "🥰", "😻",
+    "🌵", "🌹", "🌸", "🌺", "🌻", "🌷", "💐",
+    "⭐", "✨", "💫", "🌟", "🎉", "🎊", "🎈", "🎁",
+    "⏰", "📝", "🛒", "✅", "❌", "⚠️", "⚠", "🔧", "📡", "🖨️", "🖨", "💧",
+};
+static const size_t EMOJI_COUNT = sizeof(EMOJI) / sizeof(EMOJI[0]);
+
+// Pieces the fuzz strings are built from: text, unmapped emoji, accents,
+// controls and broken UTF-8
+static const char* const OTHER[] = {
+    "Hello", " ", "\n", "\r\n", "\t", "x", "1234", "~", "\x7F", "\x01", "\x1B",
+    "😀", "🚀", "👍🏽", "☕", "é", "ß", "Ω", "€", "\xEF\xB8\x8F",
+    "\x80", "\xBF\xBF", "\xC3", "\xE2\x9A", "\xF0\x9F\x8C", "\xF8\x88\x80\x80\x80", "\xFF",
+};
+static const size_t OTHER_COUNT = sizeof(OTHER) / sizeof(OTHER[0]);
+
+static uint32_t fuzzState;
+
+static uint32_t nextRandom() {
+    fuzzState = fuzzState * 1103515245u + 12345u;
+    return fuzzState >> 8;
+}
+
+static String randomText(size_t pieces) {
+    String text;
+    for (size_t i = 0; i < pieces; i++) {
+        uint32_t pick = nextRandom();
+        text += (pick & 3) == 0 ? EMOJI[(pick >> 2) % EMOJI_COUNT] : OTHER[(pick >> 2) % OTHER_COUNT];
+    }
+    return text;
+}
+
+static void assertSame(const String& input) {
+    String expected = legacySanitize(input);
+    String actual = TextSanitizer::sanitize(input);
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), actual.c_str());
+}
+
+void setUp(void) {
+    fuzzState = 20240601;
+}
+
+void tearDown(void) {}
+
+void test_each_emoji_matches_the_replace_chain(void) {
+    for (size_t i = 0; i < EMOJI_COUNT; i++) {
+        assertSame(EMOJI[i]);
+        assertSame(String("a") + EMOJI[i] + "b");
+        assertSame(String(EMOJI[i]) + EMOJI[i]);
+    }
+}
+
+void test_variation_selectors_match_the_replace_chain(void) {
+    assertSame("I \xE2\x9D\xA4\xEF\xB8\x8F you");         // ❤ + VS16
+    assertSame("\xE2\x9A\xA0\xEF\xB8\x8F low paper");     // ⚠ + VS16
+    assertSame("\xF0\x9F\x96\xA8\xEF\xB8\x8F ready");     // 🖨 + VS16
+    assertSame("\xEF\xB8\x8F\xEF\xB8\x8F");               // Selectors alone
+}
+
+void test_broken_utf8_matches_the_replace_chain(void) {
+    assertSame("\x80\x80 stray continuations");
+    assertSame("cut off \xF0\x9F\x8C");
+    assertSame("cut off \xF0\x9F\x8C then text");
+    assertSame("\xC3(");
+    assertSame("\xF8\x88\x80\x80\x80 five bytes");
+    assertSame("\xFE\xFF");
+    assertSame("\xE2\xE2\x9A\xA0");                       // Lead byte, then ⚠
+}
+
+void test_random_text_matches_the_replace_chain(void) {
+    for (int i = 0; i < 2000; i++) {
+        assertSame(randomText(1 + nextRandom() % 40));
+    }
+}
+
+void test_measure_only_matches_the_result(void) {
+    for (int i = 0; i < 200; i++) {
+        String input = randomText(30);
+        size_t needed = TextSanitizer::sanitize(input.c_str(), input.length(), nullptr, 0);
+        TEST_ASSERT_EQUAL(TextSanitizer::sanitize(input).length(), needed);
+
+        // A short buffer gets a prefix, never more than it can hold
+        char buffer[8];
+        size_t total = TextSanitizer::sanitize(input.c_str(), input.length(), buffer, sizeof(buffer));
+        TEST_ASSERT_EQUAL(needed, total);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(TextSanitizer::sanitize(input).c_str(), buffer, min(needed, sizeof(buffer)));
+    }
+}
+
+// Emoji-heavy message: roughly one emoji per three words
+static String emojiHeavy(size_t length) {
+    static const char* const words[] = {"Good", "morning", "love", "water", "the", "plants", "today"};
+    String text;
+    size_t i = 0;
+    while (text.length() < length) {
+        text += words[i % 7];
+        text += " ";
+        if (i % 3 == 2) text += EMOJI[(i * 7) % EMOJI_COUNT];
+        i++;
+    }
+    return text;
+}
+
+template <class F>
+static double medianUs(F run) {
+    std::vector<double> times;
+    for (int i = 0; i < 51; i++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        run();
+        times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+void test_benchmark_against_the_replace_chain(void) {
+    const size_t sizes[] = {100, 1024, 4096};
+    for (size_t s = 0; s < 3; s++) {
+        String input = emojiHeavy(sizes[s]);
+        String legacyResult;
+        String result;
+        double legacyUs = medianUs([&]() { legacyResult = legacySanitize(input); });
+        double singlePassUs = medianUs([&]() { result = TextSanitizer::sanitize(input); });
+        TEST_ASSERT_EQUAL_STRING(legacyResult.c_str(), result.c_str());
+
+        char line[128];
+        snprintf(line, sizeof(line), "%5u bytes: replace chain %8.1f us, single pass %7.1f us (%.0fx)",
+                 (unsigned)input.length(), legacyUs, singlePassUs, legacyUs / singlePassUs);
+        TEST_MESSAGE(line);
+        if (sizes[s] >= 1024) {
+            TEST_ASSERT_TRUE_MESSAGE(singlePassUs < legacyUs, line);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_each_emoji_matches_the_replace_chain);
+    RUN_TEST(test_variation_selectors_match_the_replace_chain);
+    RUN_TEST(test_broken_utf8_matches_the_replace_chain);
+    RUN_TEST(test_random_text_matches_the_replace_chain);
+    RUN_TEST(test_measure_only_matches_the_result);
+    RUN_TEST(test_benchmark_against_the_replace_chain);
+    return UNITY_END();
+}